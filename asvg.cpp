@@ -1,6 +1,15 @@
 #include "asvg.hpp"
 #include "lunasvg.h"
+#include "plutovg.h"
 #include <charconv>
+#include <cstring>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
 #include "glew.h"
 
 namespace asvg {
@@ -12,12 +21,19 @@ svg_instance::~svg_instance() noexcept {
 	}
 }
 
-svg_instance::svg_instance(char const* bytes, int32_t sx, int32_t sy) {
+svg_instance::svg_instance(char const* bytes, int32_t sx, int32_t sy, bool single_channel) {
 	glGenTextures(1, &texture_handle);
 	if(texture_handle) {
 		glBindTexture(GL_TEXTURE_2D, texture_handle);
-		glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, sx, sy);
-		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, sx, sy, GL_RGBA, GL_UNSIGNED_BYTE, bytes);
+		if(single_channel) {
+			glTexStorage2D(GL_TEXTURE_2D, 1, GL_R8, sx, sy);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, sx, sy, GL_RED, GL_UNSIGNED_BYTE, bytes);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		} else {
+			glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, sx, sy);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, sx, sy, GL_RGBA, GL_UNSIGNED_BYTE, bytes);
+		}
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -141,32 +157,29 @@ svg::svg(char const* data, size_t count, int32_t base_width, int32_t base_height
 	}
 }
 
-void svg::release_renders() {
-	renders.clear();
-}
-
-uint32_t svg::get_render(float size_x, float size_y, int32_t grid_size, float scale, float r, float g, float b) {
-	uint64_t colorid = uint64_t(r * 255.0f) | (uint64_t(g * 255.0f) << uint64_t(8)) | (uint64_t(b * 255.0f) << uint64_t(16));
-	uint64_t idx = uint64_t(uint32_t(size_x * grid_size)) | (uint64_t(uint32_t(size_y * grid_size)) << uint64_t(20)) | (colorid << 40);
-
-	if(auto it = renders.find(idx); it != renders.end()) {
-		return it->second.texture_handle;
-	}
-	return make_new_render(size_x, size_y, grid_size, scale);
-}
-uint32_t svg::try_get_render(float size_x, float size_y, int32_t grid_size, float r, float g, float b) {
-	uint64_t colorid = uint64_t(r * 255.0f) | (uint64_t(g * 255.0f) << uint64_t(8)) | (uint64_t(b * 255.0f) << uint64_t(16));
-	uint64_t idx = uint64_t(uint32_t(size_x * grid_size)) | (uint64_t(uint32_t(size_y * grid_size)) << uint64_t(20)) | (colorid << 40);
+using image_loader = std::function<lunasvg::Bitmap(std::string_view)>;
 
-	if(auto it = renders.find(idx); it != renders.end()) {
-		return it->second.texture_handle;
-	}
-	return 0;
+template<size_t N>
+static void set_primary_color(char (&cssstylesheet)[N], float r, float g, float b) {
+	auto const clroffset = strlen(".primarycolor { fill: #");
+	auto const clroffset2 = strlen(".primarycolor { fill: #000000; stroke: #");
+	auto tohexdigit = [](uint32_t v) {
+		char table[] = "0123456789abcdef";
+		return table[v & 0x0F];
+	};
+	auto rv = uint32_t(r * 255.0f);
+	cssstylesheet[clroffset] = cssstylesheet[clroffset2] = tohexdigit(rv >> 4);
+	cssstylesheet[clroffset + 1] = cssstylesheet[clroffset2 + 1] = tohexdigit(rv);
+	auto gv = uint32_t(g * 255.0f);
+	cssstylesheet[clroffset + 2] = cssstylesheet[clroffset2 + 2] = tohexdigit(gv >> 4);
+	cssstylesheet[clroffset + 3] = cssstylesheet[clroffset2 + 3] = tohexdigit(gv);
+	auto bv = uint32_t(b * 255.0f);
+	cssstylesheet[clroffset + 4] = cssstylesheet[clroffset2 + 4] = tohexdigit(bv >> 4);
+	cssstylesheet[clroffset + 5] = cssstylesheet[clroffset2 + 5] = tohexdigit(bv);
 }
-uint32_t svg::make_new_render(float size_x, float size_y, int32_t grid_size, float scale, float r, float g, float b) {
-	if(svg_data.size() == 0)
-		return 0;
 
+// writes the sizes the svg asks for over its placeholders
+static void fill_in_sizes(std::vector<char>& svg_data, std::vector<affine_replacement> const& replacements, int32_t base_width, int32_t base_height, float size_x, float size_y, int32_t grid_size) {
 	char temp_buffer[128] = { 0 };
 
 	float x_scale = float(size_x * 500.0f) / float(base_width);
@@ -198,38 +211,853 @@ uint32_t svg::make_new_render(float size_x, float size_y, int32_t grid_size, flo
 			memcpy(svg_data.data() + r.start_position, temp_buffer, size_t(std::min(r.end_position - r.start_position, uint32_t(128))));
 		}
 	}
+}
 
-	char cssstylesheet[] = ".primarycolor { fill: #000000; stroke: #000000; } ";
-	auto const clroffset = strlen(".primarycolor { fill: #");
-	auto const clroffset2 = strlen(".primarycolor { fill: #000000; stroke: #");
-	auto tohexdigit = [](uint32_t v) { 
-		char table[] = "0123456789abcdef";
-		return table[v & 0x0F];
-	};
-	auto rv = uint32_t(r * 255.0f);
-	cssstylesheet[clroffset] = cssstylesheet[clroffset2] = tohexdigit(rv >> 4);
-	cssstylesheet[clroffset+1] = cssstylesheet[clroffset2 + 1] = tohexdigit(rv);
-	auto gv = uint32_t(g * 255.0f);
-	cssstylesheet[clroffset + 2] = cssstylesheet[clroffset2 + 2] = tohexdigit(gv >> 4);
-	cssstylesheet[clroffset + 3] = cssstylesheet[clroffset2 + 3] = tohexdigit(gv);
-	auto bv = uint32_t(b * 255.0f);
-	cssstylesheet[clroffset + 4] = cssstylesheet[clroffset2 + 4] = tohexdigit(bv >> 4);
-	cssstylesheet[clroffset + 5] = cssstylesheet[clroffset2 + 5] = tohexdigit(bv);
+// plutovg keeps the memory of the layers a render draws through for the next ones, which is given back once it is done
+static void render_document(lunasvg::Document& doc, lunasvg::Bitmap& bmp, lunasvg::Matrix const& matrix) {
+	doc.render(bmp, matrix);
+	plutovg_surface_pool_trim();
+}
+
+// fills in the sizes the svg asks for and renders it; returns false if the data could not be parsed
+static bool rasterize_svg(std::vector<char>& svg_data, std::vector<affine_replacement> const& replacements, int32_t base_width, int32_t base_height, float size_x, float size_y, int32_t grid_size, float scale, float r, float g, float b, image_loader const& loader, lunasvg::Bitmap& bmp) {
+	fill_in_sizes(svg_data, replacements, base_width, base_height, size_x, size_y, grid_size);
 
-	auto doc = lunasvg::Document::loadFromData(svg_data.data(), svg_data.size(), [](std::string_view file_name) {
-		return common_file_bank::bank.get_file_data(file_name);
-	});
+	char cssstylesheet[] = ".primarycolor { fill: #000000; stroke: #000000; } ";
+	set_primary_color(cssstylesheet, r, g, b);
 
-	if(!doc) std::abort(); // TODO: error message
+	auto doc = lunasvg::Document::loadFromData(svg_data.data(), svg_data.size(), loader);
+	if(!doc)
+		return false;
 	doc->applyStyleSheet(cssstylesheet);
 
-	lunasvg::Bitmap bmp(
+	bmp = lunasvg::Bitmap(
 		int32_t(size_x * scale * grid_size),
 		int32_t(size_y * scale * grid_size));
 
-	doc->render(bmp, lunasvg::Matrix{ }.scale(scale * float(grid_size) / 500.0f, scale * float(grid_size) / 500.0f));
+	render_document(*doc, bmp, lunasvg::Matrix{ }.scale(scale * float(grid_size) / 500.0f, scale * float(grid_size) / 500.0f));
 
 	bmp.convertToRGBA();
+	return true;
+}
+
+static bool rasterize_simple_svg(std::vector<char> const& svg_data, int32_t size_x, int32_t size_y, float scale, float r, float g, float b, image_loader const& loader, lunasvg::Bitmap& bmp) {
+	char cssstylesheet[] = ".primarycolor { fill: #000000; stroke: #000000; } ";
+	set_primary_color(cssstylesheet, r, g, b);
+
+	auto doc = lunasvg::Document::loadFromData(svg_data.data(), svg_data.size(), loader);
+	if(!doc)
+		return false;
+	doc->applyStyleSheet(cssstylesheet);
+
+	bmp = lunasvg::Bitmap(
+		int32_t(size_x * scale),
+		int32_t(size_y * scale));
+
+	render_document(*doc, bmp, lunasvg::Matrix{ }.scale(scale * size_x / float(doc->width()), scale * size_y / float(doc->height())));
+	bmp.convertToRGBA();
+	return true;
+}
+
+/*
+renders the icon once with the primary color black and once with it white; compositing is linear in the color, so
+drawn in the color c a pixel comes out as the black render plus c times the difference between the two
+the difference is the same for each channel, and is kept relative to the pixel's alpha, as the colors are
+*/
+static bool rasterize_tinted_svg(std::vector<char> const& svg_data, int32_t size_x, int32_t size_y, float scale, image_loader const& loader, lunasvg::Bitmap& bmp, std::vector<char>& tint) {
+	char cssstylesheet[] = ".primarycolor { fill: #000000; stroke: #000000; } ";
+
+	auto doc = lunasvg::Document::loadFromData(svg_data.data(), svg_data.size(), loader);
+	if(!doc)
+		return false;
+	doc->applyStyleSheet(cssstylesheet);
+
+	auto transform = lunasvg::Matrix{ }.scale(scale * size_x / float(doc->width()), scale * size_y / float(doc->height()));
+	bmp = lunasvg::Bitmap(
+		int32_t(size_x * scale),
+		int32_t(size_y * scale));
+	render_document(*doc, bmp, transform);
+
+	set_primary_color(cssstylesheet, 1.0f, 1.0f, 1.0f);
+	doc->applyStyleSheet(cssstylesheet); // same selector, so it replaces the black
+	lunasvg::Bitmap white(bmp.width(), bmp.height());
+	render_document(*doc, white, transform);
+
+	tint.assign(size_t(bmp.width()) * size_t(bmp.height()), char(0));
+	for(int32_t y = 0; y < bmp.height(); ++y) {
+		auto black_row = reinterpret_cast<uint32_t const*>(bmp.data() + size_t(y) * size_t(bmp.stride()));
+		auto white_row = reinterpret_cast<uint32_t const*>(white.data() + size_t(y) * size_t(white.stride()));
+		for(int32_t x = 0; x < bmp.width(); ++x) {
+			uint32_t alpha = black_row[x] >> 24;
+			if(alpha == 0)
+				continue;
+			uint32_t difference = 0; // premultiplied, like the pixels
+			for(uint32_t shift = 0; shift < 24; shift += 8) {
+				auto b = (black_row[x] >> shift) & 0xFF;
+				auto w = (white_row[x] >> shift) & 0xFF;
+				if(w > b)
+					difference = std::max(difference, w - b);
+			}
+			tint[size_t(y) * size_t(bmp.width()) + size_t(x)] = char(std::min(uint32_t(255), (difference * 255 + alpha / 2) / alpha));
+		}
+	}
+
+	bmp.convertToRGBA();
+	return true;
+}
+
+/*
+distance fields are made from the outlines lunasvg parses the icon into, with this many texels along the larger side
+each texel holds three distances, each to the nearest edge of one of three colors (the multi-channel fields from
+Chlumsky's "Shape Decomposition for Multi-channel Distance Fields"); the two edges meeting at a corner never share
+two colors, so the median of the three keeps the corner sharp however far the field is stretched
+their values run from 0 to 1 over twice the spread (in texels), with 0.5 on the outline and higher inside
+*/
+constexpr int32_t distance_field_size = 32;
+constexpr float distance_field_spread = 4.0f;
+
+namespace msdf {
+
+enum colors : uint8_t {
+	red = 1, green = 2, blue = 4, yellow = red | green, magenta = red | blue, cyan = green | blue, white = red | green | blue
+};
+
+struct segment {
+	float ax = 0.0f;
+	float ay = 0.0f;
+	float bx = 0.0f;
+	float by = 0.0f;
+	uint8_t colors = white;
+	// whether the outline turns sharply there; only there is the segment extended to give pseudo-distances, so that
+	// the straight pieces a curve is flattened into still come out as one smooth edge
+	bool corner_at_start = false;
+	bool corner_at_end = false;
+	bool starts_command = false;
+};
+
+struct contour {
+	std::vector<segment> segments;
+	bool closed = false;
+	bool reversed = false; // turned around so that the inside is on its left; the winding it fills with is not
+};
+
+struct shape {
+	std::vector<contour> contours;
+	std::vector<contour> hidden_contours; // filled with, but not part of the outline
+	bool filled = false;
+	bool even_odd = false;
+	float half_width = 0.0f; // of the stroke, if this is one
+	// half the width of a stroke along the fill's own outline, when all of its subpaths are closed: the two together
+	// are then the fill grown by that much, which keeps the fill's corners
+	float grown_by = 0.0f;
+	bool round_caps = false;
+	bool square_caps = false;
+};
+
+static float median(float a, float b, float c) {
+	return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+// cubics are cut into pieces no more than a fiftieth of a texel from the curve
+static void flatten_cubic(std::vector<std::pair<float, float>>& points, float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3) {
+	float ddx = std::max(std::abs(x0 - 2.0f * x1 + x2), std::abs(x1 - 2.0f * x2 + x3));
+	float ddy = std::max(std::abs(y0 - 2.0f * y1 + y2), std::abs(y1 - 2.0f * y2 + y3));
+	auto pieces = std::clamp(int32_t(std::ceil(std::sqrt(0.75f * std::sqrt(ddx * ddx + ddy * ddy) / 0.02f))), 1, 64);
+	for(int32_t i = 1; i <= pieces; ++i) {
+		float t = float(i) / float(pieces);
+		float u = 1.0f - t;
+		points.emplace_back(u * u * u * x0 + 3.0f * u * u * t * x1 + 3.0f * u * t * t * x2 + t * t * t * x3,
+			u * u * u * y0 + 3.0f * u * u * t * y1 + 3.0f * u * t * t * y2 + t * t * t * y3);
+	}
+}
+
+static void add_contour(shape& s, std::vector<std::pair<float, float>> const& points, std::vector<bool> const& command_starts, bool closed) {
+	contour c;
+	c.closed = closed;
+	for(size_t i = 0; i + 1 < points.size(); ++i) {
+		if(points[i] == points[i + 1])
+			continue;
+		c.segments.push_back(segment{ points[i].first, points[i].second, points[i + 1].first, points[i + 1].second });
+		c.segments.back().starts_command = command_starts[i];
+	}
+	if(closed && points.size() > 1 && points.back() != points.front()) {
+		c.segments.push_back(segment{ points.back().first, points.back().second, points.front().first, points.front().second });
+		c.segments.back().starts_command = true;
+	}
+	if(c.segments.empty()) {
+		// a stroke with round caps still draws a dot for a subpath that goes nowhere
+		if(s.half_width > 0.0f && s.round_caps && points.size() > 1)
+			c.segments.push_back(segment{ points[0].first, points[0].second, points[0].first, points[0].second });
+		else
+			return;
+	}
+	s.contours.push_back(std::move(c));
+}
+
+// the outline's points are in the document's coordinates, which are scaled by sx and sy into texels
+static void add_outline(shape& s, lunasvg::ShapeOutline const& outline, float sx, float sy) {
+	std::vector<std::pair<float, float>> points;
+	std::vector<bool> command_starts;
+	size_t p = 0;
+	auto next_point = [&]() {
+		auto point = std::make_pair(outline.points[p] * sx, outline.points[p + 1] * sy);
+		p += 2;
+		return point;
+	};
+	// a subpath is filled as if it were closed, but only stroked that way if it is
+	bool close_all = s.half_width == 0.0f;
+	bool open = false; // whether points holds a subpath not yet added
+	for(auto command : outline.commands) {
+		switch(command) {
+		case lunasvg::OutlineCommand::MoveTo:
+			if(open)
+				add_contour(s, points, command_starts, close_all);
+			points.clear();
+			command_starts.clear();
+			points.push_back(next_point());
+			command_starts.push_back(true);
+			open = true;
+			break;
+		case lunasvg::OutlineCommand::LineTo:
+			if(points.empty())
+				points.emplace_back(0.0f, 0.0f);
+			points.push_back(next_point());
+			command_starts.resize(points.size(), true);
+			open = true;
+			break;
+		case lunasvg::OutlineCommand::CubicTo:
+		{
+			if(points.empty())
+				points.emplace_back(0.0f, 0.0f);
+			auto start = points.back();
+			auto c1 = next_point();
+			auto c2 = next_point();
+			auto end = next_point();
+			auto first = points.size();
+			flatten_cubic(points, start.first, start.second, c1.first, c1.second, c2.first, c2.second, end.first, end.second);
+			command_starts.resize(points.size(), false);
+			command_starts[first] = true;
+			open = true;
+			break;
+		}
+		case lunasvg::OutlineCommand::Close:
+			add_contour(s, points, command_starts, true);
+			// anything after a close without a move starts from where the subpath did
+			points.resize(std::min(points.size(), size_t(1)));
+			command_starts.resize(points.size());
+			open = false;
+			break;
+		}
+	}
+	if(open)
+		add_contour(s, points, command_starts, close_all);
+}
+
+// whether the point is inside the fill, by its winding rule
+static bool inside(shape const& s, float x, float y) {
+	int32_t winding = 0;
+	auto wind = [&](std::vector<contour> const& contours) {
+		for(auto& c : contours) {
+			int32_t direction = c.reversed ? -1 : 1;
+			for(auto& e : c.segments) {
+				if((e.ay <= y) == (e.by <= y))
+					continue;
+				float cross_x = e.ax + (y - e.ay) * (e.bx - e.ax) / (e.by - e.ay);
+				if(cross_x > x)
+					winding += (e.by > e.ay ? 1 : -1) * direction;
+			}
+		}
+	};
+	wind(s.contours);
+	wind(s.hidden_contours);
+	return s.even_odd ? (winding & 1) != 0 : winding != 0;
+}
+
+// finds the corners, turns each contour so that the inside is on its left, and colors the edges between corners
+static void prepare_fill(shape& s) {
+	float const corner_threshold = std::sin(3.0f); // from msdfgen: about eight degrees
+	for(auto& c : s.contours) {
+		auto n = c.segments.size();
+		for(size_t i = 0; i < n; ++i) {
+			auto& e = c.segments[i];
+			if(!e.starts_command)
+				continue;
+			auto& before = c.segments[(i + n - 1) % n];
+			float ax = before.bx - before.ax;
+			float ay = before.by - before.ay;
+			float bx = e.bx - e.ax;
+			float by = e.by - e.ay;
+			float al = std::sqrt(ax * ax + ay * ay);
+			float bl = std::sqrt(bx * bx + by * by);
+			float dot = (ax * bx + ay * by) / (al * bl);
+			float cross = (ax * by - ay * bx) / (al * bl);
+			if(dot <= 0.0f || std::abs(cross) > corner_threshold) {
+				e.corner_at_start = true;
+				before.corner_at_end = true;
+			}
+		}
+	}
+
+	// which side is inside is decided against the whole shape, beside the middle of each segment, by a vote of the
+	// segments that have the inside on one side only; a contour with none of those (one that encloses nothing, or only
+	// runs through the inside of others) is not part of the outline at all
+	std::vector<int32_t> votes(s.contours.size(), 0);
+	std::vector<bool> separates(s.contours.size(), false);
+	for(size_t k = 0; k < s.contours.size(); ++k) {
+		for(auto& e : s.contours[k].segments) {
+			float dx = e.bx - e.ax;
+			float dy = e.by - e.ay;
+			float length = std::sqrt(dx * dx + dy * dy);
+			float nx = -dy / length * 0.01f;
+			float ny = dx / length * 0.01f;
+			float mx = (e.ax + e.bx) * 0.5f;
+			float my = (e.ay + e.by) * 0.5f;
+			bool left = inside(s, mx + nx, my + ny);
+			bool right = inside(s, mx - nx, my - ny);
+			if(left != right) {
+				separates[k] = true;
+				votes[k] += left ? 1 : -1;
+			}
+		}
+	}
+	for(size_t k = 0; k < s.contours.size(); ++k) {
+		if(votes[k] >= 0)
+			continue;
+		auto& c = s.contours[k];
+		std::reverse(c.segments.begin(), c.segments.end());
+		for(auto& e : c.segments) {
+			std::swap(e.ax, e.bx);
+			std::swap(e.ay, e.by);
+			std::swap(e.corner_at_start, e.corner_at_end);
+		}
+		c.reversed = true;
+	}
+	// the winding is still needed for which texels are covered, so those contours are only kept apart
+	for(size_t k = s.contours.size(); k-- > 0; ) {
+		if(!separates[k]) {
+			s.hidden_contours.push_back(std::move(s.contours[k]));
+			s.contours.erase(s.contours.begin() + k);
+		}
+	}
+
+	// the coloring is msdfgen's simple one: the color changes at each corner, never back to the one the contour
+	// started with at its last corner, and a contour with a single corner is split into three
+	auto switch_color = [](uint8_t& color, uint8_t banned) {
+		uint8_t combined = color & banned;
+		if(combined == red || combined == green || combined == blue) {
+			color = uint8_t(combined ^ white);
+			return;
+		}
+		if(color == 0 || color == white) {
+			color = cyan;
+			return;
+		}
+		auto shifted = uint8_t(color << 1);
+		color = uint8_t((shifted | shifted >> 3) & white);
+	};
+	for(auto& c : s.contours) {
+		std::vector<size_t> corners;
+		for(size_t i = 0; i < c.segments.size(); ++i) {
+			if(c.segments[i].corner_at_start)
+				corners.push_back(i);
+		}
+		auto n = c.segments.size();
+		if(corners.empty()) {
+			for(auto& e : c.segments)
+				e.colors = white;
+		} else if(corners.size() == 1) {
+			uint8_t colors[3] = { white, white, white };
+			switch_color(colors[0], 0);
+			colors[2] = colors[0];
+			switch_color(colors[2], 0);
+			if(n >= 3) {
+				for(size_t i = 0; i < n; ++i) {
+					auto third = int32_t(3.0f + 2.875f * float(i) / float(n - 1) - 1.4375f + 0.5f) - 2;
+					c.segments[(corners[0] + i) % n].colors = colors[std::clamp(third, 0, 2)];
+				}
+			} else {
+				for(auto& e : c.segments)
+					e.colors = white;
+			}
+		} else {
+			size_t spline = 0;
+			auto start = corners[0];
+			uint8_t color = white;
+			switch_color(color, 0);
+			auto initial = color;
+			for(size_t i = 0; i < n; ++i) {
+				auto index = (start + i) % n;
+				if(spline + 1 < corners.size() && corners[spline + 1] == index) {
+					++spline;
+					switch_color(color, spline == corners.size() - 1 ? initial : 0);
+				}
+				c.segments[index].colors = color;
+			}
+		}
+	}
+}
+
+// signed pseudo-distances, in texels, from the point to the fill's edges of each color, positive inside; returns the
+// distance to the nearest edge of any color
+static float fill_distances(shape const& s, float x, float y, float* distances) {
+	struct nearest {
+		float distance_squared = 1e30f;
+		segment const* edge = nullptr;
+		float t = 0.0f;
+		float distance = 0.0f;
+	} best[3];
+	// of two edges the same distance away (at the corner they share), the one the point is more squarely beside
+	auto orthogonality = [x, y](segment const& e, float t) {
+		float dx = e.bx - e.ax;
+		float dy = e.by - e.ay;
+		float clamped = std::clamp(t, 0.0f, 1.0f);
+		float qx = x - (clamped == 1.0f ? e.bx : e.ax + clamped * dx);
+		float qy = y - (clamped == 1.0f ? e.by : e.ay + clamped * dy);
+		float distance = std::sqrt(qx * qx + qy * qy);
+		if(clamped == t || distance == 0.0f)
+			return 0.0f;
+		return std::abs((qx * dx + qy * dy) / (distance * std::sqrt(dx * dx + dy * dy)));
+	};
+	for(auto& c : s.contours) {
+		for(auto& e : c.segments) {
+			float dx = e.bx - e.ax;
+			float dy = e.by - e.ay;
+			float t = ((x - e.ax) * dx + (y - e.ay) * dy) / (dx * dx + dy * dy);
+			float clamped = std::clamp(t, 0.0f, 1.0f);
+			// the end itself, so that two edges sharing it come out exactly the same distance away
+			float qx = x - (clamped == 1.0f ? e.bx : e.ax + clamped * dx);
+			float qy = y - (clamped == 1.0f ? e.by : e.ay + clamped * dy);
+			float distance_squared = qx * qx + qy * qy;
+			for(int32_t channel = 0; channel < 3; ++channel) {
+				if((e.colors & (1 << channel)) == 0)
+					continue;
+				auto& b = best[channel];
+				if(distance_squared < b.distance_squared || (distance_squared == b.distance_squared && orthogonality(e, t) < orthogonality(*b.edge, b.t))) {
+					b.distance_squared = distance_squared;
+					b.edge = &e;
+					b.t = t;
+				}
+			}
+		}
+	}
+	float nearest_edge = 1e20f;
+	for(int32_t channel = 0; channel < 3; ++channel) {
+		auto& b = best[channel];
+		if(!b.edge) {
+			distances[channel] = -1e20f;
+			continue;
+		}
+		b.distance = std::sqrt(b.distance_squared);
+		nearest_edge = std::min(nearest_edge, b.distance);
+		auto& e = *b.edge;
+		float dx = e.bx - e.ax;
+		float dy = e.by - e.ay;
+		float length = std::sqrt(dx * dx + dy * dy);
+		float side = (dx * (y - e.ay) - dy * (x - e.ax)) / length;
+		float distance = side >= 0.0f ? b.distance : -b.distance;
+		// past a corner, the distance to the edge carried on in a straight line
+		if((b.t < 0.0f && e.corner_at_start) || (b.t > 1.0f && e.corner_at_end)) {
+			if(std::abs(side) <= b.distance)
+				distance = side;
+		}
+		distances[channel] = distance + s.grown_by;
+	}
+	return nearest_edge;
+}
+
+// the signed distance, in texels, from the point to the edge of the stroke, positive inside
+static float stroke_distance(shape const& s, float x, float y) {
+	float result = -1e20f;
+	for(auto& c : s.contours) {
+		auto n = c.segments.size();
+		for(size_t i = 0; i < n; ++i) {
+			auto& e = c.segments[i];
+			float dx = e.bx - e.ax;
+			float dy = e.by - e.ay;
+			float length_squared = dx * dx + dy * dy;
+			float t = length_squared > 0.0f ? std::clamp(((x - e.ax) * dx + (y - e.ay) * dy) / length_squared, 0.0f, 1.0f) : 0.0f;
+			float qx = x - (e.ax + t * dx);
+			float qy = y - (e.ay + t * dy);
+			float d = s.half_width - std::sqrt(qx * qx + qy * qy);
+			// butt and square caps cut the round end off square, at the end or half the width past it
+			if(!c.closed && !s.round_caps && length_squared > 0.0f) {
+				float length = std::sqrt(length_squared);
+				float extension = s.square_caps ? s.half_width : 0.0f;
+				if(i == 0)
+					d = std::min(d, ((x - e.ax) * dx + (y - e.ay) * dy) / length + extension);
+				if(i + 1 == n)
+					d = std::min(d, ((e.bx - x) * dx + (e.by - y) * dy) / length + extension);
+			}
+			result = std::max(result, d);
+		}
+	}
+	return result;
+}
+
+// msdfgen's clash correction: a texel whose channels differ from a neighbor's so much that stretching the field
+// between the two would put a false edge there is flattened to its median
+static void correct_clashes(std::vector<float>& values, int32_t width, int32_t height) {
+	float const threshold = 1.001f / (2.0f * distance_field_spread);
+	auto clashes = [threshold](float const* a, float const* b) {
+		float a0 = a[0], a1 = a[1], a2 = a[2];
+		float b0 = b[0], b1 = b[1], b2 = b[2];
+		// sorted so that the pairs go from the largest difference to the smallest
+		if(std::abs(b0 - a0) < std::abs(b1 - a1)) {
+			std::swap(a0, a1);
+			std::swap(b0, b1);
+		}
+		if(std::abs(b1 - a1) < std::abs(b2 - a2)) {
+			std::swap(a1, a2);
+			std::swap(b1, b2);
+			if(std::abs(b0 - a0) < std::abs(b1 - a1)) {
+				std::swap(a0, a1);
+				std::swap(b0, b1);
+			}
+		}
+		// only the one of the pair farther from the edge is flagged, and never against one already flattened
+		return std::abs(b1 - a1) >= threshold && !(b0 == b1 && b0 == b2) && std::abs(a2 - 0.5f) >= std::abs(b2 - 0.5f);
+	};
+	std::vector<size_t> flagged;
+	for(int32_t y = 0; y < height; ++y) {
+		for(int32_t x = 0; x < width; ++x) {
+			auto i = size_t(y) * width + x;
+			auto a = values.data() + i * 3;
+			if((x > 0 && clashes(a, a - 3))
+				|| (x + 1 < width && clashes(a, a + 3))
+				|| (y > 0 && clashes(a, a - size_t(width) * 3))
+				|| (y + 1 < height && clashes(a, a + size_t(width) * 3))) {
+				flagged.push_back(i);
+			}
+		}
+	}
+	for(auto i : flagged) {
+		auto a = values.data() + i * 3;
+		a[0] = a[1] = a[2] = median(a[0], a[1], a[2]);
+	}
+}
+
+}
+
+// whether every shape is drawn, opaquely, in the primary color: black in the outlines taken with it black, and white
+// in the ones taken with it white
+static bool drawn_in_primary_color(std::vector<lunasvg::ShapeOutline> const& black, std::vector<lunasvg::ShapeOutline> const& white) {
+	if(black.size() != white.size())
+		return false;
+	for(size_t i = 0; i < black.size(); ++i) {
+		if(black[i].fill != 0 && (black[i].fill != 0xFF000000 || white[i].fill != 0xFFFFFFFF))
+			return false;
+		if(black[i].stroke != 0 && (black[i].stroke != 0xFF000000 || white[i].stroke != 0xFFFFFFFF))
+			return false;
+	}
+	return true;
+}
+
+// returns false if the data could not be parsed, and leaves the field empty if the icon has parts in other colors, or
+// draws something other than filled and stroked outlines
+static bool make_distance_field(std::vector<char> const& svg_data, image_loader const& loader, std::vector<char>& field, int32_t& width, int32_t& height) {
+	char cssstylesheet[] = ".primarycolor { fill: #000000; stroke: #000000; } ";
+
+	auto doc = lunasvg::Document::loadFromData(svg_data.data(), svg_data.size(), loader);
+	if(!doc)
+		return false;
+
+	field.clear();
+	doc->applyStyleSheet(cssstylesheet);
+	std::vector<lunasvg::ShapeOutline> black;
+	if(!doc->outlines(black))
+		return true;
+	set_primary_color(cssstylesheet, 1.0f, 1.0f, 1.0f);
+	doc->applyStyleSheet(cssstylesheet); // same selector, so it replaces the black
+	std::vector<lunasvg::ShapeOutline> white;
+	if(!doc->outlines(white) || !drawn_in_primary_color(black, white))
+		return true;
+
+	float larger = std::max(1.0f, std::max(doc->width(), doc->height()));
+	width = std::max(1, int32_t(std::round(float(distance_field_size) * doc->width() / larger)));
+	height = std::max(1, int32_t(std::round(float(distance_field_size) * doc->height() / larger)));
+	float sx = float(width) / std::max(1.0f, doc->width());
+	float sy = float(height) / std::max(1.0f, doc->height());
+
+	std::vector<msdf::shape> shapes;
+	for(auto& outline : black) {
+		msdf::shape stroke;
+		if(outline.stroke != 0 && outline.strokeWidth > 0.0f) {
+			stroke.half_width = outline.strokeWidth * 0.5f * (sx + sy) * 0.5f;
+			stroke.round_caps = outline.roundCaps;
+			stroke.square_caps = outline.squareCaps;
+			msdf::add_outline(stroke, outline, sx, sy);
+		}
+		if(outline.fill != 0) {
+			msdf::shape s;
+			s.filled = true;
+			s.even_odd = outline.evenOdd;
+			msdf::add_outline(s, outline, sx, sy);
+			msdf::prepare_fill(s);
+			bool all_closed = std::all_of(stroke.contours.begin(), stroke.contours.end(), [](msdf::contour const& c) { return c.closed; });
+			if(!stroke.contours.empty() && all_closed && s.hidden_contours.empty() && !s.contours.empty()) {
+				s.grown_by = stroke.half_width;
+				stroke.contours.clear();
+			}
+			if(!s.contours.empty())
+				shapes.push_back(std::move(s));
+		}
+		if(!stroke.contours.empty())
+			shapes.push_back(std::move(stroke));
+	}
+
+	// the shapes are joined by taking the distances of the one the texel is farthest inside (or nearest outside); the
+	// channels of different shapes are never mixed, as their medians would no longer mean anything
+	std::vector<float> values(size_t(width) * size_t(height) * 3);
+	for(int32_t y = 0; y < height; ++y) {
+		for(int32_t x = 0; x < width; ++x) {
+			float px = float(x) + 0.5f;
+			float py = float(y) + 0.5f;
+			float combined[3] = { -1e20f, -1e20f, -1e20f };
+			bool covered = false;
+			for(auto& s : shapes) {
+				float distances[3];
+				if(s.filled) {
+					auto nearest = msdf::fill_distances(s, px, py, distances);
+					covered = covered || nearest < s.grown_by || msdf::inside(s, px, py);
+				} else {
+					distances[0] = distances[1] = distances[2] = msdf::stroke_distance(s, px, py);
+					covered = covered || distances[0] > 0.0f;
+				}
+				if(msdf::median(distances[0], distances[1], distances[2]) > msdf::median(combined[0], combined[1], combined[2]))
+					std::copy(distances, distances + 3, combined);
+			}
+			// where overlapping shapes leave the median on the wrong side, the texel's true side is what counts
+			if((msdf::median(combined[0], combined[1], combined[2]) > 0.0f) != covered) {
+				for(auto& c : combined)
+					c = -c;
+			}
+			auto v = values.data() + (size_t(y) * width + x) * 3;
+			for(int32_t channel = 0; channel < 3; ++channel)
+				v[channel] = std::clamp(0.5f + combined[channel] / (2.0f * distance_field_spread), 0.0f, 1.0f);
+		}
+	}
+	msdf::correct_clashes(values, width, height);
+
+	field.resize(values.size());
+	for(size_t i = 0; i < values.size(); ++i)
+		field[i] = char(uint8_t(values[i] * 255.0f + 0.5f));
+	return true;
+}
+
+void sample_distance_field(std::vector<char> const& field, int32_t width, int32_t height, int32_t size_x, int32_t size_y, std::vector<uint8_t>& coverage) {
+	coverage.assign(size_t(size_x) * size_t(size_y), 0);
+	if(field.empty() || size_x <= 0 || size_y <= 0)
+		return;
+
+	// linear filtering with the coordinates clamped to the edge, as the atlas's border around each field gives
+	auto texel = [&](int32_t x, int32_t y, int32_t channel) {
+		x = std::clamp(x, 0, width - 1);
+		y = std::clamp(y, 0, height - 1);
+		return float(uint8_t(field[(size_t(y) * width + x) * 3 + channel])) / 255.0f;
+	};
+	std::vector<float> values(coverage.size());
+	for(int32_t y = 0; y < size_y; ++y) {
+		float v = (float(y) + 0.5f) * float(height) / float(size_y) - 0.5f;
+		auto v0 = int32_t(std::floor(v));
+		float fy = v - float(v0);
+		for(int32_t x = 0; x < size_x; ++x) {
+			float u = (float(x) + 0.5f) * float(width) / float(size_x) - 0.5f;
+			auto u0 = int32_t(std::floor(u));
+			float fx = u - float(u0);
+			float channels[3];
+			for(int32_t channel = 0; channel < 3; ++channel) {
+				float top = texel(u0, v0, channel) * (1.0f - fx) + texel(u0 + 1, v0, channel) * fx;
+				float bottom = texel(u0, v0 + 1, channel) * (1.0f - fx) + texel(u0 + 1, v0 + 1, channel) * fx;
+				channels[channel] = top * (1.0f - fy) + bottom * fy;
+			}
+			values[size_t(y) * size_x + x] = msdf::median(channels[0], channels[1], channels[2]);
+		}
+	}
+
+	// fwidth, taken between neighboring pixels as the gpu takes it within each two by two block
+	for(int32_t y = 0; y < size_y; ++y) {
+		for(int32_t x = 0; x < size_x; ++x) {
+			auto i = size_t(y) * size_x + x;
+			auto nx = x + 1 < size_x ? i + 1 : i - (size_x > 1 ? 1 : 0);
+			auto ny = y + 1 < size_y ? i + size_x : i - (size_y > 1 ? size_t(size_x) : 0);
+			float w = std::max((std::abs(values[nx] - values[i]) + std::abs(values[ny] - values[i])) * 0.5f, 0.001f);
+			float t = std::clamp((values[i] - (0.5f - w)) / (2.0f * w), 0.0f, 1.0f);
+			coverage[i] = uint8_t(t * t * (3.0f - 2.0f * t) * 255.0f + 0.5f);
+		}
+	}
+}
+
+static lunasvg::Bitmap load_from_bank(std::string_view file_name) {
+	return common_file_bank::bank.get_image(file_name);
+}
+
+/*
+renders of changed files are made one at a time on a single background thread
+the thread is never stopped (it only ever waits for more work), and its state is never destroyed, so that it
+can be left running when the editor exits
+*/
+struct rerender_queue {
+	std::mutex lock;
+	std::condition_variable wake;
+	std::deque<std::function<void()>> jobs;
+	std::atomic<int32_t> pending = 0;
+	bool started = false;
+};
+static rerender_queue& rerenders() {
+	static rerender_queue* q = new rerender_queue();
+	return *q;
+}
+
+static void queue_rerender(std::function<void()>&& job) {
+	auto& q = rerenders();
+	++q.pending;
+	{
+		std::lock_guard<std::mutex> guard(q.lock);
+		q.jobs.push_back(std::move(job));
+		if(!q.started) {
+			q.started = true;
+			std::thread([&q]() {
+				while(true) {
+					std::function<void()> next;
+					{
+						std::unique_lock<std::mutex> guard(q.lock);
+						q.wake.wait(guard, [&]() { return !q.jobs.empty(); });
+						next = std::move(q.jobs.front());
+						q.jobs.pop_front();
+					}
+					next();
+					--q.pending;
+				}
+			}).detach();
+		}
+	}
+	q.wake.notify_one();
+}
+
+bool renders_pending() {
+	return rerenders().pending.load() != 0;
+}
+
+static void deliver_rerender(rerender_results& into, uint64_t key, uint32_t generation, bool rendered, lunasvg::Bitmap const& bmp, std::vector<char>&& tint = std::vector<char>{ }) {
+	rerender_result result;
+	result.key = key;
+	result.generation = generation;
+	if(rendered && bmp.valid()) {
+		result.width = bmp.width();
+		result.height = bmp.height();
+		result.pixels.assign((char const*)(bmp.data()), (char const*)(bmp.data()) + size_t(bmp.stride()) * size_t(bmp.height()));
+		result.tint = std::move(tint);
+	}
+	std::lock_guard<std::mutex> guard(into.lock);
+	into.finished.push_back(std::move(result));
+}
+
+static void replace_render(svg_instance& render, rerender_result const& f) {
+	render = svg_instance(f.pixels.data(), f.width, f.height);
+}
+static void replace_render(tinted_instance& render, rerender_result const& f) {
+	render.color = svg_instance(f.pixels.data(), f.width, f.height);
+	render.tint = svg_instance(f.tint.data(), f.width, f.height, true);
+}
+
+template<typename instance_t>
+static void collect_finished(std::unordered_map<uint64_t, instance_t>& renders, std::unordered_map<uint64_t, bool>& stale, rerender_results& rerendered, uint32_t generation) {
+	std::vector<rerender_result> finished;
+	{
+		std::lock_guard<std::mutex> guard(rerendered.lock);
+		finished.swap(rerendered.finished);
+	}
+	for(auto& f : finished) {
+		auto it = stale.find(f.key);
+		if(it == stale.end())
+			continue;
+		if(f.generation != generation) { // the file changed again while this was being made
+			it->second = false;
+			continue;
+		}
+		if(!f.pixels.empty()) // otherwise the old render stays until the file changes again
+			replace_render(renders[f.key], f);
+		stale.erase(it);
+	}
+}
+
+template<typename instance_t>
+static void mark_stale(std::unordered_map<uint64_t, instance_t> const& renders, std::unordered_map<uint64_t, bool>& stale) {
+	stale.clear();
+	for(auto& r : renders) {
+		stale.insert_or_assign(r.first, false);
+	}
+}
+
+void svg::release_renders() {
+	renders.clear();
+	stale.clear();
+}
+
+// whether lunasvg can read the data at all; the images it refers to are not loaded
+static bool parses(std::vector<char> const& svg_data) {
+	return lunasvg::Document::loadFromData(svg_data.data(), svg_data.size(), [](std::string_view) { return lunasvg::Bitmap{ }; }) != nullptr;
+}
+
+bool svg::replace_source(char const* data, size_t count) {
+	svg fresh(data, count, base_width, base_height);
+	auto filled_in = fresh.svg_data;
+	fill_in_sizes(filled_in, fresh.replacements, base_width, base_height, 1.0f, 1.0f, 1);
+	if(!parses(filled_in))
+		return false;
+	svg_data = std::move(fresh.svg_data);
+	replacements = std::move(fresh.replacements);
+	invalidate_renders();
+	return true;
+}
+void svg::invalidate_renders() {
+	++generation;
+	mark_stale(renders, stale);
+}
+void svg::collect_rerenders() {
+	collect_finished(renders, stale, *rerendered, generation);
+}
+
+uint32_t svg::get_render(float size_x, float size_y, int32_t grid_size, float scale, float r, float g, float b) {
+	uint64_t colorid = uint64_t(r * 255.0f) | (uint64_t(g * 255.0f) << uint64_t(8)) | (uint64_t(b * 255.0f) << uint64_t(16));
+	uint64_t idx = uint64_t(uint32_t(size_x * grid_size)) | (uint64_t(uint32_t(size_y * grid_size)) << uint64_t(20)) | (colorid << 40);
+
+	if(!stale.empty())
+		collect_rerenders();
+	if(auto it = renders.find(idx); it != renders.end()) {
+		if(auto st = stale.find(idx); st != stale.end() && !st->second) {
+			st->second = true;
+			queue_rerender([data = svg_data, reps = replacements, bw = base_width, bh = base_height, size_x, size_y, grid_size, scale, into = rerendered, idx, gen = generation]() mutable {
+				lunasvg::Bitmap bmp;
+				bool rendered = rasterize_svg(data, reps, bw, bh, size_x, size_y, grid_size, scale, 0.0f, 0.0f, 0.0f, load_from_bank, bmp);
+				deliver_rerender(*into, idx, gen, rendered, bmp);
+			});
+		}
+		return it->second.texture_handle;
+	}
+	return make_new_render(size_x, size_y, grid_size, scale);
+}
+uint32_t svg::try_get_render(float size_x, float size_y, int32_t grid_size, float r, float g, float b) {
+	uint64_t colorid = uint64_t(r * 255.0f) | (uint64_t(g * 255.0f) << uint64_t(8)) | (uint64_t(b * 255.0f) << uint64_t(16));
+	uint64_t idx = uint64_t(uint32_t(size_x * grid_size)) | (uint64_t(uint32_t(size_y * grid_size)) << uint64_t(20)) | (colorid << 40);
+
+	if(!stale.empty())
+		collect_rerenders();
+	if(auto it = renders.find(idx); it != renders.end()) {
+		return it->second.texture_handle;
+	}
+	return 0;
+}
+bool svg::render_pixels(float size_x, float size_y, int32_t grid_size, float scale, float r, float g, float b, lunasvg::Bitmap& bmp) {
+	return rasterize_svg(svg_data, replacements, base_width, base_height, size_x, size_y, grid_size, scale, r, g, b, load_from_bank, bmp);
+}
+uint32_t svg::make_new_render(float size_x, float size_y, int32_t grid_size, float scale, float r, float g, float b) {
+	if(svg_data.size() == 0)
+		return 0;
+
+	lunasvg::Bitmap bmp;
+	if(!render_pixels(size_x, size_y, grid_size, scale, r, g, b, bmp))
+		return 0;
 
 	svg_instance new_inst((char const*)(bmp.data()),
 		int32_t(size_x * scale * grid_size),
@@ -251,13 +1079,49 @@ simple_svg::simple_svg(char const* data, size_t count) : svg_data(data, data + c
 
 void simple_svg::release_renders() {
 	renders.clear();
+	stale.clear();
+	tinted_renders.clear();
+	tinted_stale.clear();
+	distance_field = distance_field_slot{ };
+	distance_field_state = distance_field_status::not_made;
+}
+
+bool simple_svg::replace_source(char const* data, size_t count) {
+	std::vector<char> fresh(data, data + count);
+	if(!parses(fresh))
+		return false;
+	svg_data = std::move(fresh);
+	invalidate_renders();
+	return true;
+}
+void simple_svg::invalidate_renders() {
+	++generation;
+	mark_stale(renders, stale);
+	mark_stale(tinted_renders, tinted_stale);
+	// cheap enough to make again the next time it is drawn
+	distance_field = distance_field_slot{ };
+	distance_field_state = distance_field_status::not_made;
+}
+void simple_svg::collect_rerenders() {
+	collect_finished(renders, stale, *rerendered, generation);
+	collect_finished(tinted_renders, tinted_stale, *tinted_rerendered, generation);
 }
 
 uint32_t simple_svg::get_render(int32_t size_x, int32_t size_y, float scale, float r, float g, float b) {
 	uint64_t colorid = uint64_t(r * 255.0f) | (uint64_t(g * 255.0f) << uint64_t(8)) | (uint64_t(b * 255.0f) << uint64_t(16));
 	uint64_t idx = uint64_t(uint32_t(size_x)) | (uint64_t(uint32_t(size_y)) << uint64_t(20)) | (colorid << 40);
 
+	if(!stale.empty())
+		collect_rerenders();
 	if(auto it = renders.find(idx); it != renders.end()) {
+		if(auto st = stale.find(idx); st != stale.end() && !st->second) {
+			st->second = true;
+			queue_rerender([data = svg_data, size_x, size_y, scale, r, g, b, into = rerendered, idx, gen = generation]() {
+				lunasvg::Bitmap bmp;
+				bool rendered = rasterize_simple_svg(data, size_x, size_y, scale, r, g, b, load_from_bank, bmp);
+				deliver_rerender(*into, idx, gen, rendered, bmp);
+			});
+		}
 		return it->second.texture_handle;
 	}
 	return make_new_render(size_x, size_y, scale, r, g, b);
@@ -266,6 +1130,8 @@ uint32_t simple_svg::try_get_render(int32_t size_x, int32_t size_y, float r, flo
 	uint64_t colorid = uint64_t(r * 255.0f) | (uint64_t(g * 255.0f) << uint64_t(8)) | (uint64_t(b * 255.0f) << uint64_t(16));
 	uint64_t idx = uint64_t(uint32_t(size_x)) | (uint64_t(uint32_t(size_y)) << uint64_t(20)) | (colorid << 40);
 
+	if(!stale.empty())
+		collect_rerenders();
 	if(auto it = renders.find(idx); it != renders.end()) {
 		return it->second.texture_handle;
 	}
@@ -275,36 +1141,9 @@ uint32_t simple_svg::make_new_render(int32_t size_x, int32_t size_y, float scale
 	if(svg_data.size() == 0)
 		return 0;
 
-	char cssstylesheet[] = ".primarycolor { fill: #000000; stroke: #000000; } ";
-	auto const clroffset = strlen(".primarycolor { fill: #");
-	auto const clroffset2 = strlen(".primarycolor { fill: #000000; stroke: #");
-	auto tohexdigit = [](uint32_t v) {
-		char table[] = "0123456789abcdef";
-		return table[v & 0x0F];
-	};
-	auto rv = uint32_t(r * 255.0f);
-	cssstylesheet[clroffset] = cssstylesheet[clroffset2] = tohexdigit(rv >> 4);
-	cssstylesheet[clroffset + 1] = cssstylesheet[clroffset2 + 1] = tohexdigit(rv);
-	auto gv = uint32_t(g * 255.0f);
-	cssstylesheet[clroffset + 2] = cssstylesheet[clroffset2 + 2] = tohexdigit(gv >> 4);
-	cssstylesheet[clroffset + 3] = cssstylesheet[clroffset2 + 3] = tohexdigit(gv);
-	auto bv = uint32_t(b * 255.0f);
-	cssstylesheet[clroffset + 4] = cssstylesheet[clroffset2 + 4] = tohexdigit(bv >> 4);
-	cssstylesheet[clroffset + 5] = cssstylesheet[clroffset2 + 5] = tohexdigit(bv);
-
-	auto doc = lunasvg::Document::loadFromData(svg_data.data(), svg_data.size(), [](std::string_view file_name) {
-		return common_file_bank::bank.get_file_data(file_name);
-	});
-
-	if(!doc) std::abort(); // TODO: error message
-	doc->applyStyleSheet(cssstylesheet);
-
-	lunasvg::Bitmap bmp(
-		int32_t(size_x * scale),
-		int32_t(size_y * scale));
-
-	doc->render(bmp, lunasvg::Matrix{ }.scale(scale * size_x / float(doc->width()), scale * size_y / float(doc->height())));
-	bmp.convertToRGBA();
+	lunasvg::Bitmap bmp;
+	if(!render_pixels(size_x, size_y, scale, r, g, b, bmp))
+		return 0;
 
 	svg_instance new_inst((char const*)(bmp.data()),
 		int32_t(size_x * scale),
@@ -319,18 +1158,245 @@ uint32_t simple_svg::make_new_render(int32_t size_x, int32_t size_y, float scale
 	return h;
 }
 
+tinted_handles simple_svg::get_tinted_render(int32_t size_x, int32_t size_y, float scale) {
+	uint64_t idx = uint64_t(uint32_t(size_x)) | (uint64_t(uint32_t(size_y)) << uint64_t(20));
+
+	if(!tinted_stale.empty())
+		collect_rerenders();
+	if(auto it = tinted_renders.find(idx); it != tinted_renders.end()) {
+		if(auto st = tinted_stale.find(idx); st != tinted_stale.end() && !st->second) {
+			st->second = true;
+			queue_rerender([data = svg_data, size_x, size_y, scale, into = tinted_rerendered, idx, gen = generation]() {
+				lunasvg::Bitmap bmp;
+				std::vector<char> tint;
+				bool rendered = rasterize_tinted_svg(data, size_x, size_y, scale, load_from_bank, bmp, tint);
+				deliver_rerender(*into, idx, gen, rendered, bmp, std::move(tint));
+			});
+		}
+		return tinted_handles{ it->second.color.texture_handle, it->second.tint.texture_handle };
+	}
+	return make_new_tinted_render(size_x, size_y, scale);
+}
+tinted_handles simple_svg::make_new_tinted_render(int32_t size_x, int32_t size_y, float scale) {
+	if(svg_data.size() == 0)
+		return tinted_handles{ };
+
+	lunasvg::Bitmap bmp;
+	std::vector<char> tint;
+	if(!rasterize_tinted_svg(svg_data, size_x, size_y, scale, load_from_bank, bmp, tint))
+		return tinted_handles{ };
+
+	tinted_instance new_inst;
+	new_inst.color = svg_instance((char const*)(bmp.data()), bmp.width(), bmp.height());
+	new_inst.tint = svg_instance(tint.data(), bmp.width(), bmp.height(), true);
+	tinted_handles h{ new_inst.color.texture_handle, new_inst.tint.texture_handle };
+
+	uint64_t idx = uint64_t(uint32_t(size_x)) | (uint64_t(uint32_t(size_y)) << uint64_t(20));
+	tinted_renders[idx] = std::move(new_inst);
+
+	return h;
+}
+
+bool simple_svg::render_pixels(int32_t size_x, int32_t size_y, float scale, float r, float g, float b, lunasvg::Bitmap& bmp) {
+	return rasterize_simple_svg(svg_data, size_x, size_y, scale, r, g, b, load_from_bank, bmp);
+}
+bool simple_svg::distance_field_values(std::vector<char>& field, int32_t& width, int32_t& height) {
+	return make_distance_field(svg_data, load_from_bank, field, width, height);
+}
+
+distance_field_slot simple_svg::get_distance_field() {
+	auto& atlas = common_distance_field_atlas::atlas;
+	if(distance_field_state == distance_field_status::made && !atlas.holds(distance_field))
+		distance_field_state = distance_field_status::not_made; // the atlas has started over since
+	if(distance_field_state == distance_field_status::not_made) {
+		if(svg_data.size() == 0)
+			return distance_field_slot{ };
+
+		std::vector<char> field;
+		int32_t width = 0;
+		int32_t height = 0;
+		// one that cannot be parsed is left to the other renders, as one in several colors is
+		if(!distance_field_values(field, width, height) || field.empty()) {
+			distance_field_state = distance_field_status::unsuitable;
+		} else {
+			distance_field = atlas.add(field, width, height);
+			distance_field_state = distance_field_status::made;
+		}
+	}
+	return distance_field;
+}
+
+bool distance_field_atlas::place(int32_t width, int32_t height, distance_field_slot& slot) {
+	if(size == 0)
+		size = first_size;
+	auto bordered_width = width + 2;
+	auto bordered_height = height + 2;
+	if(row_x + bordered_width > size) {
+		row_y += row_height;
+		row_x = 0;
+		row_height = 0;
+	}
+	if(bordered_width > size || row_y + bordered_height > size)
+		return false;
+
+	slot.texture_handle = texture_handle;
+	slot.generation = generation;
+	slot.x = float(row_x + 1) / float(size);
+	slot.y = float(row_y + 1) / float(size);
+	slot.width = float(width) / float(size);
+	slot.height = float(height) / float(size);
+	row_x += bordered_width;
+	row_height = std::max(row_height, bordered_height);
+	return true;
+}
+
+distance_field_slot distance_field_atlas::add(std::vector<char> const& field, int32_t width, int32_t height) {
+	distance_field_slot slot;
+	if(texture_handle == 0 || !place(width, height, slot)) {
+		auto new_size = texture_handle == 0 ? first_size : std::min(size * 2, max_size);
+		if(texture_handle == 0 || new_size != size) {
+			if(texture_handle != 0)
+				glDeleteTextures(1, &texture_handle);
+			glGenTextures(1, &texture_handle);
+			if(texture_handle == 0)
+				return distance_field_slot{ };
+			glBindTexture(GL_TEXTURE_2D, texture_handle);
+			glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGB8, new_size, new_size);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glBindTexture(GL_TEXTURE_2D, 0);
+		}
+		size = new_size;
+		++generation;
+		row_x = 0;
+		row_y = 0;
+		row_height = 0;
+		if(!place(width, height, slot))
+			return distance_field_slot{ };
+	}
+
+	std::vector<char> bordered(size_t(width + 2) * size_t(height + 2) * 3);
+	for(int32_t y = 0; y < height + 2; ++y) {
+		auto from_y = std::clamp(y - 1, 0, height - 1);
+		for(int32_t x = 0; x < width + 2; ++x) {
+			auto from_x = std::clamp(x - 1, 0, width - 1);
+			std::memcpy(bordered.data() + (size_t(y) * (width + 2) + x) * 3, field.data() + (size_t(from_y) * width + from_x) * 3, 3);
+		}
+	}
+	glBindTexture(GL_TEXTURE_2D, texture_handle);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, int32_t(slot.x * float(size)) - 1, int32_t(slot.y * float(size)) - 1, width + 2, height + 2, GL_RGB, GL_UNSIGNED_BYTE, bordered.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return slot;
+}
+
+distance_field_atlas common_distance_field_atlas::atlas{ };
+
 file_bank common_file_bank::bank{ };
 
-std::pair<void const*, int> file_bank::get_file_data(std::string_view file_name) {
-	if(auto it = file_contents.find(file_name); it != file_contents.end()) {
-		return std::pair<void const*, int>{(void const*)(it->second.data()), int(it->second.size()) };
-	} else {
-		fs::file data{ root_directory + fs::utf8_to_native(file_name) };
-		std::vector<char> hold_data(data.content().data, data.content().data + data.content().file_size);
-		std::pair<void const*, int> result{ (void const*)(hold_data.data()), int(hold_data.size()) };
-		file_contents[file_name] = std::move(hold_data);
-		return result;
+static uint64_t hash_contents(char const* data, size_t size) {
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for(size_t i = 0; i < size; ++i) {
+		hash ^= uint64_t(uint8_t(data[i]));
+		hash *= 0x100000001b3ull;
+	}
+	return hash ^ uint64_t(size);
+}
+
+// with the lock held
+static void evict_images(file_bank& bank) {
+	// the image that was just used is the most recent one, so it always stays
+	while(bank.image_bytes > bank.byte_budget && bank.images.size() > 1) {
+		auto oldest = bank.images.begin();
+		for(auto it = bank.images.begin(); it != bank.images.end(); ++it) {
+			if(it->second.last_used < oldest->second.last_used)
+				oldest = it;
+		}
+		bank.image_bytes -= oldest->second.bytes;
+		bank.images.erase(oldest); // names still pointing at it just read the file again
+	}
+}
+
+std::wstring file_bank::get_root_directory() {
+	std::lock_guard<std::mutex> guard(lock);
+	return root_directory;
+}
+void file_bank::set_root_directory(std::wstring const& directory) {
+	std::lock_guard<std::mutex> guard(lock);
+	root_directory = directory;
+	names.clear();
+}
+
+lunasvg::Bitmap file_bank::get_image(std::string_view file_name) {
+	std::string key{ file_name };
+	std::wstring root;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if(auto n = names.find(key); n != names.end()) {
+			if(auto it = images.find(n->second); it != images.end()) {
+				it->second.last_used = ++use_count;
+				return it->second.bitmap;
+			}
+		}
+		root = root_directory;
+	}
+
+	// reading and decoding happen without the lock, so that the other thread is not held up by them
+	fs::file data{ root + fs::utf8_to_native(file_name) };
+	auto content = data.content();
+	if(!content.data)
+		return lunasvg::Bitmap{ };
+	auto hash = hash_contents(content.data, content.file_size);
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		names.insert_or_assign(key, hash);
+		if(auto it = images.find(hash); it != images.end()) { // the same contents under another name
+			it->second.last_used = ++use_count;
+			return it->second.bitmap;
+		}
+	}
+
+	lunasvg::Bitmap decoded{ plutovg_surface_load_from_image_data(content.data, int(content.file_size)) };
+
+	std::lock_guard<std::mutex> guard(lock);
+	auto [it, added] = images.try_emplace(hash);
+	if(added) {
+		it->second.bitmap = decoded;
+		it->second.bytes = decoded.isNull() ? 0 : size_t(decoded.stride()) * size_t(decoded.height());
+		image_bytes += it->second.bytes;
+	}
+	it->second.last_used = ++use_count;
+	auto result = it->second.bitmap;
+	evict_images(*this);
+	return result;
+}
+std::vector<std::string> file_bank::loaded_names() {
+	std::lock_guard<std::mutex> guard(lock);
+	std::vector<std::string> result;
+	for(auto& n : names) {
+		result.push_back(n.first);
+	}
+	return result;
+}
+bool file_bank::forget(std::string_view file_name) {
+	std::lock_guard<std::mutex> guard(lock);
+	auto n = names.find(std::string{ file_name });
+	if(n == names.end())
+		return false;
+	auto hash = n->second;
+	names.erase(n);
+	for(auto& other : names) {
+		if(other.second == hash)
+			return true;
+	}
+	if(auto it = images.find(hash); it != images.end()) {
+		image_bytes -= it->second.bytes;
+		images.erase(it);
 	}
+	return true;
 }
 
 }
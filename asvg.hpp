@@ -1,7 +1,10 @@
 #pragma once
 #include <vector>
 #include <unordered_map>
+#include <memory>
+#include <mutex>
 #include "filesystem.hpp"
+#include "lunasvg.h"
 
 namespace asvg {
 
@@ -9,7 +12,7 @@ class svg_instance {
 public:
 	uint32_t texture_handle = 0;
 	svg_instance() { }
-	svg_instance(char const* bytes, int32_t sx, int32_t sy);
+	svg_instance(char const* bytes, int32_t sx, int32_t sy, bool single_channel = false);
 	svg_instance(svg_instance&& other) noexcept;
 	svg_instance(svg_instance const& other) noexcept {
 		std::abort();
@@ -21,6 +24,19 @@ public:
 	~svg_instance() noexcept;
 };
 
+/*
+an icon rendered without a color: color holds it with its .primarycolor parts black, and tint holds how much of
+the color it is drawn with each pixel takes on, so one render serves every color the icon is shown in
+*/
+struct tinted_instance {
+	svg_instance color;
+	svg_instance tint;
+};
+struct tinted_handles {
+	uint32_t color = 0;
+	uint32_t tint = 0;
+};
+
 enum class dimension_relative : uint8_t {
 	height, width, smaller, larger, diagonal, pixel
 };
@@ -34,11 +50,37 @@ struct affine_replacement {
 	bool emit_quotes = false;
 };
 
+/*
+images referenced from inside svgs, loaded from root_directory
+the names map to a hash of the file's contents, and each distinct content is decoded only once, however many names
+and svgs refer to it; decoded images are shared with the documents using them, so evicting one (least recently used
+first, once byte_budget is exceeded) never pulls it out from under a render that is in progress
+renders made in the background read from it as well, so it is locked
+*/
 class file_bank {
 public:
+	struct decoded_image {
+		lunasvg::Bitmap bitmap; // null if the file could not be decoded
+		size_t bytes = 0;
+		uint64_t last_used = 0;
+	};
+
 	std::wstring root_directory;
-	std::unordered_map<std::string_view, std::vector<char>> file_contents;
-	std::pair<void const*, int> get_file_data(std::string_view file_name);
+	std::unordered_map<std::string, uint64_t> names;
+	std::unordered_map<uint64_t, decoded_image> images;
+	std::mutex lock;
+	size_t image_bytes = 0;
+	size_t byte_budget = size_t(64) * 1024 * 1024;
+	uint64_t use_count = 0;
+
+	// the directory is read by the background renders too, so it is only touched through these
+	std::wstring get_root_directory();
+	// names loaded from the old directory are forgotten; the decoded contents stay until they are evicted
+	void set_root_directory(std::wstring const& directory);
+	lunasvg::Bitmap get_image(std::string_view file_name);
+	std::vector<std::string> loaded_names();
+	// returns whether the file had been loaded
+	bool forget(std::string_view file_name);
 };
 
 class common_file_bank {
@@ -46,9 +88,31 @@ public:
 	static file_bank bank;
 };
 
+// renders of a changed file, made on a background thread and handed back to the svg that asked for them
+struct rerender_result {
+	uint64_t key = 0;
+	uint32_t generation = 0;
+	int32_t width = 0;
+	int32_t height = 0;
+	std::vector<char> pixels; // empty if the new version of the file could not be rendered
+	std::vector<char> tint; // for tinted renders
+};
+struct rerender_results {
+	std::mutex lock;
+	std::vector<rerender_result> finished;
+};
+
+// whether any render is still being made in the background
+bool renders_pending();
+
 class svg {
 public:
 	std::unordered_map<uint64_t, svg_instance> renders;
+	// renders made from an earlier version of the file, which keep being shown until their replacement is ready
+	// the value is whether the replacement has been asked for
+	std::unordered_map<uint64_t, bool> stale;
+	std::shared_ptr<rerender_results> rerendered = std::make_shared<rerender_results>();
+	uint32_t generation = 0;
 	std::vector<char> svg_data;
 	std::vector<affine_replacement> replacements;
 	int32_t base_width = 1;
@@ -59,15 +123,81 @@ public:
 	svg(svg&& other) noexcept = default;
 	svg& operator=(svg&& other) noexcept = default;
 
+	// the rgba pixels make_new_render uploads, made without touching gl; returns false if the data could not be parsed
+	bool render_pixels(float size_x, float size_y, int32_t grid_size, float scale, float r, float g, float b, lunasvg::Bitmap& bmp);
+	// 0 if the data could not be parsed
 	uint32_t make_new_render(float size_x, float size_y, int32_t grid_size, float scale, float r = 0.0f, float g = 0.0f, float b = 0.0f);
 	void release_renders();
+	// takes on the new contents of the file; existing renders are made again in the background as they are asked for
+	// returns false, keeping the old contents, if the new ones cannot be parsed
+	bool replace_source(char const* data, size_t count);
+	void invalidate_renders();
+	void collect_rerenders();
 	uint32_t get_render(float size_x, float size_y, int32_t grid_size, float scale, float r = 0.0f, float g = 0.0f, float b = 0.0f);
 	uint32_t try_get_render(float size_x, float size_y, int32_t grid_size, float r = 0.0f, float g = 0.0f, float b = 0.0f);
 };
 
+enum class distance_field_status : uint8_t {
+	not_made, made, unsuitable
+};
+
+// where a distance field is in the atlas: the texture, and the field's corner and size in texture coordinates
+struct distance_field_slot {
+	uint32_t texture_handle = 0;
+	uint32_t generation = 0; // of the atlas it was placed in
+	float x = 0.0f;
+	float y = 0.0f;
+	float width = 0.0f;
+	float height = 0.0f;
+};
+
+/*
+the distance fields of every icon, packed into one texture in rows, each with a border of its edge texels repeated so
+that filtering at its edges does not reach into its neighbors
+when a field does not fit, the texture is made twice as large (or, once it is max_size, emptied) and the fields already
+in it are made again as their icons are drawn
+*/
+class distance_field_atlas {
+public:
+	static constexpr int32_t first_size = 256;
+	static constexpr int32_t max_size = 4096;
+
+	uint32_t texture_handle = 0;
+	int32_t size = 0;
+	uint32_t generation = 0;
+	int32_t row_x = 0;
+	int32_t row_y = 0;
+	int32_t row_height = 0;
+
+	// finds room for a field of width by height texels and its border, returning false if there is none left; an atlas
+	// nothing has been placed in yet is first_size
+	bool place(int32_t width, int32_t height, distance_field_slot& slot);
+	// places the field (three values a texel) and copies it into the texture, starting over if it does not fit
+	distance_field_slot add(std::vector<char> const& field, int32_t width, int32_t height);
+	// whether a slot still holds the field that was placed in it
+	bool holds(distance_field_slot const& slot) const {
+		return slot.texture_handle != 0 && slot.generation == generation;
+	}
+};
+
+class common_distance_field_atlas {
+public:
+	static distance_field_atlas atlas;
+};
+
 class simple_svg {
 public:
 	std::unordered_map<uint64_t, svg_instance> renders;
+	std::unordered_map<uint64_t, bool> stale;
+	std::shared_ptr<rerender_results> rerendered = std::make_shared<rerender_results>();
+	std::unordered_map<uint64_t, tinted_instance> tinted_renders;
+	std::unordered_map<uint64_t, bool> tinted_stale;
+	std::shared_ptr<rerender_results> tinted_rerendered = std::make_shared<rerender_results>();
+	// a multi-channel signed distance field of the icon in the common atlas, which can be drawn at any size; made the
+	// first time it is asked for, and only for icons drawn entirely in the primary color
+	distance_field_slot distance_field;
+	distance_field_status distance_field_state = distance_field_status::not_made;
+	uint32_t generation = 0;
 	std::vector<char> svg_data;
 public:
 	simple_svg() {
@@ -77,9 +207,29 @@ public:
 	simple_svg& operator=(simple_svg&& other) noexcept = default;
 	uint32_t make_new_render(int32_t size_x, int32_t size_y, float scale, float r = 0.0f, float g = 0.0f, float b = 0.0f);
 	void release_renders();
+	// as svg::replace_source
+	bool replace_source(char const* data, size_t count);
+	void invalidate_renders();
+	void collect_rerenders();
 	uint32_t get_render(int32_t size_x, int32_t size_y, float scale, float r = 0.0f, float g = 0.0f, float b = 0.0f);
 	uint32_t try_get_render(int32_t size_x, int32_t size_y, float r = 0.0f, float g = 0.0f, float b = 0.0f);
+	// renders that do not depend on the color, keyed by size alone; they are drawn with the color applied by the shader
+	// both handles are 0 if the data could not be parsed
+	tinted_handles make_new_tinted_render(int32_t size_x, int32_t size_y, float scale);
+	tinted_handles get_tinted_render(int32_t size_x, int32_t size_y, float scale);
+	// the rgba pixels make_new_render uploads, made without touching gl; returns false if the data could not be parsed
+	bool render_pixels(int32_t size_x, int32_t size_y, float scale, float r, float g, float b, lunasvg::Bitmap& bmp);
+	// the values get_distance_field uploads (red, green and blue for each texel), made without touching gl; returns
+	// false if the data could not be parsed, and leaves the field empty if the icon has parts in other colors or draws
+	// anything but filled and stroked outlines
+	bool distance_field_values(std::vector<char>& field, int32_t& width, int32_t& height);
+	// a slot with no texture if the icon cannot be drawn from a distance field, or could not be parsed
+	distance_field_slot get_distance_field();
 };
 
+// the coverage (0 to 255) of each pixel the ui shader draws when it stretches a distance field to size_x by size_y,
+// with the same filtering, median and edge smoothing, so that fields can be checked without a gpu
+void sample_distance_field(std::vector<char> const& field, int32_t width, int32_t height, int32_t size_x, int32_t size_y, std::vector<uint8_t>& coverage);
+
 
 }
@@ -0,0 +1,322 @@
+#include "autosave.hpp"
+#include "stools.hpp"
+#include "filesystem.hpp"
+#include "code_generator.hpp"
+
+void window_to_bytes(open_project_t const& p, window_element_wrapper_t const& win, serialization::out_buffer& buffer);
+void table_to_bytes(table_definition const& tab, serialization::out_buffer& buffer);
+void project_to_bytes(open_project_t const& p, serialization::out_buffer& buffer);
+open_project_t bytes_to_project(serialization::in_buffer& buffer);
+
+namespace autosave {
+
+constexpr uint32_t journal_record_tag = 0x4a495541; // "AUIJ"
+
+/*
+a journal record is
+	tag
+	section {
+		window count after the change
+		indices of the windows that changed
+		whether the tables changed
+		section { the changed windows (and tables), laid out exactly like a project file }
+	}
+	fingerprint of the section
+*/
+
+std::wstring journal_path(std::wstring const& project_file) {
+	return project_file + L".journal";
+}
+
+size_t replay_journal(std::wstring const& project_file, open_project_t& p) {
+	fs::file journal{ journal_path(project_file) };
+	auto content = journal.content();
+	if(!content.data)
+		return 0;
+
+	size_t applied = 0;
+	size_t position = 0;
+	while(position + 8 <= content.file_size) {
+		uint32_t tag = 0;
+		uint32_t section_size = 0;
+		std::memcpy(&tag, content.data + position, sizeof(uint32_t));
+		std::memcpy(&section_size, content.data + position + 4, sizeof(uint32_t));
+		if(tag != journal_record_tag || section_size < 4 || position + 4 + section_size + 8 > content.file_size)
+			break;
+		uint64_t check = 0;
+		std::memcpy(&check, content.data + position + 4 + section_size, sizeof(uint64_t));
+		if(undo::fingerprint_bytes(content.data + position + 4, section_size) != check)
+			break;
+
+		serialization::in_buffer record{ content.data, position + 4 + section_size, position + 4 };
+		auto body = record.read_section();
+		auto window_count = body.read<uint32_t>();
+		auto changed = body.read_variable<uint32_t>();
+		auto tables_changed = body.read<bool>();
+		auto contents = body.read_section();
+		auto partial = bytes_to_project(contents);
+
+		p.windows.resize(window_count);
+		for(size_t k = 0; k < changed.size() && k < partial.windows.size(); ++k) {
+			if(changed[k] < window_count)
+				p.windows[changed[k]] = std::move(partial.windows[k]);
+		}
+		if(tables_changed)
+			p.tables = std::move(partial.tables);
+		p.grid_size = partial.grid_size;
+		p.source_path = partial.source_path;
+		p.omit_lua = partial.omit_lua;
+		p.bake_layouts = partial.bake_layouts;
+
+		++applied;
+		position += 4 + section_size + 8;
+	}
+	return applied;
+}
+
+static open_project_t materialize(undo::project_state const& state, std::wstring const& project_name, std::wstring const& project_directory) {
+	open_project_t p;
+	p.project_name = project_name;
+	p.project_directory = project_directory;
+	p.source_path = state.source_path;
+	p.grid_size = state.grid_size;
+	p.omit_lua = state.omit_lua;
+	p.bake_layouts = state.bake_layouts;
+	p.windows.reserve(state.windows.size());
+	for(auto& w : state.windows) {
+		p.windows.push_back(w->contents);
+	}
+	if(state.tables)
+		p.tables = state.tables->contents;
+	return p;
+}
+
+service::~service() {
+	stop();
+}
+
+void service::push(open_project_t const& p, undo::project_state const& state, job_type type, bool nine_slice_backgrounds) {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if(!worker.joinable()) {
+			stopping = false;
+			worker = std::thread([this]() { run(); });
+		}
+		jobs.push_back(job{ state, p.project_name, p.project_directory, type, nine_slice_backgrounds });
+	}
+	wake.notify_one();
+}
+
+void service::start(open_project_t const& p, undo::project_state const& state) {
+	push(p, state, job_type::start);
+}
+void service::submit(open_project_t const& p, undo::project_state const& state) {
+	push(p, state, job_type::journal);
+}
+void service::save(open_project_t const& p, undo::project_state const& state) {
+	push(p, state, job_type::save);
+}
+void service::generate_code(open_project_t const& p, undo::project_state const& state, bool nine_slice_backgrounds) {
+	push(p, state, job_type::generate_code, nine_slice_backgrounds);
+}
+
+void service::wait_for(std::wstring const& project_file) {
+	std::unique_lock<std::mutex> guard(lock);
+	job_done.wait(guard, [&]() {
+		if(running_file == project_file)
+			return false;
+		for(auto& j : jobs) {
+			if(j.project_directory + j.project_name + L".aui" == project_file)
+				return false;
+		}
+		return true;
+	});
+}
+
+void service::stop() {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopping = true;
+	}
+	wake.notify_one();
+	if(worker.joinable())
+		worker.join();
+}
+
+void service::run() {
+	while(true) {
+		job j;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			wake.wait(guard, [&]() { return stopping || !jobs.empty(); });
+			if(jobs.empty())
+				return;
+			// every journal job is compared against what was last written, so only the latest of a run of them matters
+			while(jobs.size() > 1 && jobs[0].type == job_type::journal && jobs[1].type == job_type::journal && jobs[0].project_name == jobs[1].project_name && jobs[0].project_directory == jobs[1].project_directory) {
+				jobs.pop_front();
+			}
+			j = std::move(jobs.front());
+			jobs.pop_front();
+			running_file = j.project_directory + j.project_name + L".aui";
+		}
+		switch(j.type) {
+			case job_type::start:
+				take_base(j);
+				break;
+			case job_type::journal:
+				append_journal(j);
+				break;
+			case job_type::save:
+				write_project(j);
+				break;
+			case job_type::generate_code:
+				generate_code(j);
+				break;
+		}
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			running_file.clear();
+		}
+		job_done.notify_all();
+	}
+}
+
+void service::remember_written(job const& j) {
+	written_file = j.project_directory + j.project_name + L".aui";
+	written_windows.clear();
+	for(auto& w : j.state.windows) {
+		written_windows.push_back(w->fingerprint);
+	}
+	written_tables = j.state.tables ? j.state.tables->fingerprint : 0;
+	written_source_path = j.state.source_path;
+	written_grid_size = j.state.grid_size;
+	written_omit_lua = j.state.omit_lua;
+	written_bake_layouts = j.state.bake_layouts;
+	journal_bytes = 0;
+	journal_records = 0;
+	journal_broken = false;
+}
+
+void service::take_base(job const& j) {
+	remember_written(j);
+
+	// the project was opened with a journal already applied to it, so it is folded into the project file
+	// rather than appended to (a partly written record at its end would hide everything after it)
+	bool journal_exists = false;
+	{
+		fs::file journal{ journal_path(written_file) };
+		journal_exists = journal.content().data != nullptr;
+	}
+	if(journal_exists)
+		write_project(j);
+}
+
+void service::write_project(job const& j) {
+	auto p = materialize(j.state, j.project_name, j.project_directory);
+	serialization::out_buffer bytes;
+	bytes.reserve(project_bytes + project_bytes / 8);
+	project_to_bytes(p, bytes);
+	project_bytes = bytes.size();
+
+	auto project_file = j.project_directory + j.project_name + L".aui";
+	if(!fs::write_file(project_file, bytes.data(), uint32_t(bytes.size())))
+		return; // the journal is kept, since it is still the only record of the changes
+
+	fs::remove_file(journal_path(project_file));
+	remember_written(j);
+}
+
+void service::append_journal(job const& j) {
+	auto project_file = j.project_directory + j.project_name + L".aui";
+	if(project_file != written_file)
+		return;
+
+	auto& state = j.state;
+	std::vector<uint32_t> changed;
+	for(size_t i = 0; i < state.windows.size(); ++i) {
+		if(i >= written_windows.size() || written_windows[i] != state.windows[i]->fingerprint)
+			changed.push_back(uint32_t(i));
+	}
+	bool tables_changed = state.tables && state.tables->fingerprint != written_tables;
+	bool header_changed = state.windows.size() != written_windows.size() || state.source_path != written_source_path || state.grid_size != written_grid_size || state.omit_lua != written_omit_lua || state.bake_layouts != written_bake_layouts;
+	if(changed.empty() && !tables_changed && !header_changed)
+		return;
+	if(journal_broken) {
+		write_project(j);
+		return;
+	}
+
+	open_project_t header;
+	header.source_path = state.source_path;
+	header.grid_size = state.grid_size;
+	header.omit_lua = state.omit_lua;
+	header.bake_layouts = state.bake_layouts;
+
+	serialization::out_buffer record;
+	record.write(journal_record_tag);
+	record.start_section();
+	record.write(uint32_t(state.windows.size()));
+	record.write_variable(changed.data(), changed.size());
+	record.write(tables_changed);
+
+	record.start_section();
+	record.start_section(); // header
+	record.write(header.grid_size);
+	record.write(header.source_path);
+	record.write(header.omit_lua);
+	record.write(header.bake_layouts);
+	record.finish_section();
+	for(auto i : changed) {
+		record.start_section();
+		window_to_bytes(header, state.windows[i]->contents, record);
+		record.finish_section();
+	}
+	if(tables_changed) {
+		for(auto& t : state.tables->contents) {
+			table_to_bytes(t, record);
+		}
+	}
+	record.finish_section();
+
+	record.finish_section();
+	uint64_t check = undo::fingerprint_bytes(record.data() + sizeof(uint32_t), record.size() - sizeof(uint32_t));
+	record.write(check);
+
+	// the record is a delta against what was written before it, so nothing counts as written unless all of it was
+	if(!fs::append_file(journal_path(project_file), record.data(), uint32_t(record.size()))) {
+		journal_broken = true;
+		write_project(j);
+		return;
+	}
+
+	written_windows.resize(state.windows.size());
+	for(auto i : changed) {
+		written_windows[i] = state.windows[i]->fingerprint;
+	}
+	if(tables_changed)
+		written_tables = state.tables->fingerprint;
+	written_source_path = state.source_path;
+	written_grid_size = state.grid_size;
+	written_omit_lua = state.omit_lua;
+	written_bake_layouts = state.bake_layouts;
+	journal_bytes += record.size();
+	++journal_records;
+
+	if(journal_bytes > compact_after_bytes || journal_records > compact_after_records)
+		write_project(j);
+}
+
+void service::generate_code(job const& j) {
+	auto p = materialize(j.state, j.project_name, j.project_directory);
+	auto source_file = p.project_directory + p.source_path + p.project_name + L".cpp";
+
+	generator::code_snippets old_code;
+	{
+		fs::file loaded_file{ source_file };
+		old_code = generator::extract_snippets(loaded_file.content().data, loaded_file.content().file_size);
+	}
+	auto text = generator::generate_project_code(p, old_code, j.nine_slice_backgrounds);
+	fs::write_file(source_file, text.c_str(), uint32_t(text.size()));
+}
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <string>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdint.h>
+#include "undo_history.hpp"
+
+namespace autosave {
+
+/*
+keeps the project on disk up to date without making the ui thread wait for it
+the ui thread hands over states taken from the undo history (which are only pointers to immutable snapshots), and
+a worker thread appends the windows that differ from what it last wrote to a journal next to the .aui file
+once the journal grows large enough, the whole project is written to the .aui file and the journal is removed
+*/
+
+std::wstring journal_path(std::wstring const& project_file);
+// applies a journal left behind by an earlier session to a project that was just loaded from the project file
+// returns the number of records applied; a record that was only partly written when the editor stopped is ignored
+size_t replay_journal(std::wstring const& project_file, open_project_t& p);
+
+enum class job_type : uint8_t {
+	start, journal, save, generate_code
+};
+
+class service {
+private:
+	struct job {
+		undo::project_state state;
+		std::wstring project_name;
+		std::wstring project_directory;
+		job_type type = job_type::journal;
+		bool nine_slice_backgrounds = false; // for generate_code: whether the templates have nine-slice backgrounds
+	};
+
+	std::thread worker;
+	std::mutex lock;
+	std::condition_variable wake;
+	std::condition_variable job_done;
+	std::deque<job> jobs;
+	std::wstring running_file; // the project file of the job the worker is running, if any
+	bool stopping = false;
+
+	// worker side: what the .aui file plus the journal currently amount to
+	std::wstring written_file;
+	std::vector<uint64_t> written_windows;
+	uint64_t written_tables = 0;
+	std::wstring written_source_path;
+	int32_t written_grid_size = 0;
+	bool written_omit_lua = false;
+	bool written_bake_layouts = false;
+	size_t project_bytes = 0; // size of the last full write, used to size the next one
+	size_t journal_bytes = 0;
+	uint32_t journal_records = 0;
+	// an append failed, possibly leaving a torn record that would hide anything appended after it,
+	// so changes go straight to the project file until a full write succeeds
+	bool journal_broken = false;
+
+	void run();
+	void remember_written(job const& j);
+	void take_base(job const& j);
+	void write_project(job const& j);
+	void append_journal(job const& j);
+	void generate_code(job const& j);
+	void push(open_project_t const& p, undo::project_state const& state, job_type type, bool nine_slice_backgrounds = false);
+public:
+	size_t compact_after_bytes = size_t(8) * 1024 * 1024;
+	uint32_t compact_after_records = 512;
+
+	service() { }
+	~service();
+	service(service const&) = delete;
+	void operator=(service const&) = delete;
+
+	// the given state is what the project file holds right now (it was just opened or created)
+	void start(open_project_t const& p, undo::project_state const& state);
+	// journal whatever is different in the given state
+	void submit(open_project_t const& p, undo::project_state const& state);
+	// write the whole project file and discard the journal
+	void save(open_project_t const& p, undo::project_state const& state);
+	// regenerate the project's source file from the given state
+	void generate_code(open_project_t const& p, undo::project_state const& state, bool nine_slice_backgrounds);
+	// waits until nothing handed over is still to be written to the given project file or its journal, so that they can be
+	// read; opening some other project does not wait, since the worker writes the old project out after this returns
+	void wait_for(std::wstring const& project_file);
+	// finishes everything that has been handed over and then stops the worker
+	void stop();
+};
+
+}
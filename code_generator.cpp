@@ -1,6 +1,7 @@
 #include "code_generator.hpp"
 #include <string>
 #include <string_view>
+#include <charconv>
 #include "filesystem.hpp"
 #include "project_description.hpp"
 
@@ -135,32 +136,47 @@ std::string alignment_to_name(aui_text_alignment t) {
 	}
 }
 
-std::vector<generator_t*> make_generators_list(layout_level_t& lvl) {
+std::vector<generator_t*> make_generators_list(window_element_wrapper_t& win, layout_level_t& lvl) {
 	std::vector<generator_t*> result;
 	for(auto& m : lvl.contents) {
 		if(std::holds_alternative<generator_t>(m)) {
 			result.push_back(&(std::get<generator_t>(m)));
 		}
 		if(std::holds_alternative<sub_layout_t>(m)) {
-			auto subr = make_generators_list(*(get<sub_layout_t>(m).layout));
+			auto subr = make_generators_list(win, get_sub_layout(win, get<sub_layout_t>(m)));
 			result.insert(result.end(), subr.begin(), subr.end());
 		}
 	}
 	return result;
 }
 
-bool any_layout_paged(layout_level_t& lvl) {
+// the names of a generator's row pools: one for each inserted window that exists, then one for each of their headers
+std::vector<std::string> generator_pool_names(open_project_t& proj, generator_t const& g) {
+	std::vector<std::string> result;
+	std::vector<std::string> header_list;
+	for(auto& inserts : g.inserts) {
+		if(!window_from_name(proj, inserts.name))
+			continue;
+		result.push_back(inserts.name);
+		if(inserts.header.size() > 0 && std::find(header_list.begin(), header_list.end(), inserts.header) == header_list.end())
+			header_list.push_back(inserts.header);
+	}
+	result.insert(result.end(), header_list.begin(), header_list.end());
+	return result;
+}
+
+bool any_layout_paged(window_element_wrapper_t& win, layout_level_t& lvl) {
 	if(lvl.paged)
 		return true;
 	for(auto& m : lvl.contents) {
 		if(holds_alternative<sub_layout_t>(m)) {
-			auto r = any_layout_paged(*get<sub_layout_t>(m).layout);
+			auto r = any_layout_paged(win, get_sub_layout(win, get<sub_layout_t>(m)));
 			if(r) return true;
 		}
 	}
 	return false;
 }
-bool any_layout_contains_window(layout_level_t& lvl, std::string const& window_name) {
+bool any_layout_contains_window(window_element_wrapper_t& win, layout_level_t& lvl, std::string const& window_name) {
 	for(auto& m : lvl.contents) {
 		if(holds_alternative<layout_window_t>(m)) {
 			if(get<layout_window_t>(m).name == window_name)
@@ -174,7 +190,7 @@ bool any_layout_contains_window(layout_level_t& lvl, std::string const& window_n
 					return true;
 			}
 		} else if(holds_alternative<sub_layout_t>(m)) {
-			auto r = any_layout_contains_window(*get<sub_layout_t>(m).layout, window_name);
+			auto r = any_layout_contains_window(win, get_sub_layout(win, get<sub_layout_t>(m)), window_name);
 			if(r) return true;
 		}
 	}
@@ -182,6 +198,152 @@ bool any_layout_contains_window(layout_level_t& lvl, std::string const& window_n
 }
 
 
+std::string code_string(std::string_view s) {
+	std::string result = "\"";
+	for(auto c : s) {
+		if(c == '\n') {
+			result += "\\n";
+			continue;
+		}
+		if(c == '\\' || c == '\"')
+			result += '\\';
+		result += c;
+	}
+	result += "\"";
+	return result;
+}
+std::string code_bool(bool b) {
+	return b ? "true" : "false";
+}
+// the shortest literal that reads back as exactly the same float, so that baked values match the bytes the data-driven
+// path reads
+std::string code_float(float f) {
+	char buffer[32];
+	auto result = std::to_chars(buffer, buffer + sizeof(buffer), f);
+	std::string s(buffer, result.ptr);
+	if(s.find_first_of(".e") == std::string::npos)
+		s += ".0";
+	return s + "f";
+}
+
+void collect_layout_levels(window_element_wrapper_t& win, layout_level_t& lvl, std::vector<layout_level_t*>& levels) {
+	levels.push_back(&lvl);
+	for(auto& m : lvl.contents) {
+		if(holds_alternative<sub_layout_t>(m))
+			collect_layout_levels(win, get_sub_layout(win, get<sub_layout_t>(m)), levels);
+	}
+}
+
+/*
+for projects with bake_layouts set, the layout of each window is emitted as two constant tables rather than read from the window's bytes
+when it is created: one row per level (the window's own layout first) and the items of all levels, those of each level next to each other
+controls, windows, generators and nested levels are referred to by their index, so creating the layout only switches on those indices,
+where the data-driven version compares the names against every candidate
+*/
+std::string baked_layout_tables(std::string const& project_name, open_project_t& proj, window_element_wrapper_t& win, std::vector<generator_t*> const& gens) {
+	std::vector<layout_level_t*> levels;
+	collect_layout_levels(win, win.layout, levels);
+
+	std::string level_rows;
+	std::string item_rows;
+	int32_t item_count = 0;
+
+	auto add_item = [&](std::string const& type, int32_t target, int16_t abs_x, int16_t abs_y, int16_t amount, bool absolute_position, bool fill_x, bool fill_y, std::string_view name) {
+		item_rows += "\t" "{ layout_item_types::" + type + ", " + std::to_string(target) + ", " + std::to_string(abs_x) + ", " + std::to_string(abs_y) + ", " + std::to_string(amount) + ", " + code_bool(absolute_position) + ", " + code_bool(fill_x) + ", " + code_bool(fill_y) + ", " + code_string(name) + " },\n";
+		++item_count;
+	};
+
+	for(auto l : levels) {
+		int32_t first_item = item_count;
+		for(auto& m : l->contents) {
+			if(holds_alternative<layout_control_t>(m)) {
+				auto& i = get<layout_control_t>(m);
+				int32_t target = -1;
+				for(size_t k = 0; k < win.children.size() && target == -1; ++k) {
+					if(win.children[k].name == i.name && !is_lua_element(win.children[k]))
+						target = int32_t(k);
+				}
+				// scripted controls are still found by name
+				add_item("control2", target, i.abs_x, i.abs_y, 0, i.absolute_position, i.fill_x, i.fill_y, target == -1 ? std::string_view{ i.name } : std::string_view{ });
+			} else if(holds_alternative<layout_window_t>(m)) {
+				auto& i = get<layout_window_t>(m);
+				int32_t target = -1;
+				for(size_t k = 0; k < proj.windows.size() && target == -1; ++k) {
+					if(proj.windows[k].wrapped.name == i.name)
+						target = int32_t(k);
+				}
+				add_item("window2", target, i.abs_x, i.abs_y, 0, i.absolute_position, i.fill_x, i.fill_y, std::string_view{ });
+			} else if(holds_alternative<layout_glue_t>(m)) {
+				auto& i = get<layout_glue_t>(m);
+				add_item("glue", int32_t(i.type), 0, 0, i.amount, false, false, false, std::string_view{ });
+			} else if(holds_alternative<generator_t>(m)) {
+				auto& i = get<generator_t>(m);
+				int32_t target = -1;
+				for(size_t k = 0; k < gens.size() && target == -1; ++k) {
+					if(gens[k]->name == i.name)
+						target = int32_t(k);
+				}
+				add_item("generator2", target, 0, 0, 0, false, false, false, std::string_view{ });
+			} else if(holds_alternative<sub_layout_t>(m)) {
+				auto* sub = &get_sub_layout(win, get<sub_layout_t>(m));
+				int32_t target = 0;
+				while(levels[target] != sub)
+					++target;
+				add_item("layout", target, 0, 0, 0, false, false, false, std::string_view{ });
+			} else if(holds_alternative<texture_layer_t>(m)) {
+				auto& i = get<texture_layer_t>(m);
+				add_item("texture_layer", int32_t(i.texture_type), 0, 0, 0, false, false, false, i.texture);
+			}
+		}
+		level_rows += "\t" "{ " + std::to_string(l->size_x) + ", " + std::to_string(l->size_y) + ", " + std::to_string(l->margin_top) + ", " + std::to_string(l->margin_bottom) + ", " + std::to_string(l->margin_left) + ", " + std::to_string(l->margin_right) + ", " + std::to_string(l->template_id) + ", "
+			+ std::to_string(int32_t(l->line_alignment)) + ", " + std::to_string(int32_t(l->line_internal_alignment)) + ", " + std::to_string(int32_t(l->type)) + ", " + std::to_string(int32_t(l->page_animation)) + ", " + std::to_string(int32_t(l->interline_spacing)) + ", " + code_bool(l->paged) + ", "
+			+ std::to_string(first_item) + ", " + std::to_string(item_count - first_item) + " },\n";
+	}
+
+	std::string result;
+	result += "static constexpr " + project_name + "_baked_layout_level " + project_name + "_" + win.wrapped.name + "_layout_levels[] = {\n";
+	result += level_rows;
+	result += "};\n";
+	if(item_count > 0) {
+		result += "static constexpr " + project_name + "_baked_layout_item " + project_name + "_" + win.wrapped.name + "_layout_items[] = {\n";
+		result += item_rows;
+		result += "};\n";
+	}
+	return result;
+}
+
+std::string baked_child_row(ui_element_t const& c) {
+	// the same values the child's bytes would hold, including the defaults for what is not written there
+	color4f highlight{ 0.0f, 0.0f, 0.0f, 0.0f };
+	if(c.container_type == container_type::table) {
+		if(c.has_table_highlight_color)
+			highlight = c.table_highlight_color;
+	} else {
+		highlight = c.other_color;
+	}
+	int32_t template_id = c.ttype != template_project::template_type::none ? c.template_id : -1;
+
+	return "\t" "{ " + code_string(c.name) + ", " + std::to_string(c.x_pos) + ", " + std::to_string(c.y_pos) + ", " + std::to_string(c.x_size) + ", " + std::to_string(c.y_size) + ", "
+		+ code_string(c.texture) + ", " + code_string(c.alternate_bg) + ", " + code_string(c.text_key) + ", " + code_string(c.tooltip_text_key) + ", "
+		+ std::to_string(c.border_size) + ", " + code_float(c.text_scale) + ", "
+		+ "aui_text_type::" + (c.text_type == text_type::header ? "header" : "body") + ", text::alignment::" + alignment_to_name(c.text_align) + ", text::text_color::" + color_to_name(c.text_color) + ", "
+		+ std::to_string(template_id) + ", " + std::to_string(c.icon_id) + ", "
+		+ "ogl::color3f{" + code_float(c.table_divider_color.r) + ", " + code_float(c.table_divider_color.g) + ", " + code_float(c.table_divider_color.b) + "}, "
+		+ "ogl::color4f{" + code_float(highlight.r) + ", " + code_float(highlight.g) + ", " + code_float(highlight.b) + ", " + code_float(highlight.a) + "} },\n";
+}
+// one row per child that on_create makes, in the order of the window's children
+std::string baked_children_table(std::string const& project_name, open_project_t const& proj, window_element_wrapper_t const& win) {
+	std::string rows;
+	for(auto& c : win.children) {
+		if(is_lua_element(c) && proj.omit_lua)
+			continue;
+		rows += baked_child_row(c);
+	}
+	if(rows.empty())
+		return rows;
+	return "static constexpr " + project_name + "_baked_child " + project_name + "_" + win.wrapped.name + "_children[] = {\n" + rows + "};\n";
+}
+
 bool element_needs_class(ui_element_t const& c) {
 	if(is_lua_element(c))
 		return false;
@@ -430,7 +592,6 @@ std::string element_initialize_child(std::string const& project_name, window_ele
 	result += "\t" "\t" "\t" "cptr->parent = this;\n";
 	result += "\t" "\t" "\t" "cptr->on_create(state);\n";
 	result += "\t" "\t" "\t" "children.push_back(cptr);\n";
-	result += "\t" "\t" "\t" "pending_children.pop_back(); continue;\n";
 
 	return result;
 }
@@ -853,7 +1014,8 @@ std::string element_type_declarations(std::string const& project_name, window_el
 				}
 
 				result += "\t" "std::vector<" + c.child_window + "_option> list_contents;\n";
-				result += "\t" "std::vector<std::unique_ptr<" + project_name + "_" + c.child_window + "_t >> list_pool;\n";
+				result += "\t" + project_name + "_element_pool<" + project_name + "_" + c.child_window + "_t> list_pool;\n";
+				result += "\t" "size_t list_pool_prewarm = 0; // rows made at the end of on_create; the create section may set it\n";
 				result += "\t" "std::unique_ptr<" + project_name + "_" + c.child_window + "_t> label_window_internal;\n";
 
 				result += "\t" "void add_item(" + insert_params + ");\n";
@@ -1052,7 +1214,7 @@ std::string element_type_declarations(std::string const& project_name, window_el
 	return result;
 }
 
-std::string element_member_functions(std::string const& project_name, window_element_wrapper_t const& win, ui_element_t const& c, code_snippets& old_code, open_project_t const& proj) {
+std::string element_member_functions(std::string const& project_name, window_element_wrapper_t const& win, ui_element_t const& c, code_snippets& old_code, open_project_t const& proj, bool nine_slice_backgrounds) {
 	std::string result;
 
 	if(!element_needs_class(c)) {
@@ -1838,14 +2000,14 @@ std::string element_member_functions(std::string const& project_name, window_ele
 
 				result += "ui::element_base* " + project_name + "_" + win.wrapped.name + "_" + c.name + "_t::get_nth_item(sys::state& state, int32_t id, int32_t pool_id) {\n";
 				result += "\t" "while(pool_id >= int32_t(list_pool.size())) {\n";
-				result += "\t" "\t" "list_pool.emplace_back(static_cast<" + project_name + "_" + c.child_window + "_t*>(make_" + project_name + "_" + cwindow_type->wrapped.name + "(state).release()));\n";
+				result += "\t" "\t" "list_pool.emplace_back(state);\n";
 				result += "\t" "}\n";
 				if(cwindow_type) {
 					for(auto& dm : cwindow_type->wrapped.members) {
 						result += "\t" "list_pool[pool_id]->" + dm.name + " = list_contents[id]." + dm.name + "; \n";
 					}
 				}
-				result += "\t" "return list_pool[pool_id].get();\n";
+				result += "\t" "return list_pool[pool_id];\n";
 				result += "}\n";
 
 				result += "void " + project_name + "_" + win.wrapped.name + "_" + c.name + "_t::quiet_on_selection(sys::state& state, int32_t id) {\n";
@@ -1896,6 +2058,7 @@ std::string element_member_functions(std::string const& project_name, window_ele
 					result += it->second.text;
 				}
 				result += "// END\n";
+				result += "\t" "list_pool.reserve(state, list_pool_prewarm);\n";
 				result += "}\n";
 			} break;
 			case template_project::template_type::table_row:
@@ -2246,9 +2409,13 @@ std::string element_member_functions(std::string const& project_name, window_ele
 								result += "\t" "\t" "{\n";
 								result += "\t" "\t" "auto bg = template_id != -1 ? ((0 <= rel_mouse_y && rel_mouse_y < base_data.size.y && col_um_" + col.internal_data.column_name + ") ? state.ui_templates.table_t[template_id].active_header_bg : state.ui_templates.table_t[template_id].interactable_header_bg) : -1;\n";
 								result += "\t" "\t" "if(bg != -1)\n";
-								result += "\t" "\t" "ogl::render_textured_rect_direct(state, float(x + table_source->" + t->name + "_" + col.internal_data.column_name + "_column_start), float(y), float(table_source->" + t->name + "_" + col.internal_data.column_name + "_column_width), float(base_data.size.y), "
-									"state.ui_templates.backgrounds[bg].renders.get_render(state, float(table_source->" + t->name + "_" + col.internal_data.column_name + "_column_width) / float(table_source->grid_size), float(base_data.size.y) / float(table_source->grid_size), int32_t(table_source->grid_size), state.user_settings.ui_scale)"
-									"); \n";
+								if(nine_slice_backgrounds) {
+									result += "\t" "\t" + project_name + "_render_template_background(state, bg, float(x + table_source->" + t->name + "_" + col.internal_data.column_name + "_column_start), float(y), float(table_source->" + t->name + "_" + col.internal_data.column_name + "_column_width), float(base_data.size.y), int32_t(table_source->grid_size)); \n";
+								} else {
+									result += "\t" "\t" "ogl::render_textured_rect_direct(state, float(x + table_source->" + t->name + "_" + col.internal_data.column_name + "_column_start), float(y), float(table_source->" + t->name + "_" + col.internal_data.column_name + "_column_width), float(base_data.size.y), "
+										"state.ui_templates.backgrounds[bg].renders.get_render(state, float(table_source->" + t->name + "_" + col.internal_data.column_name + "_column_width) / float(table_source->grid_size), float(base_data.size.y) / float(table_source->grid_size), int32_t(table_source->grid_size), state.user_settings.ui_scale)"
+										"); \n";
+								}
 								result += "\t" "\t" "}\n";
 							}
 						}
@@ -2401,7 +2568,10 @@ std::string element_member_functions(std::string const& project_name, window_ele
 
 				result += "\t" "auto bg_id = state.ui_templates.stacked_bar_t[template_id].overlay_bg;\n";
 				result += "\t" "if(bg_id != -1)\n";
-				result += "\t" "\t" "ogl::render_textured_rect_direct(state, float(x), float(y), float(base_data.size.x), float(base_data.size.y), state.ui_templates.backgrounds[bg_id].renders.get_render(state, float(base_data.size.x) / float(par->grid_size), float(base_data.size.y) / float(par->grid_size), int32_t(par->grid_size), state.user_settings.ui_scale));\n";
+				if(nine_slice_backgrounds)
+					result += "\t" "\t" + project_name + "_render_template_background(state, bg_id, float(x), float(y), float(base_data.size.x), float(base_data.size.y), int32_t(par->grid_size));\n";
+				else
+					result += "\t" "\t" "ogl::render_textured_rect_direct(state, float(x), float(y), float(base_data.size.x), float(base_data.size.y), state.ui_templates.backgrounds[bg_id].renders.get_render(state, float(base_data.size.x) / float(par->grid_size), float(base_data.size.y) / float(par->grid_size), int32_t(par->grid_size), state.user_settings.ui_scale));\n";
 				
 				result += "}\n";
 
@@ -2835,8 +3005,28 @@ std::string element_member_functions(std::string const& project_name, window_ele
 
 	// RENDER
 	if(c.text_key.length() > 0 || c.dynamic_text || c.background != background_type::none) {
+		// plain backgrounds and text are drawn by the render_background and render_text emitted once per project
+		char const* shared_background = nullptr;
+		switch(c.background) {
+			case background_type::texture: shared_background = "texture"; break;
+			case background_type::bordered_texture: shared_background = "bordered"; break;
+			case background_type::border_texture_repeat: shared_background = "repeated_border"; break;
+			case background_type::textured_corners: shared_background = "repeated_corner"; break;
+			case background_type::progress_bar: shared_background = "progress_bar"; break;
+			default: break;
+		}
 		result += "void " + project_name + "_" + win.wrapped.name + "_" + c.name + "_t::render(sys::state & state, int32_t x, int32_t y) noexcept {\n";
-		if(c.background == background_type::existing_gfx) {
+		auto look = project_name + "_control_look{ " + project_name + "_background::" + std::string(shared_background ? shared_background : "texture") + ", " + std::string((c.left_click_action || c.right_click_action || c.shift_click_action || c.hover_activation) ? "true" : "false") + ", " + std::string(c.ignore_rtl ? "true" : "false") + " }";
+		if(shared_background) {
+			bool alternate = c.has_alternate_bg && c.background != background_type::progress_bar;
+			bool has_alt_texture = alternate || c.background == background_type::progress_bar;
+			std::string amount = "0.0f";
+			if(c.background == background_type::progress_bar)
+				amount = "progress";
+			else if(c.background == background_type::bordered_texture)
+				amount = "float(border_size)";
+			result += "\t" + project_name + "_render_background(state, *this, x, y, " + look + ", " + std::string(c.can_disable ? "disabled" : "false") + ", " + std::string(alternate ? "is_active" : "false") + ", background_texture, texture_key, " + std::string(has_alt_texture ? "alt_background_texture, alt_texture_key" : "background_texture, texture_key") + ", " + amount + ");\n";
+		} else if(c.background == background_type::existing_gfx) {
 			result += "\t" "if(background_gid) {\n";
 			result += "\t""\t" "auto& gfx_def = state.ui_defs.gfx[background_gid];\n";
 			result += "\t" "\t" "if(gfx_def.primary_texture_handle) {\n";
@@ -2862,30 +3052,6 @@ std::string element_member_functions(std::string const& project_name, window_ele
 				result += "\t" "auto tid = ogl::get_late_load_texture_handle(state, background_texture, texture_key);\n";
 				result += "\t" "ogl::render_subsprite(state, ui::get_color_modification(this == state.ui_state.under_mouse, " + std::string(c.can_disable ? "disabled" : "false") + ", " + std::string((c.left_click_action || c.right_click_action || c.shift_click_action || c.hover_activation) ? "true" : "false") + "), frame, state.open_gl.asset_textures[background_texture].size_x / std::max(1, state.open_gl.asset_textures[background_texture].size_y), float(x), float(y), float(base_data.size.x), float(base_data.size.y),  tid, base_data.get_rotation(), gfx_def.is_vertically_flipped(), " + std::string(c.ignore_rtl ? "false" : "state_is_rtl(state)") + "); \n";
 			}
-		} else if(c.background == background_type::texture) {
-			if(c.has_alternate_bg) {
-				result += "\t"  "if(is_active)\n";
-				result += "\t"   "\t" "ogl::render_textured_rect(state, ui::get_color_modification(this == state.ui_state.under_mouse, " + std::string(c.can_disable ? "disabled" : "false") + ", " + std::string((c.left_click_action || c.right_click_action || c.shift_click_action || c.hover_activation) ? "true" : "false") + "), float(x), float(y), float(base_data.size.x), float(base_data.size.y), ogl::get_late_load_texture_handle(state, alt_background_texture, alt_texture_key), base_data.get_rotation(), false, " + std::string(c.ignore_rtl ? "false" : "state_is_rtl(state)") + "); \n";
-				result += "\t"  "else\n";
-				result += "\t" "\t" "ogl::render_textured_rect(state, ui::get_color_modification(this == state.ui_state.under_mouse, " + std::string(c.can_disable ? "disabled" : "false") + ", " + std::string((c.left_click_action || c.right_click_action || c.shift_click_action || c.hover_activation) ? "true" : "false") + "), float(x), float(y), float(base_data.size.x), float(base_data.size.y), ogl::get_late_load_texture_handle(state, background_texture, texture_key), base_data.get_rotation(), false, " + std::string(c.ignore_rtl ? "false" : "state_is_rtl(state)") + ");\n";
-			} else {
-				result += "\t" "ogl::render_textured_rect(state, ui::get_color_modification(this == state.ui_state.under_mouse, " + std::string(c.can_disable ? "disabled" : "false") + ", " + std::string((c.left_click_action || c.right_click_action || c.shift_click_action || c.hover_activation) ? "true" : "false") + "), float(x), float(y), float(base_data.size.x), float(base_data.size.y), ogl::get_late_load_texture_handle(state, background_texture, texture_key), base_data.get_rotation(), false, " + std::string(c.ignore_rtl ? "false" : "state_is_rtl(state)") + ");\n";
-			}
-		} else if(c.background == background_type::progress_bar) {
-			result += "\t"   "\t" "ogl::render_progress_bar(state, ui::get_color_modification(this == state.ui_state.under_mouse, " + std::string(c.can_disable ? "disabled" : "false") + ", " + std::string((c.left_click_action || c.right_click_action || c.shift_click_action || c.hover_activation) ? "true" : "false") + "), progress, float(x), float(y), float(base_data.size.x), float(base_data.size.y), ogl::get_late_load_texture_handle(state, alt_background_texture, alt_texture_key), ogl::get_late_load_texture_handle(state, background_texture, texture_key), base_data.get_rotation(), false, " + std::string(c.ignore_rtl ? "false" : "state_is_rtl(state)") + "); \n";
-		} else if(c.background == background_type::bordered_texture) {
-			if(c.has_alternate_bg) {
-				result += "\t" "if(is_active)\n";
-				result += "\t" "\t" "ogl::render_bordered_rect(state, ui::get_color_modification(this == state.ui_state.under_mouse, " + std::string(c.can_disable ? "disabled" : "false") + ", " + std::string((c.left_click_action || c.right_click_action || c.shift_click_action || c.hover_activation) ? "true" : "false") + "), float(border_size), float(x), float(y), float(base_data.size.x), float(base_data.size.y), ogl::get_late_load_texture_handle(state, alt_background_texture, alt_texture_key), base_data.get_rotation(), false, " + std::string(c.ignore_rtl ? "false" : "state_is_rtl(state)") + "); \n";
-				result += "\t" "else\n";
-				result += "\t"  "\t" "ogl::render_bordered_rect(state, ui::get_color_modification(this == state.ui_state.under_mouse, " + std::string(c.can_disable ? "disabled" : "false") + ", " + std::string((c.left_click_action || c.right_click_action || c.shift_click_action || c.hover_activation) ? "true" : "false") + "), float(border_size), float(x), float(y), float(base_data.size.x), float(base_data.size.y), ogl::get_late_load_texture_handle(state, background_texture, texture_key), base_data.get_rotation(), false, " + std::string(c.ignore_rtl ? "false" : "state_is_rtl(state)") + "); \n";
-			} else {
-				result += "\t" "ogl::render_bordered_rect(state, ui::get_color_modification(this == state.ui_state.under_mouse, " + std::string(c.can_disable ? "disabled" : "false") + ", " + std::string((c.left_click_action || c.right_click_action || c.shift_click_action || c.hover_activation) ? "true" : "false") + "), float(border_size), float(x), float(y), float(base_data.size.x), float(base_data.size.y), ogl::get_late_load_texture_handle(state, background_texture, texture_key), base_data.get_rotation(), false, " + std::string(c.ignore_rtl ? "false" : "state_is_rtl(state)") + "); \n";
-			}
-		} else if(c.background == background_type::border_texture_repeat) {
-			result += "\t" "ogl::render_rect_with_repeated_border(state, ui::get_color_modification(this == state.ui_state.under_mouse, " + std::string(c.can_disable ? "disabled" : "false") + ", " + std::string((c.left_click_action || c.right_click_action || c.shift_click_action || c.hover_activation) ? "true" : "false") + "), float(" + std::to_string(proj.grid_size) + "), float(x), float(y), float(base_data.size.x), float(base_data.size.y), ogl::get_late_load_texture_handle(state, background_texture, texture_key), base_data.get_rotation(), false, " + std::string(c.ignore_rtl ? "false" : "state_is_rtl(state)") + "); \n";
-		} else if(c.background == background_type::textured_corners) {
-			result += "\t" "ogl::render_rect_with_repeated_corner(state, ui::get_color_modification(this == state.ui_state.under_mouse, " + std::string(c.can_disable ? "disabled" : "false") + ", " + std::string((c.left_click_action || c.right_click_action || c.shift_click_action || c.hover_activation) ? "true" : "false") + "), float(" + std::to_string(proj.grid_size) + "), float(x), float(y), float(base_data.size.x), float(base_data.size.y), ogl::get_late_load_texture_handle(state, background_texture, texture_key), base_data.get_rotation(), false, " + std::string(c.ignore_rtl ? "false" : "state_is_rtl(state)") + "); \n";
 		} else if(c.background == background_type::linechart) {
 			result += "\t" "ogl::render_linegraph(state, ogl::color_modification::none, float(x), float(y), base_data.size.x, base_data.size.y, line_color.r, line_color.g, line_color.b, line_color.a, lines);\n";
 		} else if(c.background == background_type::doughnut) {
@@ -3004,15 +3170,7 @@ std::string element_member_functions(std::string const& project_name, window_ele
 		}
 
 		if(c.text_key.length() > 0 || c.dynamic_text) {
-			result += "\t"  "if(internal_layout.contents.empty()) return;\n";
-			result += "\t"  "auto fh = text::make_font_id(state, text_is_header, text_scale * " + std::to_string(proj.grid_size * 2) + ");\n";
-			result += "\t"  "auto linesz = state.font_collection.line_height(state, fh); \n";
-			result += "\t" "if(linesz == 0.0f) return;\n";
-			result += "\t"  "auto ycentered = (base_data.size.y - linesz) / 2;\n";
-			result += "\t"  "auto cmod = ui::get_color_modification(this == state.ui_state.under_mouse, " + std::string(c.can_disable ? "disabled" : "false") + ", " + std::string((c.left_click_action || c.right_click_action || c.shift_click_action || c.hover_activation) ? "true" : "false") + "); \n";
-			result += "\t"  "for(auto& t : internal_layout.contents) {\n";
-			result += "\t"  "\t" "ui::render_text_chunk(state, t, float(x) + t.x, float(y + int32_t(ycentered)),  fh, ui::get_text_color(state, text_color), cmod);\n";
-			result += "\t"  "}\n";
+			result += "\t" + project_name + "_render_text(state, *this, x, y, " + look + ", " + std::string(c.can_disable ? "disabled" : "false") + ", internal_layout, text_is_header, text_scale, text_color);\n";
 		}
 		result += "}\n";
 	}
@@ -3050,7 +3208,7 @@ std::string element_member_functions(std::string const& project_name, window_ele
 	return result;
 }
 
-std::string generate_project_code(open_project_t& proj, code_snippets& old_code) {
+std::string generate_project_code(open_project_t& proj, code_snippets& old_code, bool nine_slice_backgrounds) {
 	// fix parents
 	for(auto& win : proj.windows) {
 		for(auto& c : win.children) {
@@ -3064,7 +3222,7 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 			}
 		}
 		for(auto& owin : proj.windows) {
-			if(owin.wrapped.name != win.wrapped.name && any_layout_contains_window(owin.layout, win.wrapped.name)) {
+			if(owin.wrapped.name != win.wrapped.name && any_layout_contains_window(owin, owin.layout, win.wrapped.name)) {
 				win.wrapped.parent = owin.wrapped.name;
 				win.wrapped.parent_is_layout = true;
 			}
@@ -3083,6 +3241,195 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 
 	auto project_name = fs::native_to_utf8(proj.project_name);
 
+	if(proj.bake_layouts) {
+		result += "struct " + project_name + "_baked_child {\n";
+		result += "\t" "std::string_view name;\n";
+		result += "\t" "int16_t x_pos; int16_t y_pos; int16_t x_size; int16_t y_size;\n";
+		result += "\t" "std::string_view texture; std::string_view alt_texture; std::string_view text_key; std::string_view tooltip_text_key;\n";
+		result += "\t" "int16_t border_size; float text_scale;\n";
+		result += "\t" "aui_text_type text_type; text::alignment text_alignment; text::text_color text_color;\n";
+		result += "\t" "int16_t template_id; int16_t icon_id;\n";
+		result += "\t" "ogl::color3f table_divider_color; ogl::color4f table_highlight_color;\n";
+		result += "};\n";
+		result += "struct " + project_name + "_baked_layout_level {\n";
+		result += "\t" "int16_t size_x; int16_t size_y; int16_t margin_top; int16_t margin_bottom; int16_t margin_left; int16_t margin_right; int16_t template_id;\n";
+		result += "\t" "uint8_t line_alignment; uint8_t line_internal_alignment; uint8_t type; uint8_t page_animation; uint8_t interline_spacing; bool paged;\n";
+		result += "\t" "int32_t first_item; int32_t item_count;\n";
+		result += "};\n";
+		result += "struct " + project_name + "_baked_layout_item {\n";
+		result += "\t" "layout_item_types type;\n";
+		result += "\t" "int16_t target; // control, window, generator or level index; the glue or texture layer type\n";
+		result += "\t" "int16_t abs_x; int16_t abs_y; int16_t amount;\n";
+		result += "\t" "bool absolute_position; bool fill_x; bool fill_y;\n";
+		result += "\t" "std::string_view name; // of a scripted control, or the texture of a texture layer\n";
+		result += "};\n";
+	}
+
+	// the rows made by generators and drop down lists live in blocks that never move, each made in place the first time it is needed
+	// indexing gives the element's address, like the vectors of unique_ptrs used before
+	// each block holds twice the rows of the one before it, up to 256, so a short list keeps one small block while a long one
+	// is laid out from a few large ones; a reserve made while the pool is empty sizes the first block to hold all it asks for
+	result += "template<typename T>\n";
+	result += "class " + project_name + "_element_pool {\n";
+	result += "\t" "struct alignas(T) slot { std::byte bytes[sizeof(T)]; };\n";
+	result += "\t" "std::vector<std::unique_ptr<slot[]>> blocks;\n";
+	result += "\t" "size_t count = 0;\n";
+	result += "\t" "size_t capacity = 0;\n";
+	result += "\t" "int32_t first_block_shift = 4;\n";
+	result += "\t" "int32_t last_block_shift = 8;\n";
+	result += "\t" "std::byte* storage(size_t i) const {\n";
+	result += "\t" "\t" "auto doublings = last_block_shift - first_block_shift;\n";
+	result += "\t" "\t" "auto doubling_rows = ((size_t(2) << doublings) - 1) << first_block_shift;\n";
+	result += "\t" "\t" "if(i < doubling_rows) {\n";
+	result += "\t" "\t" "\t" "auto b = std::bit_width((i >> first_block_shift) + 1) - 1;\n";
+	result += "\t" "\t" "\t" "return blocks[b][i - (((size_t(1) << b) - 1) << first_block_shift)].bytes;\n";
+	result += "\t" "\t" "}\n";
+	result += "\t" "\t" "i -= doubling_rows;\n";
+	result += "\t" "\t" "return blocks[doublings + 1 + (i >> last_block_shift)][i & ((size_t(1) << last_block_shift) - 1)].bytes;\n";
+	result += "\t" "}\n";
+	result += "public:\n";
+	result += "\t" + project_name + "_element_pool() = default;\n";
+	result += "\t" + project_name + "_element_pool(" + project_name + "_element_pool const&) = delete;\n";
+	result += "\t" + project_name + "_element_pool& operator=(" + project_name + "_element_pool const&) = delete;\n";
+	result += "\t" "~" + project_name + "_element_pool() {\n";
+	result += "\t" "\t" "for(size_t i = count; i-- > 0; )\n";
+	result += "\t" "\t" "\t" "(*this)[i]->~T();\n";
+	result += "\t" "}\n";
+	result += "\t" "T* operator[](size_t i) const {\n";
+	result += "\t" "\t" "return std::launder(reinterpret_cast<T*>(storage(i)));\n";
+	result += "\t" "}\n";
+	result += "\t" "size_t size() const { return count; }\n";
+	result += "\t" "bool empty() const { return count == 0; }\n";
+	result += "\t" "T* emplace_back(sys::state& state) {\n";
+	result += "\t" "\t" "if(count == capacity) {\n";
+	result += "\t" "\t" "\t" "auto block_size = size_t(1) << std::min(first_block_shift + int32_t(blocks.size()), last_block_shift);\n";
+	result += "\t" "\t" "\t" "blocks.emplace_back(new slot[block_size]);\n";
+	result += "\t" "\t" "\t" "capacity += block_size;\n";
+	result += "\t" "\t" "}\n";
+	result += "\t" "\t" "auto ptr = new (storage(count)) T();\n";
+	result += "\t" "\t" "++count;\n";
+	result += "\t" "\t" "ptr->on_create(state);\n";
+	result += "\t" "\t" "return ptr;\n";
+	result += "\t" "}\n";
+	result += "\t" "// makes elements ahead of time, so that they are not made while the list is first shown; the generators and drop down\n";
+	result += "\t" "// lists call this at the end of their on_create with the _prewarm count that the on_create section may set\n";
+	result += "\t" "void reserve(sys::state& state, size_t n) {\n";
+	result += "\t" "\t" "if(blocks.empty()) {\n";
+	result += "\t" "\t" "\t" "while((size_t(1) << first_block_shift) < n)\n";
+	result += "\t" "\t" "\t" "\t" "++first_block_shift;\n";
+	result += "\t" "\t" "\t" "last_block_shift = std::max(first_block_shift, last_block_shift);\n";
+	result += "\t" "\t" "}\n";
+	result += "\t" "\t" "while(count < n)\n";
+	result += "\t" "\t" "\t" "emplace_back(state);\n";
+	result += "\t" "}\n";
+	result += "};\n";
+
+	// the background and text of plain controls are drawn here instead of in a copy made for each of them
+	// a control's render passes its own members along with what it looks like
+	result += "enum class " + project_name + "_background : uint8_t { texture, bordered, repeated_border, repeated_corner, progress_bar };\n";
+	result += "struct " + project_name + "_control_look {\n";
+	result += "\t" + project_name + "_background background = " + project_name + "_background::texture;\n";
+	result += "\t" "bool interactable = false;\n";
+	result += "\t" "bool ignore_rtl = false;\n";
+	result += "};\n";
+	result += "void " + project_name + "_render_background(sys::state& state, ui::element_base& self, int32_t x, int32_t y, " + project_name + "_control_look look, bool disabled, bool active, dcon::texture_id& background_texture, std::string_view texture_key, dcon::texture_id& alt_background_texture, std::string_view alt_texture_key, float amount) noexcept {\n";
+	result += "\t" "auto cmod = ui::get_color_modification(&self == state.ui_state.under_mouse, disabled, look.interactable);\n";
+	result += "\t" "auto rtl = look.ignore_rtl ? false : state_is_rtl(state);\n";
+	result += "\t" "auto& base_data = self.base_data;\n";
+	result += "\t" "switch(look.background) {\n";
+	result += "\t" "\t" "case " + project_name + "_background::texture:\n";
+	result += "\t" "\t" "\t" "ogl::render_textured_rect(state, cmod, float(x), float(y), float(base_data.size.x), float(base_data.size.y), active ? ogl::get_late_load_texture_handle(state, alt_background_texture, alt_texture_key) : ogl::get_late_load_texture_handle(state, background_texture, texture_key), base_data.get_rotation(), false, rtl);\n";
+	result += "\t" "\t" "\t" "break;\n";
+	result += "\t" "\t" "case " + project_name + "_background::bordered:\n";
+	result += "\t" "\t" "\t" "ogl::render_bordered_rect(state, cmod, amount, float(x), float(y), float(base_data.size.x), float(base_data.size.y), active ? ogl::get_late_load_texture_handle(state, alt_background_texture, alt_texture_key) : ogl::get_late_load_texture_handle(state, background_texture, texture_key), base_data.get_rotation(), false, rtl);\n";
+	result += "\t" "\t" "\t" "break;\n";
+	result += "\t" "\t" "case " + project_name + "_background::repeated_border:\n";
+	result += "\t" "\t" "\t" "ogl::render_rect_with_repeated_border(state, cmod, float(" + std::to_string(proj.grid_size) + "), float(x), float(y), float(base_data.size.x), float(base_data.size.y), ogl::get_late_load_texture_handle(state, background_texture, texture_key), base_data.get_rotation(), false, rtl);\n";
+	result += "\t" "\t" "\t" "break;\n";
+	result += "\t" "\t" "case " + project_name + "_background::repeated_corner:\n";
+	result += "\t" "\t" "\t" "ogl::render_rect_with_repeated_corner(state, cmod, float(" + std::to_string(proj.grid_size) + "), float(x), float(y), float(base_data.size.x), float(base_data.size.y), ogl::get_late_load_texture_handle(state, background_texture, texture_key), base_data.get_rotation(), false, rtl);\n";
+	result += "\t" "\t" "\t" "break;\n";
+	result += "\t" "\t" "case " + project_name + "_background::progress_bar:\n";
+	result += "\t" "\t" "\t" "ogl::render_progress_bar(state, cmod, amount, float(x), float(y), float(base_data.size.x), float(base_data.size.y), ogl::get_late_load_texture_handle(state, alt_background_texture, alt_texture_key), ogl::get_late_load_texture_handle(state, background_texture, texture_key), base_data.get_rotation(), false, rtl);\n";
+	result += "\t" "\t" "\t" "break;\n";
+	result += "\t" "}\n";
+	result += "}\n";
+	result += "void " + project_name + "_render_text(sys::state& state, ui::element_base& self, int32_t x, int32_t y, " + project_name + "_control_look look, bool disabled, text::layout& internal_layout, bool text_is_header, float text_scale, text::text_color text_color) noexcept {\n";
+	result += "\t" "if(internal_layout.contents.empty()) return;\n";
+	result += "\t" "auto fh = text::make_font_id(state, text_is_header, text_scale * " + std::to_string(proj.grid_size * 2) + ");\n";
+	result += "\t" "auto linesz = state.font_collection.line_height(state, fh); \n";
+	result += "\t" "if(linesz == 0.0f) return;\n";
+	result += "\t" "auto ycentered = (self.base_data.size.y - linesz) / 2;\n";
+	result += "\t" "auto cmod = ui::get_color_modification(&self == state.ui_state.under_mouse, disabled, look.interactable); \n";
+	result += "\t" "for(auto& t : internal_layout.contents) {\n";
+	result += "\t" "\t" "ui::render_text_chunk(state, t, float(x) + t.x, float(y + int32_t(ycentered)),  fh, ui::get_text_color(state, text_color), cmod);\n";
+	result += "\t" "}\n";
+	result += "}\n";
+
+	// a template background, drawn from one small render of its corners and edges when it is nine-slice and the element has room
+	// for them; the middle cell of that render is repeated by the runtime's repeated border drawing
+	// it is only emitted when some background in the templates is nine-slice, since it needs a runtime whose template
+	// backgrounds carry nine_slice_border; the border is given in pixels of the render, which is made at the ui scale, as
+	// the editor does
+	if(nine_slice_backgrounds) {
+		result += "// needs a runtime that loads nine_slice_border into its template backgrounds\n";
+		result += "void " + project_name + "_render_template_background(sys::state& state, int32_t bg_id, float x, float y, float width, float height, int32_t grid_size) noexcept {\n";
+		result += "\t" "auto& bg = state.ui_templates.backgrounds[bg_id];\n";
+		result += "\t" "auto cells = 2 * bg.nine_slice_border + 1;\n";
+		result += "\t" "if(bg.nine_slice_border > 0 && width >= float(cells * grid_size) && height >= float(cells * grid_size))\n";
+		result += "\t" "\t" "ogl::render_rect_with_repeated_border(state, ogl::color_modification::none, float(bg.nine_slice_border * grid_size) * state.user_settings.ui_scale, x, y, width, height, bg.renders.get_render(state, float(cells), float(cells), grid_size, state.user_settings.ui_scale), ui::rotation::upright, false, false);\n";
+		result += "\t" "else\n";
+		result += "\t" "\t" "ogl::render_textured_rect_direct(state, x, y, width, height, bg.renders.get_render(state, width / float(grid_size), height / float(grid_size), grid_size, state.user_settings.ui_scale));\n";
+		result += "}\n";
+	}
+
+	bool any_sortable = false;
+	for(auto& win : proj.windows) {
+		for(auto g : make_generators_list(win, win.layout)) {
+			for(auto& i : g->inserts) {
+				if(i.sortable)
+					any_sortable = true;
+			}
+		}
+	}
+	if(any_sortable) {
+		// sorts pointers to the options instead of the variants holding them, and then moves each value into its place once
+		// when only a few rows are out of order (such as after a few of them changed) an insertion sort puts them back
+		result += "template<typename option_t, typename value_t, typename compare_t>\n";
+		result += "void " + project_name + "_sort_values(std::vector<value_t>& values, size_t start, size_t end, compare_t&& compare) {\n";
+		// checking that they are still in order, which they usually are, allocates nothing
+		result += "\t" "size_t descents = 0;\n";
+		result += "\t" "for(size_t k = start + 1; k < end; ++k) {\n";
+		result += "\t" "\t" "if(compare(*std::get_if<option_t>(&values[k]), *std::get_if<option_t>(&values[k - 1])))\n";
+		result += "\t" "\t" "\t" "++descents;\n";
+		result += "\t" "}\n";
+		result += "\t" "if(descents == 0)\n";
+		result += "\t" "\t" "return;\n";
+		result += "\t" "struct entry { option_t const* option; uint32_t index; };\n";
+		result += "\t" "std::vector<entry> order;\n";
+		result += "\t" "order.reserve(end - start);\n";
+		result += "\t" "for(size_t k = start; k < end; ++k)\n";
+		result += "\t" "\t" "order.push_back(entry{ std::get_if<option_t>(&values[k]), uint32_t(k - start) });\n";
+		result += "\t" "auto less = [&](entry const& a, entry const& b) { return compare(*a.option, *b.option); };\n";
+		result += "\t" "if(descents <= 8) {\n";
+		result += "\t" "\t" "for(size_t k = 1; k < order.size(); ++k) {\n";
+		result += "\t" "\t" "\t" "auto e = order[k];\n";
+		result += "\t" "\t" "\t" "size_t j = k;\n";
+		result += "\t" "\t" "\t" "for(; j > 0 && less(e, order[j - 1]); --j)\n";
+		result += "\t" "\t" "\t" "\t" "order[j] = order[j - 1];\n";
+		result += "\t" "\t" "\t" "order[j] = e;\n";
+		result += "\t" "\t" "}\n";
+		result += "\t" "} else {\n";
+		result += "\t" "\t" "sys::merge_sort(order.begin(), order.end(), less);\n";
+		result += "\t" "}\n";
+		result += "\t" "std::vector<value_t> sorted;\n";
+		result += "\t" "sorted.reserve(order.size());\n";
+		result += "\t" "for(auto& e : order)\n";
+		result += "\t" "\t" "sorted.push_back(std::move(values[start + e.index]));\n";
+		result += "\t" "std::move(sorted.begin(), sorted.end(), values.begin() + start);\n";
+		result += "}\n";
+	}
+
 	// predeclare
 	for(auto& win : proj.windows) {
 		for(auto& c : win.children) {
@@ -3097,7 +3444,7 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 			result += element_type_declarations(project_name, win, c, old_code, proj);
 		}
 
-		auto gens = make_generators_list(win.layout);
+		auto gens = make_generators_list(win, win.layout);
 		for(auto g : gens) {
 			result += "struct " + project_name + "_" + win.wrapped.name + "_" + g->name + "_t : public layout_generator {\n";
 			result += "// BEGIN " + win.wrapped.name + "::" + g->name + "::variables\n";
@@ -3129,7 +3476,7 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 					if(inserts.header.size() > 0 && std::find(header_list.begin(), header_list.end(), inserts.header) == header_list.end()) {
 						header_list.push_back(inserts.header);
 					}
-					result += "\t" "std::vector<std::unique_ptr<ui::element_base>> " + inserts.name + "_pool;\n";
+					result += "\t" + project_name + "_element_pool<" + project_name + "_" + inserts.name + "_t> " + inserts.name + "_pool;\n";
 					result += "\t" "int32_t " + inserts.name + "_pool_used = 0;\n";
 					if(insert_params.size() >= 2) {
 						insert_params.pop_back();
@@ -3139,11 +3486,38 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 				}
 			}
 			for(auto& h : header_list) {
-				result += "\t" "std::vector<std::unique_ptr<ui::element_base>> " + h + "_pool;\n";
+				result += "\t" + project_name + "_element_pool<" + project_name + "_" + h + "_t> " + h + "_pool;\n";
 				result += "\t" "int32_t " + h + "_pool_used = 0;\n";
 			}
 
+			for(auto& name : generator_pool_names(proj, *g))
+				result += "\t" "size_t " + name + "_pool_prewarm = 0; // rows made at the end of on_create; the on_create section may set it\n";
+
 			result += "\t" "std::vector<std::variant<std::monostate" + insert_types + ">> values;\n";
+			result += "\t" "uint32_t values_generation = 0; // bumped by the add_ functions; code changing values in some other way should bump it too\n";
+			bool has_sortable = false;
+			for(auto& i : g->inserts)
+				has_sortable = has_sortable || i.sortable;
+			if(has_sortable) {
+				result += "\t" "// the values are checked to be in order on every update, since the comparisons can read the game state; set this when\n";
+				result += "\t" "// they read only the values, and every change to the values goes through the add_ functions or bumps values_generation,\n";
+				result += "\t" "// to skip even the check while neither the values nor the sort directions change\n";
+				result += "\t" "bool sort_only_when_values_change = false;\n";
+			}
+			for(auto& i : g->inserts) {
+				if(!i.sortable)
+					continue;
+				if(auto w = window_from_name(proj, i.name); w) {
+					if(auto t = table_from_name(proj, w->wrapped.table_connection); t) {
+						// what the values of this type were last sorted for
+						result += "\t" "uint32_t " + i.name + "_sorted_generation = 0;\n";
+						for(auto& col : t->table_columns) {
+							if(col.internal_data.sortable)
+								result += "\t" "int8_t " + i.name + "_" + col.internal_data.column_name + "_sorted_direction = 0;\n";
+						}
+					}
+				}
+			}
 
 			result += "\t" "void on_create(sys::state& state, layout_window_element* container);\n";
 			result += "\t" "void update(sys::state& state, layout_window_element* container);\n";
@@ -3176,7 +3550,7 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 			if (!is_lua_element(c))
 				result += "\t" "std::unique_ptr<" + element_class_name(project_name, win, c) + "> " + c.name + ";\n";
 		}
-		auto gens = make_generators_list(win.layout);
+		auto gens = make_generators_list(win, win.layout);
 		for(auto g : gens) {
 			result += "\t" + project_name + "_" + win.wrapped.name + "_" + g->name + "_t " + g->name + ";\n";
 		}
@@ -3244,7 +3618,9 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 			}
 		}
 
-		if(win.layout.contents.size() > 0)
+		if(win.layout.contents.size() > 0 && proj.bake_layouts)
+			result += "\t" "void create_layout_level(sys::state& state, layout_level& lvl, int32_t level_index);\n";
+		else if(win.layout.contents.size() > 0)
 			result += "\t" "void create_layout_level(sys::state& state, layout_level& lvl, char const* ldata, size_t sz);\n";
 		result += "\t" "void on_create(sys::state& state) noexcept override;\n";
 		if(win.wrapped.template_id == -1)
@@ -3260,7 +3636,7 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 		}
 
 		if(win.wrapped.template_id != -1) {
-			if(any_layout_paged(win.layout)) {
+			if(any_layout_paged(win, win.layout)) {
 				result += "\t" "ui::message_result test_mouse(sys::state& state, int32_t x, int32_t y, ui::mouse_probe_type type) noexcept override {\n";
 				result += "\t" "\t" "return ui::message_result::consumed;\n";
 				result += "\t" "}\n";
@@ -3268,7 +3644,7 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 		} else {
 			result += "\t" "ui::message_result test_mouse(sys::state& state, int32_t x, int32_t y, ui::mouse_probe_type type) noexcept override {\n";
 			if(win.wrapped.background != background_type::none) {
-				if(any_layout_paged(win.layout))
+				if(any_layout_paged(win, win.layout))
 					result += "\t" "\t" "return ui::message_result::consumed;\n";
 				else
 					result += "\t" "\t" "return (type == ui::mouse_probe_type::scroll ? ui::message_result::unseen : ui::message_result::consumed);\n";
@@ -3386,7 +3762,7 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 		};
 
 		// generator functions
-		auto gens = make_generators_list(win.layout);
+		auto gens = make_generators_list(win, win.layout);
 
 		for(auto g : gens) {
 			std::string insert_params;
@@ -3415,6 +3791,7 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 				if(found) {
 					result += "void " + project_name + "_" + win.wrapped.name + "_" + g->name + "_t::add_" + inserts.name + "(" + insert_params + ") {\n";
 					result += "\t" "values.emplace_back(" + inserts.name + "_option{" + insert_vals + "});\n";
+					result += "\t" "++values_generation;\n";
 					result += "}\n";
 				}
 			}
@@ -3427,6 +3804,8 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 				result += it->second.text;
 			}
 			result += "// END\n";
+			for(auto& name : generator_pool_names(proj, *g))
+				result += "\t" + name + "_pool.reserve(state, " + name + "_pool_prewarm);\n";
 			result += "}\n";
 
 			result += "void  " + project_name + "_" + win.wrapped.name + "_" + g->name + "_t::update(sys::state& state, layout_window_element* parent) {\n";
@@ -3449,7 +3828,17 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 								if(col.internal_data.sortable)
 									result += "\t" "if(table_source->" + t->name + "_" + col.internal_data.column_name + "_sort_direction != 0) work_to_do = true;\n";
 							}
-							result += "\t" "if(work_to_do) {\n"; // if work to do
+							// unless asked to trust values_generation, the values are always checked, which costs one comparison per row
+							// when they are still in order
+							result += "\t" "bool sort_changed = !sort_only_when_values_change || values_generation != " + i.name + "_sorted_generation;\n";
+							result += "\t" + i.name + "_sorted_generation = values_generation;\n";
+							for(auto& col : t->table_columns) {
+								if(col.internal_data.sortable) {
+									result += "\t" "if(table_source->" + t->name + "_" + col.internal_data.column_name + "_sort_direction != " + i.name + "_" + col.internal_data.column_name + "_sorted_direction) sort_changed = true;\n";
+									result += "\t" + i.name + "_" + col.internal_data.column_name + "_sorted_direction = table_source->" + t->name + "_" + col.internal_data.column_name + "_sort_direction;\n";
+								}
+							}
+							result += "\t" "if(work_to_do && sort_changed) {\n"; // if work to do
 							// sort ranges of insert
 							result += "\t" "\t" "for(size_t i = 0; i < values.size(); ) {\n"; // loop over values
 							result += "\t" "\t" "\t" "if(std::holds_alternative<" + i.name + "_option>(values[i])) {\n"; // if holds type
@@ -3459,9 +3848,7 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 							for(auto& col : t->table_columns) {
 								if(col.internal_data.sortable) {
 									result += "\t" "\t" "\t" "\t" "if(table_source->" + t->name + "_" + col.internal_data.column_name + "_sort_direction != 0) {\n";
-									result +=  "\t" "\t" "\t" "\t" "\t" "sys::merge_sort(values.begin() + start_i, values.begin() + i, [&](auto const& raw_a, auto const& raw_b){\n";
-									result +=  "\t" "\t" "\t" "\t" "\t" "\t" "auto const& a = std::get<" + i.name + "_option>(raw_a);\n";
-									result +=  "\t" "\t" "\t" "\t" "\t" "\t" "auto const& b = std::get<" + i.name + "_option>(raw_b);\n";
+									result +=  "\t" "\t" "\t" "\t" "\t" + project_name + "_sort_values<" + i.name + "_option>(values, start_i, i, [&](" + i.name + "_option const& a, " + i.name + "_option const& b){\n";
 									result +=  "\t" "\t" "\t" "\t" "\t" "\t" "int8_t result = 0;\n";
 									result += "// BEGIN " + win.wrapped.name + "::" + g->name + "::" + t->name + "::sort::" + col.internal_data.column_name + "\n";
 									if(auto it = old_code.found_code.find(win.wrapped.name + "::" + g->name + "::" + t->name + "::sort::" + col.internal_data.column_name); it != old_code.found_code.end()) {
@@ -3515,15 +3902,15 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 
 				result += "\t" "if(std::holds_alternative<" + inserts.name + "_option>(values[index])) {\n";
 				if(inserts.header.size() > 0)
-					result += "\t" "\t" "if(" + inserts.header + "_pool.empty()) " + inserts.header + "_pool.emplace_back(make_" + project_name + "_" + inserts.header + "(state));\n";
-				result += "\t" "\t" "if(" + inserts.name + "_pool.empty()) " + inserts.name + "_pool.emplace_back(make_" + project_name + "_" + inserts.name + "(state));\n";
+					result += "\t" "\t" "if(" + inserts.header + "_pool.empty()) " + inserts.header + "_pool.emplace_back(state);\n";
+				result += "\t" "\t" "if(" + inserts.name + "_pool.empty()) " + inserts.name + "_pool.emplace_back(state);\n";
 
 				if(inserts.header.size() > 0) {
 					result += "\t" "\t" "if(index == 0 || first_in_section || (true" + shared_header_test + ")) {\n";
 					result += "\t" "\t" "\t" "if(destination) {\n";
 
-					result += "\t" "\t" "\t" "\t" "if(" + inserts.header + "_pool.size() <= size_t(" + inserts.header + "_pool_used)) " + inserts.header + "_pool.emplace_back(make_" + project_name + "_" + inserts.header + "(state));\n";
-					result += "\t" "\t" "\t" "\t" "if(" + inserts.name + "_pool.size() <= size_t(" + inserts.name + "_pool_used)) " + inserts.name + "_pool.emplace_back(make_" + project_name + "_" + inserts.name + "(state));\n";
+					result += "\t" "\t" "\t" "\t" "if(" + inserts.header + "_pool.size() <= size_t(" + inserts.header + "_pool_used)) " + inserts.header + "_pool.emplace_back(state);\n";
+					result += "\t" "\t" "\t" "\t" "if(" + inserts.name + "_pool.size() <= size_t(" + inserts.name + "_pool_used)) " + inserts.name + "_pool.emplace_back(state);\n";
 
 					result += "\t" "\t" "\t" "\t" + inserts.header + "_pool[" + inserts.header + "_pool_used]->base_data.position.x = int16_t(x);\n";
 					result += "\t" "\t" "\t" "\t" + inserts.header + "_pool[" + inserts.header + "_pool_used]->base_data.position.y = int16_t(y);\n";
@@ -3532,14 +3919,14 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 					result += "\t" "\t" "\t" "\t" "\t" + inserts.header + "_pool[" + inserts.header + "_pool_used]->impl_on_update(state);\n";
 					result += "\t" "\t" "\t" "\t" "\t" + inserts.header + "_pool[" + inserts.header + "_pool_used]->impl_on_reset_text(state);\n";
 					result += "\t" "\t" "\t" "\t" "}\n";
-					result += "\t" "\t" "\t" "\t" "destination->children.push_back(" + inserts.header + "_pool[" + inserts.header + "_pool_used].get());\n";
+					result += "\t" "\t" "\t" "\t" "destination->children.push_back(" + inserts.header + "_pool[" + inserts.header + "_pool_used]);\n";
 
 					for(auto& window : proj.windows) {
 						if(window.wrapped.name == inserts.header) {
 							if(window.wrapped.template_id != -1 && !window.alternates.empty()) {
-								result += "\t" "\t" "\t" "((" + project_name + "_" + inserts.header + "_t*)(" + inserts.header + "_pool[" + inserts.header + "_pool_used].get()))->set_alternate(alternate);\n";
+								result += "\t" "\t" "\t" + inserts.header + "_pool[" + inserts.header + "_pool_used]->set_alternate(alternate);\n";
 							} else if(window.wrapped.has_alternate_bg) {
-								result += "\t" "\t" "\t" "((" + project_name + "_" + inserts.header + "_t*)(" + inserts.header + "_pool[" + inserts.header + "_pool_used].get()))->is_active = alternate;\n";
+								result += "\t" "\t" "\t" + inserts.header + "_pool[" + inserts.header + "_pool_used]->is_active = alternate;\n";
 							}
 						}
 					}
@@ -3547,17 +3934,17 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 					result += "\t" "\t" "\t" "\t" + inserts.name + "_pool[" + inserts.name + "_pool_used]->base_data.position.x = int16_t(x);\n";
 					result += "\t" "\t" "\t" "\t" + inserts.name + "_pool[" + inserts.name + "_pool_used]->base_data.position.y = int16_t(y +  " + inserts.header + "_pool[0]->base_data.size.y + " + std::to_string(inserts.inter_item_space) + ");\n";
 					result += "\t" "\t" "\t" "\t" + inserts.name + "_pool[" + inserts.name + "_pool_used]->parent = destination;\n";
-					result += "\t" "\t" "\t" "\t" "destination->children.push_back(" + inserts.name + "_pool[" + inserts.name + "_pool_used].get());\n";
+					result += "\t" "\t" "\t" "\t" "destination->children.push_back(" + inserts.name + "_pool[" + inserts.name + "_pool_used]);\n";
 
 					for(auto& window : proj.windows) {
 						if(window.wrapped.name == inserts.name) {
 							for(auto& dm : window.wrapped.members) {
-								result += "\t" "\t" "\t"  "\t" "((" + project_name + "_" + inserts.name + "_t*)(" + inserts.name + "_pool[" + inserts.name + "_pool_used].get()))->" + dm.name + " = std::get<" + inserts.name + "_option>(values[index])." + dm.name + ";\n";
+								result += "\t" "\t" "\t"  "\t" + inserts.name + "_pool[" + inserts.name + "_pool_used]->" + dm.name + " = std::get<" + inserts.name + "_option>(values[index])." + dm.name + ";\n";
 							}
 							if(window.wrapped.template_id != -1 && !window.alternates.empty()) {
-								result += "\t" "\t" "\t" "((" + project_name + "_" + inserts.name + "_t*)(" + inserts.name + "_pool[" + inserts.name + "_pool_used].get()))->set_alternate(!alternate);\n";
+								result += "\t" "\t" "\t" + inserts.name + "_pool[" + inserts.name + "_pool_used]->set_alternate(!alternate);\n";
 							} else if(window.wrapped.has_alternate_bg) {
-								result += "\t" "\t" "\t" "((" + project_name + "_" + inserts.name + "_t*)(" + inserts.name + "_pool[" + inserts.name + "_pool_used].get()))->is_active = !alternate;\n";
+								result += "\t" "\t" "\t" + inserts.name + "_pool[" + inserts.name + "_pool_used]->is_active = !alternate;\n";
 							}
 						}
 					}
@@ -3585,22 +3972,22 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 
 				result += "\t" "\t" "if(destination) {\n";
 
-				result += "\t" "\t" "\t" "if(" + inserts.name + "_pool.size() <= size_t(" + inserts.name + "_pool_used)) " + inserts.name + "_pool.emplace_back(make_" + project_name + "_" + inserts.name + "(state));\n";
+				result += "\t" "\t" "\t" "if(" + inserts.name + "_pool.size() <= size_t(" + inserts.name + "_pool_used)) " + inserts.name + "_pool.emplace_back(state);\n";
 
 				result += "\t" "\t" "\t" + inserts.name + "_pool[" + inserts.name + "_pool_used]->base_data.position.x = int16_t(x);\n";
 				result += "\t" "\t" "\t" + inserts.name + "_pool[" + inserts.name + "_pool_used]->base_data.position.y = int16_t(y);\n";
 				result += "\t" "\t" "\t" + inserts.name + "_pool[" + inserts.name + "_pool_used]->parent = destination;\n";
-				result += "\t" "\t" "\t" "destination->children.push_back(" + inserts.name + "_pool[" + inserts.name + "_pool_used].get());\n";
+				result += "\t" "\t" "\t" "destination->children.push_back(" + inserts.name + "_pool[" + inserts.name + "_pool_used]);\n";
 
 				for(auto& window : proj.windows) {
 					if(window.wrapped.name == inserts.name) {
 						for(auto& dm : window.wrapped.members) {
-							result += "\t" "\t" "\t" "((" + project_name + "_" + inserts.name + "_t*)(" + inserts.name + "_pool[" + inserts.name + "_pool_used].get()))->" + dm.name + " = std::get<" + inserts.name + "_option>(values[index])." + dm.name + ";\n";
+							result += "\t" "\t" "\t" + inserts.name + "_pool[" + inserts.name + "_pool_used]->" + dm.name + " = std::get<" + inserts.name + "_option>(values[index])." + dm.name + ";\n";
 						}
 						if(window.wrapped.template_id != -1 && !window.alternates.empty()) {
-							result += "\t" "\t" "\t" "((" + project_name + "_" + inserts.name + "_t*)(" + inserts.name + "_pool[" + inserts.name + "_pool_used].get()))->set_alternate(alternate);\n";
+							result += "\t" "\t" "\t" + inserts.name + "_pool[" + inserts.name + "_pool_used]->set_alternate(alternate);\n";
 						} else if(window.wrapped.has_alternate_bg) {
-							result += "\t" "\t" "\t" "((" + project_name + "_" + inserts.name + "_t*)(" + inserts.name + "_pool[" + inserts.name + "_pool_used].get()))->is_active = alternate;\n";
+							result += "\t" "\t" "\t" + inserts.name + "_pool[" + inserts.name + "_pool_used]->is_active = alternate;\n";
 						}
 					}
 				}
@@ -3649,7 +4036,7 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 			if (is_lua_element(c))
 				continue;
 
-			result += element_member_functions(project_name, win, c, old_code, proj);
+			result += element_member_functions(project_name, win, c, old_code, proj, nine_slice_backgrounds);
 		}
 
 		// window functions
@@ -3856,7 +4243,125 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 		result += "}\n";
 
 
-		if(win.layout.contents.size() > 0) {
+		if(win.layout.contents.size() > 0 && proj.bake_layouts) {
+			auto table_prefix = project_name + "_" + win.wrapped.name;
+			result += baked_layout_tables(project_name, proj, win, gens);
+			result += "void " + project_name + "_" + win.wrapped.name + "_t::create_layout_level(sys::state& state, layout_level& lvl, int32_t level_index) {\n";
+			result += "\t" "auto const& level = " + table_prefix + "_layout_levels[level_index];\n";
+			result += "\t" "lvl.size_x = level.size_x;\n";
+			result += "\t" "lvl.size_y = level.size_y;\n";
+			result += "\t" "lvl.margin_top = level.margin_top;\n";
+			result += "\t" "lvl.margin_bottom = level.margin_bottom;\n";
+			result += "\t" "lvl.margin_left = level.margin_left;\n";
+			result += "\t" "lvl.margin_right = level.margin_right;\n";
+			result += "\t" "lvl.line_alignment = decltype(lvl.line_alignment)(level.line_alignment);\n";
+			result += "\t" "lvl.line_internal_alignment = decltype(lvl.line_internal_alignment)(level.line_internal_alignment);\n";
+			result += "\t" "lvl.type = decltype(lvl.type)(level.type);\n";
+			result += "\t" "lvl.page_animation = decltype(lvl.page_animation)(level.page_animation);\n";
+			result += "\t" "lvl.interline_spacing = level.interline_spacing;\n";
+			result += "\t" "lvl.paged = level.paged;\n";
+			result += "\t" "if(lvl.paged) {\n";
+			result += "\t" "\t" "lvl.page_controls = std::make_unique<page_buttons>();\n";
+			result += "\t" "\t" "lvl.page_controls->for_layout = &lvl;\n";
+			result += "\t" "\t" "lvl.page_controls->parent = this;\n";
+			result += "\t" "\t" "lvl.page_controls->base_data.size.x = int16_t(grid_size * 10);\n";
+			result += "\t" "\t" "lvl.page_controls->base_data.size.y = int16_t(grid_size * 2);\n";
+			result += "\t" "}\n";
+			result += "\t" "lvl.template_id = level.template_id;\n";
+			result += "\t" "if(lvl.template_id == -1 && window_template != -1)\n";
+			result += "\t" "\t" "lvl.template_id = int16_t(state.ui_templates.window_t[window_template].layout_region_definition);\n";
+			result += "\t" "for(int32_t i = level.first_item; i < level.first_item + level.item_count; ++i) {\n";
+			result += "\t" "\t" "auto const& item = " + table_prefix + "_layout_items[i];\n";
+			result += "\t" "\t" "switch(item.type) {\n";
+			result += "\t" "\t" "\t" "case layout_item_types::texture_layer:\n";
+			result += "\t" "\t" "\t" "{\n";
+			result += "\t" "\t" "\t" "\t" "texture_layer temp;\n";
+			result += "\t" "\t" "\t" "\t" "temp.texture_type = decltype(temp.texture_type)(item.target);\n";
+			result += "\t" "\t" "\t" "\t" "temp.texture = item.name;\n";
+			result += "\t" "\t" "\t" "\t" "lvl.contents.emplace_back(std::move(temp));\n";
+			result += "\t" "\t" "\t" "} break;\n";
+
+			result += "\t" "\t" "\t" "case layout_item_types::control2:\n";
+			result += "\t" "\t" "\t" "{\n";
+			result += "\t" "\t" "\t" "\t" "layout_control temp;\n";
+			result += "\t" "\t" "\t" "\t" "temp.abs_x = item.abs_x;\n";
+			result += "\t" "\t" "\t" "\t" "temp.abs_y = item.abs_y;\n";
+			result += "\t" "\t" "\t" "\t" "temp.absolute_position = item.absolute_position;\n";
+			result += "\t" "\t" "\t" "\t" "temp.fill_x = item.fill_x;\n";
+			result += "\t" "\t" "\t" "\t" "temp.fill_y = item.fill_y;\n";
+			result += "\t" "\t" "\t" "\t" "temp.ptr = nullptr;\n";
+			result += "\t" "\t" "\t" "\t" "switch(item.target) {\n";
+			for(size_t k = 0; k < win.children.size(); ++k) {
+				if(!is_lua_element(win.children[k]))
+					result += "\t" "\t" "\t" "\t" "\t" "case " + std::to_string(k) + ": temp.ptr = " + win.children[k].name + ".get(); break;\n";
+			}
+			if(!proj.omit_lua) {
+				result += "\t" "\t" "\t" "\t" "\t" "default:\n";
+				result += "\t" "\t" "\t" "\t" "\t" "{\n";
+				result += "\t" "\t" "\t" "\t" "\t" "\t" "auto found = scripted_elements.find(std::string{ item.name });\n";
+				result += "\t" "\t" "\t" "\t" "\t" "\t" "if (found != scripted_elements.end()) {\n";
+				result += "\t" "\t" "\t" "\t" "\t" "\t" "\t" "temp.ptr = found->second.get();\n";
+				result += "\t" "\t" "\t" "\t" "\t" "\t" "}\n";
+				result += "\t" "\t" "\t" "\t" "\t" "} break;\n";
+			} else {
+				result += "\t" "\t" "\t" "\t" "\t" "default: break;\n";
+			}
+			result += "\t" "\t" "\t" "\t" "}\n";
+			result += "\t" "\t" "\t" "\t" "lvl.contents.emplace_back(std::move(temp));\n";
+			result += "\t" "\t" "\t" "} break;\n";
+
+			result += "\t" "\t" "\t" "case layout_item_types::window2:\n";
+			result += "\t" "\t" "\t" "{\n";
+			result += "\t" "\t" "\t" "\t" "layout_window temp;\n";
+			result += "\t" "\t" "\t" "\t" "temp.abs_x = item.abs_x;\n";
+			result += "\t" "\t" "\t" "\t" "temp.abs_y = item.abs_y;\n";
+			result += "\t" "\t" "\t" "\t" "temp.absolute_position = item.absolute_position;\n";
+			result += "\t" "\t" "\t" "\t" "temp.fill_x = item.fill_x;\n";
+			result += "\t" "\t" "\t" "\t" "temp.fill_y = item.fill_y;\n";
+			result += "\t" "\t" "\t" "\t" "switch(item.target) {\n";
+			for(size_t k = 0; k < proj.windows.size(); ++k) {
+				if(any_layout_contains_window(win, win.layout, proj.windows[k].wrapped.name))
+					result += "\t" "\t" "\t" "\t" "\t" "case " + std::to_string(k) + ": temp.ptr = make_" + project_name + "_" + proj.windows[k].wrapped.name + "(state); break;\n";
+			}
+			result += "\t" "\t" "\t" "\t" "\t" "default: break;\n";
+			result += "\t" "\t" "\t" "\t" "}\n";
+			result += "\t" "\t" "\t" "\t" "lvl.contents.emplace_back(std::move(temp));\n";
+			result += "\t" "\t" "\t" "} break;\n";
+
+			result += "\t" "\t" "\t" "case layout_item_types::glue:\n";
+			result += "\t" "\t" "\t" "{\n";
+			result += "\t" "\t" "\t" "\t" "layout_glue temp;\n";
+			result += "\t" "\t" "\t" "\t" "temp.type = decltype(temp.type)(item.target);\n";
+			result += "\t" "\t" "\t" "\t" "temp.amount = item.amount;\n";
+			result += "\t" "\t" "\t" "\t" "lvl.contents.emplace_back(std::move(temp));\n";
+			result += "\t" "\t" "\t" "} break;\n";
+
+			result += "\t" "\t" "\t" "case layout_item_types::generator2:\n";
+			result += "\t" "\t" "\t" "{\n";
+			result += "\t" "\t" "\t" "\t" "generator_instance temp;\n";
+			result += "\t" "\t" "\t" "\t" "switch(item.target) {\n";
+			for(size_t k = 0; k < gens.size(); ++k) {
+				result += "\t" "\t" "\t" "\t" "\t" "case " + std::to_string(k) + ": temp.generator = &" + gens[k]->name + "; break;\n";
+			}
+			result += "\t" "\t" "\t" "\t" "\t" "default: break;\n";
+			result += "\t" "\t" "\t" "\t" "}\n";
+			result += "\t" "\t" "\t" "\t" "lvl.contents.emplace_back(std::move(temp));\n";
+			result += "\t" "\t" "\t" "} break;\n";
+
+			result += "\t" "\t" "\t" "case layout_item_types::layout:\n";
+			result += "\t" "\t" "\t" "{\n";
+			result += "\t" "\t" "\t" "\t" "sub_layout temp;\n";
+			result += "\t" "\t" "\t" "\t" "temp.layout = std::make_unique<layout_level>();\n";
+			result += "\t" "\t" "\t" "\t" "create_layout_level(state, *temp.layout, item.target);\n";
+			result += "\t" "\t" "\t" "\t" "lvl.contents.emplace_back(std::move(temp));\n";
+			result += "\t" "\t" "\t" "} break;\n";
+
+			result += "\t" "\t" "\t" "default: break;\n";
+			result += "\t" "\t" "}\n"; // end switch
+
+			result += "\t" "}\n"; // end loop over contents
+			result += "}\n";
+		} else if(win.layout.contents.size() > 0) {
 			result += "void " + project_name + "_" + win.wrapped.name + "_t::create_layout_level(sys::state& state, layout_level& lvl, char const* ldata, size_t sz) {\n";
 			result += "\t" "serialization::in_buffer buffer(ldata, sz);\n";
 			result += "\t" "buffer.read(lvl.size_x); \n";
@@ -4026,149 +4531,262 @@ std::string generate_project_code(open_project_t& proj, code_snippets& old_code)
 		}
 
 		//ON CREATE
+		if(proj.bake_layouts)
+			result += baked_children_table(project_name, proj, win);
 		result += "void " + project_name + "_" + win.wrapped.name + "_t::on_create(sys::state& state) noexcept {\n";
 
-		result += "\t" "auto window_bytes = state.ui_state.new_ui_windows.find(std::string(\"" + project_name + "::" + win.wrapped.name + "\"));\n";
-		result += "\t" "if(window_bytes == state.ui_state.new_ui_windows.end()) std::abort();\n";
-		result += "\t" "std::vector<sys::aui_pending_bytes> pending_children;\n";
-		result += "\t" "auto win_data = read_window_bytes(window_bytes->second.data, window_bytes->second.size, pending_children);\n";
-		result += "\t" "base_data.position.x = win_data.x_pos;\n";
-		result += "\t" "base_data.position.y = win_data.y_pos;\n";
-		result += "\t" "base_data.size.x = win_data.x_size;\n";
-		result += "\t" "base_data.size.y = win_data.y_size;\n";
-		result += "\t" "base_data.flags = uint8_t(win_data.orientation);\n";
+		if(proj.bake_layouts) {
+			result += "\t" "base_data.position.x = int16_t(" + std::to_string(win.wrapped.x_pos) + ");\n";
+			result += "\t" "base_data.position.y = int16_t(" + std::to_string(win.wrapped.y_pos) + ");\n";
+			result += "\t" "base_data.size.x = int16_t(" + std::to_string(win.wrapped.x_size) + ");\n";
+			result += "\t" "base_data.size.y = int16_t(" + std::to_string(win.wrapped.y_size) + ");\n";
+			result += "\t" "base_data.flags = uint8_t(" + std::to_string(int32_t(win.wrapped.orientation)) + ");\n";
 
-		if(win.wrapped.template_id != -1) {
-			result += "\t" "layout_window_element::initialize_template(state, win_data.template_id, win_data.grid_size, win_data.auto_close_button);\n";
-		} else {
-			if(win.wrapped.background == background_type::existing_gfx) {
-				result += "\t"  "gfx_key = win_data.texture;\n";
-				result += "\t" "if(auto it = state.ui_state.gfx_by_name.find(state.lookup_key(gfx_key)); it != state.ui_state.gfx_by_name.end()) {\n";
-				result += "\t" "\t" "background_gid = it->second;\n";
-				result += "\t" "}\n";
-			} else if(background_type_is_textured(win.wrapped.background)) {
-				result += "\t"   "texture_key = win_data.texture;\n";
-				if(background_type_requires_border_width(win.wrapped.background)) {
-					result += "\t"  "\t"  "border_size = win_data.border_size;\n";
+			if(win.wrapped.template_id != -1) {
+				result += "\t" "layout_window_element::initialize_template(state, " + std::to_string(win.wrapped.template_id) + ", int16_t(" + std::to_string(proj.grid_size) + "), " + code_bool(win.wrapped.auto_close_button) + ");\n";
+			} else {
+				if(win.wrapped.background == background_type::existing_gfx) {
+					result += "\t"  "gfx_key = " + code_string(win.wrapped.texture) + ";\n";
+					result += "\t" "if(auto it = state.ui_state.gfx_by_name.find(state.lookup_key(gfx_key)); it != state.ui_state.gfx_by_name.end()) {\n";
+					result += "\t" "\t" "background_gid = it->second;\n";
+					result += "\t" "}\n";
+				} else if(background_type_is_textured(win.wrapped.background)) {
+					result += "\t"   "texture_key = " + code_string(win.wrapped.texture) + ";\n";
+					if(background_type_requires_border_width(win.wrapped.background)) {
+						result += "\t"  "border_size = int16_t(" + std::to_string(win.wrapped.border_size) + ");\n";
+					}
+					if(win.wrapped.has_alternate_bg) {
+						result += "\t"   "alt_texture_key = " + code_string(win.wrapped.alternate_bg) + ";\n";
+					}
 				}
-				if(win.wrapped.has_alternate_bg) {
-					result += "\t"   "alt_texture_key = win_data.alt_texture;\n";
+			}
+
+			if(win.wrapped.updates_while_hidden) {
+				result += "\t"  "ui::element_base::flags |= ui::element_base::wants_update_when_hidden_mask;\n";
+			}
+
+			// children are created last to first, as they are when taken from the back of the pending list, each from its row
+			// of the table
+			std::vector<std::string> child_blocks;
+			for(auto& c : win.children) {
+				if(is_lua_element(c) && proj.omit_lua)
+					continue;
+				std::string block = "\t" "\t" "{ // " + c.name + "\n";
+				block += "\t" "\t" "\t" "auto const& child_data = " + project_name + "_" + win.wrapped.name + "_children[" + std::to_string(child_blocks.size()) + "];\n";
+				if(is_lua_element(c)) {
+					block += "\t" "\t" "\t" "std::string str_name {child_data.name};\n";
+					block += "\t" "\t" "\t" "scripted_elements[str_name] = std::make_unique<ui::lua_scripted_element>();\n";
+					block += "\t" "\t" "\t" "auto cptr = scripted_elements[str_name].get();\n";
+					block += "\t" "\t" "\t" "cptr->base_data.position.x = child_data.x_pos;\n";
+					block += "\t" "\t" "\t" "cptr->base_data.position.y = child_data.y_pos;\n";
+					block += "\t" "\t" "\t" "cptr->base_data.size.x = child_data.x_size;\n";
+					block += "\t" "\t" "\t" "cptr->base_data.size.y = child_data.y_size;\n";
+					block += "\t" "\t" "\t" "cptr->texture_key = child_data.texture;\n";
+					block += "\t" "\t" "\t" "cptr->text_scale = child_data.text_scale;\n";
+					block += "\t" "\t" "\t" "cptr->text_is_header = (child_data.text_type == aui_text_type::header);\n";
+					block += "\t" "\t" "\t" "cptr->text_alignment = child_data.text_alignment;\n";
+					block += "\t" "\t" "\t" "cptr->text_color = child_data.text_color;\n";
+					block += "\t" "\t" "\t" "cptr->on_update_lname = child_data.text_key;\n";
+					block += "\t" "\t" "\t" "if(child_data.tooltip_text_key.length() > 0) {\n";
+					block += "\t" "\t" "\t" "\t" "cptr->tooltip_key = state.lookup_key(child_data.tooltip_text_key);\n";
+					block += "\t" "\t" "\t" "}\n";
+					block += "\t" "\t" "\t" "cptr->parent = this;\n";
+					block += "\t" "\t" "\t" "cptr->on_create(state);\n";
+					block += "\t" "\t" "\t" "children.push_back(cptr);\n";
+				} else {
+					block += element_initialize_child(project_name, win, c, proj);
+				}
+				block += "\t" "\t" "}\n";
+				// written for the body of the data-driven loop, which is a level deeper
+				std::string dedented;
+				for(size_t line = 0; line < block.size(); ) {
+					auto end = block.find('\n', line);
+					dedented.append(block, line + (block[line] == '\t' ? 1 : 0), end + 1 - line - (block[line] == '\t' ? 1 : 0));
+					line = end + 1;
+				}
+				child_blocks.push_back(std::move(dedented));
+			}
+			for(auto it = child_blocks.rbegin(); it != child_blocks.rend(); ++it)
+				result += *it;
+
+			// the colors and alignment of the columns are already the initial values of their members
+			auto tabs = tables_in_window(proj, win);
+			for(auto t : tabs) {
+				if(t->ascending_sort_icon.size() > 0)
+					result += "\t" + t->name + "_ascending_icon_key = " + code_string(t->ascending_sort_icon) + ";\n";
+				if(t->descending_sort_icon.size() > 0)
+					result += "\t" + t->name + "_descending_icon_key = " + code_string(t->descending_sort_icon) + ";\n";
+				int32_t running_w_total = 0;
+				for(auto& col : t->table_columns) {
+					if(col.internal_data.cell_type == table_cell_type::text) {
+						if(col.display_data.header_key.size() > 0)
+							result += "\t" + t->name + "_" + col.internal_data.column_name + "_header_text_key = " + code_string(col.display_data.header_key) + ";\n";
+						if(col.display_data.header_tooltip_key.size() > 0 && !col.internal_data.has_dy_header_tooltip)
+							result += "\t" + t->name + "_" + col.internal_data.column_name + "_header_tooltip_key = " + code_string(col.display_data.header_tooltip_key) + ";\n";
+						if(col.display_data.cell_tooltip_key.length() > 0 && !col.internal_data.has_dy_cell_tooltip)
+							result += "\t" + t->name + "_" + col.internal_data.column_name + "_column_tooltip_key = " + code_string(col.display_data.cell_tooltip_key) + ";\n";
+					}
+					result += "\t" + t->name + "_" + col.internal_data.column_name + "_column_start = int16_t(" + std::to_string(running_w_total) + ");\n";
+					result += "\t" + t->name + "_" + col.internal_data.column_name + "_column_width = int16_t(" + std::to_string(col.display_data.width) + ");\n";
+					running_w_total += col.display_data.width;
 				}
 			}
-		}
 
-		if(win.wrapped.updates_while_hidden) {
-			result += "\t"  "ui::element_base::flags |= ui::element_base::wants_update_when_hidden_mask;\n";
-		}
+			for(auto g : gens) {
+				result += "\t" + g->name + ".on_create(state, this);\n";
+			}
 
-		result += "\t" "while(!pending_children.empty()) {\n";
-		result += "\t" "\t" "auto child_data = read_child_bytes(pending_children.back().data, pending_children.back().size);\n";
-		for(auto& c : win.children) {
-			if (is_lua_element(c)) {
-				continue;
+			if(win.layout.contents.size() > 0) {
+				bool page_textures = win.wrapped.template_id == -1 && (win.wrapped.page_left_texture.size() > 0 || win.wrapped.page_right_texture.size() > 0);
+				result += "\t" "page_left_texture_key = " + code_string(page_textures ? win.wrapped.page_left_texture : std::string{ }) + ";\n";
+				result += "\t" "page_right_texture_key = " + code_string(page_textures ? win.wrapped.page_right_texture : std::string{ }) + ";\n";
+				result += "\t" "page_text_color = text::text_color::" + color_to_name(page_textures ? win.wrapped.page_text_color : text_color::black) + ";\n";
+				result += "\t" "create_layout_level(state, layout, 0);\n";
 			}
-			result += "\t" "\t" "if(child_data.name == \"" + c.name + "\") {\n";
-			result += element_initialize_child(project_name, win, c, proj);
-			result += "\t" "\t" "} else \n";
-		}
-		auto tabs = tables_in_window(proj, win);
-		for(auto t : tabs) {
-			result += "\t" "\t" "if(child_data.name == \".tab" + t->name + "\") {\n";
-			result += "\t" "\t" "\t" "int16_t running_w_total = 0;\n";
-			result += "\t" "\t" "\t" "auto tbuffer = serialization::in_buffer(pending_children.back().data, pending_children.back().size);\n";
-			result += "\t" "\t" "\t" "auto main_section = tbuffer.read_section();\n";
-			result += "\t" "\t" "\t" "main_section.read<std::string_view>(); // discard name \n";
-			if(t->ascending_sort_icon.size() > 0)
-				result += "\t" "\t" "\t" + t->name + "_ascending_icon_key = main_section.read<std::string_view>();\n";
-			else
-				result += "\t" "\t" "\t" "main_section.read<std::string_view>(); // discard\n";
-			if(t->descending_sort_icon.size() > 0)
-				result += "\t" "\t" "\t" + t->name + "_descending_icon_key = main_section.read<std::string_view>();\n";
-			else
-				result += "\t" "\t" "\t" "main_section.read<std::string_view>(); // discard\n";
-			if(t->template_id != -1) {
-				result += "\t" "\t" "\t" "main_section.read<ogl::color3f>();\n";
-				// result += "\t" "\t" "\t" + t->name + "_template_id = main_section.read<int32_t>();\n";
-				// result += "\t" "\t" "\t" + t->name + "_ink_color = state.ui_templates.tables_t[" + t->name + "_template_id].table_color;\n";
+		} else {
+			result += "\t" "auto window_bytes = state.ui_state.new_ui_windows.find(std::string(\"" + project_name + "::" + win.wrapped.name + "\"));\n";
+			result += "\t" "if(window_bytes == state.ui_state.new_ui_windows.end()) std::abort();\n";
+			result += "\t" "std::vector<sys::aui_pending_bytes> pending_children;\n";
+			result += "\t" "auto win_data = read_window_bytes(window_bytes->second.data, window_bytes->second.size, pending_children);\n";
+			result += "\t" "base_data.position.x = win_data.x_pos;\n";
+			result += "\t" "base_data.position.y = win_data.y_pos;\n";
+			result += "\t" "base_data.size.x = win_data.x_size;\n";
+			result += "\t" "base_data.size.y = win_data.y_size;\n";
+			result += "\t" "base_data.flags = uint8_t(win_data.orientation);\n";
+
+			if(win.wrapped.template_id != -1) {
+				result += "\t" "layout_window_element::initialize_template(state, win_data.template_id, win_data.grid_size, win_data.auto_close_button);\n";
 			} else {
-				result += "\t" "\t" "\t" "main_section.read(" + t->name + "_divider_color);\n";
+				if(win.wrapped.background == background_type::existing_gfx) {
+					result += "\t"  "gfx_key = win_data.texture;\n";
+					result += "\t" "if(auto it = state.ui_state.gfx_by_name.find(state.lookup_key(gfx_key)); it != state.ui_state.gfx_by_name.end()) {\n";
+					result += "\t" "\t" "background_gid = it->second;\n";
+					result += "\t" "}\n";
+				} else if(background_type_is_textured(win.wrapped.background)) {
+					result += "\t"   "texture_key = win_data.texture;\n";
+					if(background_type_requires_border_width(win.wrapped.background)) {
+						result += "\t"  "\t"  "border_size = win_data.border_size;\n";
+					}
+					if(win.wrapped.has_alternate_bg) {
+						result += "\t"   "alt_texture_key = win_data.alt_texture;\n";
+					}
+				}
 			}
-			result += "\t" "\t" "\t" "auto col_section = tbuffer.read_section();\n";
-			for(auto& col : t->table_columns) {
-				if(col.internal_data.cell_type == table_cell_type::text) {
-					if(col.display_data.header_key.size() > 0)
-						result += "\t" "\t" "\t" + t->name + "_" + col.internal_data.column_name + "_header_text_key = col_section.read<std::string_view>();\n";
-					else
+
+			if(win.wrapped.updates_while_hidden) {
+				result += "\t"  "ui::element_base::flags |= ui::element_base::wants_update_when_hidden_mask;\n";
+			}
+
+			result += "\t" "while(!pending_children.empty()) {\n";
+			result += "\t" "\t" "auto child_data = read_child_bytes(pending_children.back().data, pending_children.back().size);\n";
+			for(auto& c : win.children) {
+				if (is_lua_element(c)) {
+					continue;
+				}
+				result += "\t" "\t" "if(child_data.name == \"" + c.name + "\") {\n";
+				result += element_initialize_child(project_name, win, c, proj);
+				result += "\t" "\t" "\t" "pending_children.pop_back(); continue;\n";
+				result += "\t" "\t" "} else \n";
+			}
+			auto tabs = tables_in_window(proj, win);
+			for(auto t : tabs) {
+				result += "\t" "\t" "if(child_data.name == \".tab" + t->name + "\") {\n";
+				result += "\t" "\t" "\t" "int16_t running_w_total = 0;\n";
+				result += "\t" "\t" "\t" "auto tbuffer = serialization::in_buffer(pending_children.back().data, pending_children.back().size);\n";
+				result += "\t" "\t" "\t" "auto main_section = tbuffer.read_section();\n";
+				result += "\t" "\t" "\t" "main_section.read<std::string_view>(); // discard name \n";
+				if(t->ascending_sort_icon.size() > 0)
+					result += "\t" "\t" "\t" + t->name + "_ascending_icon_key = main_section.read<std::string_view>();\n";
+				else
+					result += "\t" "\t" "\t" "main_section.read<std::string_view>(); // discard\n";
+				if(t->descending_sort_icon.size() > 0)
+					result += "\t" "\t" "\t" + t->name + "_descending_icon_key = main_section.read<std::string_view>();\n";
+				else
+					result += "\t" "\t" "\t" "main_section.read<std::string_view>(); // discard\n";
+				if(t->template_id != -1) {
+					result += "\t" "\t" "\t" "main_section.read<ogl::color3f>();\n";
+					// result += "\t" "\t" "\t" + t->name + "_template_id = main_section.read<int32_t>();\n";
+					// result += "\t" "\t" "\t" + t->name + "_ink_color = state.ui_templates.tables_t[" + t->name + "_template_id].table_color;\n";
+				} else {
+					result += "\t" "\t" "\t" "main_section.read(" + t->name + "_divider_color);\n";
+				}
+				result += "\t" "\t" "\t" "auto col_section = tbuffer.read_section();\n";
+				for(auto& col : t->table_columns) {
+					if(col.internal_data.cell_type == table_cell_type::text) {
+						if(col.display_data.header_key.size() > 0)
+							result += "\t" "\t" "\t" + t->name + "_" + col.internal_data.column_name + "_header_text_key = col_section.read<std::string_view>();\n";
+						else
+							result += "\t" "\t" "\t" "col_section.read<std::string_view>(); // discard\n";
+						if(col.display_data.header_tooltip_key.size() > 0 && !col.internal_data.has_dy_header_tooltip)
+							result += "\t" "\t" "\t" + t->name + "_" + col.internal_data.column_name + "_header_tooltip_key = col_section.read<std::string_view>();\n";
+						else
+							result += "\t" "\t" "\t" "col_section.read<std::string_view>(); // discard\n";
+						if(col.display_data.cell_tooltip_key.length() > 0 && !col.internal_data.has_dy_cell_tooltip)
+							result += "\t" "\t" "\t" + t->name + "_" + col.internal_data.column_name + "_column_tooltip_key = col_section.read<std::string_view>();\n";
+						else
+							result += "\t" "\t" "\t" "col_section.read<std::string_view>(); // discard\n";
+						result += "\t" "\t" "\t" + t->name + "_" + col.internal_data.column_name + "_column_start = running_w_total;\n";
+						result += "\t" "\t" "\t" "col_section.read(" + t->name + "_" + col.internal_data.column_name + "_column_width);\n";
+						result += "\t" "\t" "\t" "running_w_total += " + t->name + "_" + col.internal_data.column_name + "_column_width;\n";
+						result += "\t" "\t" "\t" "col_section.read(" + t->name + "_" + col.internal_data.column_name + "_column_text_color);\n";
+						result += "\t" "\t" "\t" "col_section.read(" + t->name + "_" + col.internal_data.column_name + "_header_text_color);\n";
+						result += "\t" "\t" "\t" "col_section.read(" + t->name + "_" + col.internal_data.column_name + "_text_alignment);\n";
+					} else {
 						result += "\t" "\t" "\t" "col_section.read<std::string_view>(); // discard\n";
-					if(col.display_data.header_tooltip_key.size() > 0 && !col.internal_data.has_dy_header_tooltip)
-						result += "\t" "\t" "\t" + t->name + "_" + col.internal_data.column_name + "_header_tooltip_key = col_section.read<std::string_view>();\n";
-					else
 						result += "\t" "\t" "\t" "col_section.read<std::string_view>(); // discard\n";
-					if(col.display_data.cell_tooltip_key.length() > 0 && !col.internal_data.has_dy_cell_tooltip)
-						result += "\t" "\t" "\t" + t->name + "_" + col.internal_data.column_name + "_column_tooltip_key = col_section.read<std::string_view>();\n";
-					else
 						result += "\t" "\t" "\t" "col_section.read<std::string_view>(); // discard\n";
-					result += "\t" "\t" "\t" + t->name + "_" + col.internal_data.column_name + "_column_start = running_w_total;\n";
-					result += "\t" "\t" "\t" "col_section.read(" + t->name + "_" + col.internal_data.column_name + "_column_width);\n";
-					result += "\t" "\t" "\t" "running_w_total += " + t->name + "_" + col.internal_data.column_name + "_column_width;\n";
-					result += "\t" "\t" "\t" "col_section.read(" + t->name + "_" + col.internal_data.column_name + "_column_text_color);\n";
-					result += "\t" "\t" "\t" "col_section.read(" + t->name + "_" + col.internal_data.column_name + "_header_text_color);\n";
-					result += "\t" "\t" "\t" "col_section.read(" + t->name + "_" + col.internal_data.column_name + "_text_alignment);\n";
-				} else {
-					result += "\t" "\t" "\t" "col_section.read<std::string_view>(); // discard\n";
-					result += "\t" "\t" "\t" "col_section.read<std::string_view>(); // discard\n";
-					result += "\t" "\t" "\t" "col_section.read<std::string_view>(); // discard\n";
 
-					result += "\t" "\t" "\t" + t->name + "_" + col.internal_data.column_name + "_column_start = running_w_total;\n";
-					result += "\t" "\t" "\t" "col_section.read(" + t->name + "_" + col.internal_data.column_name + "_column_width);\n";
-					result += "\t" "\t" "\t" "running_w_total += " + t->name + "_" + col.internal_data.column_name + "_column_width;\n";
+						result += "\t" "\t" "\t" + t->name + "_" + col.internal_data.column_name + "_column_start = running_w_total;\n";
+						result += "\t" "\t" "\t" "col_section.read(" + t->name + "_" + col.internal_data.column_name + "_column_width);\n";
+						result += "\t" "\t" "\t" "running_w_total += " + t->name + "_" + col.internal_data.column_name + "_column_width;\n";
 
-					result += "\t" "\t" "\t" "col_section.read<text::text_color>(); // discard\n";
-					result += "\t" "\t" "\t" "col_section.read<text::text_color>(); // discard\n";
-					result += "\t" "\t" "\t" "col_section.read<text::alignment>(); // discard\n";
+						result += "\t" "\t" "\t" "col_section.read<text::text_color>(); // discard\n";
+						result += "\t" "\t" "\t" "col_section.read<text::text_color>(); // discard\n";
+						result += "\t" "\t" "\t" "col_section.read<text::alignment>(); // discard\n";
+					}
 				}
+				result += "\t" "\t" "\t" "pending_children.pop_back(); continue;\n";
+				result += "\t" "\t" "} else \n";
 			}
-			result += "\t" "\t" "\t" "pending_children.pop_back(); continue;\n";
-			result += "\t" "\t" "} else \n";
-		}
-		if(!proj.omit_lua) {
-			result += "\t" "\t" "if (child_data.is_lua) { \n";
-			result += "\t" "\t" "\t" "std::string str_name {child_data.name};\n";
-			result += "\t" "\t" "\t" "scripted_elements[str_name] = std::make_unique<ui::lua_scripted_element>();\n";
-			result += "\t" "\t" "\t" "auto cptr = scripted_elements[str_name].get();\n";
-			result += "\t" "\t" "\t" "cptr->base_data.position.x = child_data.x_pos;\n";
-			result += "\t" "\t" "\t" "cptr->base_data.position.y = child_data.y_pos;\n";
-			result += "\t" "\t" "\t" "cptr->base_data.size.x = child_data.x_size;\n";
-			result += "\t" "\t" "\t" "cptr->base_data.size.y = child_data.y_size;\n";
-			result += "\t" "\t" "\t" "cptr->texture_key = child_data.texture;\n";
-			result += "\t" "\t" "\t" "cptr->text_scale = child_data.text_scale;\n";
-			result += "\t" "\t" "\t" "cptr->text_is_header = (child_data.text_type == aui_text_type::header);\n";
-			result += "\t" "\t" "\t" "cptr->text_alignment = child_data.text_alignment;\n";
-			result += "\t" "\t" "\t" "cptr->text_color = child_data.text_color;\n";
-			result += "\t" "\t" "\t" "cptr->on_update_lname = child_data.text_key;\n";
-			result += "\t" "\t" "\t" "if(child_data.tooltip_text_key.length() > 0) {\n";
-			result += "\t" "\t" "\t" "\t" "cptr->tooltip_key = state.lookup_key(child_data.tooltip_text_key);\n";
-			result += "\t" "\t" "\t" "}\n";
-			result += "\t" "\t" "\t" "cptr->parent = this;\n";
-			result += "\t" "\t" "\t" "cptr->on_create(state);\n";
-			result += "\t" "\t" "\t" "children.push_back(cptr);\n";
-			result += "\t" "\t" "\t" "pending_children.pop_back(); continue;\n";
-			result += "\t" "\t" "}\n";
-		} else {
-			result += "\t" "\t" "{ } \n";
-		}
-		result += "\t" "\t" "pending_children.pop_back();\n";
-		result += "\t" "}\n";
+			if(!proj.omit_lua) {
+				result += "\t" "\t" "if (child_data.is_lua) { \n";
+				result += "\t" "\t" "\t" "std::string str_name {child_data.name};\n";
+				result += "\t" "\t" "\t" "scripted_elements[str_name] = std::make_unique<ui::lua_scripted_element>();\n";
+				result += "\t" "\t" "\t" "auto cptr = scripted_elements[str_name].get();\n";
+				result += "\t" "\t" "\t" "cptr->base_data.position.x = child_data.x_pos;\n";
+				result += "\t" "\t" "\t" "cptr->base_data.position.y = child_data.y_pos;\n";
+				result += "\t" "\t" "\t" "cptr->base_data.size.x = child_data.x_size;\n";
+				result += "\t" "\t" "\t" "cptr->base_data.size.y = child_data.y_size;\n";
+				result += "\t" "\t" "\t" "cptr->texture_key = child_data.texture;\n";
+				result += "\t" "\t" "\t" "cptr->text_scale = child_data.text_scale;\n";
+				result += "\t" "\t" "\t" "cptr->text_is_header = (child_data.text_type == aui_text_type::header);\n";
+				result += "\t" "\t" "\t" "cptr->text_alignment = child_data.text_alignment;\n";
+				result += "\t" "\t" "\t" "cptr->text_color = child_data.text_color;\n";
+				result += "\t" "\t" "\t" "cptr->on_update_lname = child_data.text_key;\n";
+				result += "\t" "\t" "\t" "if(child_data.tooltip_text_key.length() > 0) {\n";
+				result += "\t" "\t" "\t" "\t" "cptr->tooltip_key = state.lookup_key(child_data.tooltip_text_key);\n";
+				result += "\t" "\t" "\t" "}\n";
+				result += "\t" "\t" "\t" "cptr->parent = this;\n";
+				result += "\t" "\t" "\t" "cptr->on_create(state);\n";
+				result += "\t" "\t" "\t" "children.push_back(cptr);\n";
+				result += "\t" "\t" "\t" "pending_children.pop_back(); continue;\n";
+				result += "\t" "\t" "}\n";
+			} else {
+				result += "\t" "\t" "{ } \n";
+			}
+			result += "\t" "\t" "pending_children.pop_back();\n";
+			result += "\t" "}\n";
 
-		for(auto g : gens) {
-			result += "\t" + g->name + ".on_create(state, this);\n";
-		}
+			for(auto g : gens) {
+				result += "\t" + g->name + ".on_create(state, this);\n";
+			}
 
-		if(win.layout.contents.size() > 0) {
-			result += "\t" "page_left_texture_key = win_data.page_left_texture;\n";
-			result += "\t" "page_right_texture_key = win_data.page_right_texture;\n";
-			result += "\t" "page_text_color = win_data.page_text_color;\n";
-			result += "\t" "create_layout_level(state, layout, win_data.layout_data, win_data.layout_data_size);\n";
+			if(win.layout.contents.size() > 0) {
+				result += "\t" "page_left_texture_key = win_data.page_left_texture;\n";
+				result += "\t" "page_right_texture_key = win_data.page_right_texture;\n";
+				result += "\t" "page_text_color = win_data.page_text_color;\n";
+				result += "\t" "create_layout_level(state, layout, win_data.layout_data, win_data.layout_data_size);\n";
+			}
 		}
 
 		result += "// BEGIN " + win.wrapped.name + "::create\n";
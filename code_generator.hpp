@@ -18,5 +18,8 @@ struct code_snippets {
 };
 
 code_snippets extract_snippets(char const* data, size_t size);
-std::string generate_project_code(open_project_t& proj, code_snippets& old_code);
+// nine_slice_backgrounds: whether any background in the project's templates is nine-slice (see
+// template_project::any_nine_slice_background); only then do table headers and stacked bar overlays draw their
+// backgrounds through the generated nine-slice helper, which needs a runtime that knows about nine_slice_border
+std::string generate_project_code(open_project_t& proj, code_snippets& old_code, bool nine_slice_backgrounds = false);
 }
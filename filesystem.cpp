@@ -1,6 +1,9 @@
 #include "filesystem.hpp"
 #include <shobjidl.h> 
 #include <memory>
+#include <thread>
+#include <mutex>
+#include <algorithm>
 
 namespace fs {
 
@@ -209,16 +212,129 @@ file::file(std::wstring const& full_path) {
         }
 }
 
-void write_file(std::wstring const& full_path, char const* file_data, uint32_t file_size) {
-        HANDLE file_handle = CreateFileW(full_path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+// the data goes to a temporary file first, which then replaces the target in one step, so a crash part
+// way through never leaves a truncated file behind
+bool write_file(std::wstring const& full_path, char const* file_data, uint32_t file_size) {
+        auto temp_path = full_path + L".tmp";
+        HANDLE file_handle = CreateFileW(temp_path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
                 FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
         if(file_handle != INVALID_HANDLE_VALUE) {
                 DWORD written_bytes = 0;
-                WriteFile(file_handle, file_data, DWORD(file_size), &written_bytes, nullptr);
-                (void)written_bytes;
+                auto result = WriteFile(file_handle, file_data, DWORD(file_size), &written_bytes, nullptr);
                 SetEndOfFile(file_handle);
+                FlushFileBuffers(file_handle);
                 CloseHandle(file_handle);
+                if(result && written_bytes == DWORD(file_size)) {
+                        if(MoveFileExW(temp_path.c_str(), full_path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+                                return true;
+                }
+                DeleteFileW(temp_path.c_str());
+        }
+        return false;
+}
+
+bool append_file(std::wstring const& full_path, char const* file_data, uint32_t file_size) {
+        HANDLE file_handle = CreateFileW(full_path.c_str(), FILE_APPEND_DATA, 0, nullptr, OPEN_ALWAYS,
+                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if(file_handle == INVALID_HANDLE_VALUE)
+                return false;
+        DWORD written_bytes = 0;
+        auto result = WriteFile(file_handle, file_data, DWORD(file_size), &written_bytes, nullptr);
+        auto flushed = FlushFileBuffers(file_handle);
+        CloseHandle(file_handle);
+        return result && flushed && written_bytes == DWORD(file_size);
+}
+
+void remove_file(std::wstring const& full_path) {
+        DeleteFileW(full_path.c_str());
+}
+
+class windows_directory_watch : public directory_watch {
+        HANDLE directory = INVALID_HANDLE_VALUE;
+        HANDLE stop_event = nullptr;
+        std::function<void()> on_change;
+        std::mutex lock;
+        std::vector<std::wstring> changes;
+        std::thread worker;
+
+        void run() {
+                alignas(DWORD) char buffer[32 * 1024];
+                OVERLAPPED overlapped{ };
+                overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+                if(!overlapped.hEvent)
+                        return;
+
+                while(true) {
+                        ResetEvent(overlapped.hEvent);
+                        if(!ReadDirectoryChangesW(directory, buffer, DWORD(sizeof(buffer)), TRUE,
+                                FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE, nullptr, &overlapped, nullptr)) {
+                                break;
+                        }
+                        HANDLE waiting_on[2] = { overlapped.hEvent, stop_event };
+                        DWORD bytes = 0;
+                        if(WaitForMultipleObjects(2, waiting_on, FALSE, INFINITE) != WAIT_OBJECT_0) {
+                                CancelIoEx(directory, &overlapped);
+                                GetOverlappedResult(directory, &overlapped, &bytes, TRUE);
+                                break;
+                        }
+                        if(!GetOverlappedResult(directory, &overlapped, &bytes, FALSE))
+                                break;
+
+                        std::vector<std::wstring> found;
+                        if(bytes == 0) { // the buffer overflowed and the individual changes were lost
+                                found.emplace_back();
+                        } else {
+                                size_t offset = 0;
+                                while(true) {
+                                        auto info = reinterpret_cast<FILE_NOTIFY_INFORMATION const*>(buffer + offset);
+                                        if(info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+                                                found.emplace_back(info->FileName, info->FileNameLength / sizeof(WCHAR));
+                                        if(info->NextEntryOffset == 0)
+                                                break;
+                                        offset += info->NextEntryOffset;
+                                }
+                        }
+                        if(found.empty())
+                                continue;
+                        {
+                                std::lock_guard<std::mutex> guard(lock);
+                                for(auto& f : found) {
+                                        if(std::find(changes.begin(), changes.end(), f) == changes.end()) // saving a file usually reports it several times
+                                                changes.push_back(std::move(f));
+                                }
+                        }
+                        if(on_change)
+                                on_change();
+                }
+                CloseHandle(overlapped.hEvent);
+        }
+public:
+        windows_directory_watch(HANDLE directory, std::function<void()>&& on_change) : directory(directory), on_change(std::move(on_change)) {
+                stop_event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+                worker = std::thread([this]() { run(); });
+        }
+        ~windows_directory_watch() override {
+                SetEvent(stop_event);
+                if(worker.joinable())
+                        worker.join();
+                CloseHandle(stop_event);
+                CloseHandle(directory);
+        }
+        void take_changes(std::vector<std::wstring>& paths) override {
+                std::lock_guard<std::mutex> guard(lock);
+                for(auto& c : changes) {
+                        paths.push_back(std::move(c));
+                }
+                changes.clear();
         }
+};
+
+std::unique_ptr<directory_watch> watch_directory(std::wstring const& directory, std::function<void()> on_change) {
+        HANDLE handle = CreateFileW(directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if(handle == INVALID_HANDLE_VALUE)
+                return nullptr;
+        return std::make_unique<windows_directory_watch>(handle, std::move(on_change));
 }
 
 std::wstring utf8_to_native(std::string_view str) {
@@ -4,6 +4,9 @@
 #include <Windows.h>
 #include <shellscalingapi.h>
 #include <string>
+#include <vector>
+#include <memory>
+#include <functional>
 
 namespace fs {
 
@@ -31,7 +34,24 @@ public:
 	}
 };
 
-void write_file(std::wstring const& full_path, char const* file_data, uint32_t file_size);
+bool write_file(std::wstring const& full_path, char const* file_data, uint32_t file_size);
+// returns false unless all of the data was written; a failed append may still have left part of it at the end of the file
+bool append_file(std::wstring const& full_path, char const* file_data, uint32_t file_size);
+void remove_file(std::wstring const& full_path);
+/*
+reports files that were created, written to or renamed somewhere below a directory
+changes are collected on a background thread, and on_change (when given) is called from that thread each time some arrive
+*/
+class directory_watch {
+public:
+	virtual ~directory_watch() { }
+	// appends the paths, relative to the watched directory, that changed since the last call
+	// an empty path means that too much changed at once to say what, so everything below the directory should be assumed changed
+	virtual void take_changes(std::vector<std::wstring>& paths) = 0;
+};
+// returns nullptr if the directory cannot be watched
+std::unique_ptr<directory_watch> watch_directory(std::wstring const& directory, std::function<void()> on_change);
+
 std::wstring utf8_to_native(std::string_view str);
 std::string native_to_utf8(std::wstring_view str);
 
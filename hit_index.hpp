@@ -0,0 +1,134 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+
+namespace canvas {
+
+struct hit_rect {
+	float x = 0.0f;
+	float y = 0.0f;
+	float w = 0.0f;
+	float h = 0.0f;
+	int32_t id = -1;
+};
+
+/*
+uniform grid over the screen-space rectangles produced by laying out the window being edited
+the rectangles are collected while rendering, and the grid is built once per frame, so that picking
+on the following frame only has to look at the handful of rectangles sharing a cell with the mouse
+*/
+
+class hit_index {
+private:
+	std::vector<hit_rect> rects;
+	std::vector<uint32_t> cell_starts;
+	std::vector<uint32_t> cell_contents;
+	float min_x = 0.0f;
+	float min_y = 0.0f;
+	float cell_w = 1.0f;
+	float cell_h = 1.0f;
+	float margin = 0.0f;
+	int32_t cells_x = 0;
+	int32_t cells_y = 0;
+public:
+	void const* owner = nullptr;
+
+	void clear(void const* new_owner, float edge_margin) {
+		owner = new_owner;
+		margin = edge_margin;
+		rects.clear();
+		cell_starts.clear();
+		cell_contents.clear();
+		cells_x = 0;
+		cells_y = 0;
+	}
+	void add(float x, float y, float w, float h, int32_t id) {
+		rects.push_back(hit_rect{ x, y, w, h, id });
+	}
+	size_t size() const {
+		return rects.size();
+	}
+	void build() {
+		cell_starts.clear();
+		cell_contents.clear();
+		cells_x = 0;
+		cells_y = 0;
+		if(rects.empty())
+			return;
+
+		// rectangles are expanded by the edge margin so that resize handles just outside a control still find it
+		float max_x = rects[0].x + rects[0].w;
+		float max_y = rects[0].y + rects[0].h;
+		min_x = rects[0].x;
+		min_y = rects[0].y;
+		for(auto& r : rects) {
+			min_x = std::min(min_x, r.x);
+			min_y = std::min(min_y, r.y);
+			max_x = std::max(max_x, r.x + r.w);
+			max_y = std::max(max_y, r.y + r.h);
+		}
+		min_x -= margin;
+		min_y -= margin;
+		max_x += margin;
+		max_y += margin;
+
+		int32_t per_side = std::clamp(int32_t(std::ceil(std::sqrt(float(rects.size())))), 1, 128);
+		cells_x = per_side;
+		cells_y = per_side;
+		cell_w = std::max(1.0f, (max_x - min_x) / float(cells_x));
+		cell_h = std::max(1.0f, (max_y - min_y) / float(cells_y));
+
+		auto cell_range = [&](hit_rect const& r, int32_t& x0, int32_t& y0, int32_t& x1, int32_t& y1) {
+			x0 = std::clamp(int32_t((r.x - margin - min_x) / cell_w), 0, cells_x - 1);
+			y0 = std::clamp(int32_t((r.y - margin - min_y) / cell_h), 0, cells_y - 1);
+			x1 = std::clamp(int32_t((r.x + r.w + margin - min_x) / cell_w), 0, cells_x - 1);
+			y1 = std::clamp(int32_t((r.y + r.h + margin - min_y) / cell_h), 0, cells_y - 1);
+		};
+
+		// counting pass, then prefix sum, then fill: the cells end up as contiguous runs of one array
+		cell_starts.resize(size_t(cells_x * cells_y + 1), 0);
+		for(auto& r : rects) {
+			int32_t x0, y0, x1, y1;
+			cell_range(r, x0, y0, x1, y1);
+			for(int32_t j = y0; j <= y1; ++j) {
+				for(int32_t i = x0; i <= x1; ++i) {
+					++cell_starts[size_t(j * cells_x + i + 1)];
+				}
+			}
+		}
+		for(size_t i = 1; i < cell_starts.size(); ++i) {
+			cell_starts[i] += cell_starts[i - 1];
+		}
+		cell_contents.resize(cell_starts.back());
+		std::vector<uint32_t> fill_position(cell_starts.begin(), cell_starts.end() - 1);
+		for(uint32_t k = 0; k < uint32_t(rects.size()); ++k) {
+			int32_t x0, y0, x1, y1;
+			cell_range(rects[k], x0, y0, x1, y1);
+			for(int32_t j = y0; j <= y1; ++j) {
+				for(int32_t i = x0; i <= x1; ++i) {
+					cell_contents[fill_position[size_t(j * cells_x + i)]++] = k;
+				}
+			}
+		}
+	}
+
+	template<typename F>
+	void for_each_at(float px, float py, F&& f) const {
+		if(cells_x == 0 || cells_y == 0)
+			return;
+		if(px < min_x || py < min_y)
+			return;
+		auto i = int32_t((px - min_x) / cell_w);
+		auto j = int32_t((py - min_y) / cell_h);
+		if(i >= cells_x || j >= cells_y)
+			return;
+		auto cell = size_t(j * cells_x + i);
+		for(auto k = cell_starts[cell]; k < cell_starts[cell + 1]; ++k) {
+			f(rects[cell_contents[k]]);
+		}
+	}
+};
+
+}
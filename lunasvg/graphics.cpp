@@ -3,6 +3,7 @@
 
 #include <cfloat>
 #include <cmath>
+#include <cstring>
 
 namespace lunasvg {
 
@@ -308,6 +309,20 @@ bool Path::isUnique() const
     return plutovg_path_get_reference_count(m_data) == 1;
 }
 
+bool Path::isEqual(const Path& path) const
+{
+    if(m_data == path.m_data)
+        return true;
+    if(m_data == nullptr || path.m_data == nullptr)
+        return false;
+    const plutovg_path_element_t* elements;
+    const plutovg_path_element_t* otherElements;
+    auto size = plutovg_path_get_elements(m_data, &elements);
+    if(size != plutovg_path_get_elements(path.m_data, &otherElements))
+        return false;
+    return size == 0 || std::memcmp(elements, otherElements, size * sizeof(plutovg_path_element_t)) == 0;
+}
+
 bool Path::parse(const char* data, size_t length)
 {
     plutovg_path_reset(ensure());
@@ -360,6 +360,7 @@ public:
     bool isEmpty() const;
     bool isUnique() const;
     bool isNull() const { return m_data == nullptr; }
+    bool isEqual(const Path& path) const;
     plutovg_path_t* data() const { return m_data; }
 
     bool parse(const char* data, size_t length);
@@ -1,5 +1,6 @@
 #include "lunasvg.h"
 #include "svgelement.h"
+#include "svggeometryelement.h"
 #include "svgrenderstate.h"
 
 #include <cstring>
@@ -325,6 +326,8 @@ const std::string& Element::getAttribute(const std::string& name) const
 void Element::setAttribute(const std::string& name, const std::string& value)
 {
     if(m_node) {
+        if(name == "id" || name == "class")
+            element()->document()->m_styleSheetMatches.clear();
         element()->setAttribute(name, value);
     }
 }
@@ -447,6 +450,15 @@ std::unique_ptr<Document> Document::loadFromData(const char* data, size_t length
     return document;
 }
 
+std::unique_ptr<Document> Document::loadFromData(const char* data, size_t length, std::function<Bitmap(std::string_view)> const& images)
+{
+    std::unique_ptr<Document> document(new Document);
+    document->image_loader = images;
+    if(!document->parse(data, length))
+        return nullptr;
+    return document;
+}
+
 float Document::width() const
 {
     return rootElement(true)->intrinsicWidth();
@@ -521,6 +533,114 @@ Element Document::documentElement() const
     return m_rootElement.get();
 }
 
+static bool collectOutline(const SVGGeometryElement* element, const Transform& transform, std::vector<ShapeOutline>& outlines)
+{
+    if(!element->markerPositions().empty())
+        return false;
+    const auto& fill = element->fill();
+    const auto& stroke = element->stroke();
+    if(fill.element() || stroke.element())
+        return false;
+    ShapeOutline outline;
+    if(fill.isRenderable())
+        outline.fill = fill.color().colorWithAlpha(fill.opacity()).value();
+    if(stroke.isRenderable()) {
+        const auto& strokeData = element->strokeData();
+        if(!strokeData.dashArray().empty())
+            return false;
+        auto xScale = transform.xScale();
+        auto yScale = transform.yScale();
+        if(std::abs(xScale - yScale) > 0.01f * std::max(xScale, yScale))
+            return false;
+        outline.stroke = stroke.color().colorWithAlpha(stroke.opacity()).value();
+        outline.strokeWidth = strokeData.lineWidth() * xScale;
+        outline.roundCaps = strokeData.lineCap() == LineCap::Round;
+        outline.squareCaps = strokeData.lineCap() == LineCap::Square;
+    }
+
+    if(outline.fill == 0 && outline.stroke == 0)
+        return true;
+    outline.evenOdd = element->fill_rule() == FillRule::EvenOdd;
+    std::array<Point, 3> points;
+    for(PathIterator it(element->path()); !it.isDone(); it.next()) {
+        auto command = it.currentSegment(points);
+        int count = 0;
+        switch(command) {
+        case PathCommand::MoveTo:
+            outline.commands.push_back(OutlineCommand::MoveTo);
+            count = 1;
+            break;
+        case PathCommand::LineTo:
+            outline.commands.push_back(OutlineCommand::LineTo);
+            count = 1;
+            break;
+        case PathCommand::CubicTo:
+            outline.commands.push_back(OutlineCommand::CubicTo);
+            count = 3;
+            break;
+        case PathCommand::Close:
+            outline.commands.push_back(OutlineCommand::Close);
+            break;
+        }
+
+        for(int i = 0; i < count; ++i) {
+            auto point = transform.mapPoint(points[i]);
+            outline.points.push_back(point.x);
+            outline.points.push_back(point.y);
+        }
+    }
+
+    outlines.push_back(std::move(outline));
+    return true;
+}
+
+static bool collectOutlines(const SVGElement* element, const Transform& parentTransform, std::vector<ShapeOutline>& outlines)
+{
+    if(element->isDisplayNone())
+        return true;
+    switch(element->id()) {
+    case ElementID::Svg:
+    case ElementID::G:
+    case ElementID::Use:
+        break;
+    case ElementID::Image:
+    case ElementID::Text:
+        return false;
+    default:
+        if(!element->isGeometryElement())
+            return true; // nothing that is drawn on its own
+        break;
+    }
+
+    if(element->clipper() || element->masker() || element->opacity() < 1.f)
+        return false;
+    auto transform = parentTransform * element->localTransform();
+    if(element->isGeometryElement()) {
+        auto geometry = static_cast<const SVGGeometryElement*>(element);
+        if(!geometry->isRenderable())
+            return true;
+        return collectOutline(geometry, transform, outlines);
+    }
+
+    for(const auto& child : element->children()) {
+        if(auto childElement = toSVGElement(child)) {
+            if(childElement->id() == ElementID::Svg)
+                return false; // its viewport would clip what it draws
+            if(!collectOutlines(childElement, transform, outlines)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool Document::outlines(std::vector<ShapeOutline>& outlines) const
+{
+    outlines.clear();
+    return collectOutlines(rootElement(true), Transform::Identity, outlines);
+}
+
 SVGRootElement* Document::rootElement(bool layoutIfNeeded) const
 {
     if(layoutIfNeeded)
@@ -662,6 +662,31 @@ private:
 
 using ElementList = std::vector<Element>;
 
+/**
+ * @brief The commands a shape's outline is made of; quadratic curves and arcs come out as cubic curves.
+ */
+enum class OutlineCommand : uint8_t {
+    MoveTo, ///< Starts a new subpath, at one point.
+    LineTo, ///< A straight line, to one point.
+    CubicTo, ///< A cubic curve, through two control points to a third.
+    Close ///< Closes the subpath, with no points.
+};
+
+/**
+ * @brief The outline of one shape the document draws, in the coordinates `Document::render` is given
+ * before its matrix is applied.
+ */
+struct ShapeOutline {
+    std::vector<OutlineCommand> commands; ///< The commands, in order.
+    std::vector<float> points; ///< The x and y of each point the commands take, in order.
+    bool evenOdd{false}; ///< Whether it is filled with the even-odd rule rather than the nonzero one.
+    uint32_t fill{0}; ///< The fill color in 0xAARRGGBB format, with the fill opacity applied; 0 if it is not filled.
+    uint32_t stroke{0}; ///< The stroke color, in the same format; 0 if it is not stroked.
+    float strokeWidth{0}; ///< The width of the stroke, in the same coordinates as the points.
+    bool roundCaps{false}; ///< Whether the ends of open subpaths are rounded.
+    bool squareCaps{false}; ///< Whether the ends of open subpaths are extended by half the stroke width.
+};
+
 class SVGRootElement;
 
 class LUNASVG_API Document {
@@ -695,6 +720,15 @@ public:
      */
     static std::unique_ptr<Document> loadFromData(const char* data, size_t length, std::function<std::pair<const void*, int>(std::string_view)> const& f);
 
+    /**
+     * @brief Load an SVG document from a string with a specified length, taking images that have already been decoded from a loader.
+     * @param data The string containing the SVG data.
+     * @param length The length of the string in bytes.
+     * @param images Called with the same reference a file loader would be given; a null bitmap leaves the image out.
+     * @return A pointer to the loaded `Document`, or `nullptr` on failure.
+     */
+    static std::unique_ptr<Document> loadFromData(const char* data, size_t length, std::function<Bitmap(std::string_view)> const& images);
+
     /**
      * @brief Applies a CSS stylesheet to the document.
      * @param content A string containing the CSS rules to apply, with comments removed.
@@ -773,11 +807,21 @@ public:
      */
     Element documentElement() const;
 
+    /**
+     * @brief Collects the outlines of the shapes the document draws, in the order they are drawn.
+     * @param outlines Receives the outlines.
+     * @return `false`, leaving `outlines` incomplete, if the document draws anything a solid fill or stroke
+     * of an outline cannot describe: images, text, gradients, patterns, clipping, masks, markers, dashes,
+     * group opacity, nested viewports, or strokes whose transform is not uniformly scaled.
+     */
+    bool outlines(std::vector<ShapeOutline>& outlines) const;
+
     Document(Document&&);
     Document& operator=(Document&&);
     ~Document();
 
     std::function<std::pair<const void*, int>(std::string_view)> file_loader;
+    std::function<Bitmap(std::string_view)> image_loader;
 
 private:
     Document();
@@ -785,9 +829,20 @@ private:
     Document& operator=(const Document&) = delete;
     SVGRootElement* rootElement(bool layoutIfNeeded = false) const;
     bool parse(const char* data, size_t length);
+
+    struct StyleSheetMatches {
+        std::string selectors;
+        size_t ruleCount;
+        std::vector<std::pair<SVGElement*, size_t>> matches; // the element and the rule, in the order they apply
+    };
+
+    static constexpr size_t maxStyleSheetMatches = 4;
+
     std::unique_ptr<SVGRootElement> m_rootElement;
+    std::vector<StyleSheetMatches> m_styleSheetMatches;
     friend class SVGURIReference;
     friend class SVGNode;
+    friend class Element;
 };
 
 } // namespace lunasvg
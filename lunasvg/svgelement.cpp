@@ -921,10 +921,25 @@ static Bitmap loadImageResource(const std::string& href, std::function<std::pair
     }
 }
 
+static Bitmap loadDecodedImage(const std::string& href, std::function<Bitmap(std::string_view)> const& f)
+{
+    std::string_view input(href);
+    if(href.compare(0, 5, "data:") == 0) {
+        auto index = input.find(',', 5);
+        if(index == std::string_view::npos)
+            return Bitmap();
+        input.remove_prefix(index + 1);
+    }
+    return f(input);
+}
+
 void SVGImageElement::parseAttribute(PropertyID id, const std::string& value)
 {
     if(id == PropertyID::Href) {
-        m_image = loadImageResource(value, document()->file_loader);
+        if(document()->image_loader)
+            m_image = loadDecodedImage(value, document()->image_loader);
+        else
+            m_image = loadImageResource(value, document()->file_loader);
     } else {
         SVGGraphicsElement::parseAttribute(id, value);
     }
@@ -1199,6 +1214,51 @@ Rect SVGMaskElement::maskBoundingBox(const SVGElement* element) const
     return maskBoundingBox.intersected(maskRect(element));
 }
 
+const SVGGeometryElement* SVGMaskElement::maskShape() const
+{
+    if(clipper() || masker())
+        return nullptr;
+    const SVGGeometryElement* maskShape = nullptr;
+    for(const auto& child : children()) {
+        auto element = toSVGElement(child);
+        if(element == nullptr || element->isDisplayNone())
+            continue;
+        auto shapeElement = toSVGGeometryElement(element);
+        if(shapeElement == nullptr || maskShape)
+            return nullptr;
+        if(!shapeElement->isRenderable())
+            continue;
+        if(shapeElement->clipper() || shapeElement->masker() || shapeElement->opacity() < 1.f)
+            return nullptr;
+        if(shapeElement->stroke().isRenderable() || !shapeElement->markerPositions().empty())
+            return nullptr;
+        const auto& fill = shapeElement->fill();
+        if(fill.element() || fill.opacity() < 1.f || !fill.color().isOpaque())
+            return nullptr;
+        if(m_mask_type == MaskType::Luminance && fill.color().value() != Color::White.value())
+            return nullptr;
+        maskShape = shapeElement;
+    }
+
+    return maskShape;
+}
+
+void SVGMaskElement::applyMaskShape(SVGRenderState& state, const SVGGeometryElement* shapeElement) const
+{
+    if(state.hasCycleReference(this))
+        return;
+    state->clipRect(maskRect(state.element()), FillRule::NonZero, state.currentTransform());
+
+    auto currentTransform = state.currentTransform();
+    if(m_maskContentUnits.value() == Units::ObjectBoundingBox) {
+        auto bbox = state.fillBoundingBox();
+        currentTransform.translate(bbox.x, bbox.y);
+        currentTransform.scale(bbox.w, bbox.h);
+    }
+
+    state->clipPath(shapeElement->path(), shapeElement->fill_rule(), currentTransform * shapeElement->localTransform());
+}
+
 void SVGMaskElement::applyMask(SVGRenderState& state) const
 {
     if(state.hasCycleReference(this))
@@ -117,6 +117,7 @@ class SVGMarkerElement;
 class SVGClipPathElement;
 class SVGMaskElement;
 class SVGPaintElement;
+class SVGGeometryElement;
 class SVGLayoutState;
 class SVGRenderState;
 
@@ -479,7 +480,9 @@ public:
 
     Rect maskRect(const SVGElement* element) const;
     Rect maskBoundingBox(const SVGElement* element) const;
+    const SVGGeometryElement* maskShape() const;
     void applyMask(SVGRenderState& state) const;
+    void applyMaskShape(SVGRenderState& state, const SVGGeometryElement* shapeElement) const;
 
     void layoutElement(const SVGLayoutState& state) final;
 
@@ -50,9 +50,12 @@ void SVGGeometryElement::layoutElement(const SVGLayoutState& state)
     m_strokeData = getStrokeData(state);
     SVGGraphicsElement::layoutElement(state);
 
-    m_path.reset();
+    // a shape that comes out the same as before keeps its path, and with it the outline the path was last stroked to
+    Path path;
     m_markerPositions.clear();
-    m_fillBoundingBox = updateShape(m_path);
+    m_fillBoundingBox = updateShape(path);
+    if(!path.isEqual(m_path))
+        m_path = std::move(path);
     updateMarkerPositions(m_markerPositions, state);
 }
 
@@ -47,6 +47,10 @@ public:
     void render(SVGRenderState& state) const override;
 
     const Path& path() const { return m_path; }
+    const SVGPaintServer& fill() const { return m_fill; }
+    const SVGPaintServer& stroke() const { return m_stroke; }
+    const StrokeData& strokeData() const { return m_strokeData; }
+    const SVGMarkerPositionList& markerPositions() const { return m_markerPositions; }
 
 private:
     Path m_path;
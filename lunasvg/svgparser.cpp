@@ -3,6 +3,7 @@
 #include "svgparserutils.h"
 
 #include <cassert>
+#include <map>
 
 namespace lunasvg {
 
@@ -901,23 +902,187 @@ bool Document::parse(const char* data, size_t length)
         return false;
     applyStyleSheet(styleSheet);
     m_rootElement->build();
+    m_styleSheetMatches.clear(); // building adds the contents of use elements
     return true;
 }
 
+// rules sorted by their rightmost compound selector, so an element is only tested against rules that could match it
+class RuleIndex {
+public:
+    explicit RuleIndex(const RuleDataList& rules);
+
+    void candidates(const SVGElement* element, std::vector<const RuleData*>& rules) const;
+
+private:
+    static void add(const std::map<std::string, std::vector<const RuleData*>, std::less<>>& buckets, const std::string_view& key, std::vector<const RuleData*>& rules);
+
+    std::map<std::string, std::vector<const RuleData*>, std::less<>> m_idRules;
+    std::map<std::string, std::vector<const RuleData*>, std::less<>> m_classRules;
+    std::map<ElementID, std::vector<const RuleData*>> m_tagRules;
+    std::vector<const RuleData*> m_universalRules;
+};
+
+RuleIndex::RuleIndex(const RuleDataList& rules)
+{
+    for(const auto& rule : rules) {
+        const auto& compound = rule.selector().back();
+        const AttributeSelector* classSelector = nullptr;
+        const AttributeSelector* idSelector = nullptr;
+        for(const auto& attributeSelector : compound.attributeSelectors) {
+            if(attributeSelector.id == PropertyID::Id && attributeSelector.matchType == AttributeSelector::MatchType::Equals) {
+                idSelector = &attributeSelector;
+            } else if(attributeSelector.id == PropertyID::Class && attributeSelector.matchType == AttributeSelector::MatchType::Includes && !attributeSelector.value.empty()) {
+                classSelector = &attributeSelector;
+            }
+        }
+
+        if(idSelector) {
+            m_idRules[idSelector->value].push_back(&rule);
+        } else if(classSelector) {
+            m_classRules[classSelector->value].push_back(&rule);
+        } else if(compound.id != ElementID::Star) {
+            m_tagRules[compound.id].push_back(&rule);
+        } else {
+            m_universalRules.push_back(&rule);
+        }
+    }
+}
+
+void RuleIndex::add(const std::map<std::string, std::vector<const RuleData*>, std::less<>>& buckets, const std::string_view& key, std::vector<const RuleData*>& rules)
+{
+    auto it = buckets.find(key);
+    if(it != buckets.end()) {
+        rules.insert(rules.end(), it->second.begin(), it->second.end());
+    }
+}
+
+void RuleIndex::candidates(const SVGElement* element, std::vector<const RuleData*>& rules) const
+{
+    rules.assign(m_universalRules.begin(), m_universalRules.end());
+    if(!m_idRules.empty()) {
+        const auto& id = element->getAttribute(PropertyID::Id);
+        if(!id.empty()) {
+            add(m_idRules, id, rules);
+        }
+    }
+
+    if(!m_classRules.empty()) {
+        std::string_view input(element->getAttribute(PropertyID::Class));
+        while(!input.empty()) {
+            skipOptionalSpaces(input);
+            std::string_view start(input);
+            while(!input.empty() && !IS_WS(input.front()))
+                input.remove_prefix(1);
+            if(start.length() > input.length()) {
+                add(m_classRules, start.substr(0, start.length() - input.length()), rules);
+            }
+        }
+    }
+
+    auto it = m_tagRules.find(element->id());
+    if(it != m_tagRules.end())
+        rules.insert(rules.end(), it->second.begin(), it->second.end());
+    // the rules are sorted, so their addresses are in the order their declarations apply; a repeated class adds a bucket twice
+    std::sort(rules.begin(), rules.end());
+    rules.erase(std::unique(rules.begin(), rules.end()), rules.end());
+}
+
+// whether a selector only depends on tags, ids, classes and the element tree, none of which a stylesheet can change
+static bool isStructuralSelector(const Selector& selector)
+{
+    for(const auto& simpleSelector : selector) {
+        for(const auto& attributeSelector : simpleSelector.attributeSelectors) {
+            if(attributeSelector.id != PropertyID::Id && attributeSelector.id != PropertyID::Class) {
+                return false;
+            }
+        }
+
+        for(const auto& pseudoClassSelector : simpleSelector.pseudoClassSelectors) {
+            for(const auto& subSelector : pseudoClassSelector.subSelectors) {
+                if(!isStructuralSelector(subSelector)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+static std::string selectorsOf(const std::string& content)
+{
+    std::string selectors;
+    int depth = 0;
+    for(auto ch : content) {
+        if(ch == '{') {
+            if(depth++ == 0)
+                selectors += ch;
+        } else if(ch == '}') {
+            if(depth > 0)
+                --depth;
+        } else if(depth == 0) {
+            selectors += ch;
+        }
+    }
+
+    return selectors;
+}
+
 void Document::applyStyleSheet(const std::string& content)
 {
     auto rules = parseStyleSheet(content);
-    if(!rules.empty()) {
-        std::sort(rules.begin(), rules.end());
-        m_rootElement->transverse([&rules](SVGElement* element) {
-            for(const auto& rule : rules) {
-                if(rule.match(element)) {
-                    for(const auto& declaration : rule.declarations()) {
-                        element->setAttribute(declaration.specificity, declaration.id, declaration.value);
-                    }
+    if(rules.empty())
+        return;
+    std::sort(rules.begin(), rules.end());
+
+    /*
+    a retained document that is styled again with the same selectors, as when only the colors change, reuses which
+    rules matched which elements; that holds as long as no selector looks at attributes a stylesheet could have set
+    */
+    auto selectors = selectorsOf(content);
+    for(const auto& matches : m_styleSheetMatches) {
+        if(matches.selectors == selectors && matches.ruleCount == rules.size()) {
+            for(const auto& match : matches.matches) {
+                for(const auto& declaration : rules[match.second].declarations()) {
+                    match.first->setAttribute(declaration.specificity, declaration.id, declaration.value);
                 }
             }
-        });
+
+            return;
+        }
+    }
+
+    bool structural = true;
+    for(const auto& rule : rules) {
+        if(!isStructuralSelector(rule.selector())) {
+            structural = false;
+            break;
+        }
+    }
+
+    StyleSheetMatches matches;
+    matches.selectors = std::move(selectors);
+    matches.ruleCount = rules.size();
+
+    RuleIndex index(rules);
+    std::vector<const RuleData*> candidates;
+    m_rootElement->transverse([&](SVGElement* element) {
+        index.candidates(element, candidates);
+        for(const auto* rule : candidates) {
+            if(rule->match(element)) {
+                if(structural)
+                    matches.matches.emplace_back(element, size_t(rule - rules.data()));
+                for(const auto& declaration : rule->declarations()) {
+                    element->setAttribute(declaration.specificity, declaration.id, declaration.value);
+                }
+            }
+        }
+    });
+
+    if(structural) {
+        if(m_styleSheetMatches.size() == maxStyleSheetMatches)
+            m_styleSheetMatches.erase(m_styleSheetMatches.begin());
+        m_styleSheetMatches.push_back(std::move(matches));
     }
 }
 
@@ -4,6 +4,10 @@
 #include <cmath>
 #include <string_view>
 #include <limits>
+#include <cstdint>
+#include <cstring>
+#include <bit>
+#include <type_traits>
 
 namespace lunasvg {
 
@@ -141,68 +145,172 @@ inline bool parseInteger(std::string_view& input, T& integer, int base = 10)
     return true;
 }
 
+/*
+the digits are gathered into an integer and scaled once by a power of ten: up to 2^24 with an exponent of at most ten
+both are exact floats, so a single float multiply or divide rounds correctly, and anything longer is scaled in double
+past 18 significant digits the rest only move the decimal point
+*/
+constexpr float floatPowersOfTen[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+constexpr double powersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+constexpr uint64_t integerPowersOfTen[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+constexpr uint64_t mantissaLimit = 100000000000000000ull;
+
+/*
+reads the digits at the start of the eight bytes at it without a branch for each one: they are found with one mask,
+shifted up so that the bytes past them turn into leading zeros and then combined into pairs, fours and finally one
+eight digit value; it returns how many digits there were and appends them to the mantissa
+*/
+inline int parseEightDigits(const char* it, uint64_t& mantissa)
+{
+    uint64_t chunk;
+    std::memcpy(&chunk, it, 8);
+    chunk ^= 0x3030303030303030ull;
+    uint64_t nonDigits = (chunk | (chunk + 0x0606060606060606ull)) & 0xF0F0F0F0F0F0F0F0ull;
+    int count = std::countr_zero(nonDigits) >> 3;
+    if(count == 0)
+        return 0;
+    chunk <<= 8 * (8 - count);
+    chunk = chunk * 10 + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FFull) * 0x000F424000000064ull)
+        + (((chunk >> 16) & 0x000000FF000000FFull) * 0x0000271000000001ull)) >> 32;
+    mantissa = mantissa * integerPowersOfTen[count] + chunk;
+    return count;
+}
+
+// appends the run of digits at it to the mantissa, eight at a time where there are eight bytes left to look at
+inline const char* parseDigits(const char* it, const char* end, uint64_t& mantissa)
+{
+    if constexpr(std::endian::native == std::endian::little) {
+        while(end - it >= 8) {
+            int count = parseEightDigits(it, mantissa);
+            it += count;
+            if(count < 8) {
+                return it;
+            }
+        }
+    }
+
+    while(it < end && IS_NUM(*it))
+        mantissa = 10 * mantissa + (*it++ - '0');
+    return it;
+}
+
+// more than 19 digits overflow the mantissa, so they are read again keeping the first 18 significant ones; the rest
+// only move the decimal point
+inline uint64_t parseLongMantissa(const char* it, const char* end, int& exponent)
+{
+    uint64_t mantissa = 0;
+    bool isFraction = false;
+    for(; it < end; ++it) {
+        if(*it == '.') {
+            isFraction = true;
+        } else if(mantissa < mantissaLimit) {
+            mantissa = 10 * mantissa + (*it - '0');
+            if(isFraction) {
+                --exponent;
+            }
+        } else if(!isFraction) {
+            ++exponent;
+        }
+    }
+
+    return mantissa;
+}
+
 template<typename T>
 inline bool parseNumber(std::string_view& input, T& number)
 {
     constexpr T maxValue = std::numeric_limits<T>::max();
-    T integer = 0;
-    T fraction = 0;
+    const char* it = input.data();
+    const char* end = it + input.size();
+    uint64_t mantissa = 0;
     int exponent = 0;
-    int sign = 1;
-    int expsign = 1;
+    bool isNegative = false;
 
-    if(!input.empty() && input.front() == '+') {
-        input.remove_prefix(1);
-    } else if(!input.empty() && input.front() == '-') {
-        input.remove_prefix(1);
-        sign = -1;
+    if(it < end && (*it == '+' || *it == '-')) {
+        isNegative = *it == '-';
+        ++it;
     }
 
-    if(input.empty() || (!IS_NUM(input.front()) && input.front() != '.'))
+    const char* digits = it;
+    it = parseDigits(it, end, mantissa);
+    int count = static_cast<int>(it - digits);
+    if(it < end && *it == '.') {
+        const char* fraction = ++it;
+        it = parseDigits(it, end, mantissa);
+        if(it == fraction)
+            return false;
+        exponent = static_cast<int>(fraction - it);
+        count += static_cast<int>(it - fraction);
+    } else if(count == 0) {
         return false;
-    if(IS_NUM(input.front())) {
-        do {
-            integer = static_cast<T>(10) * integer + (input.front() - '0');
-            input.remove_prefix(1);
-        } while(!input.empty() && IS_NUM(input.front()));
     }
 
-    if(!input.empty() && input.front() == '.') {
-        input.remove_prefix(1);
-        if(input.empty() || !IS_NUM(input.front()))
-            return false;
-        T divisor = static_cast<T>(1);
-        do {
-            fraction = static_cast<T>(10) * fraction + (input.front() - '0');
-            divisor *= static_cast<T>(10);
-            input.remove_prefix(1);
-        } while(!input.empty() && IS_NUM(input.front()));
-        fraction /= divisor;
+    if(count > 19) {
+        exponent = 0;
+        mantissa = parseLongMantissa(digits, it, exponent);
     }
 
-    if(input.size() > 1 && (input[0] == 'e' || input[0] == 'E')
-        && (input[1] != 'x' && input[1] != 'm'))
+    // an e that starts an em or ex unit is not an exponent
+    if(end - it > 1 && (it[0] == 'e' || it[0] == 'E')
+        && (it[1] != 'x' && it[1] != 'm'))
     {
-        input.remove_prefix(1);
-        if(!input.empty() && input.front() == '+')
-            input.remove_prefix(1);
-        else if(!input.empty() && input.front() == '-') {
-            input.remove_prefix(1);
-            expsign = -1;
+        ++it;
+        bool isNegativeExponent = false;
+        if(it < end && *it == '+') {
+            ++it;
+        } else if(it < end && *it == '-') {
+            ++it;
+            isNegativeExponent = true;
         }
 
-        if(input.empty() || !IS_NUM(input.front()))
+        if(it == end || !IS_NUM(*it))
             return false;
+        int value = 0;
         do {
-            exponent = 10 * exponent + (input.front() - '0');
-            input.remove_prefix(1);
-        } while(!input.empty() && IS_NUM(input.front()));
+            if(value < 10000)
+                value = 10 * value + (*it - '0');
+            ++it;
+        } while(it < end && IS_NUM(*it));
+        exponent += isNegativeExponent ? -value : value;
+    }
+
+    input.remove_prefix(it - input.data());
+    if constexpr(std::is_same_v<T, float>) {
+        if(mantissa < (1u << 24) && exponent >= -10 && exponent <= 10) {
+            float value = static_cast<float>(mantissa);
+            if(exponent < 0)
+                value /= floatPowersOfTen[-exponent];
+            else
+                value *= floatPowersOfTen[exponent];
+            number = isNegative ? -value : value;
+            return true;
+        }
+    }
+
+    double value = static_cast<double>(mantissa);
+    if(mantissa && exponent) {
+        if(exponent > 0 && exponent <= 22) {
+            value *= powersOfTen[exponent];
+        } else if(exponent < 0 && exponent >= -22) {
+            value /= powersOfTen[-exponent];
+        } else {
+            value *= std::pow(10.0, exponent);
+        }
     }
 
-    number = sign * (integer + fraction);
-    if(exponent)
-        number *= static_cast<T>(std::pow(10.0, expsign * exponent));
-    return number >= -maxValue && number <= maxValue;
+    number = static_cast<T>(isNegative ? -value : value);
+    return value <= maxValue;
 }
 
 } // namespace lunasvg
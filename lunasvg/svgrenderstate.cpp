@@ -5,13 +5,14 @@ namespace lunasvg {
 SVGBlendInfo::SVGBlendInfo(const SVGElement* element)
     : m_clipper(element->clipper())
     , m_masker(element->masker())
+    , m_maskShape(m_masker ? m_masker->maskShape() : nullptr)
     , m_opacity(element->opacity())
 {
 }
 
 bool SVGBlendInfo::requiresCompositing(SVGRenderMode mode) const
 {
-    return (m_clipper && m_clipper->requiresMasking()) || (mode == SVGRenderMode::Painting && (m_masker || m_opacity < 1.f));
+    return (m_clipper && m_clipper->requiresMasking()) || (mode == SVGRenderMode::Painting && ((m_masker && !m_maskShape) || m_opacity < 1.f));
 }
 
 bool SVGRenderState::hasCycleReference(const SVGElement* element) const
@@ -39,6 +40,10 @@ void SVGRenderState::beginGroup(const SVGBlendInfo& blendInfo)
     if(!requiresCompositing && blendInfo.clipper()) {
         blendInfo.clipper()->applyClipPath(*this);
     }
+
+    if(m_mode == SVGRenderMode::Painting && blendInfo.maskShape()) {
+        blendInfo.masker()->applyMaskShape(*this, blendInfo.maskShape());
+    }
 }
 
 void SVGRenderState::endGroup(const SVGBlendInfo& blendInfo)
@@ -51,7 +56,7 @@ void SVGRenderState::endGroup(const SVGBlendInfo& blendInfo)
     auto opacity = m_mode == SVGRenderMode::Clipping ? 1.f : blendInfo.opacity();
     if(blendInfo.clipper())
         blendInfo.clipper()->applyClipMask(*this);
-    if(m_mode == SVGRenderMode::Painting && blendInfo.masker()) {
+    if(m_mode == SVGRenderMode::Painting && blendInfo.masker() && !blendInfo.maskShape()) {
         blendInfo.masker()->applyMask(*this);
     }
 
@@ -14,17 +14,19 @@ class SVGBlendInfo {
 public:
     explicit SVGBlendInfo(const SVGElement* element);
     SVGBlendInfo(const SVGClipPathElement* clipper, const SVGMaskElement* masker, float opacity)
-        : m_clipper(clipper), m_masker(masker), m_opacity(opacity)
+        : m_clipper(clipper), m_masker(masker), m_maskShape(masker ? masker->maskShape() : nullptr), m_opacity(opacity)
     {}
 
     bool requiresCompositing(SVGRenderMode mode) const;
     const SVGClipPathElement* clipper() const { return m_clipper; }
     const SVGMaskElement* masker() const { return m_masker; }
+    const SVGGeometryElement* maskShape() const { return m_maskShape; }
     float opacity() const { return m_opacity; }
 
 private:
     const SVGClipPathElement* m_clipper;
     const SVGMaskElement* m_masker;
+    const SVGGeometryElement* m_maskShape;
     const float m_opacity;
 };
 
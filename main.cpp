@@ -30,6 +30,9 @@
 #include "stools.hpp"
 #include "code_generator.hpp"
 #include "templateproject.hpp"
+#include "hit_index.hpp"
+#include "undo_history.hpp"
+#include "autosave.hpp"
 #include <uiautomation.h>
 #include <atlbase.h>
 #include <ranges>
@@ -167,11 +170,13 @@ void load_shaders() {
 		"in vec2 tex_coord;\n"
 		"out vec4 frag_color;\n"
 		"uniform sampler2D texture_sampler;\n"
+		"uniform sampler2D tint_sampler;\n"
 		"uniform vec4 d_rect;\n"
 		"uniform float border_size;\n"
 		"uniform float grid_size;\n"
 		"uniform vec2 grid_off;\n"
 		"uniform vec3 inner_color;\n"
+		"uniform vec4 atlas_rect;\n"
 		"uniform uvec2 subroutines_index;\n"
 
 		"vec4 empty_rect(vec2 tc) {\n"
@@ -202,6 +207,37 @@ void load_shaders() {
 				"return vec4(inner_color.r, inner_color.g, inner_color.b, 1.0f);\n"
 			"\treturn texture(texture_sampler, tc);\n"
 		"}\n"
+		"vec4 tinted_texture(vec2 tc) {\n"
+			"float realx = tc.x * d_rect.z;\n"
+			"float realy = tc.y * d_rect.w;\n"
+			"if(realx <= 2.5 || realy <= 2.5 || realx >= (d_rect.z -2.5) || realy >= (d_rect.w -2.5))\n"
+				"return vec4(0.0f, 0.0f, 0.0f, 1.0f);\n"
+			"vec4 base = texture(texture_sampler, tc);\n"
+			"return vec4(base.rgb + texture(tint_sampler, tc).r * inner_color, base.a);\n"
+		"}\n"
+		"vec4 distance_field(vec2 tc) {\n"
+			"float realx = tc.x * d_rect.z;\n"
+			"float realy = tc.y * d_rect.w;\n"
+			"if(realx <= 2.5 || realy <= 2.5 || realx >= (d_rect.z -2.5) || realy >= (d_rect.w -2.5))\n"
+				"return vec4(0.0f, 0.0f, 0.0f, 1.0f);\n"
+			"vec3 s = texture(texture_sampler, atlas_rect.xy + tc * atlas_rect.zw).rgb;\n"
+			"float d = max(min(s.r, s.g), min(max(s.r, s.g), s.b));\n"
+			"float w = max(fwidth(d) * 0.5, 0.001);\n"
+			"return vec4(inner_color, smoothstep(0.5 - w, 0.5 + w, d));\n"
+		"}\n"
+		"vec4 nine_slice(vec2 tc) {\n"
+			"float realx = tc.x * d_rect.z;\n"
+			"float realy = tc.y * d_rect.w;\n"
+			"if(realx <= 2.5 || realy <= 2.5 || realx >= (d_rect.z -2.5) || realy >= (d_rect.w -2.5))\n"
+				"return vec4(inner_color.r, inner_color.g, inner_color.b, 1.0f);\n"
+			"vec2 real = vec2(realx, realy);\n"
+			"vec2 from_end = d_rect.zw - real;\n"
+			"float tsize = 2.0 * border_size + grid_size;\n"
+			"vec2 t = border_size + mod(real - border_size, grid_size);\n"
+			"t = mix(t, real, lessThan(real, vec2(border_size)));\n"
+			"t = mix(t, tsize - from_end, lessThan(from_end, vec2(border_size)));\n"
+			"return texture(texture_sampler, t / tsize);\n"
+		"}\n"
 		"vec4 frame_stretch(vec2 tc) {\n"
 			"float realx = tc.x * d_rect.z;\n"
 			"float realy = tc.y * d_rect.w;\n"
@@ -231,6 +267,9 @@ void load_shaders() {
 				"\tcase 3: return frame_stretch(tc);\n"
 				"\tcase 4: return grid_texture(tc);\n"
 				"\tcase 5: return hollow_rect(tc);\n"
+				"\tcase 6: return tinted_texture(tc);\n"
+				"\tcase 7: return distance_field(tc);\n"
+				"\tcase 8: return nine_slice(tc);\n"
 				"\tdefault: break;\n"
 			"\t}\n"
 			"\treturn vec4(1.0f,1.0f,1.0f,1.0f);\n"
@@ -342,6 +381,99 @@ void render_textured_rect(color3f color, float ix, float iy, int32_t iwidth, int
 
 	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 }
+// draws a render from simple_svg::get_tinted_render in the given color, with the same outline render_textured_rect gives icons
+void render_tinted_rect(color3f color, float ix, float iy, int32_t iwidth, int32_t iheight, asvg::tinted_handles handles) {
+	float x = float(ix);
+	float y = float(iy);
+	float width = float(iwidth);
+	float height = float(iheight);
+
+	glBindVertexArray(global_square_vao);
+
+	glBindVertexBuffer(0, global_square_buffer, 0, sizeof(GLfloat) * 4);
+
+	glUniform4f(glGetUniformLocation(ui_shader_program, "d_rect"), x, y, width, height);
+	glUniform3f(glGetUniformLocation(ui_shader_program, "inner_color"), color.r, color.g, color.b);
+
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, handles.tint);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, handles.color);
+
+	GLuint subroutines[2] = { 6, 0 };
+	glUniform2ui(glGetUniformLocation(ui_shader_program, "subroutines_index"), subroutines[0], subroutines[1]);
+
+	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+}
+// draws a texture that holds the corners and edges of a background (each border_size pixels wide on the screen) around one cell
+// of its middle, which is repeated to fill the rest
+void render_nine_slice_rect(color3f color, float ix, float iy, int32_t iwidth, int32_t iheight, float border_size, float cell_size, GLuint texture_handle) {
+	float x = float(ix);
+	float y = float(iy);
+	float width = float(iwidth);
+	float height = float(iheight);
+
+	glBindVertexArray(global_square_vao);
+
+	glBindVertexBuffer(0, global_square_buffer, 0, sizeof(GLfloat) * 4);
+
+	glUniform1f(glGetUniformLocation(ui_shader_program, "border_size"), border_size);
+	glUniform1f(glGetUniformLocation(ui_shader_program, "grid_size"), cell_size);
+	glUniform4f(glGetUniformLocation(ui_shader_program, "d_rect"), x, y, width, height);
+	glUniform3f(glGetUniformLocation(ui_shader_program, "inner_color"), color.r, color.g, color.b);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, texture_handle);
+
+	GLuint subroutines[2] = { 8, 0 };
+	glUniform2ui(glGetUniformLocation(ui_shader_program, "subroutines_index"), subroutines[0], subroutines[1]);
+
+	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+}
+// a template background, from one small render when it is nine-slice and the element has room for its corners and edges
+void render_template_background(template_project::background_definition& b, float x, float y, float x_sz, float y_sz, int32_t gsz, float ui_scale) {
+	auto cells = 2 * b.nine_slice_border + 1;
+	if(b.nine_slice_border > 0 && x_sz >= float(cells * gsz) && y_sz >= float(cells * gsz)) {
+		render_nine_slice_rect(color3f{ 0.f, 0.f, 0.f },
+			x,
+			y,
+			std::max(1, int32_t(x_sz * ui_scale)),
+			std::max(1, int32_t(y_sz * ui_scale)),
+			float(b.nine_slice_border * gsz) * ui_scale,
+			float(gsz) * ui_scale,
+			b.renders.get_render(float(cells), float(cells), gsz, 2.0f));
+	} else {
+		render_textured_rect(color3f{ 0.f, 0.f, 0.f },
+			x,
+			y,
+			std::max(1, int32_t(x_sz * ui_scale)),
+			std::max(1, int32_t(y_sz * ui_scale)),
+			b.renders.get_render(x_sz / float(gsz), y_sz / float(gsz), gsz, 2.0f));
+	}
+}
+// draws a distance field from simple_svg::get_distance_field in the given color, at whatever size
+void render_distance_field_rect(color3f color, float ix, float iy, int32_t iwidth, int32_t iheight, asvg::distance_field_slot const& slot) {
+	float x = float(ix);
+	float y = float(iy);
+	float width = float(iwidth);
+	float height = float(iheight);
+
+	glBindVertexArray(global_square_vao);
+
+	glBindVertexBuffer(0, global_square_buffer, 0, sizeof(GLfloat) * 4);
+
+	glUniform4f(glGetUniformLocation(ui_shader_program, "d_rect"), x, y, width, height);
+	glUniform3f(glGetUniformLocation(ui_shader_program, "inner_color"), color.r, color.g, color.b);
+	glUniform4f(glGetUniformLocation(ui_shader_program, "atlas_rect"), slot.x, slot.y, slot.width, slot.height);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, slot.texture_handle);
+
+	GLuint subroutines[2] = { 7, 0 };
+	glUniform2ui(glGetUniformLocation(ui_shader_program, "subroutines_index"), subroutines[0], subroutines[1]);
+
+	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+}
 void render_stretch_textured_rect(color3f color, float ix, float iy, float ui_scale, int32_t iwidth, int32_t iheight, float border_size, GLuint texture_handle) {
 	float x = float(ix);
 	float y = float(iy);
@@ -531,6 +663,9 @@ float drag_offset_y = 0.0f;
 int32_t selected_window = -1;
 int32_t chosen_window = -1;
 bool just_chose_window = false;
+// an editor setting, not saved with the project: icons drawn entirely in their primary color are drawn from distance fields
+// instead of from renders made for each size
+bool icons_from_distance_fields = false;
 int32_t selected_control = -1;
 int32_t hovered_control = -1;
 int32_t selected_table = -1;
@@ -538,6 +673,250 @@ int32_t selected_table = -1;
 std::vector<size_t> path_to_selected_layout {};
 int current_edit_target = edit_targets::layout_window;
 
+// the expanded part of the selected window's layout tree, flattened into one row per item so that only the rows
+// scrolled into view have to be submitted; it is rebuilt when the window changes or when one of the edits that change
+// the rows (of the layout, of the names shown in it, or of the whole project) marks it as stale
+struct layout_tree_row {
+	layout_level_t* level = nullptr; // the layout holding the item
+	int32_t parent = -1; // the row of the sub-layout holding the item
+	uint32_t index = 0; // position in level->contents
+	uint16_t depth = 0;
+	std::string label;
+};
+struct layout_tree_rows {
+	std::vector<layout_tree_row> rows;
+	window_element_wrapper_t const* window = nullptr;
+	bool stale = true;
+};
+layout_tree_rows layout_tree;
+
+canvas::hit_index control_hits;
+undo::history edit_history;
+autosave::service project_autosave;
+
+// the canvas (the window being edited and the grid) is drawn into this framebuffer and copied to the screen every frame
+// it is only drawn again when something it depends on changed, so frames in which only the imgui panels change skip it
+struct canvas_framebuffer {
+	GLuint framebuffer = 0;
+	GLuint color = 0;
+	GLuint depth_stencil = 0;
+	int32_t width = 0;
+	int32_t height = 0;
+
+	// what the current contents were drawn from
+	struct inputs {
+		void const* window = nullptr;
+		int32_t selected_control = -1;
+		bool highlight_window = false;
+		float drag_offset_x = 0.0f;
+		float drag_offset_y = 0.0f;
+		float ui_scale = 1.0f;
+		int32_t grid_size = 0;
+		bool icons_from_distance_fields = false;
+		size_t window_count = 0;
+
+		bool operator==(inputs const&) const = default;
+	} drawn;
+	bool valid = false;
+
+	void resize(int32_t w, int32_t h) {
+		if(w == width && h == height && framebuffer != 0)
+			return;
+		release();
+		width = w;
+		height = h;
+
+		glGenTextures(1, &color);
+		glBindTexture(GL_TEXTURE_2D, color);
+		glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, std::max(1, w), std::max(1, h));
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glGenRenderbuffers(1, &depth_stencil);
+		glBindRenderbuffer(GL_RENDERBUFFER, depth_stencil);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, std::max(1, w), std::max(1, h));
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+		glGenFramebuffers(1, &framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color, 0);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_stencil);
+		if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			release();
+			return;
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+	void release() {
+		if(framebuffer)
+			glDeleteFramebuffers(1, &framebuffer);
+		if(depth_stencil)
+			glDeleteRenderbuffers(1, &depth_stencil);
+		if(color)
+			glDeleteTextures(1, &color);
+		framebuffer = 0;
+		depth_stencil = 0;
+		color = 0;
+		valid = false;
+	}
+};
+canvas_framebuffer canvas_cache;
+
+// anything but the mouse moving may have edited the project (or will, once the frame has been processed)
+bool input_may_have_edited(ImGuiIO const& io) {
+	for(auto& e : ImGui::GetCurrentContext()->InputEventsTrail) {
+		if(e.Type != ImGuiInputEventType_MousePos)
+			return true;
+	}
+	for(auto d : io.MouseDown) {
+		if(d)
+			return true;
+	}
+	return ImGui::IsAnyItemActive();
+}
+
+/*
+the project directory (and the svg directory, if it lies elsewhere) is watched for files changed outside of the editor,
+so that edited images and svgs show up without reopening the project
+*/
+struct project_file_watch {
+	std::unique_ptr<fs::directory_watch> project;
+	std::unique_ptr<fs::directory_watch> svgs;
+	std::vector<std::wstring> changes;
+};
+project_file_watch file_watch;
+
+std::wstring comparable_path(std::wstring const& path) {
+	std::wstring result;
+	auto length = GetFullPathNameW(path.c_str(), 0, nullptr, nullptr);
+	if(length == 0) {
+		result = path;
+	} else {
+		result.resize(length);
+		length = GetFullPathNameW(path.c_str(), length, result.data(), nullptr);
+		result.resize(length);
+	}
+	std::replace(result.begin(), result.end(), L'/', L'\\');
+	if(!result.empty())
+		CharLowerBuffW(result.data(), DWORD(result.size()));
+	return result;
+}
+
+void watch_project_files() {
+	file_watch.project.reset();
+	file_watch.svgs.reset();
+	auto wake = []() { glfwPostEmptyEvent(); };
+	file_watch.project = fs::watch_directory(open_project.project_directory, wake);
+	auto svg_root = comparable_path(open_templates.project_directory + open_templates.svg_directory);
+	if(!file_watch.project || !svg_root.starts_with(comparable_path(open_project.project_directory)))
+		file_watch.svgs = fs::watch_directory(open_templates.project_directory + open_templates.svg_directory, wake);
+}
+
+// the project file, its journal, the generated code and the temporaries they are written through; changes to
+// these come from the editor itself, so they are not reloaded
+// full_path is a comparable_path
+bool written_by_editor(std::wstring const& full_path) {
+	auto project_file = comparable_path(open_project.project_directory + open_project.project_name + L".aui");
+	auto source_file = comparable_path(open_project.project_directory + open_project.source_path + open_project.project_name + L".cpp");
+	for(auto& written : { project_file, project_file + L".journal", source_file }) {
+		if(full_path == written || full_path == written + L".tmp")
+			return true;
+	}
+	return false;
+}
+
+// full_path is a comparable_path; an empty one stands for every file
+void reload_svg_file(std::wstring const& full_path, std::wstring const& svg_root) {
+	auto reload_source = [&](std::string const& file_name, auto& renders) {
+		auto file = svg_root + fs::utf8_to_native(file_name);
+		if(!full_path.empty() && comparable_path(file) != full_path)
+			return;
+		fs::file loaded_file{ file };
+		// it may be in the middle of being replaced, or saved half edited; the old version stays until a change
+		// brings in one that can be read
+		if(loaded_file.content().data)
+			renders.replace_source(loaded_file.content().data, size_t(loaded_file.content().file_size));
+	};
+	for(auto& i : open_templates.icons) {
+		reload_source(i.file_name, i.renders);
+	}
+	for(auto& b : open_templates.backgrounds) {
+		reload_source(b.file_name, b.renders);
+	}
+
+	// files embedded in the svgs are dropped from the bank, and whatever refers to them is rendered again
+	auto& bank = asvg::common_file_bank::bank;
+	auto bank_root = bank.get_root_directory();
+	for(auto& name : bank.loaded_names()) {
+		if(!full_path.empty() && comparable_path(bank_root + fs::utf8_to_native(name)) != full_path)
+			continue;
+		if(!bank.forget(name))
+			continue;
+		auto refers_to = [&](std::vector<char> const& svg_data) {
+			return std::search(svg_data.begin(), svg_data.end(), name.begin(), name.end()) != svg_data.end();
+		};
+		for(auto& i : open_templates.icons) {
+			if(refers_to(i.renders.svg_data))
+				i.renders.invalidate_renders();
+		}
+		for(auto& b : open_templates.backgrounds) {
+			if(refers_to(b.renders.svg_data))
+				b.renders.invalidate_renders();
+		}
+	}
+}
+
+// returns whether anything changed
+bool apply_file_changes() {
+	auto& changes = file_watch.changes;
+	changes.clear();
+	if(file_watch.project)
+		file_watch.project->take_changes(changes);
+	auto from_project = changes.size();
+	if(file_watch.svgs)
+		file_watch.svgs->take_changes(changes);
+	if(changes.empty())
+		return false;
+
+	auto svg_directory = open_templates.project_directory + open_templates.svg_directory;
+	auto svg_root = comparable_path(svg_directory);
+	for(size_t i = 0; i < changes.size(); ++i) {
+		if(changes[i].empty()) { // too much changed to tell what
+			ogl::reload_texture(std::wstring{ });
+			reload_svg_file(std::wstring{ }, svg_directory);
+			return true;
+		}
+	}
+	bool changed = false;
+	for(size_t i = 0; i < changes.size(); ++i) {
+		auto full_path = comparable_path((i < from_project ? open_project.project_directory : svg_directory) + changes[i]);
+		if(written_by_editor(full_path))
+			continue;
+		ogl::reload_texture(full_path);
+		if(full_path.starts_with(svg_root))
+			reload_svg_file(full_path, svg_directory);
+		changed = true;
+	}
+	return changed;
+}
+
+int32_t pick_control(window_element_wrapper_t const& win, float pos_x, float pos_y, float scale, drag_target& target) {
+	int32_t result = -1;
+	target = drag_target::none;
+	if(control_hits.owner != &win)
+		return result;
+	control_hits.for_each_at(pos_x, pos_y, [&](canvas::hit_rect const& r) {
+		// the highest index wins, as it is drawn last
+		if(r.id <= result || r.id >= int32_t(win.children.size()))
+			return;
+		auto t = test_rect_target(pos_x, pos_y, r.x, r.y, r.w, r.h, scale);
+		if(t != drag_target::none) {
+			result = r.id;
+			target = t;
+		}
+	});
+	return result;
+}
+
 bool paths_are_the_same(std::vector<size_t>& left, std::vector<size_t>& right) {
 	if (left.size() != right.size()) return false;
 	for (size_t i = 0; i < left.size(); i++) {
@@ -576,7 +955,7 @@ layout_level_t* retrieve_layout(layout_level_t& root, std::vector<size_t>& dir)
 	auto& win = open_project.windows[selected_window];
 	layout_level_t* selected_layout = &win.layout;
 	for (auto i : dir) {
-		selected_layout = std::get<sub_layout_t>(selected_layout->contents[i]).layout.get();
+		selected_layout = &get_sub_layout(win, std::get<sub_layout_t>(selected_layout->contents[i]));
 	}
 
 	return selected_layout;
@@ -588,7 +967,7 @@ layout_level_t* retrieve_layout(layout_level_t& root, std::array<size_t, SIZE>&
 	layout_level_t* selected_layout = &win.layout;
 	for (auto j = 0; j < len; j++) {
 
-		selected_layout = std::get<sub_layout_t>(selected_layout->contents[dir[j]]).layout.get();
+		selected_layout = &get_sub_layout(win, std::get<sub_layout_t>(selected_layout->contents[dir[j]]));
 	}
 	return selected_layout;
 }
@@ -648,22 +1027,33 @@ void render_layout(window_element_wrapper_t& window, layout_level_t& layout, int
 void render_window(window_element_wrapper_t& win, float x, float y, bool highlightwin, float ui_scale) {
 	// bg
 	if(win.wrapped.template_id != -1) {
-		auto render_asvg_rect = [&](asvg::svg& s, float hcursor, float vcursor, float x_sz, float y_sz, int32_t gsz) {
+		auto render_asvg_rect = [&](template_project::background_definition& b, float hcursor, float vcursor, float x_sz, float y_sz, int32_t gsz) {
 			render_hollow_rect(win.wrapped.rectangle_color * (highlightwin ? 1.0f : 0.8f),
 				hcursor,
 				vcursor,
 				std::max(1, int32_t(x_sz * ui_scale)),
 				std::max(1, int32_t(y_sz * ui_scale)));
 
-			render_textured_rect(color3f{ 0.f, 0.f, 0.f },
-				hcursor,
-				vcursor,
-				std::max(1, int32_t(x_sz * ui_scale)),
-				std::max(1, int32_t(y_sz * ui_scale)),
-				s.get_render(x_sz / float(gsz), y_sz / float(gsz), gsz, 2.0f));
+			render_template_background(b, hcursor, vcursor, x_sz, y_sz, gsz, ui_scale);
 
 		};
 		auto render_svg_rect = [&](asvg::simple_svg& s, float hcursor, float vcursor, int32_t x_sz, int32_t y_sz, color3f c) {
+			if(icons_from_distance_fields) {
+				if(auto field = s.get_distance_field(); field.texture_handle != 0) {
+					render_distance_field_rect(c, hcursor, vcursor, std::max(1, int32_t(x_sz * ui_scale)), std::max(1, int32_t(y_sz * ui_scale)), field);
+					return;
+				}
+			}
+			if(auto tinted = s.get_tinted_render(x_sz, y_sz, 2.0f); tinted.color != 0) {
+				render_tinted_rect(c,
+					hcursor,
+					vcursor,
+					std::max(1, int32_t(x_sz * ui_scale)),
+					std::max(1, int32_t(y_sz * ui_scale)),
+					tinted);
+				return;
+			}
+			// the icon could not be split into color and tint, so it is rendered in its color directly
 			render_textured_rect(color3f{ 0.f, 0.f, 0.f },
 				hcursor,
 				vcursor,
@@ -676,7 +1066,7 @@ void render_window(window_element_wrapper_t& win, float x, float y, bool highlig
 		auto selected_template = win.wrapped.template_id;
 
 		if(thm.window_t[selected_template].bg != -1) {
-			render_asvg_rect(thm.backgrounds[thm.window_t[selected_template].bg].renders, x * ui_scale, y * ui_scale, win.wrapped.x_size, win.wrapped.y_size, open_project.grid_size);
+			render_asvg_rect(thm.backgrounds[thm.window_t[selected_template].bg], x * ui_scale, y * ui_scale, win.wrapped.x_size, win.wrapped.y_size, open_project.grid_size);
 		} else {
 			render_empty_rect(win.wrapped.rectangle_color * (highlightwin ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(win.wrapped.x_size * ui_scale)), std::max(1, int32_t(win.wrapped.y_size * ui_scale)));
 		}
@@ -689,7 +1079,7 @@ void render_window(window_element_wrapper_t& win, float x, float y, bool highlig
 			auto b = thm.iconic_button_t[thm.window_t[selected_template].close_button_definition].primary.icon_bottom.resolve(float(3 * open_project.grid_size), float(3 * open_project.grid_size), open_project.grid_size) * ui_scale + vcursor;
 
 			if(thm.iconic_button_t[thm.window_t[selected_template].close_button_definition].primary.bg != -1)
-				render_asvg_rect(thm.backgrounds[thm.iconic_button_t[thm.window_t[selected_template].close_button_definition].primary.bg].renders, hcursor, vcursor, 3 * open_project.grid_size, 3 * open_project.grid_size, open_project.grid_size);
+				render_asvg_rect(thm.backgrounds[thm.iconic_button_t[thm.window_t[selected_template].close_button_definition].primary.bg], hcursor, vcursor, 3 * open_project.grid_size, 3 * open_project.grid_size, open_project.grid_size);
 
 			hcursor = l;
 			vcursor = t;
@@ -717,19 +1107,19 @@ void render_window(window_element_wrapper_t& win, float x, float y, bool highlig
 			if(win.wrapped.ogl_texture.loaded == false) {
 				win.wrapped.ogl_texture.load(open_project.project_directory + fs::utf8_to_native(win.wrapped.texture));
 			}
-			if(win.wrapped.ogl_texture.texture_handle == 0) {
+			if(win.wrapped.ogl_texture.handle() == 0) {
 				render_empty_rect(win.wrapped.rectangle_color * (highlightwin ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(win.wrapped.x_size * ui_scale)), std::max(1, int32_t(win.wrapped.y_size * ui_scale)));
 			} else {
-				render_textured_rect(win.wrapped.rectangle_color * (highlightwin ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(win.wrapped.x_size * ui_scale)), std::max(1, int32_t(win.wrapped.y_size * ui_scale)), win.wrapped.ogl_texture.texture_handle);
+				render_textured_rect(win.wrapped.rectangle_color * (highlightwin ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(win.wrapped.x_size * ui_scale)), std::max(1, int32_t(win.wrapped.y_size * ui_scale)), win.wrapped.ogl_texture.handle());
 			}
 		} else if(win.wrapped.background == background_type::bordered_texture) {
 			if(win.wrapped.ogl_texture.loaded == false) {
 				win.wrapped.ogl_texture.load(open_project.project_directory + fs::utf8_to_native(win.wrapped.texture));
 			}
-			if(win.wrapped.ogl_texture.texture_handle == 0) {
+			if(win.wrapped.ogl_texture.handle() == 0) {
 				render_empty_rect(win.wrapped.rectangle_color * (highlightwin ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(win.wrapped.x_size * ui_scale)), std::max(1, int32_t(win.wrapped.y_size * ui_scale)));
 			} else {
-				render_stretch_textured_rect(win.wrapped.rectangle_color * (highlightwin ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), ui_scale, std::max(1, int32_t(win.wrapped.x_size * ui_scale)), std::max(1, int32_t(win.wrapped.y_size * ui_scale)), win.wrapped.border_size, win.wrapped.ogl_texture.texture_handle);
+				render_stretch_textured_rect(win.wrapped.rectangle_color * (highlightwin ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), ui_scale, std::max(1, int32_t(win.wrapped.x_size * ui_scale)), std::max(1, int32_t(win.wrapped.y_size * ui_scale)), win.wrapped.border_size, win.wrapped.ogl_texture.handle());
 			}
 		}
 	}
@@ -753,22 +1143,33 @@ void render_window(window_element_wrapper_t& win, float x, float y, bool highlig
 
 void render_control(ui_element_t& c, float x, float y, bool highlighted, float ui_scale) {
 
-	auto render_asvg_rect = [&](asvg::svg& s, float hcursor, float vcursor, float x_sz, float y_sz, int32_t gsz) {
+	auto render_asvg_rect = [&](template_project::background_definition& b, float hcursor, float vcursor, float x_sz, float y_sz, int32_t gsz) {
 		render_hollow_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f),
 			hcursor,
 			vcursor,
 			std::max(1, int32_t(x_sz * ui_scale)),
 			std::max(1, int32_t(y_sz * ui_scale)));
 
-		render_textured_rect(color3f{ 0.f, 0.f, 0.f },
-			hcursor,
-			vcursor,
-			std::max(1, int32_t(x_sz * ui_scale)),
-			std::max(1, int32_t(y_sz * ui_scale)),
-			s.get_render(x_sz / float(gsz), y_sz / float(gsz), gsz, 2.0f));
+		render_template_background(b, hcursor, vcursor, x_sz, y_sz, gsz, ui_scale);
 
 	};
 	auto render_svg_rect = [&](asvg::simple_svg& s, float hcursor, float vcursor, int32_t x_sz, int32_t y_sz, color3f c) {
+		if(icons_from_distance_fields) {
+			if(auto field = s.get_distance_field(); field.texture_handle != 0) {
+				render_distance_field_rect(c, hcursor, vcursor, std::max(1, int32_t(x_sz * ui_scale)), std::max(1, int32_t(y_sz * ui_scale)), field);
+				return;
+			}
+		}
+		if(auto tinted = s.get_tinted_render(x_sz, y_sz, 2.0f); tinted.color != 0) {
+			render_tinted_rect(c,
+				hcursor,
+				vcursor,
+				std::max(1, int32_t(x_sz * ui_scale)),
+				std::max(1, int32_t(y_sz * ui_scale)),
+				tinted);
+			return;
+		}
+		// the icon could not be split into color and tint, so it is rendered in its color directly
 		render_textured_rect(color3f{ 0.f, 0.f, 0.f },
 			hcursor,
 			vcursor,
@@ -781,7 +1182,7 @@ void render_control(ui_element_t& c, float x, float y, bool highlighted, float u
 		if(c.template_id != -1) {
 			auto bg = open_templates.label_t[c.template_id].primary.bg;
 			if(bg != -1)
-				render_asvg_rect(open_templates.backgrounds[bg].renders, (x * ui_scale), (y * ui_scale),  c.x_size, c.y_size, open_project.grid_size);
+				render_asvg_rect(open_templates.backgrounds[bg], (x * ui_scale), (y * ui_scale),  c.x_size, c.y_size, open_project.grid_size);
 			else
 				render_empty_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)));
 		} else {
@@ -793,7 +1194,7 @@ void render_control(ui_element_t& c, float x, float y, bool highlighted, float u
 		if(c.template_id != -1) {
 			auto bg = open_templates.button_t[c.template_id].primary.bg;
 			if(bg != -1)
-				render_asvg_rect(open_templates.backgrounds[bg].renders, (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
+				render_asvg_rect(open_templates.backgrounds[bg], (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
 			else
 				render_empty_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)));
 		} else {
@@ -809,7 +1210,7 @@ void render_control(ui_element_t& c, float x, float y, bool highlighted, float u
 		if(c.template_id != -1) {
 			auto bg = open_templates.button_t[c.template_id].primary.bg;
 			if(bg != -1)
-				render_asvg_rect(open_templates.backgrounds[bg].renders, (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
+				render_asvg_rect(open_templates.backgrounds[bg], (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
 			else
 				render_empty_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)));
 		} else {
@@ -819,7 +1220,7 @@ void render_control(ui_element_t& c, float x, float y, bool highlighted, float u
 	}
 	if(c.ttype == template_project::template_type::free_background) {
 		if(c.template_id != -1) 
-			render_asvg_rect(open_templates.backgrounds[c.template_id].renders, (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
+			render_asvg_rect(open_templates.backgrounds[c.template_id], (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
 		else
 			render_empty_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)));
 		return;
@@ -828,7 +1229,7 @@ void render_control(ui_element_t& c, float x, float y, bool highlighted, float u
 		if(c.template_id != -1) {
 			auto bg = open_templates.drop_down_t[c.template_id].primary_bg;
 			if(bg != -1)
-				render_asvg_rect(open_templates.backgrounds[bg].renders, (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
+				render_asvg_rect(open_templates.backgrounds[bg], (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
 			else
 				render_empty_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)));
 		} else {
@@ -858,7 +1259,7 @@ void render_control(ui_element_t& c, float x, float y, bool highlighted, float u
 		if(c.template_id != -1) {
 			auto bg = open_templates.stacked_bar_t[c.template_id].overlay_bg;
 			if(bg != -1)
-				render_asvg_rect(open_templates.backgrounds[bg].renders, (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
+				render_asvg_rect(open_templates.backgrounds[bg], (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
 			else
 				render_empty_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)));
 		} else {
@@ -870,7 +1271,7 @@ void render_control(ui_element_t& c, float x, float y, bool highlighted, float u
 		if(c.template_id != -1) {
 			auto bg = open_templates.iconic_button_t[c.template_id].primary.bg;
 			if(bg != -1)
-				render_asvg_rect(open_templates.backgrounds[bg].renders, (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
+				render_asvg_rect(open_templates.backgrounds[bg], (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
 			else
 				render_empty_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)));
 
@@ -899,7 +1300,7 @@ void render_control(ui_element_t& c, float x, float y, bool highlighted, float u
 		if(c.template_id != -1) {
 			auto bg = open_templates.mixed_button_t[c.template_id].primary.bg;
 			if(bg != -1)
-				render_asvg_rect(open_templates.backgrounds[bg].renders, (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
+				render_asvg_rect(open_templates.backgrounds[bg], (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
 			else
 				render_empty_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)));
 
@@ -928,7 +1329,7 @@ void render_control(ui_element_t& c, float x, float y, bool highlighted, float u
 		if(c.template_id != -1) {
 			auto bg = open_templates.mixed_button_t[c.template_id].primary.bg;
 			if(bg != -1)
-				render_asvg_rect(open_templates.backgrounds[bg].renders, (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
+				render_asvg_rect(open_templates.backgrounds[bg], (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
 			else
 				render_empty_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)));
 
@@ -957,7 +1358,7 @@ void render_control(ui_element_t& c, float x, float y, bool highlighted, float u
 		if(c.template_id != -1) {
 			auto bg = open_templates.iconic_button_t[c.template_id].primary.bg;
 			if(bg != -1)
-				render_asvg_rect(open_templates.backgrounds[bg].renders, (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
+				render_asvg_rect(open_templates.backgrounds[bg], (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
 			else
 				render_empty_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)));
 
@@ -986,7 +1387,7 @@ void render_control(ui_element_t& c, float x, float y, bool highlighted, float u
 		if(c.template_id != -1) {
 			auto bg = open_templates.toggle_button_t[c.template_id].on_region.primary.bg;
 			if(bg != -1)
-				render_asvg_rect(open_templates.backgrounds[bg].renders, (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
+				render_asvg_rect(open_templates.backgrounds[bg], (x * ui_scale), (y * ui_scale), c.x_size, c.y_size, open_project.grid_size);
 			else
 				render_empty_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)));
 		} else {
@@ -1028,19 +1429,19 @@ void render_control(ui_element_t& c, float x, float y, bool highlighted, float u
 		if(c.ogl_texture.loaded == false) {
 			c.ogl_texture.load(open_project.project_directory + fs::utf8_to_native(c.texture));
 		}
-		if(c.ogl_texture.texture_handle == 0) {
+		if(c.ogl_texture.handle() == 0) {
 			render_empty_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)));
 		} else {
-			render_textured_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)), c.ogl_texture.texture_handle);
+			render_textured_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)), c.ogl_texture.handle());
 		}
 	} else if(c.background == background_type::bordered_texture) {
 		if(c.ogl_texture.loaded == false) {
 			c.ogl_texture.load(open_project.project_directory + fs::utf8_to_native(c.texture));
 		}
-		if(c.ogl_texture.texture_handle == 0) {
+		if(c.ogl_texture.handle() == 0) {
 			render_empty_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)));
 		} else {
-			render_stretch_textured_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), ui_scale, std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)), c.border_size, c.ogl_texture.texture_handle);
+			render_stretch_textured_rect(c.rectangle_color * (highlighted ? 1.0f : 0.8f), (x * ui_scale), (y * ui_scale), ui_scale, std::max(1, int32_t(c.x_size * ui_scale)), std::max(1, int32_t(c.y_size * ui_scale)), c.border_size, c.ogl_texture.handle());
 		}
 	}
 }
@@ -1187,20 +1588,20 @@ struct layout_iterator {
 				return measure_result{ 0, 0, measure_result::special::none };
 			}
 		} else if(std::holds_alternative<sub_layout_t>(m)) {
-			auto& i = std::get<sub_layout_t>(m);
+			auto& i = get_sub_layout(window, std::get<sub_layout_t>(m));
 			int32_t x = 0;
 			int32_t y = 0;
 			bool consume_fill = false;
-			if(i.layout->size_x != -1)
-				x = i.layout->size_x;
+			if(i.size_x != -1)
+				x = i.size_x;
 			else {
 				if(glue_horizontal)
 					consume_fill = true;
 				else
 					x = max_crosswise;
 			}
-			if(i.layout->size_y != -1)
-				y = i.layout->size_y;
+			if(i.size_y != -1)
+				y = i.size_y;
 			else {
 				if(!glue_horizontal)
 					consume_fill = true;
@@ -1219,20 +1620,29 @@ struct layout_iterator {
 		if(std::holds_alternative<layout_control_t>(m)) {
 			auto& i = std::get<layout_control_t>(m);
 			if(i.cached_index != -1) {
+				// what the layout decides (where the control lands on screen, which also depends on the pan and zoom,
+				// and the size it is filled out to) is only lent to the child while it is drawn, as its own position
+				// and size are saved with the project and compared by the undo history
+				auto& c = window.children[i.cached_index];
+				auto in_x = c.x_size;
+				auto in_y = c.y_size;
 				if(i.fill_x)
-					window.children[i.cached_index].x_size = int16_t(width);
+					c.x_size = int16_t(width);
 				if(i.fill_y)
-					window.children[i.cached_index].y_size = int16_t(height);
+					c.y_size = int16_t(height);
 
+				float screen_x = x;
+				float screen_y = y;
 				if(i.absolute_position) {
-					window.children[i.cached_index].x_pos = int16_t((layout_x + i.abs_x) * scale);
-					window.children[i.cached_index].y_pos = int16_t((layout_y + i.abs_y) * scale);
-					render_control(window.children[i.cached_index], layout_x + i.abs_x, layout_y + i.abs_y, i.cached_index == selected_control, scale);
-				} else {
-					window.children[i.cached_index].x_pos = int16_t(x * scale);
-					window.children[i.cached_index].y_pos = int16_t(y * scale);
-					render_control(window.children[i.cached_index], x, y, i.cached_index == selected_control, scale);
+					screen_x = float(layout_x + i.abs_x);
+					screen_y = float(layout_y + i.abs_y);
 				}
+				render_control(c, screen_x, screen_y, i.cached_index == selected_control, scale);
+				if(control_hits.owner == &window) {
+					control_hits.add(screen_x * scale, screen_y * scale, c.x_size * scale, c.y_size * scale, i.cached_index);
+				}
+				c.x_size = in_x;
+				c.y_size = in_y;
 			}
 		} else if(std::holds_alternative<layout_window_t>(m)) {
 			auto& i = std::get<layout_window_t>(m);
@@ -1264,7 +1674,7 @@ struct layout_iterator {
 			}
 		} else if(std::holds_alternative<sub_layout_t>(m)) {
 			auto& i = std::get<sub_layout_t>(m);
-			render_layout(window, *(i.layout), layer + 1, x, y, width, height, outline_color, scale);
+			render_layout(window, get_sub_layout(window, i), layer + 1, x, y, width, height, outline_color, scale);
 		}
 	}
 	void move_position(int32_t n) {
@@ -1533,12 +1943,7 @@ void render_layout(window_element_wrapper_t& window, layout_level_t& layout, int
 	if(id != -1) {
 		auto bg = open_templates.layout_region_t[id].bg;
 		if(bg != -1) {
-			render_textured_rect(color3f{ 0.f, 0.f, 0.f },
-				x * scale,
-				y * scale,
-				std::max(1, int32_t(base_x_size * scale)),
-				std::max(1, int32_t(base_y_size * scale)),
-				open_templates.backgrounds[bg].renders.get_render(base_x_size / float(open_project.grid_size), base_y_size / float(open_project.grid_size), open_project.grid_size, 2.0f));
+			render_template_background(open_templates.backgrounds[bg], x * scale, y * scale, float(base_x_size), float(base_y_size), open_project.grid_size, scale);
 		}
 	}
 
@@ -1883,7 +2288,7 @@ void render_layout(window_element_wrapper_t& window, layout_level_t& layout, int
 	}
 }
 
-void rename_window(layout_level_t& layout, std::string const& old_name, std::string const& new_name) {
+void rename_window(window_element_wrapper_t& win, layout_level_t& layout, std::string const& old_name, std::string const& new_name) {
 	for(auto& m : layout.contents) {
 		if(std::holds_alternative< layout_control_t>(m)) {
 			auto& i = std::get<layout_control_t>(m);
@@ -1904,11 +2309,11 @@ void rename_window(layout_level_t& layout, std::string const& old_name, std::str
 			}
 		} else if(std::holds_alternative< sub_layout_t>(m)) {
 			auto& i = std::get<sub_layout_t>(m);
-			rename_window(*i.layout, old_name, new_name);
+			rename_window(win, get_sub_layout(win, i), old_name, new_name);
 		}
 	}
 }
-void rename_control(layout_level_t& layout, std::string const& old_name, std::string const& new_name) {
+void rename_control(window_element_wrapper_t& win, layout_level_t& layout, std::string const& old_name, std::string const& new_name) {
 	for(auto& m : layout.contents) {
 		if(std::holds_alternative< layout_control_t>(m)) {
 			auto& i = std::get<layout_control_t>(m);
@@ -1922,19 +2327,19 @@ void rename_control(layout_level_t& layout, std::string const& old_name, std::st
 
 		} else if(std::holds_alternative< sub_layout_t>(m)) {
 			auto& i = std::get<sub_layout_t>(m);
-			rename_control(*i.layout, old_name, new_name);
+			rename_control(win, get_sub_layout(win, i), old_name, new_name);
 		}
 	}
 }
 
-void apply_layout_style(layout_level_t& layout, int16_t margins, int16_t header_height, bool first) {
+void apply_layout_style(window_element_wrapper_t& win, layout_level_t& layout, int16_t margins, int16_t header_height, bool first) {
 	int internal_layouts = 0;
 	bool is_first = true;
 	for(auto& m : layout.contents) {
 		if(std::holds_alternative< sub_layout_t>(m)) {
 			internal_layouts++;
 			auto& i = std::get<sub_layout_t>(m);
-			apply_layout_style(*i.layout, margins, header_height, is_first);
+			apply_layout_style(win, get_sub_layout(win, i), margins, header_height, is_first);
 			is_first = false;
 		}
 	}
@@ -2229,7 +2634,7 @@ void update_file_contents_and_open_to(std::string const& target_name) {
 		fs::file loaded_file{ open_project.project_directory + open_project.source_path + open_project.project_name + L".cpp" };
 		old_code = generator::extract_snippets(loaded_file.content().data, loaded_file.content().file_size);
 	}
-	auto text = generator::generate_project_code(open_project, old_code);
+	auto text = generator::generate_project_code(open_project, old_code, template_project::any_nine_slice_background(open_templates));
 	fs::write_file(open_project.project_directory + open_project.source_path + open_project.project_name + L".cpp", text.c_str(), uint32_t(text.size()));
 	std::string_view text_view = text;
 
@@ -2691,6 +3096,7 @@ void sub_layout_options(layout_level_t* selected_layout) {
 void window_options(window_element_wrapper_t& win) {
 	if(ImGui::Button("Delete")) {
 		open_project.windows.erase(open_project.windows.begin() + selected_window);
+		layout_tree.stale = true;
 		path_to_selected_layout.clear();
 		current_edit_target = edit_targets::layout_sublayout;
 		selected_window = -1;
@@ -2699,8 +3105,11 @@ void window_options(window_element_wrapper_t& win) {
 	} else {
 		ImGui::SameLine();
 		if(ImGui::Button("Copy container")) {
-			open_project.windows.push_back(win);
-			open_project.windows.back().wrapped.name += "_copy";
+			auto copy = win;
+			compact_sub_layouts(copy);
+			copy.wrapped.name += "_copy";
+			open_project.windows.push_back(std::move(copy));
+			layout_tree.stale = true; // the windows may have moved
 			return;
 		}
 		ImGui::InputText("Name", &(win.wrapped.temp_name));
@@ -2721,7 +3130,9 @@ void window_options(window_element_wrapper_t& win) {
 					MessageBoxW(nullptr, L"Name must be unique", L"Invalid Name", MB_OK);
 				} else {
 					for(auto& ow : open_project.windows)
-						rename_window(ow.layout, win.wrapped.name, win.wrapped.temp_name);
+						rename_window(ow, ow.layout, win.wrapped.name, win.wrapped.temp_name);
+					edit_history.request_full_check();
+					layout_tree.stale = true;
 
 					win.wrapped.name = win.wrapped.temp_name;
 				}
@@ -3133,7 +3544,8 @@ void control_options(window_element_wrapper_t& win, ui_element_t& c, layout_cont
 					if(alt.control_name == c.name)
 						alt.control_name = c.temp_name;
 				}
-				rename_control(win.layout, c.name, c.temp_name);
+				rename_control(win, win.layout, c.name, c.temp_name);
+				layout_tree.stale = true;
 				c.name = c.temp_name;
 			}
 		}
@@ -3874,7 +4286,7 @@ void control_options(window_element_wrapper_t& win, ui_element_t& c, layout_cont
 
 auto base_tree_flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_DrawLinesFull;
 
-std::string produce_label(layout_item& m) {
+std::string produce_label(window_element_wrapper_t& win, layout_item& m) {
 	if(std::holds_alternative< layout_control_t>(m)) {
 		auto& i = std::get<layout_control_t>(m);
 		return (char const*)(u8"\uED1E control: ") + i.name;
@@ -3901,14 +4313,14 @@ std::string produce_label(layout_item& m) {
 
 		return label;
 	} else if(std::holds_alternative< sub_layout_t>(m)) {
-		auto& i = std::get<sub_layout_t>(m);
+		auto& i = get_sub_layout(win, std::get<sub_layout_t>(m));
 		std::string label = "(";
-		if (!(i.layout->open_in_ui)) {
+		if (!(i.open_in_ui)) {
 			label = (char const*)(u8"\uED41 sub-layout: ") + label;
 		} else {
 			label = (char const*)(u8"\uED43 sub-layout: ") + label;
 		}
-		label += std::to_string(i.layout->contents.size()) + ")###SUBLAYOUT";
+		label += std::to_string(i.contents.size()) + ")###SUBLAYOUT";
 		return label;
 	}
 	return "";
@@ -3921,7 +4333,7 @@ struct tree_location {
 	int index = 0;
 };
 
-bool internal_tree_location_from_control(std::string const& name, layout_level_t& layout, std::vector<size_t>& result) {
+bool internal_tree_location_from_control(std::string const& name, window_element_wrapper_t& win, layout_level_t& layout, std::vector<size_t>& result) {
 	for(size_t i = 0; i < layout.contents.size(); ++i) {
 		auto& cc = layout.contents[i];
 		if(std::holds_alternative<layout_control_t>(cc)) {
@@ -3933,7 +4345,7 @@ bool internal_tree_location_from_control(std::string const& name, layout_level_t
 		} else if(std::holds_alternative<sub_layout_t>(cc)) {
 			auto& item = std::get<sub_layout_t>(cc);
 			result.push_back(i);
-			if(internal_tree_location_from_control(name, *(item.layout), result)) {
+			if(internal_tree_location_from_control(name, win, get_sub_layout(win, item), result)) {
 				return true;
 			}
 			result.pop_back();
@@ -3943,10 +4355,10 @@ bool internal_tree_location_from_control(std::string const& name, layout_level_t
 }
 std::vector<size_t> tree_location_from_control(std::string const& name, window_element_wrapper_t& win) {
 	std::vector<size_t> result;
-	internal_tree_location_from_control(name, win.layout, result);
+	internal_tree_location_from_control(name, win, win.layout, result);
 	return result;
 }
-bool internal_tree_location_from_win(std::string const& name, layout_level_t& layout, std::vector<size_t>& result) {
+bool internal_tree_location_from_win(std::string const& name, window_element_wrapper_t& win, layout_level_t& layout, std::vector<size_t>& result) {
 	for(size_t i = 0; i < layout.contents.size(); ++i) {
 		auto& cc = layout.contents[i];
 		if(std::holds_alternative<layout_window_t>(cc)) {
@@ -3958,7 +4370,7 @@ bool internal_tree_location_from_win(std::string const& name, layout_level_t& la
 		} else if(std::holds_alternative<sub_layout_t>(cc)) {
 			auto& item = std::get<sub_layout_t>(cc);
 			result.push_back(i);
-			if(internal_tree_location_from_win(name, *(item.layout), result)) {
+			if(internal_tree_location_from_win(name, win, get_sub_layout(win, item), result)) {
 				return true;
 			}
 			result.pop_back();
@@ -3968,7 +4380,7 @@ bool internal_tree_location_from_win(std::string const& name, layout_level_t& la
 }
 std::vector<size_t> tree_location_from_win(std::string const& name, window_element_wrapper_t& win) {
 	std::vector<size_t> result;
-	internal_tree_location_from_win(name, win.layout, result);
+	internal_tree_location_from_win(name, win, win.layout, result);
 	return result;
 }
 
@@ -4072,11 +4484,11 @@ bool update_tree_dnd(layout_level_t& root, layout_level_t& layout, std::string&
 			return true;
 		}
 		if(std::holds_alternative<sub_layout_t>(layout.contents[current_location.index])) {
-			auto& i = std::get<sub_layout_t>(layout.contents[current_location.index]);
+			auto& i = get_sub_layout(win, std::get<sub_layout_t>(layout.contents[current_location.index]));
 			std::string label = "Move " + std::to_string(buffer.size()) + " items from the buffer###MOVE_FROM_BUFFER";
 			if (ImGui::Selectable(label.c_str())) {
-				i.layout->contents.insert(
-					i.layout->contents.end(),
+				i.contents.insert(
+					i.contents.end(),
 					std::make_move_iterator(
 						buffer.begin()
 					),
@@ -4095,7 +4507,7 @@ bool update_tree_dnd(layout_level_t& root, layout_level_t& layout, std::string&
 			}
 			if (ImGui::BeginMenu("Add")) {
 				if (ImGui::MenuItem("Control")) {
-					i.layout->contents.emplace_back(layout_control_t{ });
+					i.contents.emplace_back(layout_control_t{ });
 					path_to_selected_layout.clear();
 					current_edit_target = edit_targets::layout_sublayout;
 
@@ -4120,37 +4532,36 @@ bool update_tree_dnd(layout_level_t& root, layout_level_t& layout, std::string&
 						++j;
 					} while(true);
 
-					auto& itm = std::get<layout_control_t>(i.layout->contents.back());
+					auto& itm = std::get<layout_control_t>(i.contents.back());
 					itm.name = win.children.back().name;
 					result = true;
 				}
 				if (ImGui::MenuItem("Window")) {
-					i.layout->contents.emplace_back(layout_window_t{ });
+					i.contents.emplace_back(layout_window_t{ });
 					path_to_selected_layout.clear();
 					current_edit_target = edit_targets::layout_sublayout;
 					result = true;
 				}
 				if (ImGui::MenuItem("Glue")) {
-					i.layout->contents.emplace_back(layout_glue_t{ });
+					i.contents.emplace_back(layout_glue_t{ });
 					path_to_selected_layout.clear();
 					current_edit_target = edit_targets::layout_sublayout;
 					result = true;
 				}
 				if (ImGui::MenuItem("Generator")) {
-					i.layout->contents.emplace_back(generator_t{ });
+					i.contents.emplace_back(generator_t{ });
 					path_to_selected_layout.clear();
 					current_edit_target = edit_targets::layout_sublayout;
 					result = true;
 				}
 				if (ImGui::MenuItem("Sublayout")) {
-					i.layout->contents.emplace_back(sub_layout_t{ });
-					std::get<sub_layout_t>(i.layout->contents.back()).layout = std::make_unique<layout_level_t>();
+					i.contents.emplace_back(make_sub_layout(win));
 					path_to_selected_layout.clear();
 					current_edit_target = edit_targets::layout_sublayout;
 					result = true;
 				}
 				if (ImGui::MenuItem("Texture layer")) {
-					i.layout->contents.emplace_back(texture_layer_t{ });
+					i.contents.emplace_back(texture_layer_t{ });
 					path_to_selected_layout.clear();
 					current_edit_target = edit_targets::layout_sublayout;
 					result = true;
@@ -4164,212 +4575,208 @@ bool update_tree_dnd(layout_level_t& root, layout_level_t& layout, std::string&
 	return result;
 }
 
-void imgui_layout_contents(layout_level_t& root, layout_level_t& layout, std::vector<size_t> path) {
-	bool root_expanded = true;
-	if (path.size() == 0) {
-		root_expanded = ImGui::TreeNodeEx((char const*)(u8"\uEC4E"), base_tree_flags);
-		if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen()) {
-			path_to_selected_layout = {};
-			current_edit_target = edit_targets::layout_sublayout;
+void flatten_layout_tree(window_element_wrapper_t& win, layout_level_t& layout, int32_t parent, uint16_t depth) {
+	for(size_t j = 0; j < layout.contents.size(); ++j) {
+		auto& m = layout.contents[j];
+		layout_tree.rows.push_back(layout_tree_row{ &layout, parent, uint32_t(j), depth, produce_label(win, m) });
+		if(std::holds_alternative<sub_layout_t>(m)) {
+			auto& i = get_sub_layout(win, std::get<sub_layout_t>(m));
+			if(i.open_in_ui)
+				flatten_layout_tree(win, i, int32_t(layout_tree.rows.size() - 1), uint16_t(depth + 1));
 		}
-		if (ImGui::BeginPopupContextItem()) {
-			auto& win = open_project.windows[selected_window];
-			auto& buffer = win.buffer;
-			std::string label = "Move " + std::to_string(buffer.size()) + " items from the buffer###MOVE_FROM_BUFFER";
-			if (ImGui::Selectable(label.c_str())) {
-				layout.contents.insert(
-					layout.contents.end(),
-					std::make_move_iterator(
-						buffer.begin()
-					),
-					std::make_move_iterator(
-						buffer.end()
-					)
-				);
-				buffer.clear();
-				for(auto& bc : win.buffer_children) {
-					win.children.push_back(bc);
-				}
-				win.buffer_children.clear();
-				path_to_selected_layout.clear();
-				current_edit_target = edit_targets::layout_sublayout;
-			}
-			if (ImGui::BeginMenu("Add")) {
-				if (ImGui::MenuItem("Control")) {
-					layout.contents.emplace_back(layout_control_t{ });
-					path_to_selected_layout.clear();
-					current_edit_target = edit_targets::layout_sublayout;
+	}
+}
 
-					win.children.emplace_back();
-					win.children.back().x_size = int16_t(open_project.grid_size * 8);
-					win.children.back().y_size = int16_t(open_project.grid_size * 2);
+std::vector<size_t> layout_tree_path(int32_t row) {
+	std::vector<size_t> result;
+	for(auto r = row; r != -1; r = layout_tree.rows[r].parent) {
+		result.push_back(layout_tree.rows[r].index);
+	}
+	std::reverse(result.begin(), result.end());
+	return result;
+}
+bool layout_tree_row_is(int32_t row, std::vector<size_t> const& path) {
+	if(path.size() != size_t(layout_tree.rows[row].depth) + 1)
+		return false;
+	auto k = path.size();
+	for(auto r = row; r != -1; r = layout_tree.rows[r].parent) {
+		if(path[--k] != layout_tree.rows[r].index)
+			return false;
+	}
+	return true;
+}
 
-					auto i = win.children.size();
-					do {
-						std::string def_name = "Control" + std::to_string(i);
-						bool found = false;
-						for(auto& w : win.children) {
-							if(w.name == def_name) {
-								found = true;
-								break;
-							}
-						}
-						if(!found) {
-							win.children.back().name = def_name;
-							break;
-						}
-						++i;
-					} while(true);
+int layout_item_edit_target(layout_item const& m) {
+	if(std::holds_alternative<layout_control_t>(m))
+		return edit_targets::layout_control;
+	if(std::holds_alternative<layout_window_t>(m))
+		return edit_targets::layout_window;
+	if(std::holds_alternative<layout_glue_t>(m))
+		return edit_targets::layout_glue;
+	if(std::holds_alternative<texture_layer_t>(m))
+		return edit_targets::layout_texture;
+	if(std::holds_alternative<generator_t>(m))
+		return edit_targets::layout_generator;
+	return edit_targets::layout_sublayout;
+}
 
-					auto& itm = std::get<layout_control_t>(layout.contents.back());
-					itm.name = win.children.back().name;
-				}
-				if (ImGui::MenuItem("Window")) {
-					layout.contents.emplace_back(layout_window_t{ });
-					path_to_selected_layout.clear();
-					current_edit_target = edit_targets::layout_sublayout;
-				}
-				if (ImGui::MenuItem("Glue")) {
-					layout.contents.emplace_back(layout_glue_t{ });
-					path_to_selected_layout.clear();
-					current_edit_target = edit_targets::layout_sublayout;
-				}
-				if (ImGui::MenuItem("Generator")) {
-					layout.contents.emplace_back(generator_t{ });
-					path_to_selected_layout.clear();
-					current_edit_target = edit_targets::layout_sublayout;
-				}
-				if (ImGui::MenuItem("Sublayout")) {
-					layout.contents.emplace_back(sub_layout_t{ });
-					std::get<sub_layout_t>(layout.contents.back()).layout = std::make_unique<layout_level_t>();
-					path_to_selected_layout.clear();
-					current_edit_target = edit_targets::layout_sublayout;
-				}
-				if (ImGui::MenuItem("Texture layer")) {
-					layout.contents.emplace_back(texture_layer_t{ });
-					path_to_selected_layout.clear();
-					current_edit_target = edit_targets::layout_sublayout;
-				}
-				ImGui::EndMenu();
+void imgui_layout_contents(window_element_wrapper_t& win) {
+	auto& root = win.layout;
+	bool root_expanded = ImGui::TreeNodeEx((char const*)(u8"\uEC4E"), base_tree_flags);
+	if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen()) {
+		path_to_selected_layout = {};
+		current_edit_target = edit_targets::layout_sublayout;
+	}
+	if (ImGui::BeginPopupContextItem()) {
+		auto& buffer = win.buffer;
+		std::string label = "Move " + std::to_string(buffer.size()) + " items from the buffer###MOVE_FROM_BUFFER";
+		if (ImGui::Selectable(label.c_str())) {
+			root.contents.insert(
+				root.contents.end(),
+				std::make_move_iterator(
+					buffer.begin()
+				),
+				std::make_move_iterator(
+					buffer.end()
+				)
+			);
+			buffer.clear();
+			for(auto& bc : win.buffer_children) {
+				win.children.push_back(bc);
 			}
-			ImGui::EndPopup();
+			win.buffer_children.clear();
+			path_to_selected_layout.clear();
+			current_edit_target = edit_targets::layout_sublayout;
 		}
-	}
-
-	ImGui::PushID(&layout);
-
-	int32_t temp = 0;
-	int32_t id = 0;
-	for(size_t j = 0; j < layout.contents.size() && root_expanded; j++) {
-		auto& m = layout.contents[j];
-
-		ImGui::PushID(id);
-
-		auto label = produce_label(m);
-		auto flag_mod = paths_are_the_same(path, j, path_to_selected_layout) ? ImGuiTreeNodeFlags_Selected : 0;
+		if (ImGui::BeginMenu("Add")) {
+			if (ImGui::MenuItem("Control")) {
+				root.contents.emplace_back(layout_control_t{ });
+				path_to_selected_layout.clear();
+				current_edit_target = edit_targets::layout_sublayout;
 
-		tree_location current_location {
-			.dir {},
-			.dir_len = path.size(),
-			.is_root = false,
-			.index = int(j)
-		};
-		for (auto i = 0; i < path.size(); i++) {
-			current_location.dir[i] = path[i];
-		}
+				win.children.emplace_back();
+				win.children.back().x_size = int16_t(open_project.grid_size * 8);
+				win.children.back().y_size = int16_t(open_project.grid_size * 2);
+
+				auto i = win.children.size();
+				do {
+					std::string def_name = "Control" + std::to_string(i);
+					bool found = false;
+					for(auto& w : win.children) {
+						if(w.name == def_name) {
+							found = true;
+							break;
+						}
+					}
+					if(!found) {
+						win.children.back().name = def_name;
+						break;
+					}
+					++i;
+				} while(true);
 
-		if(std::holds_alternative< layout_control_t>(m)) {
-			auto& i = std::get<layout_control_t>(m);
-			auto node_open = ImGui::TreeNodeEx(label.c_str(), base_tree_flags | flag_mod | ImGuiTreeNodeFlags_Leaf);
-			if (update_tree_dnd(root, layout, label, current_location)) {if (node_open) {ImGui::TreePop();} ImGui::PopID(); break;}
-			if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen()) {
-				path_to_selected_layout = path;
-				path_to_selected_layout.push_back(j);
-				current_edit_target = edit_targets::layout_control;
-			}
-			if (node_open) {
-				ImGui::TreePop();
-			}
-		} else if(std::holds_alternative<layout_window_t>(m)) {
-			auto& i = std::get<layout_window_t>(m);
-			auto node_open = ImGui::TreeNodeEx(label.c_str(), base_tree_flags | flag_mod | ImGuiTreeNodeFlags_Leaf);
-			if (update_tree_dnd(root, layout, label, current_location)) {if (node_open) {ImGui::TreePop();} ImGui::PopID(); break;}
-			if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen()) {
-				path_to_selected_layout = path;
-				path_to_selected_layout.push_back(j);
-				current_edit_target = edit_targets::layout_window;
+				auto& itm = std::get<layout_control_t>(root.contents.back());
+				itm.name = win.children.back().name;
 			}
-			if (node_open) {
-				ImGui::TreePop();
+			if (ImGui::MenuItem("Window")) {
+				root.contents.emplace_back(layout_window_t{ });
+				path_to_selected_layout.clear();
+				current_edit_target = edit_targets::layout_sublayout;
 			}
-		} else if(std::holds_alternative<layout_glue_t>(m)) {
-			auto& i = std::get<layout_glue_t>(m);
-			auto node_open = ImGui::TreeNodeEx(label.c_str(), base_tree_flags | flag_mod | ImGuiTreeNodeFlags_Leaf);
-			if (update_tree_dnd(root, layout, label, current_location)) {if (node_open) {ImGui::TreePop();} ImGui::PopID(); break;}
-			if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen()) {
-				path_to_selected_layout = path;
-				path_to_selected_layout.push_back(j);
-				current_edit_target = edit_targets::layout_glue;
-			}
-			if (node_open) {
-				ImGui::TreePop();
-			}
-		} else if (std::holds_alternative<texture_layer_t>(m)) {
-			auto& i = std::get<texture_layer_t>(m);
-			auto node_open = ImGui::TreeNodeEx(label.c_str(), base_tree_flags | flag_mod | ImGuiTreeNodeFlags_Leaf);
-			if (update_tree_dnd(root, layout, label, current_location)) {if (node_open) {ImGui::TreePop();} ImGui::PopID(); break;}
-			if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen()) {
-				path_to_selected_layout = path;
-				path_to_selected_layout.push_back(j);
-				current_edit_target = edit_targets::layout_texture;
-			}
-			if (node_open) {
-				ImGui::TreePop();
+			if (ImGui::MenuItem("Glue")) {
+				root.contents.emplace_back(layout_glue_t{ });
+				path_to_selected_layout.clear();
+				current_edit_target = edit_targets::layout_sublayout;
 			}
-		} else if(std::holds_alternative<generator_t>(m)) {
-			auto& i = std::get<generator_t>(m);
-			auto node_open = ImGui::TreeNodeEx(label.c_str(), base_tree_flags | flag_mod | ImGuiTreeNodeFlags_Leaf);
-			if (update_tree_dnd(root, layout, label, current_location)) {if (node_open) {ImGui::TreePop();} ImGui::PopID(); break;}
-			if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen()) {
-				path_to_selected_layout = path;
-				path_to_selected_layout.push_back(j);
-				current_edit_target = edit_targets::layout_generator;
+			if (ImGui::MenuItem("Generator")) {
+				root.contents.emplace_back(generator_t{ });
+				path_to_selected_layout.clear();
+				current_edit_target = edit_targets::layout_sublayout;
 			}
-			if (node_open) {
-				ImGui::TreePop();
+			if (ImGui::MenuItem("Sublayout")) {
+				root.contents.emplace_back(make_sub_layout(win));
+				path_to_selected_layout.clear();
+				current_edit_target = edit_targets::layout_sublayout;
 			}
-		} else if(std::holds_alternative< sub_layout_t>(m)) {
-			auto& i = std::get<sub_layout_t>(m);
-			auto node_open = ImGui::TreeNodeEx(label.c_str(), base_tree_flags | flag_mod);
-			if (update_tree_dnd(root, layout, label, current_location)) {if (node_open) {ImGui::TreePop();} ImGui::PopID(); break;}
-			if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen()) {
-				path_to_selected_layout = path;
-				path_to_selected_layout.push_back(j);
+			if (ImGui::MenuItem("Texture layer")) {
+				root.contents.emplace_back(texture_layer_t{ });
+				path_to_selected_layout.clear();
 				current_edit_target = edit_targets::layout_sublayout;
 			}
+			ImGui::EndMenu();
+		}
+		ImGui::EndPopup();
+		layout_tree.stale = true; // whatever the menu did has to show up in the rows below
+	}
+	if(!root_expanded)
+		return;
 
-			if(node_open) {
-				i.layout->open_in_ui = true;
-				auto new_path = path;
-				new_path.push_back(j);
-				imgui_layout_contents(root, *i.layout, new_path);
-				ImGui::TreePop();
+	if(layout_tree.stale || layout_tree.window != &win) {
+		layout_tree.rows.clear();
+		flatten_layout_tree(win, root, -1, 0);
+		layout_tree.window = &win;
+		layout_tree.stale = false;
+	}
+
+	bool structure_changed = false;
+	ImGuiListClipper clipper;
+	clipper.Begin(int(layout_tree.rows.size()));
+	while(!structure_changed && clipper.Step()) {
+		for(int r = clipper.DisplayStart; r < clipper.DisplayEnd; ++r) {
+			auto& row = layout_tree.rows[r];
+			auto& m = row.level->contents[row.index];
+
+			ImGui::PushID(row.level);
+			ImGui::PushID(int32_t(row.index));
+			if(row.depth > 0)
+				ImGui::Indent(ImGui::GetStyle().IndentSpacing * row.depth);
+
+			tree_location current_location{
+				.dir {},
+				.dir_len = row.depth,
+				.is_root = false,
+				.index = int(row.index)
+			};
+			for(auto p = row.parent; p != -1; p = layout_tree.rows[p].parent) {
+				current_location.dir[layout_tree.rows[p].depth] = layout_tree.rows[p].index;
+			}
+
+			auto flag_mod = layout_tree_row_is(r, path_to_selected_layout) ? ImGuiTreeNodeFlags_Selected : 0;
+			sub_layout_t* sub = std::get_if<sub_layout_t>(&m);
+			if(sub)
+				ImGui::SetNextItemOpen(get_sub_layout(win, *sub).open_in_ui);
+			auto node_open = ImGui::TreeNodeEx(row.label.c_str(), base_tree_flags | flag_mod | ImGuiTreeNodeFlags_NoTreePushOnOpen | (sub ? 0 : ImGuiTreeNodeFlags_Leaf));
+			if(update_tree_dnd(root, *row.level, row.label, current_location)) {
+				structure_changed = true;
 			} else {
-				i.layout->open_in_ui = false;
+				if(ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen()) {
+					path_to_selected_layout = layout_tree_path(r);
+					current_edit_target = layout_item_edit_target(m);
+				}
+				if(sub && get_sub_layout(win, *sub).open_in_ui != node_open) {
+					get_sub_layout(win, *sub).open_in_ui = node_open;
+					structure_changed = true;
+				}
 			}
-		}
-
-		// ImGui::NewLine();
 
-		ImGui::PopID();
-		++id;
+			if(row.depth > 0)
+				ImGui::Unindent(ImGui::GetStyle().IndentSpacing * row.depth);
+			ImGui::PopID();
+			ImGui::PopID();
+			if(structure_changed) // the rows after this one no longer match the layout
+				break;
+		}
+	}
+	clipper.End();
+	if(structure_changed) {
+		layout_tree.stale = true;
+		compact_sub_layouts(win); // the rows are rebuilt from scratch, so nothing still points into the arena
 	}
-	ImGui::PopID();
 
-	if (path.size() == 0 && root_expanded) {ImGui::TreePop();}
+	ImGui::TreePop();
 }
 
-layout_control_t* find_control(layout_level_t& lvl, int32_t index) {
+layout_control_t* find_control(window_element_wrapper_t& win, layout_level_t& lvl, int32_t index) {
 	for(auto& m : lvl.contents) {
 		if(std::holds_alternative<layout_control_t>(m)) {
 			auto& i = get<layout_control_t>(m);
@@ -4377,7 +4784,7 @@ layout_control_t* find_control(layout_level_t& lvl, int32_t index) {
 				return &i;
 		} else if(holds_alternative<sub_layout_t>(m)) {
 			auto& i = get<sub_layout_t>(m);
-			auto r = find_control(*i.layout, index);
+			auto r = find_control(win, get_sub_layout(win, i), index);
 			if(r)
 				return r;
 		}
@@ -4504,6 +4911,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 	int32_t display_w = 0;
 	int32_t display_h = 0;
 	auto switch_to_window = [&](int32_t i) {
+		layout_tree.stale = true; // also after undo and after opening a project, which replace the windows
 		path_to_selected_layout.clear();
 		current_edit_target = edit_targets::layout_sublayout;
 		if(0 <= i && i < int32_t(open_project.windows.size())) {
@@ -4521,9 +4929,46 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 		}
 	};
 
+	edit_history.reset(open_project);
+	bool history_check_pending = false;
+	auto step_history = [&](bool forward) {
+		edit_history.record(open_project, selected_window, selected_table != -1);
+		if(forward ? !edit_history.can_redo() : !edit_history.can_undo())
+			return;
+		auto focus = forward ? edit_history.redo(open_project) : edit_history.undo(open_project);
+		layout_tree.stale = true;
+		project_autosave.submit(open_project, edit_history.current());
+		if(focus < 0 || focus >= int32_t(open_project.windows.size()))
+			focus = selected_window < int32_t(open_project.windows.size()) ? selected_window : -1;
+		if(focus != selected_window) {
+			switch_to_window(focus);
+		} else { // the layout may have changed shape underneath the selection, so it is dropped
+			path_to_selected_layout.clear();
+			current_edit_target = edit_targets::layout_sublayout;
+			selected_control = -1;
+			selected_table = -1;
+		}
+	};
+
+	// the loop only blocks waiting for input once a few frames have gone by without any, so that whatever the input set off
+	// (hover states, popups opening, edits recorded in the history) has had a chance to show up on screen
+	int32_t busy_frames = 3;
+	int32_t canvas_damage_frames = 3;
+	bool was_rerendering = false;
+
 	// Main loop
 	while(!glfwWindowShouldClose(window)) {
-		glfwPollEvents();
+		bool rerendering = asvg::renders_pending();
+		if(busy_frames > 0 || ogl::textures_pending() || rerendering) {
+			glfwPollEvents();
+		} else {
+			// wake up now and then anyway, for the blinking text cursor and delayed tooltips
+			glfwWaitEventsTimeout(io.WantTextInput || ImGui::IsAnyItemHovered() ? 0.25 : 2.0);
+		}
+		if(ImGui::GetCurrentContext()->InputEventsQueue.Size > 0)
+			busy_frames = 3;
+		else if(busy_frames > 0)
+			--busy_frames;
 		if(glfwGetWindowAttrib(window, GLFW_ICONIFIED) != 0) {
 			ImGui_ImplGlfw_Sleep(10);
 			continue;
@@ -4532,6 +4977,16 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 		ImGui_ImplOpenGL3_NewFrame();
 		ImGui_ImplGlfw_NewFrame();
 		ImGui::NewFrame();
+		if(ogl::upload_pending_textures() > 0)
+			canvas_damage_frames = std::max(canvas_damage_frames, 1);
+		if(apply_file_changes())
+			canvas_damage_frames = std::max(canvas_damage_frames, 1);
+		// svgs that changed are rendered again in the background, and the results are only picked up when the canvas is drawn
+		if(rerendering || was_rerendering)
+			canvas_damage_frames = std::max(canvas_damage_frames, 1);
+		was_rerendering = rerendering;
+		if(input_may_have_edited(io))
+			canvas_damage_frames = 2; // some edits (such as menu commands) only land on the frame after the click
 
 		//if(show_demo_window)
 		//	ImGui::ShowDemoWindow();
@@ -4539,6 +4994,13 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 		bool open_modal_properties = false;
 		bool open_modal_table_properties = false;
 
+		if(!io.WantTextInput && !dragging && control_drag_target == drag_target::none && !ImGui::IsPopupOpen("", ImGuiPopupFlags_AnyPopupId)) {
+			if(ImGui::IsKeyChordPressed(ImGuiMod_Ctrl | ImGuiKey_Z))
+				step_history(false);
+			else if(ImGui::IsKeyChordPressed(ImGuiMod_Ctrl | ImGuiKey_Y) || ImGui::IsKeyChordPressed(ImGuiMod_Ctrl | ImGuiMod_Shift | ImGuiKey_Z))
+				step_history(true);
+		}
+
 		if (ImGui::BeginMainMenuBar()) {
 			// std::string pname = fs::native_to_utf8(open_project.project_name);
 
@@ -4561,7 +5023,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 							open_templates = template_project::bytes_to_project(file_content);
 							open_templates.project_name = rem.substr(0, ext_pos);
 							open_templates.project_directory = open_project.project_directory;
-							asvg::common_file_bank::bank.root_directory = open_templates.project_directory + open_templates.svg_directory;
+							asvg::common_file_bank::bank.set_root_directory(open_templates.project_directory + open_templates.svg_directory);
 
 							for(auto& i : open_templates.icons) {
 								fs::file loaded_file{ open_templates.project_directory + open_templates.svg_directory + fs::utf8_to_native(i.file_name) };
@@ -4572,12 +5034,18 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 								b.renders = asvg::svg(loaded_file.content().data, size_t(loaded_file.content().file_size), b.base_x, b.base_y);
 							}
 						}
+						edit_history.reset(open_project);
+						project_autosave.start(open_project, edit_history.current());
+						watch_project_files();
 					}
 				}
 
 				if (ImGui::MenuItem("Open", "Ctrl+O")) {
 					auto new_file = fs::pick_existing_file(L"aui");
 					if(new_file.length() > 0) {
+						// the worker goes on writing out the project that was open before, and takes up this one after it;
+						// only reopening that same project has to wait, so that its journal is read whole
+						project_autosave.wait_for(new_file);
 						auto breakpt = new_file.find_last_of(L'\\');
 						auto rem = new_file.substr(breakpt + 1);
 						auto ext_pos = rem.find_last_of(L'.');
@@ -4585,6 +5053,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 							fs::file loaded_file{ new_file };
 							serialization::in_buffer file_content{ loaded_file.content().data, loaded_file.content().file_size };
 							open_project = bytes_to_project(file_content);
+							autosave::replay_journal(new_file, open_project);
 							open_project.project_name = rem.substr(0, ext_pos);
 							open_project.project_directory = new_file.substr(0, breakpt + 1);
 							switch_to_window(0);
@@ -4596,7 +5065,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 							open_templates = template_project::bytes_to_project(file_content);
 							open_templates.project_name = rem.substr(0, ext_pos);
 							open_templates.project_directory = open_project.project_directory;
-							asvg::common_file_bank::bank.root_directory = open_templates.project_directory + open_templates.svg_directory;
+							asvg::common_file_bank::bank.set_root_directory(open_templates.project_directory + open_templates.svg_directory);
 
 							for(auto& i : open_templates.icons) {
 								fs::file loaded_file{ open_templates.project_directory + open_templates.svg_directory + fs::utf8_to_native(i.file_name) };
@@ -4618,22 +5087,21 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 							}
 						}
 					}
+					if(new_file.length() > 0) {
+						edit_history.reset(open_project);
+						project_autosave.start(open_project, edit_history.current());
+						watch_project_files();
+					}
 				}
 
 				if (ImGui::MenuItem("Save", "Ctrl+S")) {
-					serialization::out_buffer bytes;
-					project_to_bytes(open_project, bytes);
-					fs::write_file(open_project.project_directory + open_project.project_name + L".aui", bytes.data(), uint32_t(bytes.size()));
+					edit_history.record(open_project, selected_window, selected_table != -1);
+					project_autosave.save(open_project, edit_history.current());
 				}
 
 				if (ImGui::MenuItem("Generate code")) {
-					generator::code_snippets old_code;
-					{
-						fs::file loaded_file{ open_project.project_directory + open_project.source_path + open_project.project_name + L".cpp" };
-						old_code = generator::extract_snippets(loaded_file.content().data, loaded_file.content().file_size);
-					}
-					auto text = generator::generate_project_code(open_project, old_code);
-					fs::write_file(open_project.project_directory + open_project.source_path + open_project.project_name + L".cpp", text.c_str(), uint32_t(text.size()));
+					edit_history.record(open_project, selected_window, selected_table != -1);
+					project_autosave.generate_code(open_project, edit_history.current(), template_project::any_nine_slice_background(open_templates));
 				}
 
 				if (ImGui::MenuItem("Properties"))
@@ -4642,6 +5110,13 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 				ImGui::EndMenu();
 			}
 
+			if(ImGui::BeginMenu("Edit")) {
+				if(ImGui::MenuItem("Undo", "Ctrl+Z", false, edit_history.can_undo()))
+					step_history(false);
+				if(ImGui::MenuItem("Redo", "Ctrl+Y", false, edit_history.can_redo()))
+					step_history(true);
+				ImGui::EndMenu();
+			}
 
 			if (ImGui::BeginMenu("Create")) {
 				if (ImGui::MenuItem("Window")) {
@@ -4691,6 +5166,11 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 				ImGui::EndMenu();
 			}
 
+			if(ImGui::BeginMenu("View")) {
+				ImGui::MenuItem("Draw icons from distance fields", nullptr, &icons_from_distance_fields);
+				ImGui::EndMenu();
+			}
+
 			if(ImGui::BeginMenu("Visual Studio Integration")) {
 				if(open_vs_windows.empty())
 					populate_vs_windows_list();
@@ -4799,6 +5279,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					open_project.grid_size = 1;
 				}
 				ImGui::Checkbox("Omit lua support code", &open_project.omit_lua);
+				ImGui::Checkbox("Bake layouts into the generated code", &open_project.bake_layouts);
 			}
 			ImGui::End();
 		}
@@ -4819,7 +5300,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 				auto& win = open_project.windows[selected_window];
 				auto current_item = &win.layout;
 				for (size_t i = 0; i + 1 < path_to_selected_layout.size(); i++) {
-					current_item = std::get<sub_layout_t>(current_item->contents[path_to_selected_layout[i]]).layout.get();
+					current_item = &get_sub_layout(win, std::get<sub_layout_t>(current_item->contents[path_to_selected_layout[i]]));
 				}
 
 				auto& i = std::get<layout_window_t>(current_item->contents[path_to_selected_layout.back()]);
@@ -4842,6 +5323,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 						i.name = "";
 					else
 						i.name = open_project.windows[selection - 1].wrapped.name;
+					layout_tree.stale = true;
 				}
 
 				ImGui::Checkbox("Absolute position", &(i.absolute_position));
@@ -4864,13 +5346,14 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 				auto& win = open_project.windows[selected_window];
 				auto current_item = &win.layout;
 				for (size_t i = 0; i + 1 < path_to_selected_layout.size(); i++) {
-					current_item = std::get<sub_layout_t>(current_item->contents[path_to_selected_layout[i]]).layout.get();
+					current_item = &get_sub_layout(win, std::get<sub_layout_t>(current_item->contents[path_to_selected_layout[i]]));
 				}
 
 				auto& i = std::get<generator_t>(current_item->contents[path_to_selected_layout.back()]);
 				int32_t temp;
 
-				ImGui::InputText("Name", &(i.name));
+				if(ImGui::InputText("Name", &(i.name)))
+					layout_tree.stale = true;
 
 				ImGui::Text("Generated items:");
 				int32_t id2 = 4000;
@@ -4961,19 +5444,20 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 				auto& win = open_project.windows[selected_window];
 				auto current_item = &win.layout;
 				for (size_t i = 0; i + 1 < path_to_selected_layout.size(); i++) {
-					current_item = std::get<sub_layout_t>(current_item->contents[path_to_selected_layout[i]]).layout.get();
+					current_item = &get_sub_layout(win, std::get<sub_layout_t>(current_item->contents[path_to_selected_layout[i]]));
 				}
 
 				auto& i = std::get<texture_layer_t>(current_item->contents[path_to_selected_layout.back()]);
 
 				{
 					int index = retrieve_texture_layer_type(i.texture_type);
-					ImGui::Combo(
+					if(ImGui::Combo(
 						"Texture type",
 						&index,
 						texture_layer_names,
 						4
-					);
+					))
+						layout_tree.stale = true;
 					i.texture_type = texture_layer_available_types[index];
 				}
 
@@ -4986,6 +5470,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 						//auto breakpt = new_file.find_last_of(L'\\');
 						//open_project.windows[i].wrapped.texture = fs::native_to_utf8(new_file.substr(breakpt + 1));
 						i.texture = fs::native_to_utf8(relative_file_name(new_file, open_project.project_directory));
+						layout_tree.stale = true;
 					}
 				}
 			}
@@ -4998,7 +5483,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 				auto& win = open_project.windows[selected_window];
 				auto current_item = &win.layout;
 				for (size_t i = 0; i + 1 < path_to_selected_layout.size(); i++) {
-					current_item = std::get<sub_layout_t>(current_item->contents[path_to_selected_layout[i]]).layout.get();
+					current_item = &get_sub_layout(win, std::get<sub_layout_t>(current_item->contents[path_to_selected_layout[i]]));
 				}
 
 				auto& i = std::get<layout_glue_t>(current_item->contents[path_to_selected_layout.back()]);
@@ -5006,12 +5491,14 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 
 				{
 					temp = int32_t(i.type);
-					ImGui::Combo("Glue type", &temp, glue_names, 5);
+					if(ImGui::Combo("Glue type", &temp, glue_names, 5))
+						layout_tree.stale = true;
 					i.type = glue_type(temp);
 				}
 				if(i.type == glue_type::standard || i.type == glue_type::at_least || i.type == glue_type::glue_don_t_break) {
 					temp = i.amount;
-					ImGui::InputInt("Glue amount", &temp);
+					if(ImGui::InputInt("Glue amount", &temp))
+						layout_tree.stale = true;
 					i.amount = int16_t(temp);
 				}
 			}
@@ -5025,7 +5512,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 				auto current_item = &win.layout;
 				if(!path_to_selected_layout.empty()) {
 					for(size_t i = 0; i + 1 < path_to_selected_layout.size(); i++) {
-						current_item = std::get<sub_layout_t>(current_item->contents[path_to_selected_layout[i]]).layout.get();
+						current_item = &get_sub_layout(win, std::get<sub_layout_t>(current_item->contents[path_to_selected_layout[i]]));
 					}
 
 					auto& selected_item = std::get<layout_control_t>(current_item->contents[path_to_selected_layout.back()]);
@@ -5049,7 +5536,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 				auto& win = open_project.windows[selected_window];
 				auto selected_layout = &win.layout;
 				for (auto i : path_to_selected_layout) {
-					selected_layout = std::get<sub_layout_t>(selected_layout->contents[i]).layout.get();
+					selected_layout = &get_sub_layout(win, std::get<sub_layout_t>(selected_layout->contents[i]));
 				}
 				if(selected_layout == &win.layout) {
 					window_options(win);
@@ -5087,14 +5574,18 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 			ImGuiTabBarFlags tab_bar_flags = ImGuiTabBarFlags_None;
 			if (ImGui::BeginTabBar("SelectionTabs", tab_bar_flags)) {
 				if (ImGui::BeginTabItem("Tables")) {
-					for(size_t ti = 0; ti < open_project.tables.size(); ++ti) {
-						ImGui::PushID(int32_t(ti));
-						auto& c = open_project.tables[ti];
-						if (ImGui::Button(c.name.c_str())) {
-							selected_table = ti;
-							open_modal_table_properties = true;
+					ImGuiListClipper table_clipper;
+					table_clipper.Begin(int(open_project.tables.size()));
+					while(table_clipper.Step()) {
+						for(int ti = table_clipper.DisplayStart; ti < table_clipper.DisplayEnd; ++ti) {
+							ImGui::PushID(ti);
+							auto& c = open_project.tables[ti];
+							if (ImGui::Button(c.name.c_str())) {
+								selected_table = ti;
+								open_modal_table_properties = true;
+							}
+							ImGui::PopID();
 						}
-						ImGui::PopID();
 					}
 					ImGui::EndTabItem();
 				}
@@ -5102,11 +5593,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					auto& win = open_project.windows[selected_window];
 
 					if (ImGui::BeginTabItem("Layout")) {
-						imgui_layout_contents(
-							open_project.windows[selected_window].layout,
-							open_project.windows[selected_window].layout,
-							{}
-						);
+						imgui_layout_contents(open_project.windows[selected_window]);
 						ImGui::EndTabItem();
 					}
 				}
@@ -5153,6 +5640,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 							}
 
 							c.name = c.temp_name;
+							edit_history.request_full_check();
 						}
 					}
 				}
@@ -5230,7 +5718,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Reorder");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue; // scrolled out of view, nothing to submit
 
 						ImGui::PushID(k);
 						ImGui::Button("drag");
@@ -5268,7 +5757,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Column name");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 
 						ImGui::PushID(k);
 						ImGui::SetNextItemWidth(text_scale * 150.f);
@@ -5283,7 +5773,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					int32_t temp;
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 
 						ImGui::PushID(k);
 						temp = c.table_columns[k].display_data.width;
@@ -5298,7 +5789,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Spacer column");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 
 						ImGui::PushID(k);
 						bool is_spacer = c.table_columns[k].internal_data.cell_type == table_cell_type::spacer;
@@ -5313,7 +5805,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Cell text color");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 						bool is_spacer = c.table_columns[k].internal_data.cell_type == table_cell_type::spacer;
 						if (is_spacer) {
 							ImGui::BeginDisabled();
@@ -5344,7 +5837,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Cell text alignment");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 						bool is_spacer = c.table_columns[k].internal_data.cell_type == table_cell_type::spacer;
 						if (is_spacer) {
 							ImGui::BeginDisabled();
@@ -5368,7 +5862,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Decimal alignment");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 						bool is_spacer = c.table_columns[k].internal_data.cell_type == table_cell_type::spacer;
 						if (is_spacer) {
 							ImGui::BeginDisabled();
@@ -5392,7 +5887,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Dynamic cell tooltip");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 						bool is_spacer = c.table_columns[k].internal_data.cell_type == table_cell_type::spacer;
 						if (is_spacer) {
 							ImGui::BeginDisabled();
@@ -5413,7 +5909,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Cell tooltip key");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 						bool is_spacer = c.table_columns[k].internal_data.cell_type == table_cell_type::spacer;
 						if (is_spacer) {
 							ImGui::BeginDisabled();
@@ -5439,7 +5936,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Column is sortable");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 						bool is_spacer = c.table_columns[k].internal_data.cell_type == table_cell_type::spacer;
 						if (is_spacer) {
 							ImGui::BeginDisabled();
@@ -5460,7 +5958,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Header key");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 						bool is_spacer = c.table_columns[k].internal_data.cell_type == table_cell_type::spacer;
 						if (is_spacer) {
 							ImGui::BeginDisabled();
@@ -5480,7 +5979,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Header has background");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 						bool is_spacer = c.table_columns[k].internal_data.cell_type == table_cell_type::spacer;
 						if (is_spacer || c.template_id != -1) {
 							ImGui::BeginDisabled();
@@ -5500,7 +6000,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Header background:");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 						bool is_spacer = c.table_columns[k].internal_data.cell_type == table_cell_type::spacer;
 						if (is_spacer || c.template_id != -1) {
 							ImGui::BeginDisabled();
@@ -5532,7 +6033,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Header text color");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 						bool is_spacer = c.table_columns[k].internal_data.cell_type == table_cell_type::spacer;
 						if (is_spacer) {
 							ImGui::BeginDisabled();
@@ -5563,7 +6065,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Dynamic header tooltip");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 						bool is_spacer = c.table_columns[k].internal_data.cell_type == table_cell_type::spacer;
 						if (is_spacer) {
 							ImGui::BeginDisabled();
@@ -5590,7 +6093,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Header tooltip key");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 						bool is_spacer = c.table_columns[k].internal_data.cell_type == table_cell_type::spacer;
 						if (is_spacer) {
 							ImGui::BeginDisabled();
@@ -5617,7 +6121,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					ImGui::Text("Delete");
 
 					for (int k = 0; k < amount_of_columns; k++) {
-						ImGui::TableSetColumnIndex(k + 1);
+						if(!ImGui::TableSetColumnIndex(k + 1))
+							continue;
 
 						ImGui::PushID(k);
 						ImGui::SetNextItemWidth(text_scale * 150.f);
@@ -5664,31 +6169,28 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 				if(0 <= selected_window && selected_window < int32_t(open_project.windows.size())) {
 					auto& win = open_project.windows[selected_window];
 
-					for(auto i = win.children.size(); i-- > 0; ) {
+					drag_target ct = drag_target::none;
+					if(auto i = pick_control(win, io.MousePos.x, io.MousePos.y, ui_scale, ct); i != -1) {
 						auto& c = win.children[i];
-						auto ct = test_rect_target(io.MousePos.x, io.MousePos.y, c.x_pos, c.y_pos, c.x_size * ui_scale, c.y_size * ui_scale, ui_scale);
-						if(ct != drag_target::none) {
-							selected_control = int32_t(i);
-							current_edit_target = edit_targets::layout_control;
-							path_to_selected_layout.clear();
-							control_drag_target = ct;
-
-							drag_start_x = io.MousePos.x;
-							drag_start_y = io.MousePos.y;
-							auto lc = find_control(win.layout, selected_control);
-							if(lc) {
-								base_values.x_pos = lc->abs_x;
-								base_values.y_pos = lc->abs_y;
-								path_to_selected_layout = tree_location_from_control(lc->name, win);
-							} else {
-								base_values.x_pos = c.x_pos;
-								base_values.y_pos = c.y_pos;
-							}
-
-							base_values.x_size = c.x_size;
-							base_values.y_size = c.y_size;
-							break;
+						selected_control = int32_t(i);
+						current_edit_target = edit_targets::layout_control;
+						path_to_selected_layout.clear();
+						control_drag_target = ct;
+
+						drag_start_x = io.MousePos.x;
+						drag_start_y = io.MousePos.y;
+						auto lc = find_control(win, win.layout, selected_control);
+						if(lc) {
+							base_values.x_pos = lc->abs_x;
+							base_values.y_pos = lc->abs_y;
+							path_to_selected_layout = tree_location_from_control(lc->name, win);
+						} else {
+							base_values.x_pos = c.x_pos;
+							base_values.y_pos = c.y_pos;
 						}
+
+						base_values.x_size = c.x_size;
+						base_values.y_size = c.y_size;
 					}
 
 					if(selected_control == -1) {
@@ -5804,7 +6306,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 						switch(control_drag_target) {
 							case drag_target::center:
 							{
-								auto lc = find_control(win.layout, selected_control);
+								auto lc = find_control(win, win.layout, selected_control);
 								if(lc && lc->absolute_position) {
 									lc->abs_x = int16_t(base_values.x_pos + offset_x - (c.no_grid ? 0.0f : std::fmod(base_values.x_pos + offset_x, float(open_project.grid_size))));
 									lc->abs_y = int16_t(base_values.y_pos + offset_y - (c.no_grid ? 0.0f : std::fmod(base_values.y_pos + offset_y, float(open_project.grid_size))));
@@ -5869,15 +6371,11 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 					auto& win = open_project.windows[selected_window];
 					hovered_control = -1;
 
-					for(auto i = win.children.size(); i-- > 0; ) {
-						auto& c = win.children[i];
-						auto ct = test_rect_target(io.MousePos.x, io.MousePos.y, c.x_pos, c.y_pos, c.x_size * ui_scale, c.y_size * ui_scale, ui_scale);
-						if(ct != drag_target::none) {
-							hovered_control = int32_t(i);
-							mouse_to_drag_type(ct);
-							ImGui::SetTooltip("%s", c.name.c_str());
-							break;
-						}
+					drag_target ct = drag_target::none;
+					if(auto i = pick_control(win, io.MousePos.x, io.MousePos.y, ui_scale, ct); i != -1) {
+						hovered_control = i;
+						mouse_to_drag_type(ct);
+						ImGui::SetTooltip("%s", win.children[i].name.c_str());
 					}
 
 					if(hovered_control == -1) {
@@ -5891,41 +6389,88 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 			}
 		}
 
+		// an edit is recorded once the interaction that made it is over, so that a whole drag or a typed name is one step
+		if(ImGui::IsAnyItemActive() || io.MouseDown[0] || io.MouseDown[1] || dragging || control_drag_target != drag_target::none) {
+			history_check_pending = true;
+		} else if(history_check_pending) {
+			if(edit_history.record(open_project, selected_window, selected_table != -1))
+				project_autosave.submit(open_project, edit_history.current());
+			history_check_pending = false;
+		}
+
 		// Rendering
 		ImGui::Render();
 
 		glfwGetFramebufferSize(window, &display_w, &display_h);
-		glViewport(0, 0, display_w, display_h);
-		glClearColor(clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-
-		glUseProgram(ui_shader_program);
-		glUniform1i(glGetUniformLocation(ui_shader_program, "texture_sampler"), 0);
-		glUniform1f(glGetUniformLocation(ui_shader_program, "screen_width"), float(display_w));
-		glUniform1f(glGetUniformLocation(ui_shader_program, "screen_height"), float(display_h));
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
 
+		canvas_framebuffer::inputs canvas_inputs;
+		canvas_inputs.selected_control = selected_control;
+		canvas_inputs.drag_offset_x = drag_offset_x;
+		canvas_inputs.drag_offset_y = drag_offset_y;
+		canvas_inputs.ui_scale = ui_scale;
+		canvas_inputs.grid_size = open_project.grid_size;
+		canvas_inputs.icons_from_distance_fields = icons_from_distance_fields;
+		canvas_inputs.window_count = open_project.windows.size();
 		if(0 <= selected_window && selected_window < int32_t(open_project.windows.size())) {
 			auto& win = open_project.windows[selected_window];
-			bool highlightwin = selected_control == -1 && (test_rect_target(io.MousePos.x, io.MousePos.y, win.wrapped.x_pos * ui_scale + drag_offset_x, win.wrapped.y_pos * ui_scale + drag_offset_y, win.wrapped.x_size * ui_scale, win.wrapped.y_size * ui_scale, ui_scale) != drag_target::none || control_drag_target != drag_target::none);
-			render_window(win, (win.wrapped.x_pos + drag_offset_x / ui_scale), (win.wrapped.y_pos + drag_offset_y / ui_scale), highlightwin, ui_scale);
+			canvas_inputs.window = &win;
+			canvas_inputs.highlight_window = selected_control == -1 && (test_rect_target(io.MousePos.x, io.MousePos.y, win.wrapped.x_pos * ui_scale + drag_offset_x, win.wrapped.y_pos * ui_scale + drag_offset_y, win.wrapped.x_size * ui_scale, win.wrapped.y_size * ui_scale, ui_scale) != drag_target::none || control_drag_target != drag_target::none);
 		}
 
-		//
-		// Draw Grid
-		//
-		{
-			glBindVertexArray(global_square_vao);
-			glBindVertexBuffer(0, global_square_buffer, 0, sizeof(GLfloat) * 4);
-			glUniform4f(glGetUniformLocation(ui_shader_program, "d_rect"), 0.0f, 0.0f, float(display_w), float(display_h));
-			glUniform1f(glGetUniformLocation(ui_shader_program, "grid_size"), ui_scale * float(open_project.grid_size));
-			glUniform2f(glGetUniformLocation(ui_shader_program, "grid_off"), std::floor(-drag_offset_x), std::floor(-drag_offset_y));
-			GLuint subroutines[2] = { 4, 0 };
-			glUniform2ui(glGetUniformLocation(ui_shader_program, "subroutines_index"), subroutines[0], subroutines[1]);
+		canvas_cache.resize(display_w, display_h);
+		bool draw_canvas = canvas_cache.framebuffer == 0 || !canvas_cache.valid || canvas_damage_frames > 0 || !(canvas_inputs == canvas_cache.drawn);
+		if(canvas_damage_frames > 0)
+			--canvas_damage_frames;
+
+		if(draw_canvas) {
+			glBindFramebuffer(GL_FRAMEBUFFER, canvas_cache.framebuffer);
+			glViewport(0, 0, display_w, display_h);
+			glClearColor(clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+			glUseProgram(ui_shader_program);
+			glUniform1i(glGetUniformLocation(ui_shader_program, "texture_sampler"), 0);
+			glUniform1i(glGetUniformLocation(ui_shader_program, "tint_sampler"), 1);
+			glUniform1f(glGetUniformLocation(ui_shader_program, "screen_width"), float(display_w));
+			glUniform1f(glGetUniformLocation(ui_shader_program, "screen_height"), float(display_h));
+			glEnable(GL_BLEND);
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+
+			if(canvas_inputs.window) {
+				auto& win = open_project.windows[selected_window];
+				control_hits.clear(&win, 2.0f * ui_scale);
+				render_window(win, (win.wrapped.x_pos + drag_offset_x / ui_scale), (win.wrapped.y_pos + drag_offset_y / ui_scale), canvas_inputs.highlight_window, ui_scale);
+				control_hits.build();
+			} else {
+				control_hits.clear(nullptr, 0.0f);
+			}
+
+			//
+			// Draw Grid
+			//
+			{
+				glBindVertexArray(global_square_vao);
+				glBindVertexBuffer(0, global_square_buffer, 0, sizeof(GLfloat) * 4);
+				glUniform4f(glGetUniformLocation(ui_shader_program, "d_rect"), 0.0f, 0.0f, float(display_w), float(display_h));
+				glUniform1f(glGetUniformLocation(ui_shader_program, "grid_size"), ui_scale * float(open_project.grid_size));
+				glUniform2f(glGetUniformLocation(ui_shader_program, "grid_off"), std::floor(-drag_offset_x), std::floor(-drag_offset_y));
+				GLuint subroutines[2] = { 4, 0 };
+				glUniform2ui(glGetUniformLocation(ui_shader_program, "subroutines_index"), subroutines[0], subroutines[1]);
+			}
+			glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+
+			canvas_cache.drawn = canvas_inputs;
+			canvas_cache.valid = canvas_cache.framebuffer != 0;
+		}
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(0, 0, display_w, display_h);
+		if(canvas_cache.framebuffer != 0) {
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, canvas_cache.framebuffer);
+			glBlitFramebuffer(0, 0, display_w, display_h, 0, 0, display_w, display_h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
 		}
-		glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 
 		glDepthRange(-1.0f, 1.0f);
 
@@ -5935,6 +6480,11 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 	}
 
 	// Cleanup
+	project_autosave.stop();
+	file_watch.project.reset();
+	file_watch.svgs.reset();
+	canvas_cache.release();
+	ogl::shutdown_texture_cache();
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplGlfw_Shutdown();
 	ImGui::DestroyContext();
@@ -522,7 +522,23 @@ static void composition_source_in(uint32_t* dest, int length, const uint32_t* sr
 static void composition_destination_in(uint32_t* dest, int length, const uint32_t* src, uint32_t const_alpha)
 {
     if(const_alpha == 255) {
-        for(int i = 0; i < length; i++) {
+        int i = 0;
+#ifdef __SSE2__
+        // masks are applied this way one whole layer at a time, so multiply four pixels at once, rounding exactly like BYTE_MUL
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i half = _mm_set1_epi16(0x80);
+        for(; i + 4 <= length; i += 4) {
+            __m128i d = _mm_loadu_si128((const __m128i*)(dest + i));
+            __m128i a = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(src + i)), 24);
+            a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+            __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi32(a, a));
+            __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi32(a, a));
+            lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), half), 8);
+            hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), half), 8);
+            _mm_storeu_si128((__m128i*)(dest + i), _mm_packus_epi16(lo, hi));
+        }
+#endif
+        for(; i < length; i++) {
             dest[i] = BYTE_MUL(dest[i], plutovg_alpha(src[i]));
         }
     } else {
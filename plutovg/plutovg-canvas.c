@@ -1,6 +1,8 @@
 #include "plutovg-private.h"
 #include "plutovg-utils.h"
 
+#include <limits.h>
+
 int plutovg_version(void)
 {
     return PLUTOVG_VERSION;
@@ -29,6 +31,7 @@ static plutovg_state_t* plutovg_state_create(void)
     state->font_size = 12.f;
     state->opacity = 1.f;
     state->clipping = false;
+    state->clip_is_rect = false;
     state->next = NULL;
     return state;
 }
@@ -50,6 +53,7 @@ static void plutovg_state_reset(plutovg_state_t* state)
     state->font_size = 12.f;
     state->opacity = 1.f;
     state->clipping = false;
+    state->clip_is_rect = false;
 }
 
 static void plutovg_state_copy(plutovg_state_t* state, const plutovg_state_t* source)
@@ -68,6 +72,7 @@ static void plutovg_state_copy(plutovg_state_t* state, const plutovg_state_t* so
     state->font_size = source->font_size;
     state->opacity = source->opacity;
     state->clipping = source->clipping;
+    state->clip_is_rect = source->clip_is_rect;
 }
 
 static void plutovg_state_destroy(plutovg_state_t* state)
@@ -91,6 +96,7 @@ plutovg_canvas_t* plutovg_canvas_create(plutovg_surface_t* surface)
     canvas->clip_rect = PLUTOVG_MAKE_RECT(0.f, 0.f, (float)(surface->width), (float)(surface->height));
     plutovg_span_buffer_init(&canvas->clip_spans);
     plutovg_span_buffer_init(&canvas->fill_spans);
+    plutovg_scratch_init(&canvas->scratch);
     return canvas;
 }
 
@@ -118,6 +124,7 @@ void plutovg_canvas_destroy(plutovg_canvas_t* canvas)
         plutovg_font_face_cache_destroy(canvas->face_cache);
         plutovg_span_buffer_destroy(&canvas->fill_spans);
         plutovg_span_buffer_destroy(&canvas->clip_spans);
+        plutovg_scratch_destroy(&canvas->scratch);
         plutovg_surface_destroy(canvas->surface);
         plutovg_path_destroy(canvas->path);
         free(canvas);
@@ -129,6 +136,18 @@ int plutovg_canvas_get_reference_count(const plutovg_canvas_t* canvas)
     return plutovg_get_reference_count(canvas);
 }
 
+void plutovg_canvas_get_scratch_counts(const plutovg_canvas_t* canvas, int* requests, int* allocations)
+{
+    if(requests) *requests = canvas->scratch.requests;
+    if(allocations) *allocations = canvas->scratch.allocations;
+}
+
+void plutovg_canvas_get_stroke_cache_counts(const plutovg_canvas_t* canvas, int* hits, int* misses)
+{
+    if(hits) *hits = canvas->scratch.stroke_hits;
+    if(misses) *misses = canvas->scratch.stroke_misses;
+}
+
 plutovg_surface_t* plutovg_canvas_get_surface(const plutovg_canvas_t* canvas)
 {
     return canvas->surface;
@@ -504,13 +523,13 @@ plutovg_path_t* plutovg_canvas_get_path(const plutovg_canvas_t* canvas)
 
 bool plutovg_canvas_fill_contains(plutovg_canvas_t* canvas, float x, float y)
 {
-    plutovg_rasterize(&canvas->fill_spans, canvas->path, &canvas->state->matrix, NULL, NULL, canvas->state->winding);
+    plutovg_rasterize(&canvas->scratch, &canvas->fill_spans, canvas->path, &canvas->state->matrix, NULL, NULL, canvas->state->winding);
     return plutovg_span_buffer_contains(&canvas->fill_spans, x, y);
 }
 
 bool plutovg_canvas_stroke_contains(plutovg_canvas_t* canvas, float x, float y)
 {
-    plutovg_rasterize(&canvas->fill_spans, canvas->path, &canvas->state->matrix, NULL, NULL, canvas->state->winding);
+    plutovg_rasterize(&canvas->scratch, &canvas->fill_spans, canvas->path, &canvas->state->matrix, NULL, NULL, canvas->state->winding);
     return plutovg_span_buffer_contains(&canvas->fill_spans, x, y);
 }
 
@@ -530,13 +549,13 @@ bool plutovg_canvas_clip_contains(plutovg_canvas_t* canvas, float x, float y)
 
 void plutovg_canvas_fill_extents(plutovg_canvas_t *canvas, plutovg_rect_t* extents)
 {
-    plutovg_rasterize(&canvas->fill_spans, canvas->path, &canvas->state->matrix, NULL, NULL, canvas->state->winding);
+    plutovg_rasterize(&canvas->scratch, &canvas->fill_spans, canvas->path, &canvas->state->matrix, NULL, NULL, canvas->state->winding);
     plutovg_span_buffer_extents(&canvas->fill_spans, extents);
 }
 
 void plutovg_canvas_stroke_extents(plutovg_canvas_t *canvas, plutovg_rect_t* extents)
 {
-    plutovg_rasterize(&canvas->fill_spans, canvas->path, &canvas->state->matrix, NULL, &canvas->state->stroke, PLUTOVG_FILL_RULE_NON_ZERO);
+    plutovg_rasterize(&canvas->scratch, &canvas->fill_spans, canvas->path, &canvas->state->matrix, NULL, &canvas->state->stroke, PLUTOVG_FILL_RULE_NON_ZERO);
     plutovg_span_buffer_extents(&canvas->fill_spans, extents);
 }
 
@@ -580,10 +599,25 @@ void plutovg_canvas_paint(plutovg_canvas_t* canvas)
     }
 }
 
-void plutovg_canvas_fill_preserve(plutovg_canvas_t* canvas)
+/*
+the box paths are rasterized against: the whole surface, or the clip itself when it covers whole pixels of one rectangle,
+in which case the spans come out already clipped and need no intersecting with the clip afterwards
+*/
+static const plutovg_rect_t* plutovg_canvas_raster_clip(const plutovg_canvas_t* canvas, plutovg_rect_t* rect)
 {
-    plutovg_rasterize(&canvas->fill_spans, canvas->path, &canvas->state->matrix, &canvas->clip_rect, NULL, canvas->state->winding);
-    if(canvas->state->clipping) {
+    const plutovg_state_t* state = canvas->state;
+    if(!state->clip_is_rect)
+        return &canvas->clip_rect;
+    rect->x = (float)(state->clip_spans.x);
+    rect->y = (float)(state->clip_spans.y);
+    rect->w = (float)(state->clip_spans.w);
+    rect->h = (float)(state->clip_spans.h);
+    return rect;
+}
+
+static void plutovg_canvas_blend_fill_spans(plutovg_canvas_t* canvas)
+{
+    if(canvas->state->clipping && !canvas->state->clip_is_rect) {
         plutovg_span_buffer_intersect(&canvas->clip_spans, &canvas->fill_spans, &canvas->state->clip_spans);
         plutovg_blend(canvas, &canvas->clip_spans);
     } else {
@@ -591,27 +625,35 @@ void plutovg_canvas_fill_preserve(plutovg_canvas_t* canvas)
     }
 }
 
+void plutovg_canvas_fill_preserve(plutovg_canvas_t* canvas)
+{
+    plutovg_rect_t clip_box;
+    plutovg_rasterize(&canvas->scratch, &canvas->fill_spans, canvas->path, &canvas->state->matrix, plutovg_canvas_raster_clip(canvas, &clip_box), NULL, canvas->state->winding);
+    plutovg_canvas_blend_fill_spans(canvas);
+}
+
 void plutovg_canvas_stroke_preserve(plutovg_canvas_t* canvas)
 {
-    plutovg_rasterize(&canvas->fill_spans, canvas->path, &canvas->state->matrix, &canvas->clip_rect, &canvas->state->stroke, PLUTOVG_FILL_RULE_NON_ZERO);
-    if(canvas->state->clipping) {
-        plutovg_span_buffer_intersect(&canvas->clip_spans, &canvas->fill_spans, &canvas->state->clip_spans);
-        plutovg_blend(canvas, &canvas->clip_spans);
-    } else {
-        plutovg_blend(canvas, &canvas->fill_spans);
-    }
+    plutovg_rect_t clip_box;
+    plutovg_rasterize(&canvas->scratch, &canvas->fill_spans, canvas->path, &canvas->state->matrix, plutovg_canvas_raster_clip(canvas, &clip_box), &canvas->state->stroke, PLUTOVG_FILL_RULE_NON_ZERO);
+    plutovg_canvas_blend_fill_spans(canvas);
 }
 
 void plutovg_canvas_clip_preserve(plutovg_canvas_t* canvas)
 {
-    if(canvas->state->clipping) {
-        plutovg_rasterize(&canvas->fill_spans, canvas->path, &canvas->state->matrix, &canvas->clip_rect, NULL, canvas->state->winding);
-        plutovg_span_buffer_intersect(&canvas->clip_spans, &canvas->fill_spans, &canvas->state->clip_spans);
-        plutovg_span_buffer_copy(&canvas->state->clip_spans, &canvas->clip_spans);
+    plutovg_state_t* state = canvas->state;
+    if(state->clipping && !state->clip_is_rect) {
+        plutovg_rasterize(&canvas->scratch, &canvas->fill_spans, canvas->path, &state->matrix, &canvas->clip_rect, NULL, state->winding);
+        plutovg_span_buffer_intersect(&canvas->clip_spans, &canvas->fill_spans, &state->clip_spans);
+        plutovg_span_buffer_copy(&state->clip_spans, &canvas->clip_spans);
     } else {
-        plutovg_rasterize(&canvas->state->clip_spans, canvas->path, &canvas->state->matrix, &canvas->clip_rect, NULL, canvas->state->winding);
-        canvas->state->clipping = true;
+        plutovg_rect_t clip_box;
+        const plutovg_rect_t* clip_rect = plutovg_canvas_raster_clip(canvas, &clip_box);
+        plutovg_rasterize(&canvas->scratch, &state->clip_spans, canvas->path, &state->matrix, clip_rect, NULL, state->winding);
+        state->clipping = true;
     }
+
+    state->clip_is_rect = plutovg_span_buffer_is_rect(&state->clip_spans);
 }
 
 void plutovg_canvas_fill_rect(plutovg_canvas_t* canvas, float x, float y, float w, float h)
@@ -637,9 +679,10 @@ void plutovg_canvas_stroke_rect(plutovg_canvas_t* canvas, float x, float y, floa
 
 void plutovg_canvas_stroke_path(plutovg_canvas_t* canvas, const plutovg_path_t* path)
 {
+    plutovg_rect_t clip_box;
     plutovg_canvas_new_path(canvas);
-    plutovg_canvas_add_path(canvas, path);
-    plutovg_canvas_stroke(canvas);
+    plutovg_rasterize_retained_stroke(&canvas->scratch, &canvas->fill_spans, path, &canvas->state->matrix, plutovg_canvas_raster_clip(canvas, &clip_box), &canvas->state->stroke);
+    plutovg_canvas_blend_fill_spans(canvas);
 }
 
 void plutovg_canvas_clip_rect(plutovg_canvas_t* canvas, float x, float y, float w, float h)
@@ -680,10 +723,121 @@ float plutovg_canvas_add_text(plutovg_canvas_t* canvas, const void* text, int le
     return advance_width;
 }
 
+typedef struct {
+    plutovg_glyph_mask_t* mask;
+    int x;
+    int y;
+} plutovg_placed_glyph_t;
+
+/*
+text drawn without rotation, skew or uneven scaling is blitted from the face's cached glyph masks instead of being
+rasterized as one path; each glyph is snapped to the nearest subpixel and overlapping glyphs add up their coverage
+*/
+static bool plutovg_canvas_fill_glyph_masks(plutovg_canvas_t* canvas, const void* text, int length, plutovg_text_encoding_t encoding, float x, float y, float* advance_width)
+{
+    plutovg_state_t* state = canvas->state;
+    const plutovg_matrix_t* matrix = &state->matrix;
+    if(state->winding != PLUTOVG_FILL_RULE_NON_ZERO || matrix->b != 0.f || matrix->c != 0.f || matrix->a <= 0.f || fabsf(matrix->a - matrix->d) > matrix->a * 1e-4f)
+        return false;
+    float size = state->font_size * matrix->a;
+    if(size > PLUTOVG_GLYPH_MASK_MAX_SIZE)
+        return false;
+    plutovg_text_iterator_t it;
+    plutovg_text_iterator_init(&it, text, length, encoding);
+    plutovg_placed_glyph_t* glyphs = (plutovg_placed_glyph_t*)plutovg_scratch_ensure(&canvas->scratch, &canvas->scratch.glyphs, it.length * sizeof(plutovg_placed_glyph_t));
+
+    int count = 0;
+    int x1 = INT_MAX;
+    int y1 = INT_MAX;
+    int x2 = INT_MIN;
+    int y2 = INT_MIN;
+    float advance = 0.f;
+    float oy = floorf((matrix->d * y + matrix->f) * PLUTOVG_GLYPH_SUBPIXELS + 0.5f);
+    float iy = floorf(oy / PLUTOVG_GLYPH_SUBPIXELS);
+    while(plutovg_text_iterator_has_next(&it)) {
+        plutovg_codepoint_t codepoint = plutovg_text_iterator_next(&it);
+        float ox = floorf((matrix->a * (x + advance) + matrix->e) * PLUTOVG_GLYPH_SUBPIXELS + 0.5f);
+        float ix = floorf(ox / PLUTOVG_GLYPH_SUBPIXELS);
+        plutovg_placed_glyph_t* glyph = &glyphs[count++];
+        glyph->mask = plutovg_font_face_get_glyph_mask(state->font_face, &canvas->scratch, codepoint, size, (int)(ox - ix * PLUTOVG_GLYPH_SUBPIXELS), (int)(oy - iy * PLUTOVG_GLYPH_SUBPIXELS));
+        glyph->x = (int)ix;
+        glyph->y = (int)iy;
+        if(glyph->mask->nspans) {
+            x1 = plutovg_min(x1, glyph->x + glyph->mask->x1);
+            y1 = plutovg_min(y1, glyph->y + glyph->mask->y1);
+            x2 = plutovg_max(x2, glyph->x + glyph->mask->x2);
+            y2 = plutovg_max(y2, glyph->y + glyph->mask->y2);
+        }
+
+        float glyph_advance = 0.f;
+        plutovg_font_face_get_glyph_metrics(state->font_face, state->font_size, codepoint, &glyph_advance, NULL, NULL);
+        advance += glyph_advance;
+    }
+
+    plutovg_rect_t clip_box;
+    const plutovg_rect_t* clip_rect = plutovg_canvas_raster_clip(canvas, &clip_box);
+    x1 = plutovg_max(x1, (int)floorf(clip_rect->x));
+    y1 = plutovg_max(y1, (int)floorf(clip_rect->y));
+    x2 = plutovg_min(x2, (int)ceilf(clip_rect->x + clip_rect->w));
+    y2 = plutovg_min(y2, (int)ceilf(clip_rect->y + clip_rect->h));
+
+    plutovg_span_buffer_reset(&canvas->fill_spans);
+    if(x1 < x2 && y1 < y2) {
+        int width = x2 - x1;
+        int height = y2 - y1;
+        uint8_t* coverage = (uint8_t*)plutovg_scratch_ensure(&canvas->scratch, &canvas->scratch.coverage, (size_t)width * height);
+        memset(coverage, 0, (size_t)width * height);
+        for(int i = 0; i < count; i++) {
+            const plutovg_glyph_mask_t* mask = glyphs[i].mask;
+            for(int j = 0; j < mask->nspans; j++) {
+                const plutovg_span_t* span = &mask->spans[j];
+                int row = glyphs[i].y + span->y;
+                int start = plutovg_max(glyphs[i].x + span->x, x1);
+                int end = plutovg_min(glyphs[i].x + span->x + span->len, x2);
+                if(row < y1 || row >= y2)
+                    continue;
+                uint8_t* pixels = coverage + (size_t)(row - y1) * width - x1;
+                for(int px = start; px < end; px++) {
+                    int value = pixels[px] + span->coverage;
+                    pixels[px] = value > 255 ? 255 : value;
+                }
+            }
+        }
+
+        for(int row = 0; row < height; row++) {
+            const uint8_t* pixels = coverage + (size_t)row * width;
+            plutovg_array_ensure_span(canvas->fill_spans.spans, width);
+            for(int px = 0; px < width;) {
+                uint8_t value = pixels[px];
+                int start = px++;
+                while(px < width && pixels[px] == value)
+                    px++;
+                if(value == 0)
+                    continue;
+                plutovg_span_t* span = canvas->fill_spans.spans.data + canvas->fill_spans.spans.size++;
+                span->x = x1 + start;
+                span->len = px - start;
+                span->y = y1 + row;
+                span->coverage = value;
+            }
+        }
+    }
+
+    for(int i = 0; i < count; i++)
+        plutovg_glyph_mask_release(glyphs[i].mask);
+    plutovg_canvas_blend_fill_spans(canvas);
+
+    *advance_width = advance;
+    return true;
+}
+
 float plutovg_canvas_fill_text(plutovg_canvas_t* canvas, const void* text, int length, plutovg_text_encoding_t encoding, float x, float y)
 {
     plutovg_canvas_new_path(canvas);
-    float advance_width = plutovg_canvas_add_text(canvas, text, length, encoding, x, y);
+    float advance_width = 0.f;
+    if(canvas->state->font_face && canvas->state->font_size > 0.f && plutovg_canvas_fill_glyph_masks(canvas, text, length, encoding, x, y, &advance_width))
+        return advance_width;
+    advance_width = plutovg_canvas_add_text(canvas, text, length, encoding, x, y);
     plutovg_canvas_fill(canvas);
     return advance_width;
 }
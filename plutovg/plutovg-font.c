@@ -141,6 +141,23 @@ typedef int plutovg_mutex_t;
 
 #endif
 
+#if defined(_WIN32)
+
+#define plutovg_atomic_load_ptr(ptr) InterlockedCompareExchangePointer((PVOID volatile*)(ptr), NULL, NULL)
+#define plutovg_atomic_store_ptr(ptr, value) InterlockedExchangePointer((PVOID volatile*)(ptr), (PVOID)(value))
+
+#elif defined(__GNUC__)
+
+#define plutovg_atomic_load_ptr(ptr) ((void*)__atomic_load_n((ptr), __ATOMIC_ACQUIRE))
+#define plutovg_atomic_store_ptr(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+
+#else
+
+#define plutovg_atomic_load_ptr(ptr) ((void*)*(ptr))
+#define plutovg_atomic_store_ptr(ptr, value) (*(ptr) = (value))
+
+#endif
+
 typedef struct plutovg_glyph {
     plutovg_codepoint_t codepoint;
     stbtt_vertex* vertices;
@@ -152,13 +169,23 @@ typedef struct plutovg_glyph {
     int y1;
     int x2;
     int y2;
-    struct plutovg_glyph* next;
+    plutovg_glyph_mask_t* masks;
 } plutovg_glyph_t;
 
-typedef struct {
+/*
+lookups probe the table without taking the face mutex, so once a table is published its filled slots never change
+and a glyph never changes after it is added; a table that has been outgrown is kept until the face is destroyed
+*/
+typedef struct plutovg_glyph_table {
+    size_t capacity;
     plutovg_glyph_t** glyphs;
+    struct plutovg_glyph_table* retired;
+} plutovg_glyph_table_t;
+
+typedef struct {
+    plutovg_glyph_table_t* table;
     size_t size;
-    size_t capacity;
+    size_t mask_bytes;
 } plutovg_glyph_cache_t;
 
 struct plutovg_font_face {
@@ -179,53 +206,88 @@ struct plutovg_font_face {
 
 static void plutovg_glyph_cache_init(plutovg_glyph_cache_t* cache)
 {
-    cache->glyphs = NULL;
+    cache->table = NULL;
     cache->size = 0;
-    cache->capacity = 0;
+    cache->mask_bytes = 0;
 }
 
 static void plutovg_glyph_cache_finish(plutovg_glyph_cache_t* cache, plutovg_font_face_t* face)
 {
     plutovg_mutex_lock(&face->mutex);
 
-    if(cache->glyphs) {
-        for(size_t i = 0; i < cache->capacity; ++i) {
-            plutovg_glyph_t* glyph = cache->glyphs[i];
-            while(glyph) {
-                plutovg_glyph_t* next = glyph->next;
-                stbtt_FreeShape(&face->info, glyph->vertices);
-                free(glyph);
-                glyph = next;
+    if(cache->table) {
+        for(size_t i = 0; i < cache->table->capacity; ++i) {
+            plutovg_glyph_t* glyph = cache->table->glyphs[i];
+            if(glyph == NULL)
+                continue;
+            plutovg_glyph_mask_t* mask = glyph->masks;
+            while(mask) {
+                plutovg_glyph_mask_t* next = mask->next;
+                free(mask);
+                mask = next;
             }
+
+            stbtt_FreeShape(&face->info, glyph->vertices);
+            free(glyph);
+        }
+
+        while(cache->table) {
+            plutovg_glyph_table_t* retired = cache->table->retired;
+            free(cache->table);
+            cache->table = retired;
         }
 
-        free(cache->glyphs);
-        cache->glyphs = NULL;
-        cache->capacity = 0;
         cache->size = 0;
+        cache->mask_bytes = 0;
     }
 
     plutovg_mutex_unlock(&face->mutex);
 }
 
 #define GLYPH_CACHE_INIT_CAPACITY 128
+#define GLYPH_MASK_CACHE_LIMIT (8 * 1024 * 1024)
 
-static plutovg_glyph_t* plutovg_glyph_cache_get(plutovg_glyph_cache_t* cache, plutovg_font_face_t* face, plutovg_codepoint_t codepoint)
+static plutovg_glyph_table_t* plutovg_glyph_table_create(size_t capacity, plutovg_glyph_table_t* retired)
 {
-    plutovg_mutex_lock(&face->mutex);
+    plutovg_glyph_table_t* table = (plutovg_glyph_table_t*)malloc(sizeof(plutovg_glyph_table_t) + capacity * sizeof(plutovg_glyph_t*));
+    table->capacity = capacity;
+    table->glyphs = (plutovg_glyph_t**)(table + 1);
+    table->retired = retired;
+    memset(table->glyphs, 0, capacity * sizeof(plutovg_glyph_t*));
+    return table;
+}
 
-    if(cache->glyphs == NULL) {
-        assert(cache->size == 0);
-        cache->glyphs = (plutovg_glyph_t **)calloc(GLYPH_CACHE_INIT_CAPACITY, sizeof(plutovg_glyph_t*));
-        cache->capacity = GLYPH_CACHE_INIT_CAPACITY;
+static plutovg_glyph_t* plutovg_glyph_table_find(plutovg_glyph_table_t* table, plutovg_codepoint_t codepoint)
+{
+    if(table == NULL)
+        return NULL;
+    size_t mask = table->capacity - 1;
+    for(size_t index = codepoint & mask;; index = (index + 1) & mask) {
+        plutovg_glyph_t* glyph = (plutovg_glyph_t*)plutovg_atomic_load_ptr(&table->glyphs[index]);
+        if(glyph == NULL || glyph->codepoint == codepoint) {
+            return glyph;
+        }
     }
+}
 
-    size_t index = codepoint & (cache->capacity - 1);
-    plutovg_glyph_t* glyph = cache->glyphs[index];
-    while(glyph && glyph->codepoint != codepoint) {
-        glyph = glyph->next;
-    }
+static void plutovg_glyph_table_insert(plutovg_glyph_table_t* table, plutovg_glyph_t* glyph)
+{
+    size_t mask = table->capacity - 1;
+    size_t index = glyph->codepoint & mask;
+    while(table->glyphs[index])
+        index = (index + 1) & mask;
+    plutovg_atomic_store_ptr(&table->glyphs[index], glyph);
+}
 
+static plutovg_glyph_t* plutovg_glyph_cache_get(plutovg_glyph_cache_t* cache, plutovg_font_face_t* face, plutovg_codepoint_t codepoint)
+{
+    plutovg_glyph_t* glyph = plutovg_glyph_table_find((plutovg_glyph_table_t*)plutovg_atomic_load_ptr(&cache->table), codepoint);
+    if(glyph)
+        return glyph;
+    plutovg_mutex_lock(&face->mutex);
+
+    plutovg_glyph_table_t* table = cache->table;
+    glyph = plutovg_glyph_table_find(table, codepoint);
     if(glyph == NULL) {
         glyph = (plutovg_glyph_t *)malloc(sizeof(plutovg_glyph_t));
         glyph->codepoint = codepoint;
@@ -236,28 +298,24 @@ static plutovg_glyph_t* plutovg_glyph_cache_get(plutovg_glyph_cache_t* cache, pl
             glyph->x1 = glyph->y1 = glyph->x2 = glyph->y2 = 0;
         }
 
-        glyph->next = cache->glyphs[index];
-        cache->glyphs[index] = glyph;
+        glyph->masks = NULL;
         cache->size += 1;
 
-        if(cache->size > (cache->capacity * 3 / 4)) {
-            size_t newcapacity = cache->capacity << 1;
-            plutovg_glyph_t** newglyphs = (plutovg_glyph_t**)calloc(newcapacity, sizeof(plutovg_glyph_t*));
-
-            for(size_t i = 0; i < cache->capacity; ++i) {
-                plutovg_glyph_t* entry = cache->glyphs[i];
-                while(entry) {
-                    plutovg_glyph_t* next = entry->next;
-                    size_t newindex = entry->codepoint & (newcapacity - 1);
-                    entry->next = newglyphs[newindex];
-                    newglyphs[newindex] = entry;
-                    entry = next;
+        if(table == NULL || cache->size > (table->capacity * 3 / 4)) {
+            size_t newcapacity = table ? table->capacity << 1 : GLYPH_CACHE_INIT_CAPACITY;
+            plutovg_glyph_table_t* newtable = plutovg_glyph_table_create(newcapacity, table);
+            if(table) {
+                for(size_t i = 0; i < table->capacity; ++i) {
+                    if(table->glyphs[i]) {
+                        plutovg_glyph_table_insert(newtable, table->glyphs[i]);
+                    }
                 }
             }
 
-            free(cache->glyphs);
-            cache->glyphs = newglyphs;
-            cache->capacity = newcapacity;
+            plutovg_glyph_table_insert(newtable, glyph);
+            plutovg_atomic_store_ptr(&cache->table, newtable);
+        } else {
+            plutovg_glyph_table_insert(table, glyph);
         }
     }
 
@@ -458,6 +516,75 @@ float plutovg_font_face_traverse_glyph_path(plutovg_font_face_t* face, float siz
     return glyph->advance_width * scale;
 }
 
+plutovg_glyph_mask_t* plutovg_font_face_get_glyph_mask(plutovg_font_face_t* face, plutovg_scratch_t* scratch, plutovg_codepoint_t codepoint, float size, int subpixel_x, int subpixel_y)
+{
+    plutovg_glyph_t* glyph = plutovg_font_face_get_glyph(face, codepoint);
+    plutovg_glyph_mask_t* mask = (plutovg_glyph_mask_t*)plutovg_atomic_load_ptr(&glyph->masks);
+    while(mask) {
+        if(mask->size == size && mask->subpixel_x == subpixel_x && mask->subpixel_y == subpixel_y)
+            return mask;
+        mask = mask->next;
+    }
+
+    plutovg_path_t* path = plutovg_path_create();
+    plutovg_font_face_get_glyph_path(face, size, (float)subpixel_x / PLUTOVG_GLYPH_SUBPIXELS, (float)subpixel_y / PLUTOVG_GLYPH_SUBPIXELS, codepoint, path);
+
+    plutovg_span_buffer_t span_buffer;
+    plutovg_span_buffer_init(&span_buffer);
+    plutovg_matrix_t matrix;
+    plutovg_matrix_init_identity(&matrix);
+    plutovg_rasterize(scratch, &span_buffer, path, &matrix, NULL, NULL, PLUTOVG_FILL_RULE_NON_ZERO);
+    plutovg_path_destroy(path);
+
+    size_t nbytes = sizeof(plutovg_glyph_mask_t) + span_buffer.spans.size * sizeof(plutovg_span_t);
+    mask = (plutovg_glyph_mask_t*)malloc(nbytes);
+    mask->size = size;
+    mask->subpixel_x = subpixel_x;
+    mask->subpixel_y = subpixel_y;
+    mask->nspans = span_buffer.spans.size;
+    mask->spans = (plutovg_span_t*)(mask + 1);
+    if(span_buffer.spans.size > 0)
+        memcpy(mask->spans, span_buffer.spans.data, span_buffer.spans.size * sizeof(plutovg_span_t));
+    mask->cached = false;
+    mask->next = NULL;
+
+    plutovg_rect_t extents;
+    plutovg_span_buffer_extents(&span_buffer, &extents);
+    mask->x1 = (int)extents.x;
+    mask->y1 = (int)extents.y;
+    mask->x2 = (int)(extents.x + extents.w);
+    mask->y2 = (int)(extents.y + extents.h);
+    plutovg_span_buffer_destroy(&span_buffer);
+
+    plutovg_mutex_lock(&face->mutex);
+    plutovg_glyph_mask_t* existing = glyph->masks;
+    while(existing) {
+        if(existing->size == size && existing->subpixel_x == subpixel_x && existing->subpixel_y == subpixel_y)
+            break;
+        existing = existing->next;
+    }
+
+    if(existing) {
+        free(mask);
+        mask = existing;
+    } else if(face->cache.mask_bytes + nbytes <= GLYPH_MASK_CACHE_LIMIT) {
+        face->cache.mask_bytes += nbytes;
+        mask->cached = true;
+        mask->next = glyph->masks;
+        plutovg_atomic_store_ptr(&glyph->masks, mask);
+    }
+
+    plutovg_mutex_unlock(&face->mutex);
+    return mask;
+}
+
+void plutovg_glyph_mask_release(plutovg_glyph_mask_t* mask)
+{
+    if(!mask->cached) {
+        free(mask);
+    }
+}
+
 float plutovg_font_face_text_extents(plutovg_font_face_t* face, float size, const void* text, int length, plutovg_text_encoding_t encoding, plutovg_rect_t* extents)
 {
     plutovg_text_iterator_t it;
@@ -1872,12 +1872,19 @@ void PVG_FT_Outline_Get_CBox(const PVG_FT_Outline* outline, PVG_FT_BBox* acbox)
   PVG_FT_Raster_Render(const PVG_FT_Raster_Params *params)
   {
       char stack[PVG_FT_MINIMUM_POOL_SIZE];
+      void* memory = stack;
       size_t length = PVG_FT_MINIMUM_POOL_SIZE;
 
+      PVG_FT_Raster_Pool* pool = params->pool;
+      if(pool && pool->size > length) {
+          memory = pool->memory;
+          length = pool->size;
+      }
+
       TWorker worker;
       worker.skip_spans = 0;
       int rendered_spans = 0;
-      int error = gray_raster_render(&worker, stack, length, params);
+      int error = gray_raster_render(&worker, memory, length, params);
       while(error == ErrRaster_OutOfMemory) {
           if(worker.skip_spans < 0)
               rendered_spans += -worker.skip_spans;
@@ -1885,7 +1892,13 @@ void PVG_FT_Outline_Get_CBox(const PVG_FT_Outline* outline, PVG_FT_BBox* acbox)
           length *= 2;
           void* heap = malloc(length);
           error = gray_raster_render(&worker, heap, length, params);
-          free(heap);
+          if(pool) {
+              free(pool->memory);
+              pool->memory = heap;
+              pool->size = length;
+          } else {
+              free(heap);
+          }
       }
   }
 
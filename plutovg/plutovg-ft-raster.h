@@ -21,6 +21,8 @@
 
 #include "plutovg-ft-types.h"
 
+#include <stddef.h>
+
 /*************************************************************************/
 /*                                                                       */
 /* <Struct>                                                              */
@@ -386,6 +388,10 @@ typedef void
 /*                   should be expressed in _integer_ pixels (and not in */
 /*                   26.6 fixed-point units).                            */
 /*                                                                       */
+/*    pool        :: Optional memory kept by the caller between calls.   */
+/*                   It is used instead of the stack block when larger,  */
+/*                   and replaced when a larger block has to be made.    */
+/*                                                                       */
 /* <Note>                                                                */
 /*    An anti-aliased glyph bitmap is drawn if the @PVG_FT_RASTER_FLAG_AA    */
 /*    bit flag is set in the `flags' field, otherwise a monochrome       */
@@ -403,6 +409,13 @@ typedef void
 /*    rendering a monochrome bitmap, as they are crucial to implement    */
 /*    correct drop-out control as defined in the TrueType specification. */
 /*                                                                       */
+typedef struct  PVG_FT_Raster_Pool_
+{
+    void*                   memory;
+    size_t                  size;
+
+} PVG_FT_Raster_Pool;
+
 typedef struct  PVG_FT_Raster_Params_
 {
     const void*             source;
@@ -410,6 +423,7 @@ typedef struct  PVG_FT_Raster_Params_
     PVG_FT_SpanFunc          gray_spans;
     void*                   user;
     PVG_FT_BBox              clip_box;
+    PVG_FT_Raster_Pool*      pool;
 
 } PVG_FT_Raster_Params;
 
@@ -44,6 +44,7 @@ plutovg_path_t* plutovg_path_create(void)
     path->num_curves = 0;
     path->start_point = PLUTOVG_EMPTY_POINT;
     plutovg_array_init(path->elements);
+    path->stroke_cache = NULL;
     return path;
 }
 
@@ -57,6 +58,7 @@ void plutovg_path_destroy(plutovg_path_t* path)
 {
     if(plutovg_destroy_reference(path)) {
         plutovg_array_destroy(path->elements);
+        plutovg_stroke_cache_destroy(path->stroke_cache);
         free(path);
     }
 }
@@ -73,8 +75,17 @@ int plutovg_path_get_elements(const plutovg_path_t* path, const plutovg_path_ele
     return path->elements.size;
 }
 
+static void plutovg_path_changed(plutovg_path_t* path)
+{
+    if(path->stroke_cache) {
+        plutovg_stroke_cache_destroy(path->stroke_cache);
+        path->stroke_cache = NULL;
+    }
+}
+
 static plutovg_path_element_t* plutovg_path_add_command(plutovg_path_t* path, plutovg_path_command_t command, int npoints)
 {
+    plutovg_path_changed(path);
     const int length = npoints + 1;
     plutovg_array_ensure_path(path->elements, length);
     plutovg_path_element_t* elements = path->elements.data + path->elements.size;
@@ -237,6 +248,7 @@ void plutovg_path_reserve(plutovg_path_t* path, int count)
 
 void plutovg_path_reset(plutovg_path_t* path)
 {
+    plutovg_path_changed(path);
     plutovg_array_clear(path->elements);
     path->start_point = PLUTOVG_EMPTY_POINT;
     path->num_points = 0;
@@ -355,6 +367,7 @@ void plutovg_path_add_arc(plutovg_path_t* path, float cx, float cy, float r, flo
 
 void plutovg_path_transform(plutovg_path_t* path, const plutovg_matrix_t* matrix)
 {
+    plutovg_path_changed(path);
     plutovg_path_element_t* elements = path->elements.data;
     for(int i = 0; i < path->elements.size; i += elements[i].header.length) {
         switch(elements[i].header.command) {
@@ -375,6 +388,7 @@ void plutovg_path_transform(plutovg_path_t* path, const plutovg_matrix_t* matrix
 void plutovg_path_add_path(plutovg_path_t* path, const plutovg_path_t* source, const plutovg_matrix_t* matrix)
 {
     if(matrix == NULL) {
+        plutovg_path_changed(path);
         plutovg_array_append_path(path->elements, source->elements);
         path->start_point = source->start_point;
         path->num_points += source->num_points;
@@ -649,11 +663,17 @@ plutovg_path_t* plutovg_path_clone_flatten(const plutovg_path_t* path)
     return clone;
 }
 
+void plutovg_path_reset_dashed(plutovg_path_t* dashed, const plutovg_path_t* path, float offset, const float* dashes, int ndashes)
+{
+    plutovg_path_reset(dashed);
+    plutovg_path_reserve(dashed, path->elements.size + path->num_curves * 32);
+    plutovg_path_traverse_dashed(path, offset, dashes, ndashes, clone_traverse_func, dashed);
+}
+
 plutovg_path_t* plutovg_path_clone_dashed(const plutovg_path_t* path, float offset, const float* dashes, int ndashes)
 {
     plutovg_path_t* clone = plutovg_path_create();
-    plutovg_path_reserve(clone, path->elements.size + path->num_curves * 32);
-    plutovg_path_traverse_dashed(path, offset, dashes, ndashes, clone_traverse_func, clone);
+    plutovg_path_reset_dashed(clone, path, offset, dashes, ndashes);
     return clone;
 }
 
@@ -717,6 +737,27 @@ float plutovg_path_length(const plutovg_path_t* path)
     return plutovg_path_extents(path, NULL, true);
 }
 
+/*
+path data has a tokenizer of its own: the command letter picks its case in a switch rather than going down a chain of
+comparisons, and after a coordinate the separators exporters write (nothing, or a single space or comma) are stepped
+over before the general white space and comma skipping is needed
+*/
+static inline void skip_path_separator(const char** begin, const char* end)
+{
+    const char* it = *begin;
+    if(it == end)
+        return;
+    if(*it == ',') {
+        ++it;
+        plutovg_skip_ws(&it, end);
+    } else if(PLUTOVG_IS_WS(*it)) {
+        ++it;
+        plutovg_skip_ws_or_comma(&it, end, NULL);
+    }
+
+    *begin = it;
+}
+
 static inline bool parse_arc_flag(const char** begin, const char* end, bool* flag)
 {
     if(plutovg_skip_delim(begin, end, '0'))
@@ -725,7 +766,7 @@ static inline bool parse_arc_flag(const char** begin, const char* end, bool* fla
         *flag = 1;
     else
         return false;
-    plutovg_skip_ws_or_comma(begin, end, NULL);
+    skip_path_separator(begin, end);
     return true;
 }
 
@@ -734,7 +775,7 @@ static inline bool parse_path_coordinates(const char** begin, const char* end, f
     for(int i = 0; i < count; i++) {
         if(!plutovg_parse_number(begin, end, values + offset + i))
             return false;
-        plutovg_skip_ws_or_comma(begin, end, NULL);
+        skip_path_separator(begin, end);
     }
 
     return true;
@@ -768,7 +809,9 @@ bool plutovg_path_parse(plutovg_path_t* path, const char* data, int length)
 
         if(!last_command && !(command == 'M' || command == 'm'))
             return false;
-        if(command == 'M' || command == 'm') {
+        switch(command) {
+        case 'M':
+        case 'm':
             if(!parse_path_coordinates(&it, end, values, 0, 2))
                 return false;
             if(command == 'm') {
@@ -780,7 +823,9 @@ bool plutovg_path_parse(plutovg_path_t* path, const char* data, int length)
             current_x = start_x = values[0];
             current_y = start_y = values[1];
             command = command == 'm' ? 'l' : 'L';
-        } else if(command == 'L' || command == 'l') {
+            break;
+        case 'L':
+        case 'l':
             if(!parse_path_coordinates(&it, end, values, 0, 2))
                 return false;
             if(command == 'l') {
@@ -791,7 +836,9 @@ bool plutovg_path_parse(plutovg_path_t* path, const char* data, int length)
             plutovg_path_line_to(path, values[0], values[1]);
             current_x = values[0];
             current_y = values[1];
-        } else if(command == 'H' || command == 'h') {
+            break;
+        case 'H':
+        case 'h':
             if(!parse_path_coordinates(&it, end, values, 0, 1))
                 return false;
             if(command == 'h') {
@@ -800,7 +847,9 @@ bool plutovg_path_parse(plutovg_path_t* path, const char* data, int length)
 
             plutovg_path_line_to(path, values[0], current_y);
             current_x = values[0];
-        } else if(command == 'V' || command == 'v') {
+            break;
+        case 'V':
+        case 'v':
             if(!parse_path_coordinates(&it, end, values, 1, 1))
                 return false;
             if(command == 'v') {
@@ -809,7 +858,9 @@ bool plutovg_path_parse(plutovg_path_t* path, const char* data, int length)
 
             plutovg_path_line_to(path, current_x, values[1]);
             current_y = values[1];
-        } else if(command == 'Q' || command == 'q') {
+            break;
+        case 'Q':
+        case 'q':
             if(!parse_path_coordinates(&it, end, values, 0, 4))
                 return false;
             if(command == 'q') {
@@ -824,7 +875,9 @@ bool plutovg_path_parse(plutovg_path_t* path, const char* data, int length)
             last_control_y = values[1];
             current_x = values[2];
             current_y = values[3];
-        } else if(command == 'C' || command == 'c') {
+            break;
+        case 'C':
+        case 'c':
             if(!parse_path_coordinates(&it, end, values, 0, 6))
                 return false;
             if(command == 'c') {
@@ -841,7 +894,9 @@ bool plutovg_path_parse(plutovg_path_t* path, const char* data, int length)
             last_control_y = values[3];
             current_x = values[4];
             current_y = values[5];
-        } else if(command == 'T' || command == 't') {
+            break;
+        case 'T':
+        case 't':
             if(last_command != 'Q' && last_command != 'q' && last_command != 'T' && last_command != 't') {
                 values[0] = current_x;
                 values[1] = current_y;
@@ -862,7 +917,9 @@ bool plutovg_path_parse(plutovg_path_t* path, const char* data, int length)
             last_control_y = values[1];
             current_x = values[2];
             current_y = values[3];
-        } else if(command == 'S' || command == 's') {
+            break;
+        case 'S':
+        case 's':
             if(last_command != 'C' && last_command != 'c' && last_command != 'S' && last_command != 's') {
                 values[0] = current_x;
                 values[1] = current_y;
@@ -885,7 +942,9 @@ bool plutovg_path_parse(plutovg_path_t* path, const char* data, int length)
             last_control_y = values[3];
             current_x = values[4];
             current_y = values[5];
-        } else if(command == 'A' || command == 'a') {
+            break;
+        case 'A':
+        case 'a':
             if(!parse_path_coordinates(&it, end, values, 0, 3)
                 || !parse_arc_flag(&it, end, &flags[0])
                 || !parse_arc_flag(&it, end, &flags[1])
@@ -901,13 +960,16 @@ bool plutovg_path_parse(plutovg_path_t* path, const char* data, int length)
             plutovg_path_arc_to(path, values[0], values[1], PLUTOVG_DEG2RAD(values[2]), flags[0], flags[1], values[3], values[4]);
             current_x = values[3];
             current_y = values[4];
-        } else if(command == 'Z' || command == 'z') {
+            break;
+        case 'Z':
+        case 'z':
             if(last_command == 'Z' || last_command == 'z')
                 return false;
             plutovg_path_close(path);
             current_x = start_x;
             current_y = start_y;
-        } else {
+            break;
+        default:
             return false;
         }
 
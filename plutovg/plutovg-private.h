@@ -3,6 +3,8 @@
 
 #include "plutovg.h"
 
+#include <stddef.h>
+
 #if defined(_WIN32)
 
 #include <windows.h>
@@ -42,8 +44,11 @@ struct plutovg_surface {
     int height;
     int stride;
     unsigned char* data;
+    size_t capacity; ///< bytes of pixels allocated along with the surface, or 0 if the data belongs to someone else
 };
 
+typedef struct plutovg_stroke_cache plutovg_stroke_cache_t;
+
 struct plutovg_path {
     plutovg_ref_count_t ref_count;
     int num_points;
@@ -55,6 +60,7 @@ struct plutovg_path {
         int size;
         int capacity;
     } elements;
+    plutovg_stroke_cache_t* stroke_cache; ///< dropped whenever the path changes
 };
 
 typedef enum {
@@ -162,9 +168,48 @@ typedef struct plutovg_state {
     float font_size;
     float opacity;
     bool clipping;
+    bool clip_is_rect; ///< the clip covers whole pixels of one rectangle, the extents of clip_spans
     struct plutovg_state* next;
 } plutovg_state_t;
 
+#define PLUTOVG_GLYPH_SUBPIXELS 4
+#define PLUTOVG_GLYPH_MASK_MAX_SIZE 256.f
+
+/* the coverage of one glyph at one pixel size, placed a whole number of subpixels right of and below a pixel corner */
+typedef struct plutovg_glyph_mask {
+    float size;
+    int subpixel_x;
+    int subpixel_y;
+    int x1;
+    int y1;
+    int x2;
+    int y2;
+    int nspans;
+    plutovg_span_t* spans; ///< relative to the pixel corner
+    bool cached; ///< owned by the font face; otherwise released by whoever asked for it
+    struct plutovg_glyph_mask* next;
+} plutovg_glyph_mask_t;
+
+typedef struct {
+    void* data;
+    size_t capacity;
+} plutovg_scratch_block_t;
+
+/* memory reused by every fill, stroke and clip rasterized on a canvas; it only grows and is freed with the canvas */
+typedef struct {
+    plutovg_scratch_block_t outline;
+    plutovg_scratch_block_t stroke_outline;
+    plutovg_scratch_block_t raster_pool;
+    plutovg_scratch_block_t glyphs;
+    plutovg_scratch_block_t coverage;
+    plutovg_path_t* dashed;
+    struct PVG_FT_StrokerRec_* stroker;
+    int requests;
+    int allocations;
+    int stroke_hits;
+    int stroke_misses;
+} plutovg_scratch_t;
+
 struct plutovg_canvas {
     plutovg_ref_count_t ref_count;
     plutovg_surface_t* surface;
@@ -175,6 +220,7 @@ struct plutovg_canvas {
     plutovg_rect_t clip_rect;
     plutovg_span_buffer_t clip_spans;
     plutovg_span_buffer_t fill_spans;
+    plutovg_scratch_t scratch;
 };
 
 void plutovg_span_buffer_init(plutovg_span_buffer_t* span_buffer);
@@ -185,8 +231,20 @@ void plutovg_span_buffer_copy(plutovg_span_buffer_t* span_buffer, const plutovg_
 bool plutovg_span_buffer_contains(const plutovg_span_buffer_t* span_buffer, float x, float y);
 void plutovg_span_buffer_extents(plutovg_span_buffer_t* span_buffer, plutovg_rect_t* extents);
 void plutovg_span_buffer_intersect(plutovg_span_buffer_t* span_buffer, const plutovg_span_buffer_t* a, const plutovg_span_buffer_t* b);
+bool plutovg_span_buffer_is_rect(plutovg_span_buffer_t* span_buffer);
+
+void plutovg_scratch_init(plutovg_scratch_t* scratch);
+void plutovg_scratch_destroy(plutovg_scratch_t* scratch);
+void* plutovg_scratch_ensure(plutovg_scratch_t* scratch, plutovg_scratch_block_t* block, size_t size);
+
+plutovg_glyph_mask_t* plutovg_font_face_get_glyph_mask(plutovg_font_face_t* face, plutovg_scratch_t* scratch, plutovg_codepoint_t codepoint, float size, int subpixel_x, int subpixel_y);
+void plutovg_glyph_mask_release(plutovg_glyph_mask_t* mask);
+
+void plutovg_path_reset_dashed(plutovg_path_t* dashed, const plutovg_path_t* path, float offset, const float* dashes, int ndashes);
 
-void plutovg_rasterize(plutovg_span_buffer_t* span_buffer, const plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_rect_t* clip_rect, const plutovg_stroke_data_t* stroke_data, plutovg_fill_rule_t winding);
+void plutovg_rasterize(plutovg_scratch_t* scratch, plutovg_span_buffer_t* span_buffer, const plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_rect_t* clip_rect, const plutovg_stroke_data_t* stroke_data, plutovg_fill_rule_t winding);
+void plutovg_rasterize_retained_stroke(plutovg_scratch_t* scratch, plutovg_span_buffer_t* span_buffer, const plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_rect_t* clip_rect, const plutovg_stroke_data_t* stroke_data);
+void plutovg_stroke_cache_destroy(plutovg_stroke_cache_t* cache);
 void plutovg_blend(plutovg_canvas_t* canvas, const plutovg_span_buffer_t* span_buffer);
 void plutovg_memfill32(unsigned int* dest, int length, unsigned int value);
 
@@ -164,14 +164,78 @@ void plutovg_span_buffer_intersect(plutovg_span_buffer_t* span_buffer, const plu
     }
 }
 
+bool plutovg_span_buffer_is_rect(plutovg_span_buffer_t* span_buffer)
+{
+    const int count = span_buffer->spans.size;
+    if(count == 0)
+        return false;
+    const plutovg_span_t* spans = span_buffer->spans.data;
+    for(int i = 0; i < count; i++) {
+        if(spans[i].coverage != 255 || spans[i].x != spans[0].x || spans[i].len != spans[0].len || spans[i].y != spans[0].y + i) {
+            return false;
+        }
+    }
+
+    plutovg_span_buffer_update_extents(span_buffer);
+    return true;
+}
+
+void plutovg_scratch_init(plutovg_scratch_t* scratch)
+{
+    scratch->outline.data = NULL;
+    scratch->outline.capacity = 0;
+    scratch->stroke_outline.data = NULL;
+    scratch->stroke_outline.capacity = 0;
+    scratch->raster_pool.data = NULL;
+    scratch->raster_pool.capacity = 0;
+    scratch->glyphs.data = NULL;
+    scratch->glyphs.capacity = 0;
+    scratch->coverage.data = NULL;
+    scratch->coverage.capacity = 0;
+    scratch->dashed = NULL;
+    scratch->stroker = NULL;
+    scratch->requests = 0;
+    scratch->allocations = 0;
+    scratch->stroke_hits = 0;
+    scratch->stroke_misses = 0;
+}
+
+void plutovg_scratch_destroy(plutovg_scratch_t* scratch)
+{
+    free(scratch->outline.data);
+    free(scratch->stroke_outline.data);
+    free(scratch->raster_pool.data);
+    free(scratch->glyphs.data);
+    free(scratch->coverage.data);
+    plutovg_path_destroy(scratch->dashed);
+    PVG_FT_Stroker_Done(scratch->stroker);
+    plutovg_scratch_init(scratch);
+}
+
+void* plutovg_scratch_ensure(plutovg_scratch_t* scratch, plutovg_scratch_block_t* block, size_t size)
+{
+    scratch->requests++;
+    if(size > block->capacity) {
+        size_t capacity = block->capacity ? block->capacity : 1024;
+        while(capacity < size)
+            capacity *= 2;
+        free(block->data);
+        block->data = malloc(capacity);
+        block->capacity = capacity;
+        scratch->allocations++;
+    }
+
+    return block->data;
+}
+
 #define ALIGN_SIZE(size) (((size) + 7ul) & ~7ul)
-static PVG_FT_Outline* ft_outline_create(int points, int contours)
+static PVG_FT_Outline* ft_outline_create(plutovg_scratch_t* scratch, plutovg_scratch_block_t* block, int points, int contours)
 {
     size_t points_size = ALIGN_SIZE((points + contours) * sizeof(PVG_FT_Vector));
     size_t tags_size = ALIGN_SIZE((points + contours) * sizeof(char));
     size_t contours_size = ALIGN_SIZE(contours * sizeof(int));
     size_t contours_flag_size = ALIGN_SIZE(contours * sizeof(char));
-    PVG_FT_Outline* outline = (PVG_FT_Outline*)malloc(points_size + tags_size + contours_size + contours_flag_size + sizeof(PVG_FT_Outline));
+    PVG_FT_Outline* outline = (PVG_FT_Outline*)plutovg_scratch_ensure(scratch, block, points_size + tags_size + contours_size + contours_flag_size + sizeof(PVG_FT_Outline));
 
     PVG_FT_Byte* outline_data = (PVG_FT_Byte*)(outline + 1);
     outline->points = (PVG_FT_Vector*)(outline_data);
@@ -184,11 +248,6 @@ static PVG_FT_Outline* ft_outline_create(int points, int contours)
     return outline;
 }
 
-static void ft_outline_destroy(PVG_FT_Outline* outline)
-{
-    free(outline);
-}
-
 #define FT_COORD(x) (PVG_FT_Pos)(roundf(x * 64))
 static void ft_outline_move_to(PVG_FT_Outline* ft, float x, float y)
 {
@@ -250,19 +309,19 @@ static void ft_outline_end(PVG_FT_Outline* ft)
     }
 }
 
-static PVG_FT_Outline* ft_outline_convert_stroke(const plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_stroke_data_t* stroke_data);
+static PVG_FT_Outline* ft_outline_convert_stroke(plutovg_scratch_t* scratch, const plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_stroke_data_t* stroke_data);
 
-static PVG_FT_Outline* ft_outline_convert(const plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_stroke_data_t* stroke_data)
+static PVG_FT_Outline* ft_outline_convert(plutovg_scratch_t* scratch, const plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_stroke_data_t* stroke_data)
 {
     if(stroke_data) {
-        return ft_outline_convert_stroke(path, matrix, stroke_data);
+        return ft_outline_convert_stroke(scratch, path, matrix, stroke_data);
     }
 
     plutovg_path_iterator_t it;
     plutovg_path_iterator_init(&it, path);
 
     plutovg_point_t points[3];
-    PVG_FT_Outline* outline = ft_outline_create(path->num_points, path->num_contours);
+    PVG_FT_Outline* outline = ft_outline_create(scratch, &scratch->outline, path->num_points, path->num_contours);
     while(plutovg_path_iterator_has_next(&it)) {
         switch(plutovg_path_iterator_next(&it, points)) {
         case PLUTOVG_PATH_COMMAND_MOVE_TO:
@@ -287,17 +346,21 @@ static PVG_FT_Outline* ft_outline_convert(const plutovg_path_t* path, const plut
     return outline;
 }
 
-static PVG_FT_Outline* ft_outline_convert_dash(const plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_stroke_dash_t* stroke_dash)
+static PVG_FT_Outline* ft_outline_convert_dash(plutovg_scratch_t* scratch, const plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_stroke_dash_t* stroke_dash)
 {
     if(stroke_dash->array.size == 0)
-        return ft_outline_convert(path, matrix, NULL);
-    plutovg_path_t* dashed = plutovg_path_clone_dashed(path, stroke_dash->offset, stroke_dash->array.data, stroke_dash->array.size);
-    PVG_FT_Outline* outline = ft_outline_convert(dashed, matrix, NULL);
-    plutovg_path_destroy(dashed);
-    return outline;
+        return ft_outline_convert(scratch, path, matrix, NULL);
+    if(scratch->dashed == NULL) {
+        scratch->dashed = plutovg_path_create();
+        scratch->allocations++;
+    }
+
+    scratch->requests++;
+    plutovg_path_reset_dashed(scratch->dashed, path, stroke_dash->offset, stroke_dash->array.data, stroke_dash->array.size);
+    return ft_outline_convert(scratch, scratch->dashed, matrix, NULL);
 }
 
-static PVG_FT_Outline* ft_outline_convert_stroke(const plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_stroke_data_t* stroke_data)
+static PVG_FT_Outline* ft_outline_convert_stroke(plutovg_scratch_t* scratch, const plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_stroke_data_t* stroke_data)
 {
     double scale_x = sqrt(matrix->a * matrix->a + matrix->b * matrix->b);
     double scale_y = sqrt(matrix->c * matrix->c + matrix->d * matrix->d);
@@ -334,52 +397,159 @@ static PVG_FT_Outline* ft_outline_convert_stroke(const plutovg_path_t* path, con
         break;
     }
 
-    PVG_FT_Stroker stroker;
-    PVG_FT_Stroker_New(&stroker);
+    if(scratch->stroker == NULL) {
+        PVG_FT_Stroker_New(&scratch->stroker);
+        scratch->allocations++;
+    }
+
+    scratch->requests++;
+    PVG_FT_Stroker stroker = scratch->stroker;
     PVG_FT_Stroker_Set(stroker, ftWidth, ftCap, ftJoin, ftMiterLimit);
 
-    PVG_FT_Outline* outline = ft_outline_convert_dash(path, matrix, &stroke_data->dash);
+    PVG_FT_Outline* outline = ft_outline_convert_dash(scratch, path, matrix, &stroke_data->dash);
     PVG_FT_Stroker_ParseOutline(stroker, outline);
 
     PVG_FT_UInt points;
     PVG_FT_UInt contours;
     PVG_FT_Stroker_GetCounts(stroker, &points, &contours);
 
-    PVG_FT_Outline* stroke_outline = ft_outline_create(points, contours);
+    PVG_FT_Outline* stroke_outline = ft_outline_create(scratch, &scratch->stroke_outline, points, contours);
     PVG_FT_Stroker_Export(stroker, stroke_outline);
-
-    PVG_FT_Stroker_Done(stroker);
-    ft_outline_destroy(outline);
     return stroke_outline;
 }
 
+static PVG_FT_Outline* ft_outline_copy(plutovg_scratch_t* scratch, plutovg_scratch_block_t* block, const PVG_FT_Outline* source)
+{
+    PVG_FT_Outline* outline = ft_outline_create(scratch, block, source->n_points, source->n_contours);
+    if(source->n_points > 0) {
+        memcpy(outline->points, source->points, source->n_points * sizeof(PVG_FT_Vector));
+        memcpy(outline->tags, source->tags, source->n_points * sizeof(char));
+    }
+
+    if(source->n_contours > 0) {
+        memcpy(outline->contours, source->contours, source->n_contours * sizeof(int));
+        memcpy(outline->contours_flag, source->contours_flag, source->n_contours * sizeof(char));
+    }
+
+    outline->n_points = source->n_points;
+    outline->n_contours = source->n_contours;
+    return outline;
+}
+
+/*
+the outline a retained path was last stroked to, in device space, with what it was stroked with
+the stroker works on the transformed path with the width scaled along, and dashes are laid out before the path is
+transformed, so the same stroke through a matrix that only differs by a translation comes out as the same outline
+moved, to within the rounding to whole 1/64ths
+*/
+struct plutovg_stroke_cache {
+    plutovg_stroke_style_t style;
+    plutovg_matrix_t matrix;
+    float dash_offset;
+    int num_dashes;
+    float* dashes;
+    plutovg_scratch_block_t outline;
+};
+
+void plutovg_stroke_cache_destroy(plutovg_stroke_cache_t* cache)
+{
+    if(cache == NULL)
+        return;
+    free(cache->dashes);
+    free(cache->outline.data);
+    free(cache);
+}
+
+static bool stroke_cache_matches(const plutovg_stroke_cache_t* cache, const plutovg_stroke_data_t* stroke_data)
+{
+    if(cache->style.width != stroke_data->style.width || cache->style.cap != stroke_data->style.cap
+        || cache->style.join != stroke_data->style.join || cache->style.miter_limit != stroke_data->style.miter_limit) {
+        return false;
+    }
+
+    if(cache->num_dashes != stroke_data->dash.array.size)
+        return false;
+    if(cache->num_dashes == 0)
+        return true;
+    return cache->dash_offset == stroke_data->dash.offset && memcmp(cache->dashes, stroke_data->dash.array.data, cache->num_dashes * sizeof(float)) == 0;
+}
+
+// whether the matrix only differs from the cached one by a translation; any other change, a uniform scale included,
+// is stroked again, as the stroker's flattening and rounding depend on the scale
+static bool stroke_cache_same_linear(const plutovg_matrix_t* cached, const plutovg_matrix_t* matrix)
+{
+    return cached->a == matrix->a && cached->b == matrix->b && cached->c == matrix->c && cached->d == matrix->d;
+}
+
+static void stroke_cache_store(plutovg_scratch_t* scratch, plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_stroke_data_t* stroke_data, const PVG_FT_Outline* outline)
+{
+    plutovg_stroke_cache_t* cache = path->stroke_cache;
+    if(cache == NULL) {
+        cache = (plutovg_stroke_cache_t*)malloc(sizeof(plutovg_stroke_cache_t));
+        cache->num_dashes = 0;
+        cache->dashes = NULL;
+        cache->outline.data = NULL;
+        cache->outline.capacity = 0;
+        path->stroke_cache = cache;
+    }
+
+    if(cache->num_dashes != stroke_data->dash.array.size) {
+        free(cache->dashes);
+        cache->num_dashes = stroke_data->dash.array.size;
+        cache->dashes = cache->num_dashes ? (float*)malloc(cache->num_dashes * sizeof(float)) : NULL;
+    }
+
+    if(cache->num_dashes > 0)
+        memcpy(cache->dashes, stroke_data->dash.array.data, cache->num_dashes * sizeof(float));
+    cache->dash_offset = stroke_data->dash.offset;
+    cache->style = stroke_data->style;
+    cache->matrix = *matrix;
+    ft_outline_copy(scratch, &cache->outline, outline);
+}
+
+static PVG_FT_Outline* ft_outline_convert_retained_stroke(plutovg_scratch_t* scratch, const plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_stroke_data_t* stroke_data)
+{
+    plutovg_stroke_cache_t* cache = path->stroke_cache;
+    if(cache == NULL || !stroke_cache_matches(cache, stroke_data) || !stroke_cache_same_linear(&cache->matrix, matrix)) {
+        scratch->stroke_misses++;
+        PVG_FT_Outline* outline = ft_outline_convert_stroke(scratch, path, matrix, stroke_data);
+        stroke_cache_store(scratch, (plutovg_path_t*)path, matrix, stroke_data, outline);
+        return outline;
+    }
+
+    scratch->stroke_hits++;
+    PVG_FT_Outline* cached = (PVG_FT_Outline*)cache->outline.data;
+    if(cache->matrix.e == matrix->e && cache->matrix.f == matrix->f)
+        return cached;
+    PVG_FT_Outline* outline = ft_outline_copy(scratch, &scratch->stroke_outline, cached);
+    PVG_FT_Pos dx = (PVG_FT_Pos)floor((matrix->e - cache->matrix.e) * 64.0 + 0.5);
+    PVG_FT_Pos dy = (PVG_FT_Pos)floor((matrix->f - cache->matrix.f) * 64.0 + 0.5);
+    for(int i = 0; i < outline->n_points; i++) {
+        outline->points[i].x += dx;
+        outline->points[i].y += dy;
+    }
+
+    return outline;
+}
+
 static void spans_generation_callback(int count, const PVG_FT_Span* spans, void* user)
 {
     plutovg_span_buffer_t* span_buffer = (plutovg_span_buffer_t*)(user);
     plutovg_array_append_data_span(span_buffer->spans, spans, count);
 }
 
-void plutovg_rasterize(plutovg_span_buffer_t* span_buffer, const plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_rect_t* clip_rect, const plutovg_stroke_data_t* stroke_data, plutovg_fill_rule_t winding)
+static void ft_outline_render(plutovg_scratch_t* scratch, plutovg_span_buffer_t* span_buffer, PVG_FT_Outline* outline, const plutovg_rect_t* clip_rect)
 {
-    PVG_FT_Outline* outline = ft_outline_convert(path, matrix, stroke_data);
-    if(stroke_data) {
-        outline->flags = PVG_FT_OUTLINE_NONE;
-    } else {
-        switch(winding) {
-        case PLUTOVG_FILL_RULE_EVEN_ODD:
-            outline->flags = PVG_FT_OUTLINE_EVEN_ODD_FILL;
-            break;
-        default:
-            outline->flags = PVG_FT_OUTLINE_NONE;
-            break;
-        }
-    }
+    PVG_FT_Raster_Pool pool;
+    pool.memory = scratch->raster_pool.data;
+    pool.size = scratch->raster_pool.capacity;
 
     PVG_FT_Raster_Params params;
     params.flags = PVG_FT_RASTER_FLAG_DIRECT | PVG_FT_RASTER_FLAG_AA;
     params.gray_spans = spans_generation_callback;
     params.user = span_buffer;
     params.source = outline;
+    params.pool = &pool;
     if(clip_rect) {
         params.flags |= PVG_FT_RASTER_FLAG_CLIP;
         params.clip_box.xMin = (PVG_FT_Pos)clip_rect->x;
@@ -390,5 +560,37 @@ void plutovg_rasterize(plutovg_span_buffer_t* span_buffer, const plutovg_path_t*
 
     plutovg_span_buffer_reset(span_buffer);
     PVG_FT_Raster_Render(&params);
-    ft_outline_destroy(outline);
+
+    scratch->requests++;
+    if(pool.memory != scratch->raster_pool.data) {
+        scratch->raster_pool.data = pool.memory;
+        scratch->raster_pool.capacity = pool.size;
+        scratch->allocations++;
+    }
+}
+
+void plutovg_rasterize(plutovg_scratch_t* scratch, plutovg_span_buffer_t* span_buffer, const plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_rect_t* clip_rect, const plutovg_stroke_data_t* stroke_data, plutovg_fill_rule_t winding)
+{
+    PVG_FT_Outline* outline = ft_outline_convert(scratch, path, matrix, stroke_data);
+    if(stroke_data) {
+        outline->flags = PVG_FT_OUTLINE_NONE;
+    } else {
+        switch(winding) {
+        case PLUTOVG_FILL_RULE_EVEN_ODD:
+            outline->flags = PVG_FT_OUTLINE_EVEN_ODD_FILL;
+            break;
+        default:
+            outline->flags = PVG_FT_OUTLINE_NONE;
+            break;
+        }
+    }
+
+    ft_outline_render(scratch, span_buffer, outline, clip_rect);
+}
+
+void plutovg_rasterize_retained_stroke(plutovg_scratch_t* scratch, plutovg_span_buffer_t* span_buffer, const plutovg_path_t* path, const plutovg_matrix_t* matrix, const plutovg_rect_t* clip_rect, const plutovg_stroke_data_t* stroke_data)
+{
+    PVG_FT_Outline* outline = ft_outline_convert_retained_stroke(scratch, path, matrix, stroke_data);
+    outline->flags = PVG_FT_OUTLINE_NONE;
+    ft_outline_render(scratch, span_buffer, outline, clip_rect);
 }
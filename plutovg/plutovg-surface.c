@@ -9,15 +9,121 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "plutovg-stb-image.h"
 
+/*
+short lived surfaces (mask and group layers are created and dropped once per element drawn) keep their memory in a
+small pool shared by all threads, so the next layer of a similar size reuses it instead of going back to the allocator
+a pooled block is only handed out for a surface needing at least half of it, blocks over 4MB (a 1024x1024 layer) are
+never kept, and plutovg_surface_pool_trim gives the rest back once a render is done with them
+*/
+
+#define PLUTOVG_SURFACE_POOL_SIZE 4
+#define PLUTOVG_SURFACE_POOL_MAX_BYTES ((size_t)4 * 1024 * 1024)
+
+static plutovg_surface_t* surface_pool[PLUTOVG_SURFACE_POOL_SIZE];
+
+#if defined(_WIN32)
+
+static SRWLOCK surface_pool_lock = SRWLOCK_INIT;
+
+#define plutovg_surface_pool_lock() AcquireSRWLockExclusive(&surface_pool_lock)
+#define plutovg_surface_pool_unlock() ReleaseSRWLockExclusive(&surface_pool_lock)
+
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && defined(HAVE_THREADS_H) && !defined(__STDC_NO_THREADS__)
+
+#include <threads.h>
+
+static mtx_t surface_pool_lock;
+static once_flag surface_pool_lock_once = ONCE_FLAG_INIT;
+
+static void plutovg_surface_pool_lock_init(void)
+{
+    mtx_init(&surface_pool_lock, mtx_plain);
+}
+
+#define plutovg_surface_pool_lock() (call_once(&surface_pool_lock_once, plutovg_surface_pool_lock_init), mtx_lock(&surface_pool_lock))
+#define plutovg_surface_pool_unlock() mtx_unlock(&surface_pool_lock)
+
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+
+// with no mutex to be had, a spin lock; it is only ever held for a few loads and stores
+static atomic_flag surface_pool_lock = ATOMIC_FLAG_INIT;
+
+#define plutovg_surface_pool_lock() while(atomic_flag_test_and_set_explicit(&surface_pool_lock, memory_order_acquire))
+#define plutovg_surface_pool_unlock() atomic_flag_clear_explicit(&surface_pool_lock, memory_order_release)
+
+#else
+
+#define plutovg_surface_pool_lock() ((void)0)
+#define plutovg_surface_pool_unlock() ((void)0)
+
+#endif
+
+static plutovg_surface_t* plutovg_surface_pool_take(size_t size)
+{
+    plutovg_surface_t* surface = NULL;
+    int index = -1;
+    plutovg_surface_pool_lock();
+    for(int i = 0; i < PLUTOVG_SURFACE_POOL_SIZE; i++) {
+        plutovg_surface_t* block = surface_pool[i];
+        if(block && block->capacity >= size && block->capacity / 2 <= size && (surface == NULL || block->capacity < surface->capacity)) {
+            surface = block;
+            index = i;
+        }
+    }
+
+    if(surface)
+        surface_pool[index] = NULL;
+    plutovg_surface_pool_unlock();
+    return surface;
+}
+
+static bool plutovg_surface_pool_give(plutovg_surface_t* surface)
+{
+    if(surface->capacity == 0 || surface->capacity > PLUTOVG_SURFACE_POOL_MAX_BYTES)
+        return false;
+    bool pooled = false;
+    plutovg_surface_pool_lock();
+    for(int i = 0; i < PLUTOVG_SURFACE_POOL_SIZE; i++) {
+        if(surface_pool[i] == NULL) {
+            surface_pool[i] = surface;
+            pooled = true;
+            break;
+        }
+    }
+
+    plutovg_surface_pool_unlock();
+    return pooled;
+}
+
+void plutovg_surface_pool_trim(void)
+{
+    plutovg_surface_t* blocks[PLUTOVG_SURFACE_POOL_SIZE];
+    plutovg_surface_pool_lock();
+    for(int i = 0; i < PLUTOVG_SURFACE_POOL_SIZE; i++) {
+        blocks[i] = surface_pool[i];
+        surface_pool[i] = NULL;
+    }
+
+    plutovg_surface_pool_unlock();
+    for(int i = 0; i < PLUTOVG_SURFACE_POOL_SIZE; i++) {
+        free(blocks[i]);
+    }
+}
+
 static plutovg_surface_t* plutovg_surface_create_uninitialized(int width, int height)
 {
     static const int kMaxSize = 1 << 15;
     if(width <= 0 || height <= 0 || width >= kMaxSize || height >= kMaxSize)
         return NULL;
-    const size_t size = width * height * 4;
-    plutovg_surface_t* surface = (plutovg_surface_t*)malloc(size + sizeof(plutovg_surface_t));
-    if(surface == NULL)
-        return NULL;
+    const size_t size = (size_t)width * height * 4;
+    plutovg_surface_t* surface = plutovg_surface_pool_take(size);
+    if(surface == NULL) {
+        surface = (plutovg_surface_t*)malloc(size + sizeof(plutovg_surface_t));
+        if(surface == NULL)
+            return NULL;
+        surface->capacity = size;
+    }
+
     plutovg_init_reference(surface);
     surface->width = width;
     surface->height = height;
@@ -42,6 +148,7 @@ plutovg_surface_t* plutovg_surface_create_for_data(unsigned char* data, int widt
     surface->height = height;
     surface->stride = stride;
     surface->data = data;
+    surface->capacity = 0;
     return surface;
 }
 
@@ -156,7 +263,7 @@ plutovg_surface_t* plutovg_surface_reference(plutovg_surface_t* surface)
 
 void plutovg_surface_destroy(plutovg_surface_t* surface)
 {
-    if(plutovg_destroy_reference(surface)) {
+    if(plutovg_destroy_reference(surface) && !plutovg_surface_pool_give(surface)) {
         free(surface);
     }
 }
@@ -122,44 +122,135 @@ static inline uint32_t plutovg_premultiply_argb(uint32_t color)
     return (a << 24) | (r << 16) | (g << 8) | (b);
 }
 
+/*
+the digits are gathered into an integer and scaled once, instead of being accumulated in floats with a powf for the
+exponent; up to 2^24 with an exponent of at most ten both the integer and the power of ten are exact floats, so one
+float multiply or divide rounds correctly, and anything longer is scaled in double
+*/
+static const float plutovg_float_powers_of_ten[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+static const double plutovg_powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define PLUTOVG_MANTISSA_LIMIT 100000000000000000ull
+
+#if defined(_MSC_VER) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define PLUTOVG_EIGHT_DIGITS_AT_ONCE
+#if defined(_MSC_VER)
+#include <intrin.h>
+static inline int plutovg_ctz64(uint64_t x)
+{
+    unsigned long r = 0;
+    _BitScanForward64(&r, x);
+    return (int)r;
+}
+#else
+#define plutovg_ctz64(x) __builtin_ctzll(x)
+#endif
+
+static const uint64_t plutovg_integer_powers_of_ten[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+/*
+reads the digits at the start of the eight bytes at it without a branch for each one: they are found with one mask,
+shifted up so that the bytes past them turn into leading zeros and then combined into pairs, fours and finally one
+eight digit value; it returns how many digits there were and appends them to the mantissa
+*/
+static inline int plutovg_parse_eight_digits(const char* it, uint64_t* mantissa)
+{
+    uint64_t chunk;
+    memcpy(&chunk, it, 8);
+    chunk ^= 0x3030303030303030ull;
+    uint64_t non_digits = (chunk | (chunk + 0x0606060606060606ull)) & 0xF0F0F0F0F0F0F0F0ull;
+    int count = non_digits ? plutovg_ctz64(non_digits) >> 3 : 8;
+    if(count == 0)
+        return 0;
+    chunk <<= 8 * (8 - count);
+    chunk = chunk * 10 + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FFull) * 0x000F424000000064ull)
+        + (((chunk >> 16) & 0x000000FF000000FFull) * 0x0000271000000001ull)) >> 32;
+    *mantissa = *mantissa * plutovg_integer_powers_of_ten[count] + chunk;
+    return count;
+}
+#endif
+
+// appends the run of digits at it to the mantissa, eight at a time where there are eight bytes left to look at
+static inline const char* plutovg_parse_digits(const char* it, const char* end, uint64_t* mantissa)
+{
+#ifdef PLUTOVG_EIGHT_DIGITS_AT_ONCE
+    while(end - it >= 8) {
+        int count = plutovg_parse_eight_digits(it, mantissa);
+        it += count;
+        if(count < 8)
+            return it;
+    }
+#endif
+    while(it < end && PLUTOVG_IS_NUM(*it))
+        *mantissa = 10 * *mantissa + (*it++ - '0');
+    return it;
+}
+
+// more than 19 digits overflow the mantissa, so they are read again keeping the first 18 significant ones; the rest
+// only move the decimal point
+static inline uint64_t plutovg_parse_long_mantissa(const char* it, const char* end, int* exponent)
+{
+    uint64_t mantissa = 0;
+    bool fraction = false;
+    for(; it < end; ++it) {
+        if(*it == '.') {
+            fraction = true;
+        } else if(mantissa < PLUTOVG_MANTISSA_LIMIT) {
+            mantissa = 10 * mantissa + (*it - '0');
+            if(fraction) {
+                --*exponent;
+            }
+        } else if(!fraction) {
+            ++*exponent;
+        }
+    }
+
+    return mantissa;
+}
+
 static inline bool plutovg_parse_number(const char** begin, const char* end, float* number)
 {
     const char* it = *begin;
-    float integer = 0;
-    float fraction = 0;
-    float exponent = 0;
-    int sign = 1;
-    int expsign = 1;
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    bool negative = false;
 
-    if(it < end && *it == '+') {
+    if(it < end && (*it == '+' || *it == '-')) {
+        negative = *it == '-';
         ++it;
-    } else if(it < end && *it == '-') {
-        ++it;
-        sign = -1;
     }
 
-    if(it >= end || (*it != '.' && !PLUTOVG_IS_NUM(*it)))
+    const char* digits = it;
+    it = plutovg_parse_digits(it, end, &mantissa);
+    int count = (int)(it - digits);
+    if(it < end && *it == '.') {
+        const char* fraction = ++it;
+        it = plutovg_parse_digits(it, end, &mantissa);
+        if(it == fraction)
+            return false;
+        exponent = (int)(fraction - it);
+        count += (int)(it - fraction);
+    } else if(count == 0) {
         return false;
-    if(PLUTOVG_IS_NUM(*it)) {
-        do {
-            integer = 10.f * integer + (*it++ - '0');
-        } while(it < end && PLUTOVG_IS_NUM(*it));
     }
 
-    if(it < end && *it == '.') {
-        ++it;
-        if(it >= end || !PLUTOVG_IS_NUM(*it))
-            return false;
-        float divisor = 1.f;
-        do {
-            fraction = 10.f * fraction + (*it++ - '0');
-            divisor *= 10.f;
-        } while(it < end && PLUTOVG_IS_NUM(*it));
-        fraction /= divisor;
+    if(count > 19) {
+        exponent = 0;
+        mantissa = plutovg_parse_long_mantissa(digits, it, &exponent);
     }
 
     if(it < end && (*it == 'e' || *it == 'E')) {
         ++it;
+        int expsign = 1;
         if(it < end && *it == '+') {
             ++it;
         } else if(it < end && *it == '-') {
@@ -169,16 +260,39 @@ static inline bool plutovg_parse_number(const char** begin, const char* end, flo
 
         if(it >= end || !PLUTOVG_IS_NUM(*it))
             return false;
+        int value = 0;
         do {
-            exponent = 10 * exponent + (*it++ - '0');
+            if(value < 10000)
+                value = 10 * value + (*it - '0');
+            ++it;
         } while(it < end && PLUTOVG_IS_NUM(*it));
+        exponent += expsign * value;
     }
 
     *begin = it;
-    *number = sign * (integer + fraction);
-    if(exponent)
-        *number *= powf(10.f, expsign * exponent);
-    return *number >= -FLT_MAX && *number <= FLT_MAX;
+    if(mantissa < (1u << 24) && exponent >= -10 && exponent <= 10) {
+        float value = (float)mantissa;
+        if(exponent < 0)
+            value /= plutovg_float_powers_of_ten[-exponent];
+        else
+            value *= plutovg_float_powers_of_ten[exponent];
+        *number = negative ? -value : value;
+        return true;
+    }
+
+    double value = (double)mantissa;
+    if(mantissa && exponent) {
+        if(exponent > 0 && exponent <= 22) {
+            value *= plutovg_powers_of_ten[exponent];
+        } else if(exponent < 0 && exponent >= -22) {
+            value /= plutovg_powers_of_ten[-exponent];
+        } else {
+            value *= pow(10.0, exponent);
+        }
+    }
+
+    *number = (float)(negative ? -value : value);
+    return value <= FLT_MAX;
 }
 
 static inline bool plutovg_skip_delim(const char** begin, const char* end, const char delim)
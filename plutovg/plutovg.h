@@ -1200,6 +1200,14 @@ PLUTOVG_API plutovg_surface_t* plutovg_surface_reference(plutovg_surface_t* surf
  */
 PLUTOVG_API void plutovg_surface_destroy(plutovg_surface_t* surface);
 
+/**
+ * @brief Frees the memory kept from destroyed surfaces.
+ *
+ * Destroyed surfaces of up to 4MB keep their memory in a small pool shared by all threads, for the next surface of a
+ * similar size. Calling this once a render is done keeps it from holding on to that memory in between.
+ */
+PLUTOVG_API void plutovg_surface_pool_trim(void);
+
 /**
  * @brief Gets the current reference count of a surface.
  *
@@ -1525,6 +1533,33 @@ PLUTOVG_API void plutovg_canvas_destroy(plutovg_canvas_t* canvas);
  */
 PLUTOVG_API int plutovg_canvas_get_reference_count(const plutovg_canvas_t* canvas);
 
+/**
+ * @brief Retrieves how often the canvas needed scratch memory to rasterize and how often it had to allocate it.
+ *
+ * Outlines, dashed paths, the stroker and the rasterizer's cell pool are kept by the canvas and reused by every
+ * fill, stroke and clip until the canvas is destroyed. `requests` counts the times one of them was needed,
+ * which is the number of allocations made when each draw call allocated its own, and `allocations` counts the
+ * times one had to be created or grown.
+ *
+ * @param canvas A pointer to a `plutovg_canvas_t` object.
+ * @param requests Receives the number of requests, if not `NULL`.
+ * @param allocations Receives the number of allocations, if not `NULL`.
+ */
+PLUTOVG_API void plutovg_canvas_get_scratch_counts(const plutovg_canvas_t* canvas, int* requests, int* allocations);
+
+/**
+ * @brief Retrieves how often `plutovg_canvas_stroke_path` reused the outline a path was last stroked to.
+ *
+ * The path keeps the outline until it is changed or destroyed, so drawing the same path again, on this canvas or
+ * another one, with the same stroke settings skips the stroker as long as the matrix only differs by a translation.
+ * `hits` counts the strokes that reused it, and `misses` the ones that had to run the stroker.
+ *
+ * @param canvas A pointer to a `plutovg_canvas_t` object.
+ * @param hits Receives the number of reused outlines, if not `NULL`.
+ * @param misses Receives the number of outlines made, if not `NULL`.
+ */
+PLUTOVG_API void plutovg_canvas_get_stroke_cache_counts(const plutovg_canvas_t* canvas, int* hits, int* misses);
+
 /**
  * @brief Gets the surface associated with the canvas.
  *
@@ -2417,6 +2452,9 @@ PLUTOVG_API void plutovg_canvas_stroke_rect(plutovg_canvas_t* canvas, float x, f
 /**
  * @brief Strokes a path with the current stroke settings.
  *
+ * The outline the path is stroked to is kept with the path and reused when it is stroked again, see
+ * `plutovg_canvas_get_stroke_cache_counts`, so the same path must not be stroked from two threads at once.
+ *
  * @note The current path will be cleared by this operation.
  * @param canvas A pointer to a `plutovg_canvas_t` object.
  * @param path The `plutovg_path_t` object.
@@ -2471,6 +2509,9 @@ PLUTOVG_API float plutovg_canvas_add_text(plutovg_canvas_t* canvas, const void*
 /**
  * @brief Fills a text at the specified origin.
  *
+ * When the current matrix only translates and scales evenly, glyphs are blitted from coverage masks cached by the
+ * font face, placed to a quarter of a pixel, instead of being rasterized as a path.
+ *
  * @note The current path will be cleared by this operation.
  * @param canvas A pointer to a `plutovg_canvas_t` object.
  * @param text The text data.
@@ -399,17 +399,8 @@ struct generator_t {
 	std::string name;
 	std::vector<generator_item> inserts;
 };
-struct layout_level_t;
 struct sub_layout_t {
-	std::unique_ptr<layout_level_t> layout;
-
-	sub_layout_t() noexcept = default;
-	sub_layout_t(sub_layout_t const& o) noexcept {
-		std::abort();
-	}
-	sub_layout_t(sub_layout_t&& o) noexcept = default;
-	sub_layout_t& operator=(sub_layout_t&& o) noexcept = default;
-	~sub_layout_t() = default;
+	int32_t index = -1; // into the sub_layouts of the window that owns the layout
 };
 
 using layout_item = std::variant<std::monostate, layout_control_t, layout_window_t, layout_glue_t, generator_t, texture_layer_t, sub_layout_t>;
@@ -439,21 +430,110 @@ struct template_alternate {
 	int32_t tempalte_id = -1;
 };
 
+/*
+the nested levels of a window's layout, kept side by side in blocks of 16 that never move once made, so that adding a
+level while the tree is being walked leaves the others in place (a std::deque gives the same guarantee, but msvc's
+allocates every level of this size on its own)
+*/
+class layout_level_arena {
+	static constexpr size_t block_size = 16;
+	std::vector<std::unique_ptr<layout_level_t[]>> blocks;
+	size_t count = 0;
+public:
+	layout_level_arena() = default;
+	layout_level_arena(layout_level_arena&&) noexcept = default;
+	layout_level_arena& operator=(layout_level_arena&&) noexcept = default;
+	layout_level_arena(layout_level_arena const& o) {
+		for(size_t i = 0; i < o.count; ++i)
+			emplace_back() = o[i];
+	}
+	layout_level_arena& operator=(layout_level_arena const& o) {
+		if(this != &o) {
+			layout_level_arena copy{ o };
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	layout_level_t& operator[](size_t i) {
+		return blocks[i / block_size][i % block_size];
+	}
+	layout_level_t const& operator[](size_t i) const {
+		return blocks[i / block_size][i % block_size];
+	}
+	size_t size() const {
+		return count;
+	}
+	layout_level_t& emplace_back() {
+		if(count == blocks.size() * block_size)
+			blocks.emplace_back(new layout_level_t[block_size]);
+		++count;
+		return (*this)[count - 1];
+	}
+};
+
 struct window_element_wrapper_t {
 	window_element_t wrapped;
 	std::vector<ui_element_t> children;
 	layout_level_t layout;
+	layout_level_arena sub_layouts; // every nested level of the layout (and buffer)
 	std::vector<layout_item> buffer;
 	std::vector<ui_element_t> buffer_children;
 	std::vector<template_alternate> alternates;
 };
 
+inline layout_level_t& get_sub_layout(window_element_wrapper_t& win, sub_layout_t const& s) {
+	return win.sub_layouts[size_t(s.index)];
+}
+inline layout_level_t const& get_sub_layout(window_element_wrapper_t const& win, sub_layout_t const& s) {
+	return win.sub_layouts[size_t(s.index)];
+}
+inline sub_layout_t make_sub_layout(window_element_wrapper_t& win) {
+	win.sub_layouts.emplace_back();
+	return sub_layout_t{ int32_t(win.sub_layouts.size() - 1) };
+}
+
+/*
+deleting an item that holds a level leaves the level (and everything nested in it) behind in the arena
+compacting moves the levels that can still be reached from the layout or the buffer into a fresh arena, in tree
+order, and renumbers the references to them; it moves levels around, so nothing may hold on to one across the call
+*/
+inline size_t count_reachable_sub_layouts(window_element_wrapper_t const& win, std::vector<layout_item> const& contents) {
+	size_t count = 0;
+	for(auto& m : contents) {
+		if(auto s = std::get_if<sub_layout_t>(&m)) {
+			count += 1 + count_reachable_sub_layouts(win, get_sub_layout(win, *s).contents);
+		}
+	}
+	return count;
+}
+inline void move_reachable_sub_layouts(window_element_wrapper_t& win, std::vector<layout_item>& contents, layout_level_arena& into) {
+	for(auto& m : contents) {
+		if(auto s = std::get_if<sub_layout_t>(&m)) {
+			auto& moved = into.emplace_back();
+			moved = std::move(win.sub_layouts[size_t(s->index)]);
+			s->index = int32_t(into.size() - 1);
+			move_reachable_sub_layouts(win, moved.contents, into); // the arena keeps its levels in place as it grows
+		}
+	}
+}
+inline void compact_sub_layouts(window_element_wrapper_t& win) {
+	auto reachable = count_reachable_sub_layouts(win, win.layout.contents) + count_reachable_sub_layouts(win, win.buffer);
+	if(reachable == win.sub_layouts.size())
+		return;
+	layout_level_arena compacted;
+	move_reachable_sub_layouts(win, win.layout.contents, compacted);
+	move_reachable_sub_layouts(win, win.buffer, compacted);
+	win.sub_layouts = std::move(compacted);
+}
+
 struct open_project_t {
 	std::wstring project_name;
 	std::wstring project_directory;
 	std::wstring source_path;
 	int32_t grid_size = 9;
 	bool omit_lua = false;
+	bool bake_layouts = false; // generate the layouts and child properties as tables in the code instead of reading them at startup
 	std::vector<window_element_wrapper_t> windows;
 	std::vector<table_definition> tables;
 };
@@ -529,7 +609,7 @@ inline std::vector<table_definition const*> tables_in_layout( open_project_t con
 		}
 		if(holds_alternative<sub_layout_t>(c)) {
 			auto& i = get<sub_layout_t>(c);
-			auto sr = tables_in_layout(proj, win, *i.layout);
+			auto sr = tables_in_layout(proj, win, get_sub_layout(win, i));
 			for(auto t : sr) {
 				if(std::find(result.begin(), result.end(), t) == result.end())
 					result.push_back(t);
@@ -568,7 +648,7 @@ inline std::vector<table_definition*> tables_in_layout(open_project_t& proj, win
 		}
 		if(holds_alternative<sub_layout_t>(c)) {
 			auto& i = get<sub_layout_t>(c);
-			auto sr = tables_in_layout(proj, win, *i.layout);
+			auto sr = tables_in_layout(proj, win, get_sub_layout(win, i));
 			for(auto t : sr) {
 				if(std::find(result.begin(), result.end(), t) == result.end())
 					result.push_back(t);
@@ -9,20 +9,58 @@ enum class layout_item_types : uint8_t {
 	control, window, glue, generator, layout, texture_layer, control2, window2, generator2
 };
 
-void layout_to_bytes(layout_level_t const& layout, serialization::out_buffer& buffer) {
+using serialization::field;
+using serialization::nested;
+using serialization::schema;
+
+using layout_header_schema = schema<
+	field<&layout_level_t::size_x>,
+	field<&layout_level_t::size_y>,
+	field<&layout_level_t::margin_top>,
+	field<&layout_level_t::margin_bottom>,
+	field<&layout_level_t::margin_left>,
+	field<&layout_level_t::margin_right>,
+	field<&layout_level_t::line_alignment>,
+	field<&layout_level_t::line_internal_alignment>,
+	field<&layout_level_t::type>,
+	field<&layout_level_t::page_animation>,
+	field<&layout_level_t::interline_spacing>,
+	field<&layout_level_t::paged>>;
+
+// generator2; the older generator records lack child_of
+using generator_item_schema = schema<
+	field<&generator_item::name>,
+	field<&generator_item::header>,
+	field<&generator_item::child_of>,
+	field<&generator_item::inter_item_space>,
+	field<&generator_item::glue>,
+	field<&generator_item::sortable>>;
+
+using column_display_schema = schema<
+	field<&table_display_column::header_key>,
+	field<&table_display_column::header_tooltip_key>,
+	field<&table_display_column::header_texture>,
+	field<&table_display_column::cell_tooltip_key>,
+	field<&table_display_column::width>,
+	field<&table_display_column::cell_text_color>,
+	field<&table_display_column::header_text_color>,
+	field<&table_display_column::text_alignment>>;
+using column_internal_schema = schema<
+	field<&table_internal_column::column_name>,
+	field<&table_internal_column::container>,
+	field<&table_internal_column::cell_type>,
+	field<&table_internal_column::has_dy_header_tooltip>,
+	field<&table_internal_column::has_dy_cell_tooltip>,
+	field<&table_internal_column::sortable>,
+	field<&table_internal_column::header_background>,
+	field<&table_internal_column::decimal_alignment>>;
+using column_schema = schema<
+	nested<&full_col_data::display_data, column_display_schema>,
+	nested<&full_col_data::internal_data, column_internal_schema>>;
+
+void layout_to_bytes(window_element_wrapper_t const& win, layout_level_t const& layout, serialization::out_buffer& buffer) {
 	buffer.start_section();
-	buffer.write(layout.size_x);
-	buffer.write(layout.size_y);
-	buffer.write(layout.margin_top);
-	buffer.write(layout.margin_bottom);
-	buffer.write(layout.margin_left);
-	buffer.write(layout.margin_right);
-	buffer.write(layout.line_alignment);
-	buffer.write(layout.line_internal_alignment);
-	buffer.write(layout.type);
-	buffer.write(layout.page_animation);
-	buffer.write(layout.interline_spacing);
-	buffer.write(layout.paged);
+	serialization::write_record<layout_header_schema>(buffer, layout);
 
 	buffer.start_section(); // expansion section
 	buffer.write(layout.template_id);
@@ -63,12 +101,7 @@ void layout_to_bytes(layout_level_t const& layout, serialization::out_buffer& bu
 
 			buffer.start_section();
 			for(auto& j : i.inserts) {
-				buffer.write(j.name);
-				buffer.write(j.header);
-				buffer.write(j.child_of);
-				buffer.write(j.inter_item_space);
-				buffer.write(j.glue);
-				buffer.write(j.sortable);
+				serialization::write_record<generator_item_schema>(buffer, j);
 			}
 			buffer.finish_section();
 
@@ -76,7 +109,7 @@ void layout_to_bytes(layout_level_t const& layout, serialization::out_buffer& bu
 			auto& i = get<sub_layout_t>(m);
 
 			buffer.write(layout_item_types::layout);
-			layout_to_bytes(*i.layout, buffer);
+			layout_to_bytes(win, get_sub_layout(win, i), buffer);
 		} else if(holds_alternative<texture_layer_t>(m)) {
 			auto& i = get<texture_layer_t>(m);
 
@@ -88,20 +121,9 @@ void layout_to_bytes(layout_level_t const& layout, serialization::out_buffer& bu
 	buffer.finish_section();
 }
 
-void bytes_to_layout(layout_level_t& layout, serialization::in_buffer& buffer) {
+void bytes_to_layout(window_element_wrapper_t& win, layout_level_t& layout, serialization::in_buffer& buffer) {
 	auto main_section = buffer.read_section();
-	main_section.read(layout.size_x);
-	main_section.read(layout.size_y);
-	main_section.read(layout.margin_top);
-	main_section.read(layout.margin_bottom);
-	main_section.read(layout.margin_left);
-	main_section.read(layout.margin_right);
-	main_section.read(layout.line_alignment);
-	main_section.read(layout.line_internal_alignment);
-	main_section.read(layout.type);
-	main_section.read(layout.page_animation);
-	main_section.read(layout.interline_spacing);
-	main_section.read(layout.paged);
+	serialization::read_record<layout_header_schema>(main_section, layout);
 
 	auto expansion_section = main_section.read_section();
 	if(expansion_section)
@@ -185,22 +207,16 @@ void bytes_to_layout(layout_level_t& layout, serialization::in_buffer& buffer) {
 				auto contents = main_section.read_section();
 				while(contents) {
 					temp.inserts.emplace_back();
-					contents.read(temp.inserts.back().name);
-					contents.read(temp.inserts.back().header);
-					contents.read(temp.inserts.back().child_of);
-					contents.read(temp.inserts.back().inter_item_space);
-					contents.read(temp.inserts.back().glue);
-					contents.read(temp.inserts.back().sortable);
+					serialization::read_record<generator_item_schema>(contents, temp.inserts.back());
 				}
 
 				layout.contents.emplace_back(std::move(temp));
 			} break;
 			case layout_item_types::layout:
 			{
-				sub_layout_t temp;
-				temp.layout = std::make_unique<layout_level_t>();
-				bytes_to_layout(*temp.layout, main_section);
-				layout.contents.emplace_back(std::move(temp));
+				auto temp = make_sub_layout(win);
+				bytes_to_layout(win, get_sub_layout(win, temp), main_section);
+				layout.contents.emplace_back(temp);
 			} break;
 			case layout_item_types::texture_layer:
 			{
@@ -215,299 +231,329 @@ void bytes_to_layout(layout_level_t& layout, serialization::in_buffer& buffer) {
 	}
 }
 
-void project_to_bytes(open_project_t const& p, serialization::out_buffer& buffer) {
-	buffer.start_section(); // header
-	buffer.write(p.grid_size);
-	buffer.write(p.source_path);
-	buffer.write(p.omit_lua);
+void window_to_bytes(open_project_t const& p, window_element_wrapper_t const& win, serialization::out_buffer& buffer) {
+	buffer.start_section(); // essential section
+	buffer.write(win.wrapped.name);
+	buffer.write(win.wrapped.x_pos);
+	buffer.write(win.wrapped.y_pos);
+	buffer.write(win.wrapped.x_size);
+	buffer.write(win.wrapped.y_size);
+	buffer.write(win.wrapped.orientation);
+
+	if(win.wrapped.border_size != 0) {
+		buffer.write(property::border_size);
+		buffer.write(win.wrapped.border_size);
+	}
+	if(win.wrapped.template_id == -1 && win.wrapped.texture.size() > 0) {
+		buffer.write(property::texture);
+		buffer.write(win.wrapped.texture);
+	}
+	if(win.wrapped.template_id == -1 && win.wrapped.alternate_bg.size() > 0) {
+		buffer.write(property::alternate_bg);
+		buffer.write(win.wrapped.alternate_bg);
+	}
+	if(win.wrapped.template_id == -1 && (win.wrapped.page_left_texture.size() > 0 || win.wrapped.page_right_texture.size() > 0)) {
+		buffer.write(property::page_button_textures);
+		buffer.write(win.wrapped.page_left_texture);
+		buffer.write(win.wrapped.page_right_texture);
+		buffer.write(win.wrapped.page_text_color);
+	}
+	if(win.layout.contents.size() > 0) {
+		buffer.write(property::layout_information);
+		layout_to_bytes(win, win.layout, buffer);
+	}
+	if(win.wrapped.template_id != -1) {
+		buffer.write(property::template_type);
+		buffer.write(win.wrapped.template_id);
+		int16_t tempgs = int16_t(p.grid_size);
+		buffer.write(tempgs);
+		buffer.write(win.wrapped.auto_close_button);
+	}
 	buffer.finish_section();
 
-	for(auto& win : p.windows) {
-		buffer.start_section();
+	buffer.start_section(); // optional section
+	buffer.write(win.wrapped.parent);
 
+	if(win.wrapped.background != background_type::none) {
+		buffer.write(property::background);
+		buffer.write(win.wrapped.background);
+	}
+	if(win.wrapped.rectangle_color != color3f{ 1.0f, 0.0f, 0.0f }) {
+		buffer.write(property::rectangle_color);
+		buffer.write(win.wrapped.rectangle_color);
+	}
+	if(win.wrapped.has_alternate_bg) {
+		buffer.write(property::has_alternate_bg);
+		buffer.write(win.wrapped.has_alternate_bg);
+	}
+	if(win.wrapped.no_grid) {
+		buffer.write(property::no_grid);
+		buffer.write(win.wrapped.no_grid);
+	}
+	if(win.wrapped.draggable) {
+		buffer.write(property::draggable);
+		buffer.write(win.wrapped.draggable);
+	}
+	if(win.wrapped.updates_while_hidden) {
+		buffer.write(property::updates_while_hidden);
+		buffer.write(win.wrapped.updates_while_hidden);
+	}
+	if(win.wrapped.ignore_rtl) {
+		buffer.write(property::ignore_rtl);
+		buffer.write(win.wrapped.ignore_rtl);
+	}
+	if(win.wrapped.share_table_highlight) {
+		buffer.write(property::share_table_highlight);
+		buffer.write(win.wrapped.share_table_highlight);
+	}
+	if(win.wrapped.on_hide_action) {
+		buffer.write(property::hide_action);
+		buffer.write(win.wrapped.on_hide_action);
+	}
+	if(win.wrapped.table_connection.size() > 0) {
+		buffer.write(property::table_connection);
+		buffer.write(win.wrapped.table_connection);
+	}
+	for(auto& dm : win.wrapped.members) {
+		buffer.write(property::data_member);
+		buffer.write(dm.type);
+		buffer.write(dm.name);
+	}
+	for(auto& alt : win.alternates) {
+		buffer.write(property::alternate_set);
+		buffer.write(alt.control_name);
+		buffer.write(alt.tempalte_id);
+	}
+	buffer.finish_section();
+
+	for(auto& c : win.children) {
 		buffer.start_section(); // essential section
-		buffer.write(win.wrapped.name);
-		buffer.write(win.wrapped.x_pos);
-		buffer.write(win.wrapped.y_pos);
-		buffer.write(win.wrapped.x_size);
-		buffer.write(win.wrapped.y_size);
-		buffer.write(win.wrapped.orientation);
-
-		if(win.wrapped.border_size != 0) {
+
+		buffer.write(c.name);
+		buffer.write(c.x_pos);
+		buffer.write(c.y_pos);
+		buffer.write(c.x_size);
+		buffer.write(c.y_size);
+		if(c.text_color != text_color::black) {
+			buffer.write(property::text_color);
+			buffer.write(c.text_color);
+		}
+		if(c.is_lua) {
+			buffer.write(property::is_lua);
+			buffer.write(c.is_lua);
+		}
+		if(c.tooltip_text_key.size() > 0) {
+			buffer.write(property::tooltip_text_key);
+			buffer.write(c.tooltip_text_key);
+		}
+		if(c.text_key.size() > 0) {
+			buffer.write(property::text_key);
+			buffer.write(c.text_key);
+		}
+		if(c.text_align != aui_text_alignment::left) {
+			buffer.write(property::text_align);
+			buffer.write(c.text_align);
+		}
+		if(c.border_size != 0) {
 			buffer.write(property::border_size);
-			buffer.write(win.wrapped.border_size);
+			buffer.write(c.border_size);
+		}
+		if(c.text_type != text_type::body) {
+			buffer.write(property::text_type);
+			buffer.write(c.text_type);
 		}
-		if(win.wrapped.template_id == -1 && win.wrapped.texture.size() > 0) {
+		if(c.text_scale != 1.0f) {
+			buffer.write(property::text_scale);
+			buffer.write(c.text_scale);
+		}
+		if(c.texture.size() > 0) {
 			buffer.write(property::texture);
-			buffer.write(win.wrapped.texture);
+			buffer.write(c.texture);
 		}
-		if(win.wrapped.template_id == -1 && win.wrapped.alternate_bg.size() > 0) {
+		if(c.alternate_bg.size() > 0) {
 			buffer.write(property::alternate_bg);
-			buffer.write(win.wrapped.alternate_bg);
+			buffer.write(c.alternate_bg);
+		}
+		if(c.has_table_highlight_color && c.container_type == container_type::table) {
+			buffer.write(property::table_highlight_color);
+			buffer.write(c.table_highlight_color);
+		}
+		if(c.ascending_sort_icon.size() > 0) {
+			buffer.write(property::ascending_sort_icon);
+			buffer.write(c.ascending_sort_icon);
+		}
+		if(c.descending_sort_icon.size() > 0) {
+			buffer.write(property::descending_sort_icon);
+			buffer.write(c.descending_sort_icon);
+		}
+		if(c.row_background_a.size() > 0) {
+			buffer.write(property::row_background_a);
+			buffer.write(c.row_background_a);
+		}
+		if(c.row_background_b.size() > 0) {
+			buffer.write(property::row_background_b);
+			buffer.write(c.row_background_b);
+		}
+		if(c.row_height != 2.0f) {
+			buffer.write(property::row_height);
+			buffer.write(c.row_height);
 		}
-		if(win.wrapped.template_id == -1 && (win.wrapped.page_left_texture.size() > 0 || win.wrapped.page_right_texture.size() > 0)) {
-			buffer.write(property::page_button_textures);
-			buffer.write(win.wrapped.page_left_texture);
-			buffer.write(win.wrapped.page_right_texture);
-			buffer.write(win.wrapped.page_text_color);
+		if(c.table_divider_color != color3f{ 0.0f, 0.0f, 0.0f}) {
+			buffer.write(property::table_divider_color);
+			buffer.write(c.table_divider_color);
 		}
-		if(win.layout.contents.size() > 0) {
-			buffer.write(property::layout_information);
-			layout_to_bytes(win.layout, buffer);
+		if(c.other_color != color4f{ 0.0f, 0.0f, 0.0f, 0.0f } && c.container_type != container_type::table) {
+			buffer.write(property::other_color);
+			buffer.write(c.other_color);
 		}
-		if(win.wrapped.template_id != -1) {
+		if(c.ttype != template_project::template_type::none) {
 			buffer.write(property::template_type);
-			buffer.write(win.wrapped.template_id);
-			int16_t tempgs = int16_t(p.grid_size);
-			buffer.write(tempgs);
-			buffer.write(win.wrapped.auto_close_button);
+			buffer.write(c.template_id);
+			buffer.write(c.ttype);
 		}
+		if(c.icon_id != -1) {
+			buffer.write(property::icon);
+			buffer.write(c.icon_id);
+		}
+		
 		buffer.finish_section();
 
 		buffer.start_section(); // optional section
-		buffer.write(win.wrapped.parent);
-
-		if(win.wrapped.background != background_type::none) {
+		if(c.background != background_type::none) {
 			buffer.write(property::background);
-			buffer.write(win.wrapped.background);
+			buffer.write(c.background);
 		}
-		if(win.wrapped.rectangle_color != color3f{ 1.0f, 0.0f, 0.0f }) {
+		if(c.rectangle_color != color3f{ 1.0f, 0.0f, 0.0f }) {
 			buffer.write(property::rectangle_color);
-			buffer.write(win.wrapped.rectangle_color);
+			buffer.write(c.rectangle_color);
 		}
-		if(win.wrapped.has_alternate_bg) {
-			buffer.write(property::has_alternate_bg);
-			buffer.write(win.wrapped.has_alternate_bg);
-		}
-		if(win.wrapped.no_grid) {
+		if(c.no_grid) {
 			buffer.write(property::no_grid);
-			buffer.write(win.wrapped.no_grid);
+			buffer.write(c.no_grid);
+		}
+		if(c.ignore_rtl) {
+			buffer.write(property::ignore_rtl);
+			buffer.write(c.ignore_rtl);
+		}
+		if(c.table_has_per_section_headers) {
+			buffer.write(property::table_has_per_section_headers);
+			buffer.write(c.table_has_per_section_headers);
+		}
+		if(c.dynamic_element) {
+			buffer.write(property::dynamic_element);
+			buffer.write(c.dynamic_element);
+		}
+		if(c.dynamic_tooltip) {
+			buffer.write(property::dynamic_tooltip);
+			buffer.write(c.dynamic_tooltip);
 		}
-		if(win.wrapped.draggable) {
-			buffer.write(property::draggable);
-			buffer.write(win.wrapped.draggable);
+		if(c.can_disable) {
+			buffer.write(property::can_disable);
+			buffer.write(c.can_disable);
 		}
-		if(win.wrapped.updates_while_hidden) {
+		if(c.updates_while_hidden) {
 			buffer.write(property::updates_while_hidden);
-			buffer.write(win.wrapped.updates_while_hidden);
+			buffer.write(c.updates_while_hidden);
 		}
-		if(win.wrapped.ignore_rtl) {
-			buffer.write(property::ignore_rtl);
-			buffer.write(win.wrapped.ignore_rtl);
+		if(c.left_click_action) {
+			buffer.write(property::left_click_action);
+			buffer.write(c.left_click_action);
+		}
+		if(c.right_click_action) {
+			buffer.write(property::right_click_action);
+			buffer.write(c.right_click_action);
+		}
+		if(c.shift_click_action) {
+			buffer.write(property::shift_click_action);
+			buffer.write(c.shift_click_action);
+		}
+		if(c.hover_activation) {
+			buffer.write(property::hover_activation);
+			buffer.write(c.hover_activation);
+		}
+		if(c.dynamic_text) {
+			buffer.write(property::dynamic_text);
+			buffer.write(c.dynamic_text);
+		}
+		if(c.container_type != container_type::none) {
+			buffer.write(property::container_type);
+			buffer.write(c.container_type);
+		}
+		if(c.datapoints != 100) {
+			buffer.write(property::datapoints);
+			buffer.write(c.datapoints);
+		}
+		if(c.hotkey.size() > 0) {
+			buffer.write(property::hotkey);
+			buffer.write(c.hotkey);
+		}
+		if(c.child_window.size() > 0) {
+			buffer.write(property::child_window);
+			buffer.write(c.child_window);
 		}
-		if(win.wrapped.share_table_highlight) {
-			buffer.write(property::share_table_highlight);
-			buffer.write(win.wrapped.share_table_highlight);
+		if(c.list_content.size() > 0) {
+			buffer.write(property::list_content);
+			buffer.write(c.list_content);
 		}
-		if(win.wrapped.on_hide_action) {
-			buffer.write(property::hide_action);
-			buffer.write(win.wrapped.on_hide_action);
+		if(c.has_alternate_bg) {
+			buffer.write(property::has_alternate_bg);
+			buffer.write(c.has_alternate_bg);
+		}
+		if(c.animation_type != animation_type::none) {
+			buffer.write(property::animation_type);
+			buffer.write(c.animation_type);
 		}
-		if(win.wrapped.table_connection.size() > 0) {
+		if(c.table_connection.size() > 0) {
 			buffer.write(property::table_connection);
-			buffer.write(win.wrapped.table_connection);
+			buffer.write(c.table_connection);
 		}
-		for(auto& dm : win.wrapped.members) {
+		for(auto& dm : c.members) {
 			buffer.write(property::data_member);
 			buffer.write(dm.type);
 			buffer.write(dm.name);
 		}
-		for(auto& alt : win.alternates) {
-			buffer.write(property::alternate_set);
-			buffer.write(alt.control_name);
-			buffer.write(alt.tempalte_id);
-		}
+		
 		buffer.finish_section();
+	}
+}
 
-		for(auto& c : win.children) {
-			buffer.start_section(); // essential section
+void table_to_bytes(table_definition const& tab, serialization::out_buffer& buffer) {
+	buffer.start_section();
 
-			buffer.write(c.name);
-			buffer.write(c.x_pos);
-			buffer.write(c.y_pos);
-			buffer.write(c.x_size);
-			buffer.write(c.y_size);
-			if(c.text_color != text_color::black) {
-				buffer.write(property::text_color);
-				buffer.write(c.text_color);
-			}
-			if(c.is_lua) {
-				buffer.write(property::is_lua);
-				buffer.write(c.is_lua);
-			}
-			if(c.tooltip_text_key.size() > 0) {
-				buffer.write(property::tooltip_text_key);
-				buffer.write(c.tooltip_text_key);
-			}
-			if(c.text_key.size() > 0) {
-				buffer.write(property::text_key);
-				buffer.write(c.text_key);
-			}
-			if(c.text_align != aui_text_alignment::left) {
-				buffer.write(property::text_align);
-				buffer.write(c.text_align);
-			}
-			if(c.border_size != 0) {
-				buffer.write(property::border_size);
-				buffer.write(c.border_size);
-			}
-			if(c.text_type != text_type::body) {
-				buffer.write(property::text_type);
-				buffer.write(c.text_type);
-			}
-			if(c.text_scale != 1.0f) {
-				buffer.write(property::text_scale);
-				buffer.write(c.text_scale);
-			}
-			if(c.texture.size() > 0) {
-				buffer.write(property::texture);
-				buffer.write(c.texture);
-			}
-			if(c.alternate_bg.size() > 0) {
-				buffer.write(property::alternate_bg);
-				buffer.write(c.alternate_bg);
-			}
-			if(c.has_table_highlight_color && c.container_type == container_type::table) {
-				buffer.write(property::table_highlight_color);
-				buffer.write(c.table_highlight_color);
-			}
-			if(c.ascending_sort_icon.size() > 0) {
-				buffer.write(property::ascending_sort_icon);
-				buffer.write(c.ascending_sort_icon);
-			}
-			if(c.descending_sort_icon.size() > 0) {
-				buffer.write(property::descending_sort_icon);
-				buffer.write(c.descending_sort_icon);
-			}
-			if(c.row_background_a.size() > 0) {
-				buffer.write(property::row_background_a);
-				buffer.write(c.row_background_a);
-			}
-			if(c.row_background_b.size() > 0) {
-				buffer.write(property::row_background_b);
-				buffer.write(c.row_background_b);
-			}
-			if(c.row_height != 2.0f) {
-				buffer.write(property::row_height);
-				buffer.write(c.row_height);
-			}
-			if(c.table_divider_color != color3f{ 0.0f, 0.0f, 0.0f}) {
-				buffer.write(property::table_divider_color);
-				buffer.write(c.table_divider_color);
-			}
-			if(c.other_color != color4f{ 0.0f, 0.0f, 0.0f, 0.0f } && c.container_type != container_type::table) {
-				buffer.write(property::other_color);
-				buffer.write(c.other_color);
-			}
-			if(c.ttype != template_project::template_type::none) {
-				buffer.write(property::template_type);
-				buffer.write(c.template_id);
-				buffer.write(c.ttype);
-			}
-			if(c.icon_id != -1) {
-				buffer.write(property::icon);
-				buffer.write(c.icon_id);
-			}
-			
-			buffer.finish_section();
+	buffer.start_section();
+	std::string table_type = ".TABLE";
+	buffer.write(table_type);
+	buffer.write(tab.name);
+	buffer.write(tab.ascending_sort_icon);
+	buffer.write(tab.descending_sort_icon);
+	buffer.write(tab.highlight_color);
+	buffer.write(tab.divider_color);
+	buffer.write(tab.has_highlight_color);
+	buffer.write(tab.template_id);
+	buffer.finish_section();
+
+	buffer.start_section();
+	for(auto& tc : tab.table_columns) {
+		serialization::write_record<column_schema>(buffer, tc);
+	}
+	buffer.finish_section();
+
+	buffer.finish_section();
+}
+
+void project_to_bytes(open_project_t const& p, serialization::out_buffer& buffer) {
+	buffer.start_section(); // header
+	buffer.write(p.grid_size);
+	buffer.write(p.source_path);
+	buffer.write(p.omit_lua);
+	buffer.write(p.bake_layouts);
+	buffer.finish_section();
+
+	for(auto& win : p.windows) {
+		buffer.start_section();
+
+		window_to_bytes(p, win, buffer);
 
-			buffer.start_section(); // optional section
-			if(c.background != background_type::none) {
-				buffer.write(property::background);
-				buffer.write(c.background);
-			}
-			if(c.rectangle_color != color3f{ 1.0f, 0.0f, 0.0f }) {
-				buffer.write(property::rectangle_color);
-				buffer.write(c.rectangle_color);
-			}
-			if(c.no_grid) {
-				buffer.write(property::no_grid);
-				buffer.write(c.no_grid);
-			}
-			if(c.ignore_rtl) {
-				buffer.write(property::ignore_rtl);
-				buffer.write(c.ignore_rtl);
-			}
-			if(c.table_has_per_section_headers) {
-				buffer.write(property::table_has_per_section_headers);
-				buffer.write(c.table_has_per_section_headers);
-			}
-			if(c.dynamic_element) {
-				buffer.write(property::dynamic_element);
-				buffer.write(c.dynamic_element);
-			}
-			if(c.dynamic_tooltip) {
-				buffer.write(property::dynamic_tooltip);
-				buffer.write(c.dynamic_tooltip);
-			}
-			if(c.can_disable) {
-				buffer.write(property::can_disable);
-				buffer.write(c.can_disable);
-			}
-			if(c.updates_while_hidden) {
-				buffer.write(property::updates_while_hidden);
-				buffer.write(c.updates_while_hidden);
-			}
-			if(c.left_click_action) {
-				buffer.write(property::left_click_action);
-				buffer.write(c.left_click_action);
-			}
-			if(c.right_click_action) {
-				buffer.write(property::right_click_action);
-				buffer.write(c.right_click_action);
-			}
-			if(c.shift_click_action) {
-				buffer.write(property::shift_click_action);
-				buffer.write(c.shift_click_action);
-			}
-			if(c.hover_activation) {
-				buffer.write(property::hover_activation);
-				buffer.write(c.hover_activation);
-			}
-			if(c.dynamic_text) {
-				buffer.write(property::dynamic_text);
-				buffer.write(c.dynamic_text);
-			}
-			if(c.container_type != container_type::none) {
-				buffer.write(property::container_type);
-				buffer.write(c.container_type);
-			}
-			if(c.datapoints != 100) {
-				buffer.write(property::datapoints);
-				buffer.write(c.datapoints);
-			}
-			if(c.hotkey.size() > 0) {
-				buffer.write(property::hotkey);
-				buffer.write(c.hotkey);
-			}
-			if(c.child_window.size() > 0) {
-				buffer.write(property::child_window);
-				buffer.write(c.child_window);
-			}
-			if(c.list_content.size() > 0) {
-				buffer.write(property::list_content);
-				buffer.write(c.list_content);
-			}
-			if(c.has_alternate_bg) {
-				buffer.write(property::has_alternate_bg);
-				buffer.write(c.has_alternate_bg);
-			}
-			if(c.animation_type != animation_type::none) {
-				buffer.write(property::animation_type);
-				buffer.write(c.animation_type);
-			}
-			if(c.table_connection.size() > 0) {
-				buffer.write(property::table_connection);
-				buffer.write(c.table_connection);
-			}
-			for(auto& dm : c.members) {
-				buffer.write(property::data_member);
-				buffer.write(dm.type);
-				buffer.write(dm.name);
-			}
-			
-			buffer.finish_section();
-		}
 		auto table_list = tables_in_window(p, win);
 		for(auto t : table_list) {
 			auto tdef_name = ".tab" + t->name;
@@ -533,42 +579,7 @@ void project_to_bytes(open_project_t const& p, serialization::out_buffer& buffer
 		buffer.finish_section();
 	}
 	for(auto& tab : p.tables) {
-		buffer.start_section();
-
-		buffer.start_section();
-		std::string table_type = ".TABLE";
-		buffer.write(table_type);
-		buffer.write(tab.name);
-		buffer.write(tab.ascending_sort_icon);
-		buffer.write(tab.descending_sort_icon);
-		buffer.write(tab.highlight_color);
-		buffer.write(tab.divider_color);
-		buffer.write(tab.has_highlight_color);
-		buffer.write(tab.template_id);
-		buffer.finish_section();
-
-		buffer.start_section();
-		for(auto& tc : tab.table_columns) {
-			buffer.write(tc.display_data.header_key);
-			buffer.write(tc.display_data.header_tooltip_key);
-			buffer.write(tc.display_data.header_texture);
-			buffer.write(tc.display_data.cell_tooltip_key);
-			buffer.write(tc.display_data.width);
-			buffer.write(tc.display_data.cell_text_color);
-			buffer.write(tc.display_data.header_text_color);
-			buffer.write(tc.display_data.text_alignment);
-			buffer.write(tc.internal_data.column_name);
-			buffer.write(tc.internal_data.container);
-			buffer.write(tc.internal_data.cell_type);
-			buffer.write(tc.internal_data.has_dy_header_tooltip);
-			buffer.write(tc.internal_data.has_dy_cell_tooltip);
-			buffer.write(tc.internal_data.sortable);
-			buffer.write(tc.internal_data.header_background);
-			buffer.write(tc.internal_data.decimal_alignment);
-		}
-		buffer.finish_section();
-
-		buffer.finish_section();
+		table_to_bytes(tab, buffer);
 	}
 }
 
@@ -588,6 +599,7 @@ open_project_t bytes_to_project(serialization::in_buffer& buffer) {
 	header_section.read(result.grid_size);
 	header_section.read(result.source_path);
 	header_section.read(result.omit_lua);
+	header_section.read(result.bake_layouts); // false in files written before it existed
 
 	while(buffer) {
 		auto window_section = buffer.read_section(); // essential section
@@ -609,22 +621,7 @@ open_project_t bytes_to_project(serialization::in_buffer& buffer) {
 			auto optional_section = window_section.read_section();
 			while(optional_section) {
 				full_col_data tc;
-				optional_section.read(tc.display_data.header_key);
-				optional_section.read(tc.display_data.header_tooltip_key);
-				optional_section.read(tc.display_data.header_texture);
-				optional_section.read(tc.display_data.cell_tooltip_key);
-				optional_section.read(tc.display_data.width);
-				optional_section.read(tc.display_data.cell_text_color);
-				optional_section.read(tc.display_data.header_text_color);
-				optional_section.read(tc.display_data.text_alignment);
-				optional_section.read(tc.internal_data.column_name);
-				optional_section.read(tc.internal_data.container);
-				optional_section.read(tc.internal_data.cell_type);
-				optional_section.read(tc.internal_data.has_dy_header_tooltip);
-				optional_section.read(tc.internal_data.has_dy_cell_tooltip);
-				optional_section.read(tc.internal_data.sortable);
-				optional_section.read(tc.internal_data.header_background);
-				optional_section.read(tc.internal_data.decimal_alignment);
+				serialization::read_record<column_schema>(optional_section, tc);
 				tab.table_columns.emplace_back(std::move(tc));
 			}
 			result.tables.emplace_back(std::move(tab));
@@ -649,7 +646,7 @@ open_project_t bytes_to_project(serialization::in_buffer& buffer) {
 					essential_window_section.read(win.wrapped.page_right_texture);
 					essential_window_section.read(win.wrapped.page_text_color);
 				} else if(ptype == property::layout_information) {
-					bytes_to_layout(win.layout, essential_window_section);
+					bytes_to_layout(win, win.layout, essential_window_section);
 				} else if(ptype == property::template_type) {
 					essential_window_section.read(win.wrapped.template_id);
 					essential_window_section.read(win.wrapped.stored_gird_size);
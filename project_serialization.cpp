@@ -4,303 +4,228 @@
 
 namespace template_project {
 
+using serialization::field;
+using serialization::nested;
+using serialization::schema;
+
+// each list of templates is a section holding one section per template, laid out as below
+
+using color_schema = schema<
+	field<&color_definition::display_name>,
+	field<&color_definition::r>,
+	field<&color_definition::g>,
+	field<&color_definition::b>,
+	field<&color_definition::a>>;
+
+using icon_schema = schema<
+	field<&icon_definition::file_name>>;
+
+using background_schema = schema<
+	field<&background_definition::file_name>,
+	field<&background_definition::base_x>,
+	field<&background_definition::base_y>,
+	field<&background_definition::nine_slice_border>>;
+
+using text_region_schema = schema<
+	field<&text_region_template::bg>,
+	field<&text_region_template::text_color>,
+	field<&text_region_template::font_choice>,
+	field<&text_region_template::font_scale>,
+	field<&text_region_template::h_text_margins>,
+	field<&text_region_template::v_text_margins>,
+	field<&text_region_template::h_text_alignment>,
+	field<&text_region_template::v_text_alignment>>;
+
+using icon_region_schema = schema<
+	field<&icon_region_template::bg>,
+	field<&icon_region_template::icon_color>,
+	field<&icon_region_template::icon_top>,
+	field<&icon_region_template::icon_left>,
+	field<&icon_region_template::icon_bottom>,
+	field<&icon_region_template::icon_right>>;
+
+using mixed_region_schema = schema<
+	field<&mixed_region_template::bg>,
+	field<&mixed_region_template::shared_color>,
+	field<&mixed_region_template::font_choice>,
+	field<&mixed_region_template::font_scale>,
+	field<&mixed_region_template::h_text_margins>,
+	field<&mixed_region_template::v_text_margins>,
+	field<&mixed_region_template::h_text_alignment>,
+	field<&mixed_region_template::v_text_alignment>,
+	field<&mixed_region_template::icon_top>,
+	field<&mixed_region_template::icon_left>,
+	field<&mixed_region_template::icon_bottom>,
+	field<&mixed_region_template::icon_right>>;
+
+using color_region_schema = schema<
+	field<&color_region::bg>,
+	field<&color_region::color>>;
+
+using toggle_region_schema = schema<
+	nested<&toggle_region::primary, color_region_schema>,
+	nested<&toggle_region::active, color_region_schema>,
+	nested<&toggle_region::disabled, color_region_schema>,
+	field<&toggle_region::font_choice>,
+	field<&toggle_region::font_scale>,
+	field<&toggle_region::h_text_alignment>,
+	field<&toggle_region::v_text_alignment>,
+	field<&toggle_region::text_margin_left>,
+	field<&toggle_region::text_margin_right>,
+	field<&toggle_region::text_margin_top>,
+	field<&toggle_region::text_margin_bottom>>;
+
+using label_schema = schema<
+	field<&label_template::display_name>,
+	nested<&label_template::primary, text_region_schema>>;
+
+using button_schema = schema<
+	field<&button_template::display_name>,
+	field<&button_template::animate_active_transition>,
+	nested<&button_template::primary, text_region_schema>,
+	nested<&button_template::active, text_region_schema>,
+	nested<&button_template::disabled, text_region_schema>>;
+
+using progress_bar_schema = schema<
+	field<&progress_bar_template::display_name>,
+	field<&progress_bar_template::bg_a>,
+	field<&progress_bar_template::bg_b>,
+	field<&progress_bar_template::text_color>,
+	field<&progress_bar_template::font_choice>,
+	field<&progress_bar_template::h_text_margins>,
+	field<&progress_bar_template::v_text_margins>,
+	field<&progress_bar_template::h_text_alignment>,
+	field<&progress_bar_template::v_text_alignment>,
+	field<&progress_bar_template::display_percentage_text>>;
+
+using window_schema = schema<
+	field<&window_template::display_name>,
+	field<&window_template::bg>,
+	field<&window_template::layout_region_definition>,
+	field<&window_template::close_button_definition>,
+	field<&window_template::close_button_icon>,
+	field<&window_template::h_close_button_margin>,
+	field<&window_template::v_close_button_margin>>;
+
+using iconic_button_schema = schema<
+	field<&iconic_button_template::display_name>,
+	field<&iconic_button_template::animate_active_transition>,
+	nested<&iconic_button_template::primary, icon_region_schema>,
+	nested<&iconic_button_template::active, icon_region_schema>,
+	nested<&iconic_button_template::disabled, icon_region_schema>>;
+
+using layout_region_schema = schema<
+	field<&layout_region_template::display_name>,
+	nested<&layout_region_template::page_number_text, text_region_schema>,
+	field<&layout_region_template::bg>,
+	field<&layout_region_template::left_button>,
+	field<&layout_region_template::left_button_icon>,
+	field<&layout_region_template::right_button>,
+	field<&layout_region_template::right_button_icon>>;
+
+using mixed_schema = schema<
+	field<&mixed_template::display_name>,
+	nested<&mixed_template::primary, mixed_region_schema>,
+	nested<&mixed_template::active, mixed_region_schema>,
+	nested<&mixed_template::disabled, mixed_region_schema>,
+	field<&mixed_template::animate_active_transition>>;
+
+using toggle_button_schema = schema<
+	field<&toggle_button_template::display_name>,
+	nested<&toggle_button_template::on_region, toggle_region_schema>,
+	nested<&toggle_button_template::off_region, toggle_region_schema>,
+	field<&toggle_button_template::animate_active_transition>>;
+
+using table_schema = schema<
+	field<&table_template::display_name>,
+	field<&table_template::arrow_increasing>,
+	field<&table_template::arrow_decreasing>,
+	field<&table_template::table_color>,
+	field<&table_template::interactable_header_bg>,
+	field<&table_template::active_header_bg>>;
+
+using stacked_bar_schema = schema<
+	field<&stacked_bar_template::display_name>,
+	field<&stacked_bar_template::overlay_bg>,
+	field<&stacked_bar_template::l_margin>,
+	field<&stacked_bar_template::t_margin>,
+	field<&stacked_bar_template::r_margin>,
+	field<&stacked_bar_template::b_margin>>;
+
+using drop_down_schema = schema<
+	field<&drop_down_template::display_name>,
+	field<&drop_down_template::primary_bg>,
+	field<&drop_down_template::active_bg>,
+	field<&drop_down_template::disabled_bg>,
+	field<&drop_down_template::list_button>,
+	field<&drop_down_template::list_button_alt>,
+	field<&drop_down_template::selection_icon>,
+	field<&drop_down_template::layout_region_base>,
+	field<&drop_down_template::dropdown_window_bg>,
+	field<&drop_down_template::dropdown_window_margin>,
+	field<&drop_down_template::animate_active_transition>>;
+
+template<typename record_schema, typename T>
+static void read_list(serialization::in_buffer& buffer, std::vector<T>& list) {
+	auto list_section = buffer.read_section();
+	while(list_section) {
+		list.emplace_back();
+		auto individual = list_section.read_section();
+		serialization::read_record<record_schema>(individual, list.back());
+	}
+}
+template<typename record_schema, typename T>
+static void write_list(serialization::out_buffer& buffer, std::vector<T> const& list) {
+	buffer.start_section();
+	for(auto& i : list) {
+		buffer.start_section();
+		serialization::write_record<record_schema>(buffer, i);
+		buffer.finish_section();
+	}
+	buffer.finish_section();
+}
+
 project bytes_to_project(serialization::in_buffer& buffer) {
 	project result;
 	auto header_section = buffer.read_section();
 	header_section.read(result.svg_directory);
 
-
-		auto colors_section = buffer.read_section();
-		while(colors_section) {
-			result.colors.emplace_back();
-			auto individual_color = colors_section.read_section();
-			individual_color.read(result.colors.back().display_name);
-			individual_color.read(result.colors.back().r);
-			individual_color.read(result.colors.back().g);
-			individual_color.read(result.colors.back().b);
-			individual_color.read(result.colors.back().a);
-		}
-
-		auto icons_section = buffer.read_section();
-		while(icons_section) {
-			result.icons.emplace_back();
-			auto indv_icon = icons_section.read_section();
-			indv_icon.read(result.icons.back().file_name);
-		}
-
-		auto bg_section = buffer.read_section();
-		while(bg_section) {
-			result.backgrounds.emplace_back();
-			auto indv_icon = bg_section.read_section();
-			indv_icon.read(result.backgrounds.back().file_name);
-			indv_icon.read(result.backgrounds.back().base_x);
-			indv_icon.read(result.backgrounds.back().base_y);
-		}
-
-		auto labels_section = buffer.read_section();
-		while(labels_section) {
-			result.label_t.emplace_back();
-			auto indv_label = labels_section.read_section();
-			indv_label.read(result.label_t.back().display_name);
-			indv_label.read(result.label_t.back().primary.bg);
-			indv_label.read(result.label_t.back().primary.text_color);
-			indv_label.read(result.label_t.back().primary.font_choice);
-			indv_label.read(result.label_t.back().primary.font_scale);
-			indv_label.read(result.label_t.back().primary.h_text_margins);
-			indv_label.read(result.label_t.back().primary.v_text_margins);
-			indv_label.read(result.label_t.back().primary.h_text_alignment);
-			indv_label.read(result.label_t.back().primary.v_text_alignment);
-		}
-
-		auto buttons_section = buffer.read_section();
-		while(buttons_section) {
-			result.button_t.emplace_back();
-			auto indv_button = buttons_section.read_section();
-			indv_button.read(result.button_t.back().display_name);
-			indv_button.read(result.button_t.back().animate_active_transition);
-			indv_button.read(result.button_t.back().primary.bg);
-			indv_button.read(result.button_t.back().primary.text_color);
-			indv_button.read(result.button_t.back().primary.font_choice);
-			indv_button.read(result.button_t.back().primary.font_scale);
-			indv_button.read(result.button_t.back().primary.h_text_margins);
-			indv_button.read(result.button_t.back().primary.v_text_margins);
-			indv_button.read(result.button_t.back().primary.h_text_alignment);
-			indv_button.read(result.button_t.back().primary.v_text_alignment);
-			indv_button.read(result.button_t.back().active.bg);
-			indv_button.read(result.button_t.back().active.text_color);
-			indv_button.read(result.button_t.back().active.font_choice);
-			indv_button.read(result.button_t.back().active.font_scale);
-			indv_button.read(result.button_t.back().active.h_text_margins);
-			indv_button.read(result.button_t.back().active.v_text_margins);
-			indv_button.read(result.button_t.back().active.h_text_alignment);
-			indv_button.read(result.button_t.back().active.v_text_alignment);
-			indv_button.read(result.button_t.back().disabled.bg);
-			indv_button.read(result.button_t.back().disabled.text_color);
-			indv_button.read(result.button_t.back().disabled.font_choice);
-			indv_button.read(result.button_t.back().disabled.font_scale);
-			indv_button.read(result.button_t.back().disabled.h_text_margins);
-			indv_button.read(result.button_t.back().disabled.v_text_margins);
-			indv_button.read(result.button_t.back().disabled.h_text_alignment);
-			indv_button.read(result.button_t.back().disabled.v_text_alignment);
-		}
-
-		auto pbs_section = buffer.read_section();
-		while(pbs_section) {
-			result.progress_bar_t.emplace_back();
-			auto indv_pb = pbs_section.read_section();
-			indv_pb.read(result.progress_bar_t.back().display_name);
-			indv_pb.read(result.progress_bar_t.back().bg_a);
-			indv_pb.read(result.progress_bar_t.back().bg_b);
-			indv_pb.read(result.progress_bar_t.back().text_color);
-			indv_pb.read(result.progress_bar_t.back().font_choice);
-			indv_pb.read(result.progress_bar_t.back().h_text_margins);
-			indv_pb.read(result.progress_bar_t.back().v_text_margins);
-			indv_pb.read(result.progress_bar_t.back().h_text_alignment);
-			indv_pb.read(result.progress_bar_t.back().v_text_alignment);
-			indv_pb.read(result.progress_bar_t.back().display_percentage_text);
-		}
-
-		auto windows_section = buffer.read_section();
-		while(windows_section) {
-			result.window_t.emplace_back();
-			auto indv_win = windows_section.read_section();
-			indv_win.read(result.window_t.back().display_name);
-			indv_win.read(result.window_t.back().bg);
-			indv_win.read(result.window_t.back().layout_region_definition);
-			indv_win.read(result.window_t.back().close_button_definition);
-			indv_win.read(result.window_t.back().close_button_icon);
-			indv_win.read(result.window_t.back().h_close_button_margin);
-			indv_win.read(result.window_t.back().v_close_button_margin);
-		}
-
-		auto ibuttons_section = buffer.read_section();
-		while(ibuttons_section) {
-			result.iconic_button_t.emplace_back();
-			auto indv_ibutton = ibuttons_section.read_section();
-			indv_ibutton.read(result.iconic_button_t.back().display_name);
-			indv_ibutton.read(result.iconic_button_t.back().animate_active_transition);
-			indv_ibutton.read(result.iconic_button_t.back().primary.bg);
-			indv_ibutton.read(result.iconic_button_t.back().primary.icon_color);
-			indv_ibutton.read(result.iconic_button_t.back().primary.icon_top);
-			indv_ibutton.read(result.iconic_button_t.back().primary.icon_left);
-			indv_ibutton.read(result.iconic_button_t.back().primary.icon_bottom);
-			indv_ibutton.read(result.iconic_button_t.back().primary.icon_right);
-			indv_ibutton.read(result.iconic_button_t.back().active.bg);
-			indv_ibutton.read(result.iconic_button_t.back().active.icon_color);
-			indv_ibutton.read(result.iconic_button_t.back().active.icon_top);
-			indv_ibutton.read(result.iconic_button_t.back().active.icon_left);
-			indv_ibutton.read(result.iconic_button_t.back().active.icon_bottom);
-			indv_ibutton.read(result.iconic_button_t.back().active.icon_right);
-			indv_ibutton.read(result.iconic_button_t.back().disabled.bg);
-			indv_ibutton.read(result.iconic_button_t.back().disabled.icon_color);
-			indv_ibutton.read(result.iconic_button_t.back().disabled.icon_top);
-			indv_ibutton.read(result.iconic_button_t.back().disabled.icon_left);
-			indv_ibutton.read(result.iconic_button_t.back().disabled.icon_bottom);
-			indv_ibutton.read(result.iconic_button_t.back().disabled.icon_right);
-		}
-
-		auto layout_regions_section = buffer.read_section();
-		while(layout_regions_section) {
-			result.layout_region_t.emplace_back();
-			auto indv_lr = layout_regions_section.read_section();
-			indv_lr.read(result.layout_region_t.back().display_name);
-			indv_lr.read(result.layout_region_t.back().page_number_text.bg);
-			indv_lr.read(result.layout_region_t.back().page_number_text.text_color);
-			indv_lr.read(result.layout_region_t.back().page_number_text.font_choice);
-			indv_lr.read(result.layout_region_t.back().page_number_text.font_scale);
-			indv_lr.read(result.layout_region_t.back().page_number_text.h_text_margins);
-			indv_lr.read(result.layout_region_t.back().page_number_text.v_text_margins);
-			indv_lr.read(result.layout_region_t.back().page_number_text.h_text_alignment);
-			indv_lr.read(result.layout_region_t.back().page_number_text.v_text_alignment);
-			indv_lr.read(result.layout_region_t.back().bg);
-			indv_lr.read(result.layout_region_t.back().left_button);
-			indv_lr.read(result.layout_region_t.back().left_button_icon);
-			indv_lr.read(result.layout_region_t.back().right_button);
-			indv_lr.read(result.layout_region_t.back().right_button_icon);
-		}
-
-		auto mb_section = buffer.read_section();
-		while(mb_section) {
-			result.mixed_button_t.emplace_back();
-			auto indv_mb = mb_section.read_section();
-			auto& i = result.mixed_button_t.back();
-
-			indv_mb.read(i.display_name);
-
-			indv_mb.read(i.primary.bg);
-			indv_mb.read(i.primary.shared_color);
-			indv_mb.read(i.primary.font_choice);
-			indv_mb.read(i.primary.font_scale);
-			indv_mb.read(i.primary.h_text_margins);
-			indv_mb.read(i.primary.v_text_margins);
-			indv_mb.read(i.primary.h_text_alignment);
-			indv_mb.read(i.primary.v_text_alignment);
-			indv_mb.read(i.primary.icon_top);
-			indv_mb.read(i.primary.icon_left);
-			indv_mb.read(i.primary.icon_bottom);
-			indv_mb.read(i.primary.icon_right);
-
-			indv_mb.read(i.active.bg);
-			indv_mb.read(i.active.shared_color);
-			indv_mb.read(i.active.font_choice);
-			indv_mb.read(i.active.font_scale);
-			indv_mb.read(i.active.h_text_margins);
-			indv_mb.read(i.active.v_text_margins);
-			indv_mb.read(i.active.h_text_alignment);
-			indv_mb.read(i.active.v_text_alignment);
-			indv_mb.read(i.active.icon_top);
-			indv_mb.read(i.active.icon_left);
-			indv_mb.read(i.active.icon_bottom);
-			indv_mb.read(i.active.icon_right);
-
-			indv_mb.read(i.disabled.bg);
-			indv_mb.read(i.disabled.shared_color);
-			indv_mb.read(i.disabled.font_choice);
-			indv_mb.read(i.disabled.font_scale);
-			indv_mb.read(i.disabled.h_text_margins);
-			indv_mb.read(i.disabled.v_text_margins);
-			indv_mb.read(i.disabled.h_text_alignment);
-			indv_mb.read(i.disabled.v_text_alignment);
-			indv_mb.read(i.disabled.icon_top);
-			indv_mb.read(i.disabled.icon_left);
-			indv_mb.read(i.disabled.icon_bottom);
-			indv_mb.read(i.disabled.icon_right);
-
-			indv_mb.read(i.animate_active_transition);
-		}
-	
-		auto tb_section = buffer.read_section();
-		while(tb_section) {
-			result.toggle_button_t.emplace_back();
-			auto indv_tb = tb_section.read_section();
-			auto& i = result.toggle_button_t.back();
-
-			indv_tb.read(i.display_name);
-			indv_tb.read(i.on_region.primary.bg);
-			indv_tb.read(i.on_region.primary.color);
-			indv_tb.read(i.on_region.active.bg);
-			indv_tb.read(i.on_region.active.color);
-			indv_tb.read(i.on_region.disabled.bg);
-			indv_tb.read(i.on_region.disabled.color);
-			indv_tb.read(i.on_region.font_choice);
-			indv_tb.read(i.on_region.font_scale);
-			indv_tb.read(i.on_region.h_text_alignment);
-			indv_tb.read(i.on_region.v_text_alignment);
-			indv_tb.read(i.on_region.text_margin_left);
-			indv_tb.read(i.on_region.text_margin_right);
-			indv_tb.read(i.on_region.text_margin_top);
-			indv_tb.read(i.on_region.text_margin_bottom);
-
-			indv_tb.read(i.off_region.primary.bg);
-			indv_tb.read(i.off_region.primary.color);
-			indv_tb.read(i.off_region.active.bg);
-			indv_tb.read(i.off_region.active.color);
-			indv_tb.read(i.off_region.disabled.bg);
-			indv_tb.read(i.off_region.disabled.color);
-			indv_tb.read(i.off_region.font_choice);
-			indv_tb.read(i.off_region.font_scale);
-			indv_tb.read(i.off_region.h_text_alignment);
-			indv_tb.read(i.off_region.v_text_alignment);
-			indv_tb.read(i.off_region.text_margin_left);
-			indv_tb.read(i.off_region.text_margin_right);
-			indv_tb.read(i.off_region.text_margin_top);
-			indv_tb.read(i.off_region.text_margin_bottom);
-
-			indv_tb.read(i.animate_active_transition);
-		}
-
-
-		auto tables_section = buffer.read_section();
-		while(tables_section) {
-			result.table_t.emplace_back();
-			auto indv_tb = tables_section.read_section();
-			auto& i = result.table_t.back();
-
-			indv_tb.read(i.display_name);
-			indv_tb.read(i.arrow_increasing);
-			indv_tb.read(i.arrow_decreasing);
-			indv_tb.read(i.table_color);
-			indv_tb.read(i.interactable_header_bg);
-			indv_tb.read(i.active_header_bg);
-		}
-
-		auto stacked_bar_section = buffer.read_section();
-		while(stacked_bar_section) {
-			result.stacked_bar_t.emplace_back();
-			auto indv_tb = stacked_bar_section.read_section();
-			auto& i = result.stacked_bar_t.back();
-
-			indv_tb.read(i.display_name);
-			indv_tb.read(i.overlay_bg);
-			indv_tb.read(i.l_margin);
-			indv_tb.read(i.t_margin);
-			indv_tb.read(i.r_margin);
-			indv_tb.read(i.b_margin);
-		}
-
-		auto drop_down_section = buffer.read_section();
-		while(drop_down_section) {
-			result.drop_down_t.emplace_back();
-			auto indv_tb = drop_down_section.read_section();
-			auto& i = result.drop_down_t.back();
-
-			indv_tb.read(i.display_name);
-			indv_tb.read(i.primary_bg);
-			indv_tb.read(i.active_bg);
-			indv_tb.read(i.disabled_bg);
-
-			indv_tb.read(i.list_button);
-			indv_tb.read(i.list_button_alt);
-			indv_tb.read(i.selection_icon);
-			indv_tb.read(i.layout_region_base);
-
-			indv_tb.read(i.dropdown_window_bg);
-			indv_tb.read(i.dropdown_window_margin);
-
-			indv_tb.read(i.animate_active_transition);
-		}
+	read_list<color_schema>(buffer, result.colors);
+	read_list<icon_schema>(buffer, result.icons);
+	read_list<background_schema>(buffer, result.backgrounds);
+	read_list<label_schema>(buffer, result.label_t);
+	read_list<button_schema>(buffer, result.button_t);
+	read_list<progress_bar_schema>(buffer, result.progress_bar_t);
+	read_list<window_schema>(buffer, result.window_t);
+	read_list<iconic_button_schema>(buffer, result.iconic_button_t);
+	read_list<layout_region_schema>(buffer, result.layout_region_t);
+	read_list<mixed_schema>(buffer, result.mixed_button_t);
+	read_list<toggle_button_schema>(buffer, result.toggle_button_t);
+	read_list<table_schema>(buffer, result.table_t);
+	read_list<stacked_bar_schema>(buffer, result.stacked_bar_t);
+	read_list<drop_down_schema>(buffer, result.drop_down_t);
 	return result;
 }
 
+void project_to_bytes(project const& p, serialization::out_buffer& buffer) {
+	buffer.start_section();
+	buffer.write(p.svg_directory);
+	buffer.finish_section();
+
+	write_list<color_schema>(buffer, p.colors);
+	write_list<icon_schema>(buffer, p.icons);
+	write_list<background_schema>(buffer, p.backgrounds);
+	write_list<label_schema>(buffer, p.label_t);
+	write_list<button_schema>(buffer, p.button_t);
+	write_list<progress_bar_schema>(buffer, p.progress_bar_t);
+	write_list<window_schema>(buffer, p.window_t);
+	write_list<iconic_button_schema>(buffer, p.iconic_button_t);
+	write_list<layout_region_schema>(buffer, p.layout_region_t);
+	write_list<mixed_schema>(buffer, p.mixed_button_t);
+	write_list<toggle_button_schema>(buffer, p.toggle_button_t);
+	write_list<table_schema>(buffer, p.table_t);
+	write_list<stacked_bar_schema>(buffer, p.stacked_bar_t);
+	write_list<drop_down_schema>(buffer, p.drop_down_t);
 }
 
+}
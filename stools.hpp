@@ -1,6 +1,10 @@
 #pragma once
 #include <vector>
-#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
 #include <stdint.h>
 #include <string>
@@ -13,31 +17,125 @@
 namespace serialization {
 
 
+class out_buffer;
+
+/*
+a relocation is written once the rest of the buffer is finished; the callable that writes it is kept in place when it
+can be copied as plain bytes and fits in a few pointers (most of them capture a pointer or two), and goes to the heap
+otherwise, so that moving a writer, as pending_writes grows, is always just a copy of its bytes
+*/
+class relocation_writer {
+private:
+	static constexpr size_t inline_size = 3 * sizeof(void*);
+	alignas(void*) unsigned char storage[inline_size]; // the callable, or a pointer to it
+	void (*invoke_fn)(unsigned char*, out_buffer&) = nullptr; // null once moved from
+	void (*destroy_fn)(unsigned char*) = nullptr; // null when there is nothing to destroy
+public:
+	template<typename F> requires (!std::is_same_v<std::decay_t<F>, relocation_writer>)
+	relocation_writer(F&& f) {
+		using stored = std::decay_t<F>;
+		if constexpr(sizeof(stored) <= inline_size && alignof(stored) <= alignof(void*) && std::is_trivially_copyable_v<stored>) {
+			new (storage) stored(std::forward<F>(f));
+			invoke_fn = [](unsigned char* s, out_buffer& b) { (*std::launder(reinterpret_cast<stored*>(s)))(b); };
+		} else {
+			stored* target = new stored(std::forward<F>(f));
+			std::memcpy(storage, &target, sizeof(target));
+			invoke_fn = [](unsigned char* s, out_buffer& b) {
+				stored* t = nullptr;
+				std::memcpy(&t, s, sizeof(t));
+				(*t)(b);
+			};
+			destroy_fn = [](unsigned char* s) {
+				stored* t = nullptr;
+				std::memcpy(&t, s, sizeof(t));
+				delete t;
+			};
+		}
+	}
+	relocation_writer(relocation_writer&& other) noexcept : invoke_fn(other.invoke_fn), destroy_fn(other.destroy_fn) {
+		std::memcpy(storage, other.storage, inline_size);
+		other.invoke_fn = nullptr;
+	}
+	relocation_writer(relocation_writer const&) = delete;
+	relocation_writer& operator=(relocation_writer const&) = delete;
+	relocation_writer& operator=(relocation_writer&&) = delete;
+	~relocation_writer() {
+		if(invoke_fn && destroy_fn)
+			destroy_fn(storage);
+	}
+	void operator()(out_buffer& b) {
+		invoke_fn(storage, b);
+	}
+};
+
+struct counting_pass_t { };
+inline constexpr counting_pass_t counting_pass{ };
+
 class out_buffer {
 private:
-	std::vector<char> data_;
-	std::vector<std::pair<size_t, std::function<void(out_buffer&)>>> pending_writes;
+	std::unique_ptr<char[]> data_;
+	size_t size_ = 0;
+	size_t capacity_ = 0;
+	std::vector<std::pair<size_t, relocation_writer>> pending_writes;
 	std::vector<size_t> open_sections;
+
+	// in a counting pass the bytes are written to a small scratch area that is recycled whenever it fills up,
+	// and only their total is kept; section sizes and relocation addresses are not filled in
+	bool counting = false;
+	size_t counted = 0;
+
+	void make_room(size_t additional) {
+		if(counting) {
+			counted += size_;
+			size_ = 0;
+			if(additional <= capacity_)
+				return;
+		}
+		auto new_capacity = std::max(std::max(capacity_ * 2, size_ + additional), size_t(256));
+		auto new_data = std::unique_ptr<char[]>(new char[new_capacity]);
+		if(size_ > 0)
+			std::memcpy(new_data.get(), data_.get(), size_);
+		data_ = std::move(new_data);
+		capacity_ = new_capacity;
+	}
+	char* append(size_t count) {
+		if(size_ + count > capacity_) [[unlikely]]
+			make_room(count);
+		auto start = data_.get() + size_;
+		size_ += count;
+		return start;
+	}
 public:
+	out_buffer() { }
+	out_buffer(counting_pass_t) : counting(true) { }
+
 	char const* data() const {
-		return data_.data();
+		return data_.get();
 	}
 	size_t size() const {
-		return data_.size();
+		return counting ? counted + size_ : size_;
+	}
+	bool is_counting_pass() const {
+		return counting;
+	}
+	void reserve(size_t total) {
+		if(total > capacity_ && !counting)
+			make_room(total - size_);
 	}
 	void finish_pending() {
 		while(!pending_writes.empty()) {
-			auto relocation_address = data_.data() + pending_writes.back().first;
-			uint32_t new_address = uint32_t(data_.size());
-			std::memcpy(relocation_address, &new_address, sizeof(uint32_t));
-
-			pending_writes.back().second(*this);
+			auto relocation_address = pending_writes.back().first;
+			uint32_t new_address = uint32_t(size());
+			if(!counting)
+				std::memcpy(data_.get() + relocation_address, &new_address, sizeof(uint32_t));
 
+			auto writer = std::move(pending_writes.back().second);
 			pending_writes.pop_back();
+			writer(*this);
 		}
 	}
 	void start_section() {
-		auto sz_address = data_.size();
+		auto sz_address = size_;
 		uint32_t placeholder = 0;
 		write(placeholder);
 		open_sections.emplace_back(sz_address);
@@ -45,9 +143,11 @@ public:
 	void finish_section() {
 		assert(!open_sections.empty());
 
-		auto size_address = data_.data() + open_sections.back();
-		uint32_t bytes_in_section = uint32_t(data_.size() - open_sections.back());
-		std::memcpy(size_address, &bytes_in_section, sizeof(uint32_t));
+		if(!counting) {
+			auto size_address = data_.get() + open_sections.back();
+			uint32_t bytes_in_section = uint32_t(size_ - open_sections.back());
+			std::memcpy(size_address, &bytes_in_section, sizeof(uint32_t));
+		}
 
 		open_sections.pop_back();
 	}
@@ -60,15 +160,14 @@ public:
 
 	template<typename T>
 	void write(T const& d) {
-		auto start_size = data_.size();
-		data_.resize(start_size + sizeof(T), 0);
-		std::memcpy(data_.data() + start_size, &d, sizeof(T));
+		static_assert(std::is_trivially_copyable_v<T>);
+		std::memcpy(append(sizeof(T)), &d, sizeof(T));
 	}
 	template<typename T>
 	void write_fixed(T const* d, size_t count) {
-		auto start_size = data_.size();
-		data_.resize(start_size + sizeof(T) * count, 0);
-		std::memcpy(data_.data() + start_size, d, sizeof(T) * count);
+		static_assert(std::is_trivially_copyable_v<T>);
+		if(count > 0)
+			std::memcpy(append(sizeof(T) * count), d, sizeof(T) * count);
 	}
 	template<typename T>
 	void write_variable(T const* d, size_t count) {
@@ -76,17 +175,19 @@ public:
 		write(c);
 		write_fixed(d, count);
 	}
-	void write_relocation(std::function<void(out_buffer&)>&& f) {
-		auto reloc_address = data_.size();
+	template<typename F>
+	void write_relocation(F&& f) {
+		auto reloc_address = size_;
 		uint32_t placeholder = 0;
 		write(placeholder);
-		pending_writes.emplace_back(reloc_address, std::move(f));
+		pending_writes.emplace_back(reloc_address, relocation_writer(std::forward<F>(f)));
 	}
-	void write_relocation(size_t reloc_address, std::function<void(out_buffer&)>&& f) {
-		pending_writes.emplace_back(reloc_address, std::move(f));
+	template<typename F>
+	void write_relocation(size_t reloc_address, F&& f) {
+		pending_writes.emplace_back(reloc_address, relocation_writer(std::forward<F>(f)));
 	}
 	size_t get_data_position() const {
-		return data_.size();
+		return size();
 	}
 	void write(std::string_view sv) {
 		write_variable(sv.data(), sv.length());
@@ -145,6 +246,14 @@ public:
 		auto count = read<uint32_t>();
 		return read_fixed<T>(size_t(count));
 	}
+	// copies count bytes out only if they are all there
+	bool read_bytes(void* out, size_t count) {
+		if(read_position + count > size)
+			return false;
+		std::memcpy(out, data + read_position, count);
+		read_position += count;
+		return true;
+	}
 	in_buffer read_relocation() {
 		uint32_t offset = read<uint32_t>();
 		return in_buffer(data, size, offset);
@@ -175,4 +284,126 @@ public:
 	}
 };
 
+/*
+records that are always laid out the same way are described by a schema listing their fields in file order, and are read
+and written by read_record and write_record; each field is stored exactly as read and write above store it, so a schema
+can replace a hand written sequence of reads without changing the file
+fields that are stored as their raw bytes and also sit back to back in memory are copied as one run
+*/
+
+template<auto member>
+struct field { };
+template<auto member, typename record_schema>
+struct nested { };
+template<typename... fields>
+struct schema { };
+
+namespace detail {
+
+template<typename M>
+struct member_traits;
+template<typename C, typename F>
+struct member_traits<F C::*> {
+	using type = F;
+};
+
+struct record_field {
+	size_t offset = 0;
+	size_t size = 0; // 0 if it is not stored as its raw bytes
+	void (*read)(in_buffer&, void*) = nullptr;
+	void (*write)(out_buffer&, void const*) = nullptr;
+};
+struct record_run {
+	size_t offset = 0;
+	size_t size = 0; // 0 for a single field that is not stored as its raw bytes
+	uint32_t first = 0;
+	uint32_t count = 0;
+};
+struct record_plan {
+	std::vector<record_field> fields;
+	std::vector<record_run> runs;
+};
+
+template<typename F>
+void read_field(in_buffer& b, void* target) {
+	b.read(*static_cast<F*>(target));
+}
+template<typename F>
+void write_field(out_buffer& b, void const* source) {
+	b.write(*static_cast<F const*>(source));
+}
+
+template<typename T, typename M>
+size_t offset_in(T const& probe, M const& member) {
+	return size_t(reinterpret_cast<char const*>(&member) - reinterpret_cast<char const*>(&probe));
+}
+
+template<typename T, typename... F>
+void add_fields(record_plan& plan, T const& probe, size_t base, schema<F...>*);
+
+template<typename T, auto member>
+void add_field(record_plan& plan, T const& probe, size_t base, field<member>*) {
+	using F = typename member_traits<decltype(member)>::type;
+	constexpr bool raw = !std::is_same_v<F, std::string> && !std::is_same_v<F, std::wstring>;
+	static_assert(!raw || std::is_trivially_copyable_v<F>);
+	plan.fields.push_back(record_field{ base + offset_in(probe, probe.*member), raw ? sizeof(F) : 0, &read_field<F>, &write_field<F> });
+}
+template<typename T, auto member, typename record_schema>
+void add_field(record_plan& plan, T const& probe, size_t base, nested<member, record_schema>*) {
+	add_fields(plan, probe.*member, base + offset_in(probe, probe.*member), (record_schema*)nullptr);
+}
+template<typename T, typename... F>
+void add_fields(record_plan& plan, T const& probe, size_t base, schema<F...>*) {
+	(add_field(plan, probe, base, (F*)nullptr), ...);
+}
+
+// worked out once per schema, from a default constructed record
+template<typename record_schema, typename T>
+record_plan const& plan_for() {
+	static record_plan const plan = []() {
+		record_plan p;
+		T probe{ };
+		add_fields(p, probe, 0, (record_schema*)nullptr);
+		for(uint32_t i = 0; i < uint32_t(p.fields.size()); ++i) {
+			auto& f = p.fields[i];
+			if(f.size != 0 && !p.runs.empty() && p.runs.back().size != 0 && p.runs.back().offset + p.runs.back().size == f.offset) {
+				p.runs.back().size += f.size;
+				++p.runs.back().count;
+			} else {
+				p.runs.push_back(record_run{ f.offset, f.size, i, 1 });
+			}
+		}
+		return p;
+	}();
+	return plan;
+}
+
+}
+
+template<typename record_schema, typename T>
+void read_record(in_buffer& buffer, T& record) {
+	auto& plan = detail::plan_for<record_schema, T>();
+	auto base = reinterpret_cast<char*>(&record);
+	for(auto& r : plan.runs) {
+		if(r.size != 0 && buffer.read_bytes(base + r.offset, r.size))
+			continue;
+		// near the end of the data each field is read on its own, so whatever does not fit is reset just like read does
+		for(uint32_t i = r.first; i < r.first + r.count; ++i) {
+			plan.fields[i].read(buffer, base + plan.fields[i].offset);
+		}
+	}
+}
+template<typename record_schema, typename T>
+void write_record(out_buffer& buffer, T const& record) {
+	auto& plan = detail::plan_for<record_schema, T>();
+	auto base = reinterpret_cast<char const*>(&record);
+	for(auto& r : plan.runs) {
+		if(r.size != 0) {
+			buffer.write_fixed(base + r.offset, r.size);
+		} else {
+			plan.fields[r.first].write(buffer, base + plan.fields[r.first].offset);
+		}
+	}
+}
+
 }
@@ -17,6 +17,9 @@ struct background_definition {
 
 	int32_t base_x = 1000;
 	int32_t base_y = 1000;
+	// when not 0, the width in grid cells of the corners and edges: the background is rendered once with one cell between them,
+	// and that cell is repeated to fill elements of any size instead of rendering the background at the size of each element
+	int32_t nine_slice_border = 0;
 
 	// not to save -- rendering info
 	asvg::svg renders;
@@ -249,4 +252,12 @@ struct project {
 	std::vector<color_definition> colors;
 };
 
+inline bool any_nine_slice_background(project const& p) {
+	for(auto& b : p.backgrounds) {
+		if(b.nine_slice_border > 0)
+			return true;
+	}
+	return false;
+}
+
 }
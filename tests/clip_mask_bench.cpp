@@ -0,0 +1,50 @@
+#include "lunasvg.h"
+#include "plutovg.h"
+#include "test_support.hpp"
+#include <fstream>
+#include <sstream>
+
+/*
+renders clip_mask_bench.svg, forty groups drawn through every kind of clip path and mask, at several sizes
+each size is timed rendering twenty times in a row, as a sheet of icons does, both keeping the layers' memory pooled
+across the renders and giving it back after each one, as asvg does
+run from the repository's root, or pass the path of the svg
+*/
+
+int main(int argc, char** argv) {
+	char const* path = argc > 1 ? argv[1] : "tests/clip_mask_bench.svg";
+	std::ifstream file(path, std::ios::binary);
+	std::stringstream contents;
+	contents << file.rdbuf();
+	auto data = contents.str();
+	auto doc = lunasvg::Document::loadFromData(data.data(), data.size(), [](std::string_view) { return lunasvg::Bitmap{ }; });
+	if(!doc) {
+		std::printf("could not read %s\n", path);
+		return 1;
+	}
+
+	std::printf("%6s %14s %14s\n", "size", "pooled ms", "trimmed ms");
+	double pooled_total = 0.0;
+	double trimmed_total = 0.0;
+	for(int32_t size : { 512, 400, 256, 128, 333 }) {
+		lunasvg::Bitmap bmp(size, size);
+		auto pooled = testing::time_ms(3, [&]() {
+			for(int32_t i = 0; i < 20; ++i) {
+				bmp.clear(0);
+				doc->render(bmp, lunasvg::Matrix{ }.scale(float(size) / 100.0f, float(size) / 100.0f));
+			}
+		});
+		auto trimmed = testing::time_ms(3, [&]() {
+			for(int32_t i = 0; i < 20; ++i) {
+				bmp.clear(0);
+				doc->render(bmp, lunasvg::Matrix{ }.scale(float(size) / 100.0f, float(size) / 100.0f));
+				plutovg_surface_pool_trim();
+			}
+		});
+		std::printf("%6d %14.2f %14.2f\n", int(size), pooled, trimmed);
+		pooled_total += pooled;
+		trimmed_total += trimmed;
+	}
+	std::printf("%6s %14.2f %14.2f\n", "total", pooled_total, trimmed_total);
+	return 0;
+}
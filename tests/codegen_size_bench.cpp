@@ -0,0 +1,340 @@
+#include "code_generator.hpp"
+#include "test_support.hpp"
+#include <fstream>
+#include <cstdlib>
+#include <cctype>
+
+/*
+what drawing plain controls through the shared render_background and render_text saves in the generated code, against
+the copy of the drawing code each control had before, and against the per-control CRTP base that was the alternative
+the render functions of a window of plain controls (every background the shared functions draw, with and without text,
+alternate backgrounds, disabling, clicks and rtl) are compiled each way, and the compile time, the size of the object
+file and the number of instructions in it are compared; the object file also holds each control's vtable and symbols,
+which the instruction count leaves out
+the shared version is cut out of what the generator emits; the other two are written here, the copies as the generator
+wrote them before, and the CRTP base as a template over the control type and a constexpr descriptor of it, which is
+what a shared header of base classes would hold
+the game's runtime is replaced by tests/generated_code_stub.hpp, so only the controls' own code is measured
+run from the repository's root, after ninja benchmarks; the first argument, if any, is the compiler to use instead of
+clang++
+*/
+
+enum class plain_background {
+	texture, bordered, repeated_border, repeated_corner, progress_bar
+};
+
+struct plain_control {
+	std::string name;
+	plain_background background = plain_background::texture;
+	bool text = false;
+	bool alternate = false;
+	bool can_disable = false;
+	bool interactable = false;
+	bool ignore_rtl = false;
+};
+
+constexpr int32_t control_count = 600;
+constexpr int32_t grid_size = 9;
+
+static std::vector<plain_control> make_controls() {
+	std::vector<plain_control> result;
+	for(int32_t i = 0; i < control_count; ++i) {
+		plain_control c;
+		c.name = "c" + std::to_string(i);
+		c.background = plain_background(i % 5);
+		c.text = i % 3 != 0;
+		c.alternate = i % 4 == 0 && (c.background == plain_background::texture || c.background == plain_background::bordered);
+		c.can_disable = i % 6 == 0;
+		c.interactable = i % 2 == 0;
+		c.ignore_rtl = i % 7 == 0;
+		result.push_back(c);
+	}
+	return result;
+}
+
+static background_type to_background_type(plain_background b) {
+	switch(b) {
+		case plain_background::texture: return background_type::texture;
+		case plain_background::bordered: return background_type::bordered_texture;
+		case plain_background::repeated_border: return background_type::border_texture_repeat;
+		case plain_background::repeated_corner: return background_type::textured_corners;
+		case plain_background::progress_bar: return background_type::progress_bar;
+	}
+	return background_type::texture;
+}
+
+static char const* background_name(plain_background b) {
+	switch(b) {
+		case plain_background::texture: return "texture";
+		case plain_background::bordered: return "bordered";
+		case plain_background::repeated_border: return "repeated_border";
+		case plain_background::repeated_corner: return "repeated_corner";
+		case plain_background::progress_bar: return "progress_bar";
+	}
+	return "texture";
+}
+
+static std::string class_name(plain_control const& c) {
+	return "bench_main_" + c.name + "_t";
+}
+
+// the members the generator declares for a plain control, which its render uses
+static std::string members(plain_control const& c) {
+	std::string result;
+	result += "\t" "std::string_view texture_key;\n";
+	result += "\t" "dcon::texture_id background_texture;\n";
+	if(c.alternate || c.background == plain_background::progress_bar) {
+		result += "\t" "std::string_view alt_texture_key;\n";
+		result += "\t" "dcon::texture_id alt_background_texture;\n";
+	}
+	if(c.alternate)
+		result += "\t" "bool is_active = false;\n";
+	if(c.background == plain_background::progress_bar)
+		result += "\t" "float progress = 0.0f;\n";
+	if(c.background == plain_background::bordered)
+		result += "\t" "int16_t border_size = 0;\n";
+	if(c.can_disable)
+		result += "\t" "bool disabled = false;\n";
+	if(c.text) {
+		result += "\t" "text::layout internal_layout;\n";
+		result += "\t" "text::text_color text_color = text::text_color::black;\n";
+		result += "\t" "float text_scale = 1.0f;\n";
+		result += "\t" "bool text_is_header = false;\n";
+	}
+	return result;
+}
+
+// the generated code for a project holding one window of the controls; the shared version is cut out of it
+static std::string generated_code(std::vector<plain_control> const& controls) {
+	open_project_t project;
+	project.project_name = L"bench";
+	project.grid_size = grid_size;
+	window_element_wrapper_t win;
+	win.wrapped.name = "main";
+	win.wrapped.x_size = 400;
+	win.wrapped.y_size = 300;
+	for(auto& c : controls) {
+		ui_element_t e;
+		e.name = c.name;
+		e.background = to_background_type(c.background);
+		e.texture = "background.dds";
+		e.alternate_bg = c.alternate ? "active.dds" : "";
+		e.text_key = c.text ? "text_" + c.name : "";
+		e.has_alternate_bg = c.alternate;
+		e.can_disable = c.can_disable;
+		e.left_click_action = c.interactable;
+		e.ignore_rtl = c.ignore_rtl;
+		win.children.push_back(std::move(e));
+	}
+	project.windows.push_back(std::move(win));
+	generator::code_snippets no_old_code;
+	return generator::generate_project_code(project, no_old_code);
+}
+
+static std::string cut(std::string const& code, std::string_view from, std::string_view to) {
+	auto start = code.find(from);
+	if(start == std::string::npos)
+		return std::string();
+	auto end = code.find(to, start);
+	if(end == std::string::npos)
+		return std::string();
+	return code.substr(start, end - start);
+}
+
+static std::string shared_version(std::vector<plain_control> const& controls, std::string const& code) {
+	auto helpers = cut(code, "enum class bench_background", "void bench_render_template_background");
+	if(helpers.empty())
+		return std::string();
+	std::string result = "#include \"generated_code_stub.hpp\"\n";
+	for(auto& c : controls)
+		result += "struct " + class_name(c) + " : public ui::element_base {\n" + members(c) + "\t" "void render(sys::state& state, int32_t x, int32_t y) noexcept override;\n};\n";
+	result += helpers;
+	for(auto& c : controls) {
+		auto render = cut(code, "void " + class_name(c) + "::render(", "\n}\n");
+		if(render.empty())
+			return std::string();
+		result += render + "\n}\n";
+	}
+	return result;
+}
+
+// what the generator wrote for each control before the shared functions
+static std::string copied_version(std::vector<plain_control> const& controls) {
+	std::string result = "#include \"generated_code_stub.hpp\"\n";
+	for(auto& c : controls)
+		result += "struct " + class_name(c) + " : public ui::element_base {\n" + members(c) + "\t" "void render(sys::state& state, int32_t x, int32_t y) noexcept override;\n};\n";
+	for(auto& c : controls) {
+		std::string cmod = "ui::get_color_modification(this == state.ui_state.under_mouse, " + std::string(c.can_disable ? "disabled" : "false") + ", " + std::string(c.interactable ? "true" : "false") + ")";
+		std::string rtl = c.ignore_rtl ? "false" : "state_is_rtl(state)";
+		std::string rect = "float(x), float(y), float(base_data.size.x), float(base_data.size.y), ";
+		std::string main_texture = "ogl::get_late_load_texture_handle(state, background_texture, texture_key)";
+		std::string alt_texture = "ogl::get_late_load_texture_handle(state, alt_background_texture, alt_texture_key)";
+		std::string tail = ", base_data.get_rotation(), false, " + rtl + ");\n";
+		auto either = [&](std::string const& call) {
+			if(c.alternate)
+				return "\t" "if(is_active)\n" "\t" "\t" + call + alt_texture + tail + "\t" "else\n" "\t" "\t" + call + main_texture + tail;
+			return "\t" + call + main_texture + tail;
+		};
+		result += "void " + class_name(c) + "::render(sys::state & state, int32_t x, int32_t y) noexcept {\n";
+		switch(c.background) {
+			case plain_background::texture:
+				result += either("ogl::render_textured_rect(state, " + cmod + ", " + rect);
+				break;
+			case plain_background::bordered:
+				result += either("ogl::render_bordered_rect(state, " + cmod + ", float(border_size), " + rect);
+				break;
+			case plain_background::repeated_border:
+				result += "\t" "ogl::render_rect_with_repeated_border(state, " + cmod + ", float(" + std::to_string(grid_size) + "), " + rect + main_texture + tail;
+				break;
+			case plain_background::repeated_corner:
+				result += "\t" "ogl::render_rect_with_repeated_corner(state, " + cmod + ", float(" + std::to_string(grid_size) + "), " + rect + main_texture + tail;
+				break;
+			case plain_background::progress_bar:
+				result += "\t" "ogl::render_progress_bar(state, " + cmod + ", progress, " + rect + alt_texture + ", " + main_texture + tail;
+				break;
+		}
+		if(c.text) {
+			result += "\t" "if(internal_layout.contents.empty()) return;\n";
+			result += "\t" "auto fh = text::make_font_id(state, text_is_header, text_scale * " + std::to_string(grid_size * 2) + ");\n";
+			result += "\t" "auto linesz = state.font_collection.line_height(state, fh); \n";
+			result += "\t" "if(linesz == 0.0f) return;\n";
+			result += "\t" "auto ycentered = (base_data.size.y - linesz) / 2;\n";
+			result += "\t" "auto cmod = " + cmod + "; \n";
+			result += "\t" "for(auto& t : internal_layout.contents) {\n";
+			result += "\t" "\t" "ui::render_text_chunk(state, t, float(x) + t.x, float(y + int32_t(ycentered)),  fh, ui::get_text_color(state, text_color), cmod);\n";
+			result += "\t" "}\n";
+		}
+		result += "}\n";
+	}
+	return result;
+}
+
+// the alternative: one base template, in a shared header, that each control derives from with its descriptor
+static std::string crtp_version(std::vector<plain_control> const& controls) {
+	std::string result = "#include \"generated_code_stub.hpp\"\n";
+	result += "enum class bench_background : uint8_t { texture, bordered, repeated_border, repeated_corner, progress_bar };\n";
+	result += "struct bench_control_descriptor {\n";
+	result += "\t" "bench_background background = bench_background::texture;\n";
+	result += "\t" "bool text = false;\n";
+	result += "\t" "bool alternate = false;\n";
+	result += "\t" "bool can_disable = false;\n";
+	result += "\t" "bool interactable = false;\n";
+	result += "\t" "bool ignore_rtl = false;\n";
+	result += "};\n";
+	result += "template<typename T, bench_control_descriptor d>\n";
+	result += "class bench_plain_control : public ui::element_base {\n";
+	result += "public:\n";
+	result += "\t" "void render(sys::state& state, int32_t x, int32_t y) noexcept override {\n";
+	result += "\t" "\t" "auto& self = static_cast<T&>(*this);\n";
+	result += "\t" "\t" "bool disabled = false;\n";
+	result += "\t" "\t" "if constexpr(d.can_disable)\n";
+	result += "\t" "\t" "\t" "disabled = self.disabled;\n";
+	result += "\t" "\t" "auto cmod = ui::get_color_modification(this == state.ui_state.under_mouse, disabled, d.interactable);\n";
+	result += "\t" "\t" "auto rtl = d.ignore_rtl ? false : state_is_rtl(state);\n";
+	result += "\t" "\t" "auto texture = [&]() {\n";
+	result += "\t" "\t" "\t" "if constexpr(d.alternate) {\n";
+	result += "\t" "\t" "\t" "\t" "if(self.is_active)\n";
+	result += "\t" "\t" "\t" "\t" "\t" "return ogl::get_late_load_texture_handle(state, self.alt_background_texture, self.alt_texture_key);\n";
+	result += "\t" "\t" "\t" "}\n";
+	result += "\t" "\t" "\t" "return ogl::get_late_load_texture_handle(state, self.background_texture, self.texture_key);\n";
+	result += "\t" "\t" "};\n";
+	result += "\t" "\t" "if constexpr(d.background == bench_background::texture) {\n";
+	result += "\t" "\t" "\t" "ogl::render_textured_rect(state, cmod, float(x), float(y), float(base_data.size.x), float(base_data.size.y), texture(), base_data.get_rotation(), false, rtl);\n";
+	result += "\t" "\t" "} else if constexpr(d.background == bench_background::bordered) {\n";
+	result += "\t" "\t" "\t" "ogl::render_bordered_rect(state, cmod, float(self.border_size), float(x), float(y), float(base_data.size.x), float(base_data.size.y), texture(), base_data.get_rotation(), false, rtl);\n";
+	result += "\t" "\t" "} else if constexpr(d.background == bench_background::repeated_border) {\n";
+	result += "\t" "\t" "\t" "ogl::render_rect_with_repeated_border(state, cmod, float(" + std::to_string(grid_size) + "), float(x), float(y), float(base_data.size.x), float(base_data.size.y), texture(), base_data.get_rotation(), false, rtl);\n";
+	result += "\t" "\t" "} else if constexpr(d.background == bench_background::repeated_corner) {\n";
+	result += "\t" "\t" "\t" "ogl::render_rect_with_repeated_corner(state, cmod, float(" + std::to_string(grid_size) + "), float(x), float(y), float(base_data.size.x), float(base_data.size.y), texture(), base_data.get_rotation(), false, rtl);\n";
+	result += "\t" "\t" "} else {\n";
+	result += "\t" "\t" "\t" "ogl::render_progress_bar(state, cmod, self.progress, float(x), float(y), float(base_data.size.x), float(base_data.size.y), ogl::get_late_load_texture_handle(state, self.alt_background_texture, self.alt_texture_key), ogl::get_late_load_texture_handle(state, self.background_texture, self.texture_key), base_data.get_rotation(), false, rtl);\n";
+	result += "\t" "\t" "}\n";
+	result += "\t" "\t" "if constexpr(d.text) {\n";
+	result += "\t" "\t" "\t" "if(self.internal_layout.contents.empty()) return;\n";
+	result += "\t" "\t" "\t" "auto fh = text::make_font_id(state, self.text_is_header, self.text_scale * " + std::to_string(grid_size * 2) + ");\n";
+	result += "\t" "\t" "\t" "auto linesz = state.font_collection.line_height(state, fh);\n";
+	result += "\t" "\t" "\t" "if(linesz == 0.0f) return;\n";
+	result += "\t" "\t" "\t" "auto ycentered = (base_data.size.y - linesz) / 2;\n";
+	result += "\t" "\t" "\t" "for(auto& t : self.internal_layout.contents)\n";
+	result += "\t" "\t" "\t" "\t" "ui::render_text_chunk(state, t, float(x) + t.x, float(y + int32_t(ycentered)), fh, ui::get_text_color(state, self.text_color), cmod);\n";
+	result += "\t" "\t" "}\n";
+	result += "\t" "}\n";
+	result += "};\n";
+	for(auto& c : controls) {
+		auto descriptor = "bench_control_descriptor{ bench_background::" + std::string(background_name(c.background)) + ", " + (c.text ? "true" : "false") + ", " + (c.alternate ? "true" : "false") + ", " + (c.can_disable ? "true" : "false") + ", " + (c.interactable ? "true" : "false") + ", " + (c.ignore_rtl ? "true" : "false") + " }";
+		result += "struct " + class_name(c) + " : public bench_plain_control<" + class_name(c) + ", " + descriptor + "> {\n" + members(c) + "};\n";
+		// the generated file has to make each control's vtable, and with it the render, somewhere
+		result += "template class bench_plain_control<" + class_name(c) + ", " + descriptor + ">;\n";
+	}
+	return result;
+}
+
+static size_t file_size(std::string const& path) {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	return file ? size_t(file.tellg()) : 0;
+}
+
+// the lines of an assembly listing that are instructions: indented, and neither a directive nor a label
+static size_t instruction_count(std::string const& path) {
+	std::ifstream file(path);
+	size_t count = 0;
+	std::string line;
+	while(std::getline(file, line)) {
+		if(line.size() > 1 && (line[0] == '\t' || line[0] == ' ')) {
+			auto first = line.find_first_not_of(" \t");
+			if(first != std::string::npos && std::isalpha((unsigned char)(line[first])) && line.back() != ':')
+				++count;
+		}
+	}
+	return count;
+}
+
+int main(int argc, char** argv) {
+	std::string compiler = argc > 1 ? argv[1] : "clang++";
+	auto controls = make_controls();
+	auto shared = shared_version(controls, generated_code(controls));
+	if(shared.empty()) {
+		std::printf("the generator no longer emits the shared render functions or the renders that call them\n");
+		return 1;
+	}
+	struct variant {
+		char const* name;
+		std::string source;
+	};
+	variant variants[] = {
+		{ "copied per control", copied_version(controls) },
+		{ "shared functions", shared },
+		{ "crtp base", crtp_version(controls) }
+	};
+
+	std::printf("%d plain controls, compiled with %s -O2\n", int(control_count), compiler.c_str());
+	std::printf("%-20s %14s %12s %14s %14s\n", "", "source bytes", "compile ms", "object bytes", "instructions");
+	int32_t n = 0;
+	for(auto& v : variants) {
+		auto source_path = "out/bench/codegen_size_" + std::to_string(n) + ".cpp";
+		auto object_path = "out/bench/codegen_size_" + std::to_string(n) + ".o";
+		auto listing_path = "out/bench/codegen_size_" + std::to_string(n) + ".s";
+		++n;
+		{
+			std::ofstream file(source_path, std::ios::binary);
+			file << v.source;
+			if(!file) {
+				std::printf("could not write %s\n", source_path.c_str());
+				return 1;
+			}
+		}
+		auto command = compiler + " -std=c++20 -O2 -Itests -c " + source_path + " -o " + object_path;
+		int status = 0;
+		auto ms = testing::time_ms(3, [&]() { status = std::system(command.c_str()); });
+		if(status != 0) {
+			std::printf("%s failed\n", command.c_str());
+			return 1;
+		}
+		if(std::system((compiler + " -std=c++20 -O2 -Itests -S " + source_path + " -o " + listing_path).c_str()) != 0) {
+			std::printf("could not make %s\n", listing_path.c_str());
+			return 1;
+		}
+		std::printf("%-20s %14zu %12.1f %14zu %14zu\n", v.name, v.source.size(), ms, file_size(object_path), instruction_count(listing_path));
+	}
+	return 0;
+}
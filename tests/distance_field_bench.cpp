@@ -0,0 +1,50 @@
+#include "asvg.hpp"
+#include "test_support.hpp"
+#include <cstring>
+
+/*
+what drawing icons from distance fields saves: rendering an icon directly at every size it is drawn at, and keeping
+a texture for each, against making its field once and stretching that
+the field is stretched here on the cpu, the way the ui shader does it; on the gpu that part is close to free, so the
+sampling column is an upper bound
+*/
+
+static char const* const icons[] = {
+	"<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'><circle class='primarycolor' cx='50' cy='50' r='40'/></svg>",
+	"<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'><path class='primarycolor' d='M50 5 L61 38 L95 38 L67 58 L78 92 L50 71 L22 92 L33 58 L5 38 L39 38 Z'/></svg>",
+	"<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'><path class='primarycolor' fill='none' stroke-width='6' stroke-linecap='round' d='M15 50 C15 20 85 20 85 50 S15 80 15 50 M30 30 L70 70 M70 30 L30 70'/></svg>",
+};
+static char const* const icon_names[] = { "circle", "star", "stroked" };
+
+int main() {
+	std::printf("%-10s %6s %11s %10s %12s %14s %12s\n", "icon", "sizes", "direct ms", "field ms", "sampling ms", "direct bytes", "field bytes");
+	for(size_t icon = 0; icon < std::size(icons); ++icon) {
+		asvg::simple_svg s(icons[icon], std::strlen(icons[icon]));
+		std::vector<int32_t> sizes;
+		for(int32_t size = 16; size <= 256; size += 16)
+			sizes.push_back(size);
+
+		auto direct = testing::time_ms(5, [&]() {
+			for(auto size : sizes) {
+				lunasvg::Bitmap bmp;
+				s.render_pixels(size, size, 1.0f, 0.0f, 0.0f, 0.0f, bmp);
+			}
+		});
+		std::vector<char> field;
+		int32_t width = 0;
+		int32_t height = 0;
+		auto make = testing::time_ms(5, [&]() {
+			s.distance_field_values(field, width, height);
+		});
+		auto sample = testing::time_ms(5, [&]() {
+			std::vector<uint8_t> coverage;
+			for(auto size : sizes)
+				asvg::sample_distance_field(field, width, height, size, size, coverage);
+		});
+		size_t direct_bytes = 0;
+		for(auto size : sizes)
+			direct_bytes += size_t(size) * size_t(size) * 4;
+		std::printf("%-10s %6d %11.3f %10.3f %12.3f %14zu %12zu\n", icon_names[icon], int(sizes.size()), direct, make, sample, direct_bytes, field.size());
+	}
+	return 0;
+}
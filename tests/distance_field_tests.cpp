@@ -0,0 +1,173 @@
+#include "asvg.hpp"
+#include "test_support.hpp"
+#include <cstring>
+#include <cmath>
+
+/*
+icons drawn from distance fields are compared against the same icons rendered directly at the size they are drawn
+the field is sampled the way the ui shader samples it, so this runs without a gpu
+*/
+
+static char const* const single_color_icons[] = {
+	"<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'><circle class='primarycolor' cx='50' cy='50' r='40'/></svg>",
+	"<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'><rect class='primarycolor' x='20' y='20' width='60' height='60'/></svg>",
+	"<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'><path class='primarycolor' d='M50 5 L61 38 L95 38 L67 58 L78 92 L50 71 L22 92 L33 58 L5 38 L39 38 Z'/></svg>",
+	"<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'><path class='primarycolor' fill-rule='evenodd' d='M50 10 A40 40 0 1 0 50 90 A40 40 0 1 0 50 10 Z M50 30 A20 20 0 1 1 50 70 A20 20 0 1 1 50 30 Z'/></svg>",
+	"<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'><path class='primarycolor' d='M10 10 H90 V90 H10 Z M30 30 V70 H70 V30 Z'/></svg>",
+	"<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100' viewBox='0 0 24 24'><g transform='translate(2 2)'><path class='primarycolor' fill='none' stroke-width='2' stroke-linecap='round' d='M2 10 C2 2 18 2 18 10 M4 16 L16 16'/><rect class='primarycolor' x='8' y='12' width='4' height='8' transform='rotate(15 10 16)'/></g></svg>",
+	"<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'><path class='primarycolor' fill='none' stroke-width='10' d='M20 20 L80 20 M20 50 L80 80'/></svg>",
+};
+static char const* const icon_names[] = { "circle", "square", "star", "ring", "frame", "stroked", "butt caps" };
+
+static char const two_color_icon[] = "<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'><rect class='primarycolor' x='0' y='0' width='50' height='100'/><rect x='50' y='0' width='50' height='100' fill='#ff0000'/></svg>";
+static char const unreadable_icon[] = "<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'><rect class='primarycolor'";
+
+static void compare_with_direct_renders() {
+	int32_t const sizes[] = { 16, 24, 32, 48, 64, 128 };
+	for(size_t icon = 0; icon < std::size(single_color_icons); ++icon) {
+		asvg::simple_svg s(single_color_icons[icon], std::strlen(single_color_icons[icon]));
+		std::vector<char> field;
+		int32_t width = 0;
+		int32_t height = 0;
+		bool parsed = s.distance_field_values(field, width, height);
+		testing::check(parsed && !field.empty(), std::string(icon_names[icon]) + ": makes a distance field");
+		if(field.empty())
+			continue;
+
+		for(auto size : sizes) {
+			lunasvg::Bitmap direct;
+			s.render_pixels(size, size, 1.0f, 0.0f, 0.0f, 0.0f, direct);
+			std::vector<uint8_t> sampled;
+			asvg::sample_distance_field(field, width, height, size, size, sampled);
+
+			double total_error = 0.0;
+			int32_t far_off = 0;
+			for(int32_t y = 0; y < size; ++y) {
+				for(int32_t x = 0; x < size; ++x) {
+					int32_t expected = direct.data()[size_t(y) * direct.stride() + size_t(x) * 4 + 3];
+					int32_t error = std::abs(expected - int32_t(sampled[size_t(y) * size + x]));
+					total_error += error;
+					if(error > 160) // a pixel on the wrong side of the outline, not just one with its edge softened differently
+						++far_off;
+				}
+			}
+			double mean_error = total_error / double(size * size);
+			auto what = std::string(icon_names[icon]) + " at " + std::to_string(size) + ": ";
+			testing::check(mean_error < 8.0, what + "mean error " + std::to_string(mean_error) + " out of 255");
+			testing::check(far_off <= size / 8, what + std::to_string(far_off) + " pixels on the wrong side of the outline");
+		}
+	}
+}
+
+static void other_colors_have_no_field() {
+	asvg::simple_svg s(two_color_icon, std::strlen(two_color_icon));
+	std::vector<char> field;
+	int32_t width = 0;
+	int32_t height = 0;
+	testing::check(s.distance_field_values(field, width, height), "two colors: parses");
+	testing::check(field.empty(), "two colors: no distance field");
+	testing::check(s.get_distance_field().texture_handle == 0, "two colors: get_distance_field gives 0");
+	testing::check(s.distance_field_state == asvg::distance_field_status::unsuitable, "two colors: marked unsuitable");
+}
+
+static void unreadable_data_has_no_field() {
+	asvg::simple_svg s(unreadable_icon, std::strlen(unreadable_icon));
+	std::vector<char> field;
+	int32_t width = 0;
+	int32_t height = 0;
+	testing::check(!s.distance_field_values(field, width, height), "unreadable: reported as not parsed");
+	testing::check(s.get_distance_field().texture_handle == 0, "unreadable: get_distance_field gives 0");
+	testing::check(s.distance_field_state == asvg::distance_field_status::unsuitable, "unreadable: marked unsuitable");
+	testing::check(s.get_distance_field().texture_handle == 0, "unreadable: not tried again");
+}
+
+static void sampling_matches_the_field() {
+	// a flat field has no edge to smooth, so it is covered or not by which side of the outline it is on
+	std::vector<char> outside(48, char(127));
+	std::vector<uint8_t> coverage;
+	asvg::sample_distance_field(outside, 4, 4, 9, 7, coverage);
+	testing::check(coverage.size() == 63, "sampling: one value per pixel");
+	testing::check(std::all_of(coverage.begin(), coverage.end(), [](uint8_t c) { return c == 0; }), "sampling: outside is not covered");
+	std::vector<char> inside(48, char(128));
+	asvg::sample_distance_field(inside, 4, 4, 9, 7, coverage);
+	testing::check(std::all_of(coverage.begin(), coverage.end(), [](uint8_t c) { return c == 255; }), "sampling: inside is covered");
+
+	// the median of the three channels is what counts: one channel alone on the other side changes nothing
+	std::vector<char> one_off(48);
+	for(size_t i = 0; i < one_off.size(); i += 3) {
+		one_off[i] = char(200);
+		one_off[i + 1] = char(60);
+		one_off[i + 2] = char(100);
+	}
+	asvg::sample_distance_field(one_off, 4, 4, 9, 7, coverage);
+	testing::check(std::all_of(coverage.begin(), coverage.end(), [](uint8_t c) { return c == 0; }), "sampling: the median decides");
+
+	// a ramp across the outline, stretched to four times its size, is smoothed over about a pixel where it crosses
+	std::vector<char> ramp(24);
+	for(int32_t x = 0; x < 8; ++x)
+		ramp[x * 3] = ramp[x * 3 + 1] = ramp[x * 3 + 2] = char(uint8_t(128 + (x - 4) * 24 + 12));
+	asvg::sample_distance_field(ramp, 8, 1, 32, 1, coverage);
+	testing::check(coverage.front() == 0 && coverage.back() == 255, "sampling: ramp runs from outside to inside");
+	testing::check(std::is_sorted(coverage.begin(), coverage.end()), "sampling: ramp coverage only grows");
+	auto partly = std::count_if(coverage.begin(), coverage.end(), [](uint8_t c) { return c != 0 && c != 255; });
+	testing::check(partly >= 1 && partly <= 3, "sampling: ramp is smoothed over about a pixel, not " + std::to_string(partly));
+}
+
+static void corners_stay_sharp() {
+	// stretched far past its resolution, a single channel field rounds the square's corners off; the three channels
+	// keep them, so the pixel just inside each corner stays covered
+	char const square[] = "<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'><rect class='primarycolor' x='20' y='20' width='60' height='60'/></svg>";
+	asvg::simple_svg s(square, std::strlen(square));
+	std::vector<char> field;
+	int32_t width = 0;
+	int32_t height = 0;
+	s.distance_field_values(field, width, height);
+	std::vector<uint8_t> coverage;
+	int32_t const size = 400;
+	asvg::sample_distance_field(field, width, height, size, size, coverage);
+	int32_t const near = 80 + 2;
+	int32_t const far = 320 - 3;
+	bool sharp = coverage[size_t(near) * size + near] > 128 && coverage[size_t(near) * size + far] > 128
+		&& coverage[size_t(far) * size + near] > 128 && coverage[size_t(far) * size + far] > 128;
+	testing::check(sharp, "square at 400: corners stay sharp");
+}
+
+static void atlas_packs_fields_in_rows() {
+	asvg::distance_field_atlas atlas;
+	asvg::distance_field_slot first;
+	asvg::distance_field_slot second;
+	testing::check(atlas.place(32, 20, first) && atlas.place(32, 32, second), "atlas: places fields");
+	testing::check(atlas.size == asvg::distance_field_atlas::first_size, "atlas: starts at its first size");
+	float texel = 1.0f / float(atlas.size);
+	testing::check(first.x == texel && first.y == texel, "atlas: the first field is inside its border");
+	testing::check(second.x == first.x + 34.0f * texel && second.y == first.y, "atlas: the next field goes beside it, past both borders");
+	testing::check(first.width == 32.0f * texel && first.height == 20.0f * texel, "atlas: slots are the fields' size");
+
+	int32_t placed = 2;
+	asvg::distance_field_slot slot;
+	while(atlas.place(32, 32, slot))
+		++placed;
+	int32_t per_row = asvg::distance_field_atlas::first_size / 34;
+	testing::check(placed == per_row * per_row, "atlas: fills " + std::to_string(per_row * per_row) + " slots, not " + std::to_string(placed));
+
+	// an atlas that is full grows, and what was placed before has to be made again
+	asvg::distance_field_atlas growing;
+	std::vector<char> field(size_t(32) * 32 * 3);
+	auto before = growing.add(field, 32, 32);
+	for(int32_t i = 1; i < per_row * per_row; ++i)
+		growing.add(field, 32, 32);
+	testing::check(growing.holds(before) && growing.size == asvg::distance_field_atlas::first_size, "atlas: holds fields until it is full");
+	auto after = growing.add(field, 32, 32);
+	testing::check(growing.size == 2 * asvg::distance_field_atlas::first_size, "atlas: grows when full");
+	testing::check(!growing.holds(before) && growing.holds(after), "atlas: fields from before it grew are made again");
+}
+
+int main() {
+	sampling_matches_the_field();
+	compare_with_direct_renders();
+	corners_stay_sharp();
+	atlas_packs_fields_in_rows();
+	other_colors_have_no_field();
+	unreadable_data_has_no_field();
+	return testing::finish("distance_field_tests");
+}
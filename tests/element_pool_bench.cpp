@@ -0,0 +1,266 @@
+#include "code_generator.hpp"
+#include "test_support.hpp"
+#include <vector>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <cctype>
+#include <bit>
+
+/*
+what keeping generator rows in <project>_element_pool saves over the vectors of unique_ptrs it replaced: 10000 rows are
+made and laid out, the way a generator fills a long list the first time it is shown, and then laid out again, the way
+it does on every scroll; last, rows reserved ahead of time (as a _pool_prewarm count does from on_create) are laid out
+for the first time
+the generated code needs the game's runtime, so the rows here are built on a small stand-in for it with the shape of a
+generated row window (six child controls, made in on_create); the pool itself is a copy of the one the generator emits,
+and the benchmark first checks that the copy still matches it
+*/
+
+namespace sys {
+struct state {
+	int32_t updates = 0;
+};
+}
+
+namespace ui {
+struct xy_pair {
+	int16_t x = 0;
+	int16_t y = 0;
+};
+struct element_data {
+	xy_pair position;
+	xy_pair size;
+};
+class element_base {
+public:
+	element_data base_data;
+	element_base* parent = nullptr;
+	uint8_t flags = 0;
+	virtual ~element_base() { }
+	virtual void on_create(sys::state& state) noexcept { }
+	virtual void impl_on_update(sys::state& state) noexcept {
+		++state.updates;
+	}
+};
+class container_base : public element_base {
+public:
+	std::vector<element_base*> children;
+};
+}
+
+// the copy is kept in a macro so that it can be both compiled and compared, as text, with the generated one
+#define BENCH_STRINGIZE(...) #__VA_ARGS__
+#define BENCH_TEXT(...) BENCH_STRINGIZE(__VA_ARGS__)
+#define BENCH_ELEMENT_POOL \
+template<typename T> \
+class bench_element_pool { \
+	struct alignas(T) slot { std::byte bytes[sizeof(T)]; }; \
+	std::vector<std::unique_ptr<slot[]>> blocks; \
+	size_t count = 0; \
+	size_t capacity = 0; \
+	int32_t first_block_shift = 4; \
+	int32_t last_block_shift = 8; \
+	std::byte* storage(size_t i) const { \
+		auto doublings = last_block_shift - first_block_shift; \
+		auto doubling_rows = ((size_t(2) << doublings) - 1) << first_block_shift; \
+		if(i < doubling_rows) { \
+			auto b = std::bit_width((i >> first_block_shift) + 1) - 1; \
+			return blocks[b][i - (((size_t(1) << b) - 1) << first_block_shift)].bytes; \
+		} \
+		i -= doubling_rows; \
+		return blocks[doublings + 1 + (i >> last_block_shift)][i & ((size_t(1) << last_block_shift) - 1)].bytes; \
+	} \
+public: \
+	bench_element_pool() = default; \
+	bench_element_pool(bench_element_pool const&) = delete; \
+	bench_element_pool& operator=(bench_element_pool const&) = delete; \
+	~bench_element_pool() { \
+		for(size_t i = count; i-- > 0; ) \
+			(*this)[i]->~T(); \
+	} \
+	T* operator[](size_t i) const { \
+		return std::launder(reinterpret_cast<T*>(storage(i))); \
+	} \
+	size_t size() const { return count; } \
+	bool empty() const { return count == 0; } \
+	T* emplace_back(sys::state& state) { \
+		if(count == capacity) { \
+			auto block_size = size_t(1) << std::min(first_block_shift + int32_t(blocks.size()), last_block_shift); \
+			blocks.emplace_back(new slot[block_size]); \
+			capacity += block_size; \
+		} \
+		auto ptr = new (storage(count)) T(); \
+		++count; \
+		ptr->on_create(state); \
+		return ptr; \
+	} \
+	void reserve(sys::state& state, size_t n) { \
+		if(blocks.empty()) { \
+			while((size_t(1) << first_block_shift) < n) \
+				++first_block_shift; \
+			last_block_shift = std::max(first_block_shift, last_block_shift); \
+		} \
+		while(count < n) \
+			emplace_back(state); \
+	} \
+};
+
+BENCH_ELEMENT_POOL
+
+class bench_row_label_t : public ui::element_base {
+public:
+	std::string text;
+	uint32_t text_color = 0;
+	bool dynamic = true;
+};
+class bench_row_icon_t : public ui::element_base {
+public:
+	int32_t texture = -1;
+	int32_t frame = 0;
+};
+class bench_row_t : public ui::container_base {
+public:
+	std::unique_ptr<bench_row_icon_t> flag;
+	std::unique_ptr<bench_row_label_t> name;
+	std::unique_ptr<bench_row_label_t> value;
+	std::unique_ptr<bench_row_label_t> change;
+	std::unique_ptr<bench_row_icon_t> trend;
+	std::unique_ptr<bench_row_label_t> rank;
+	int32_t content = 0;
+
+	void on_create(sys::state& state) noexcept override {
+		base_data.size = ui::xy_pair{ 400, 27 };
+		auto add = [&](auto& child, int16_t x, int16_t width) {
+			child = std::make_unique<std::remove_reference_t<decltype(*child)>>();
+			child->parent = this;
+			child->base_data.position = ui::xy_pair{ x, 0 };
+			child->base_data.size = ui::xy_pair{ width, 27 };
+			children.push_back(child.get());
+		};
+		add(flag, 0, 27);
+		add(name, 27, 160);
+		add(value, 187, 80);
+		add(change, 267, 60);
+		add(trend, 327, 27);
+		add(rank, 354, 46);
+	}
+	void impl_on_update(sys::state& state) noexcept override {
+		for(auto c : children)
+			c->impl_on_update(state);
+	}
+};
+std::unique_ptr<ui::element_base> make_bench_row(sys::state& state) {
+	auto ptr = std::make_unique<bench_row_t>();
+	ptr->on_create(state);
+	return ptr;
+}
+
+// a generator's place function: the row for each value is positioned, given its value and updated, then put in the page
+template<typename P, typename G>
+void lay_out(sys::state& state, P& pool, G&& get, ui::container_base& page, int32_t rows) {
+	page.children.clear();
+	for(int32_t i = 0; i < rows; ++i) {
+		if(pool.size() <= size_t(i))
+			pool.emplace_back(state);
+		bench_row_t* row = get(pool, i);
+		row->base_data.position = ui::xy_pair{ 0, int16_t((i % 40) * 27) };
+		row->content = i;
+		row->impl_on_update(state);
+		page.children.push_back(row);
+	}
+}
+
+struct unique_ptr_pool {
+	std::vector<std::unique_ptr<ui::element_base>> rows;
+	size_t size() const {
+		return rows.size();
+	}
+	void emplace_back(sys::state& state) {
+		rows.emplace_back(make_bench_row(state));
+	}
+};
+
+static std::string without_whitespace_or_comments(std::string_view s) {
+	std::string result;
+	for(size_t i = 0; i < s.size(); ++i) {
+		if(s[i] == '/' && i + 1 < s.size() && s[i + 1] == '/') {
+			while(i < s.size() && s[i] != '\n')
+				++i;
+		} else if(!std::isspace((unsigned char)(s[i]))) {
+			result += s[i];
+		}
+	}
+	return result;
+}
+
+// the pool class in the code generated for a project named bench
+static std::string generated_pool() {
+	open_project_t project;
+	project.project_name = L"bench";
+	generator::code_snippets no_old_code;
+	auto code = generator::generate_project_code(project, no_old_code);
+	auto start = code.find("template<typename T>\nclass bench_element_pool {");
+	if(start == std::string::npos)
+		return std::string();
+	auto end = code.find("\n};\n", start);
+	return code.substr(start, end + 3 - start);
+}
+
+int main() {
+	if(without_whitespace_or_comments(generated_pool()) != without_whitespace_or_comments(BENCH_TEXT(BENCH_ELEMENT_POOL))) {
+		std::printf("the element pool in this benchmark no longer matches the one the generator emits\n");
+		return 1;
+	}
+
+	constexpr int32_t rows = 10000;
+	sys::state state;
+	ui::container_base page;
+
+	auto old_first = testing::time_ms(5, [&]() {
+		unique_ptr_pool pool;
+		lay_out(state, pool, [](unique_ptr_pool& p, int32_t i) { return static_cast<bench_row_t*>(p.rows[i].get()); }, page, rows);
+	});
+	auto new_first = testing::time_ms(5, [&]() {
+		bench_element_pool<bench_row_t> pool;
+		lay_out(state, pool, [](bench_element_pool<bench_row_t>& p, int32_t i) { return p[i]; }, page, rows);
+	});
+
+	unique_ptr_pool old_pool;
+	lay_out(state, old_pool, [](unique_ptr_pool& p, int32_t i) { return static_cast<bench_row_t*>(p.rows[i].get()); }, page, rows);
+	auto old_again = testing::time_ms(20, [&]() {
+		lay_out(state, old_pool, [](unique_ptr_pool& p, int32_t i) { return static_cast<bench_row_t*>(p.rows[i].get()); }, page, rows);
+	});
+	bench_element_pool<bench_row_t> new_pool;
+	lay_out(state, new_pool, [](bench_element_pool<bench_row_t>& p, int32_t i) { return p[i]; }, page, rows);
+	auto new_again = testing::time_ms(20, [&]() {
+		lay_out(state, new_pool, [](bench_element_pool<bench_row_t>& p, int32_t i) { return p[i]; }, page, rows);
+	});
+
+	// rows made ahead of time by a _pool_prewarm count, so that only the layout is left when the list is first shown
+	std::vector<std::unique_ptr<bench_element_pool<bench_row_t>>> warm_pools;
+	for(int32_t i = 0; i < 5; ++i) {
+		warm_pools.emplace_back(std::make_unique<bench_element_pool<bench_row_t>>());
+		warm_pools.back()->reserve(state, rows);
+	}
+	size_t next_warm = 0;
+	auto warm_first = testing::time_ms(5, [&]() {
+		lay_out(state, *warm_pools[next_warm++], [](bench_element_pool<bench_row_t>& p, int32_t i) { return p[i]; }, page, rows);
+	});
+
+	// every row has its own place, whether or not its pool was reserved first
+	for(auto* p : { &new_pool, warm_pools[0].get() }) {
+		for(int32_t i = 0; i < rows; ++i) {
+			if((*p)[i]->content != i || (i > 0 && (*p)[i] == (*p)[i - 1])) {
+				std::printf("row %d of the pool is not where it was laid out\n", int(i));
+				return 1;
+			}
+		}
+	}
+
+	std::printf("%-28s %14s %14s %10s\n", "10000 rows", "unique_ptr ms", "pool ms", "speedup");
+	std::printf("%-28s %14.3f %14.3f %9.2fx\n", "made and laid out", old_first, new_first, old_first / new_first);
+	std::printf("%-28s %14.3f %14.3f %9.2fx\n", "laid out again", old_again, new_again, old_again / new_again);
+	std::printf("%-28s %14.3f %14.3f %9.2fx\n", "laid out after prewarm", old_first, warm_first, old_first / warm_first);
+	return 0;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/*
+the part of the game's runtime that the render functions of generated plain controls call, declared with the same
+shapes so that those functions can be compiled, and their object code measured, without the game
+nothing here is defined: the code is only compiled, never linked
+*/
+
+namespace sys {
+struct state;
+}
+
+namespace dcon {
+struct texture_id {
+	uint16_t value = 0;
+};
+}
+
+namespace ogl {
+using GLuint = unsigned int;
+enum class color_modification : uint8_t {
+	none, disabled, interactable, interactable_disabled
+};
+struct color3f {
+	float r = 0.0f;
+	float g = 0.0f;
+	float b = 0.0f;
+};
+}
+
+namespace ui {
+enum class rotation : uint8_t {
+	upright, r90_left, r90_right
+};
+struct xy_pair {
+	int16_t x = 0;
+	int16_t y = 0;
+};
+struct element_data {
+	xy_pair position;
+	xy_pair size;
+	uint8_t flags = 0;
+	rotation get_rotation() const {
+		return rotation(flags & 0x03);
+	}
+};
+class element_base {
+public:
+	element_data base_data;
+	element_base* parent = nullptr;
+	virtual ~element_base() { }
+	virtual void render(sys::state& state, int32_t x, int32_t y) noexcept { }
+};
+}
+
+namespace text {
+enum class text_color : uint8_t {
+	black, white, red, green, yellow, unspecified, light_blue, dark_blue, orange, lilac, light_grey, dark_red, dark_green,
+	gold, reset, brown
+};
+struct text_chunk {
+	float x = 0.0f;
+	float width = 0.0f;
+	uint16_t first = 0;
+	uint16_t length = 0;
+	text_color color = text_color::black;
+};
+struct layout {
+	std::vector<text_chunk> contents;
+};
+uint16_t make_font_id(sys::state& state, bool as_header, float size);
+}
+
+namespace sys {
+struct ui_state_t {
+	ui::element_base* under_mouse = nullptr;
+};
+struct font_collection_t {
+	float line_height(sys::state& state, uint16_t font_id) const;
+};
+struct state {
+	ui_state_t ui_state;
+	font_collection_t font_collection;
+};
+}
+
+namespace ogl {
+GLuint get_late_load_texture_handle(sys::state& state, dcon::texture_id& id, std::string_view key);
+void render_textured_rect(sys::state& state, color_modification enabled, float x, float y, float width, float height, GLuint texture_handle, ui::rotation r, bool flipped, bool rtl);
+void render_bordered_rect(sys::state& state, color_modification enabled, float border_size, float x, float y, float width, float height, GLuint texture_handle, ui::rotation r, bool flipped, bool rtl);
+void render_rect_with_repeated_border(sys::state& state, color_modification enabled, float grid_size, float x, float y, float width, float height, GLuint texture_handle, ui::rotation r, bool flipped, bool rtl);
+void render_rect_with_repeated_corner(sys::state& state, color_modification enabled, float grid_size, float x, float y, float width, float height, GLuint texture_handle, ui::rotation r, bool flipped, bool rtl);
+void render_progress_bar(sys::state& state, color_modification enabled, float progress, float x, float y, float width, float height, GLuint left_texture_handle, GLuint right_texture_handle, ui::rotation r, bool flipped, bool rtl);
+}
+
+namespace ui {
+ogl::color_modification get_color_modification(bool is_under_mouse, bool is_disabled, bool is_interactable);
+ogl::color3f get_text_color(sys::state& state, text::text_color text_color);
+void render_text_chunk(sys::state& state, text::text_chunk t, float x, float baseline_y, uint16_t font_id, ogl::color3f text_color, ogl::color_modification cmod);
+}
+
+bool state_is_rtl(sys::state& state);
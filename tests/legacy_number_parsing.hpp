@@ -0,0 +1,349 @@
+#pragma once
+#include <string_view>
+#include <limits>
+#include <cmath>
+#include <cfloat>
+#include "plutovg.h"
+
+/*
+the two svg number parsers as they were before they gathered digits into an integer mantissa: lunasvg's parseNumber
+and plutovg_parse_number, both adding up the integer and fraction parts one float multiply and add per digit and then
+scaling by pow for any exponent
+and plutovg_path_parse as it was before it had its own tokenizer: every command found by a chain of comparisons, every
+coordinate read by the old number parser and followed by the general white space and comma skipping
+*/
+namespace legacy {
+
+inline bool is_num(char c) {
+	return c >= '0' && c <= '9';
+}
+
+template<typename T>
+bool parse_number(std::string_view& input, T& number) {
+	constexpr T max_value = std::numeric_limits<T>::max();
+	T integer = 0;
+	T fraction = 0;
+	int exponent = 0;
+	int sign = 1;
+	int expsign = 1;
+
+	if(!input.empty() && input.front() == '+') {
+		input.remove_prefix(1);
+	} else if(!input.empty() && input.front() == '-') {
+		input.remove_prefix(1);
+		sign = -1;
+	}
+
+	if(input.empty() || (!is_num(input.front()) && input.front() != '.'))
+		return false;
+	if(is_num(input.front())) {
+		do {
+			integer = static_cast<T>(10) * integer + (input.front() - '0');
+			input.remove_prefix(1);
+		} while(!input.empty() && is_num(input.front()));
+	}
+
+	if(!input.empty() && input.front() == '.') {
+		input.remove_prefix(1);
+		if(input.empty() || !is_num(input.front()))
+			return false;
+		T divisor = static_cast<T>(1);
+		do {
+			fraction = static_cast<T>(10) * fraction + (input.front() - '0');
+			divisor *= static_cast<T>(10);
+			input.remove_prefix(1);
+		} while(!input.empty() && is_num(input.front()));
+		fraction /= divisor;
+	}
+
+	if(input.size() > 1 && (input[0] == 'e' || input[0] == 'E') && (input[1] != 'x' && input[1] != 'm')) {
+		input.remove_prefix(1);
+		if(!input.empty() && input.front() == '+') {
+			input.remove_prefix(1);
+		} else if(!input.empty() && input.front() == '-') {
+			input.remove_prefix(1);
+			expsign = -1;
+		}
+
+		if(input.empty() || !is_num(input.front()))
+			return false;
+		do {
+			exponent = 10 * exponent + (input.front() - '0');
+			input.remove_prefix(1);
+		} while(!input.empty() && is_num(input.front()));
+	}
+
+	number = sign * (integer + fraction);
+	if(exponent)
+		number *= static_cast<T>(std::pow(10.0, expsign * exponent));
+	return number >= -max_value && number <= max_value;
+}
+
+inline bool plutovg_parse_number(char const** begin, char const* end, float* number) {
+	char const* it = *begin;
+	float integer = 0;
+	float fraction = 0;
+	float exponent = 0;
+	int sign = 1;
+	int expsign = 1;
+
+	if(it < end && *it == '+') {
+		++it;
+	} else if(it < end && *it == '-') {
+		++it;
+		sign = -1;
+	}
+
+	if(it >= end || (*it != '.' && !is_num(*it)))
+		return false;
+	if(is_num(*it)) {
+		do {
+			integer = 10.f * integer + (*it++ - '0');
+		} while(it < end && is_num(*it));
+	}
+
+	if(it < end && *it == '.') {
+		++it;
+		if(it >= end || !is_num(*it))
+			return false;
+		float divisor = 1.f;
+		do {
+			fraction = 10.f * fraction + (*it++ - '0');
+			divisor *= 10.f;
+		} while(it < end && is_num(*it));
+		fraction /= divisor;
+	}
+
+	if(it < end && (*it == 'e' || *it == 'E')) {
+		++it;
+		if(it < end && *it == '+') {
+			++it;
+		} else if(it < end && *it == '-') {
+			++it;
+			expsign = -1;
+		}
+
+		if(it >= end || !is_num(*it))
+			return false;
+		do {
+			exponent = 10 * exponent + (*it++ - '0');
+		} while(it < end && is_num(*it));
+	}
+
+	*begin = it;
+	*number = sign * (integer + fraction);
+	if(exponent)
+		*number *= powf(10.f, expsign * exponent);
+	return *number >= -FLT_MAX && *number <= FLT_MAX;
+}
+
+inline bool is_ws(char c) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool is_alpha(char c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+inline bool skip_ws(char const** begin, char const* end) {
+	char const* it = *begin;
+	while(it < end && is_ws(*it))
+		++it;
+	*begin = it;
+	return it < end;
+}
+
+inline bool skip_ws_or_comma(char const** begin, char const* end) {
+	char const* it = *begin;
+	if(skip_ws(&it, end)) {
+		if(it < end && *it == ',') {
+			++it;
+			skip_ws(&it, end);
+		}
+	}
+	if(it == *begin)
+		return false;
+	*begin = it;
+	return it < end;
+}
+
+inline bool parse_arc_flag(char const** begin, char const* end, bool* flag) {
+	if(*begin < end && **begin == '0')
+		*flag = false;
+	else if(*begin < end && **begin == '1')
+		*flag = true;
+	else
+		return false;
+	++*begin;
+	skip_ws_or_comma(begin, end);
+	return true;
+}
+
+inline bool parse_path_coordinates(char const** begin, char const* end, float values[6], int offset, int count) {
+	for(int i = 0; i < count; i++) {
+		if(!plutovg_parse_number(begin, end, values + offset + i))
+			return false;
+		skip_ws_or_comma(begin, end);
+	}
+	return true;
+}
+
+inline bool plutovg_path_parse(plutovg_path_t* path, char const* data, int length) {
+	char const* it = data;
+	char const* end = it + length;
+
+	float values[6];
+	bool flags[2];
+
+	float start_x = 0;
+	float start_y = 0;
+	float current_x = 0;
+	float current_y = 0;
+	float last_control_x = 0;
+	float last_control_y = 0;
+
+	char command = 0;
+	char last_command = 0;
+	skip_ws(&it, end);
+	while(it < end) {
+		if(is_alpha(*it)) {
+			command = *it++;
+			skip_ws(&it, end);
+		}
+
+		if(!last_command && !(command == 'M' || command == 'm'))
+			return false;
+		if(command == 'M' || command == 'm') {
+			if(!parse_path_coordinates(&it, end, values, 0, 2))
+				return false;
+			if(command == 'm') {
+				values[0] += current_x;
+				values[1] += current_y;
+			}
+			plutovg_path_move_to(path, values[0], values[1]);
+			current_x = start_x = values[0];
+			current_y = start_y = values[1];
+			command = command == 'm' ? 'l' : 'L';
+		} else if(command == 'L' || command == 'l') {
+			if(!parse_path_coordinates(&it, end, values, 0, 2))
+				return false;
+			if(command == 'l') {
+				values[0] += current_x;
+				values[1] += current_y;
+			}
+			plutovg_path_line_to(path, values[0], values[1]);
+			current_x = values[0];
+			current_y = values[1];
+		} else if(command == 'H' || command == 'h') {
+			if(!parse_path_coordinates(&it, end, values, 0, 1))
+				return false;
+			if(command == 'h')
+				values[0] += current_x;
+			plutovg_path_line_to(path, values[0], current_y);
+			current_x = values[0];
+		} else if(command == 'V' || command == 'v') {
+			if(!parse_path_coordinates(&it, end, values, 1, 1))
+				return false;
+			if(command == 'v')
+				values[1] += current_y;
+			plutovg_path_line_to(path, current_x, values[1]);
+			current_y = values[1];
+		} else if(command == 'Q' || command == 'q') {
+			if(!parse_path_coordinates(&it, end, values, 0, 4))
+				return false;
+			if(command == 'q') {
+				values[0] += current_x;
+				values[1] += current_y;
+				values[2] += current_x;
+				values[3] += current_y;
+			}
+			plutovg_path_quad_to(path, values[0], values[1], values[2], values[3]);
+			last_control_x = values[0];
+			last_control_y = values[1];
+			current_x = values[2];
+			current_y = values[3];
+		} else if(command == 'C' || command == 'c') {
+			if(!parse_path_coordinates(&it, end, values, 0, 6))
+				return false;
+			if(command == 'c') {
+				values[0] += current_x;
+				values[1] += current_y;
+				values[2] += current_x;
+				values[3] += current_y;
+				values[4] += current_x;
+				values[5] += current_y;
+			}
+			plutovg_path_cubic_to(path, values[0], values[1], values[2], values[3], values[4], values[5]);
+			last_control_x = values[2];
+			last_control_y = values[3];
+			current_x = values[4];
+			current_y = values[5];
+		} else if(command == 'T' || command == 't') {
+			if(last_command != 'Q' && last_command != 'q' && last_command != 'T' && last_command != 't') {
+				values[0] = current_x;
+				values[1] = current_y;
+			} else {
+				values[0] = 2 * current_x - last_control_x;
+				values[1] = 2 * current_y - last_control_y;
+			}
+			if(!parse_path_coordinates(&it, end, values, 2, 2))
+				return false;
+			if(command == 't') {
+				values[2] += current_x;
+				values[3] += current_y;
+			}
+			plutovg_path_quad_to(path, values[0], values[1], values[2], values[3]);
+			last_control_x = values[0];
+			last_control_y = values[1];
+			current_x = values[2];
+			current_y = values[3];
+		} else if(command == 'S' || command == 's') {
+			if(last_command != 'C' && last_command != 'c' && last_command != 'S' && last_command != 's') {
+				values[0] = current_x;
+				values[1] = current_y;
+			} else {
+				values[0] = 2 * current_x - last_control_x;
+				values[1] = 2 * current_y - last_control_y;
+			}
+			if(!parse_path_coordinates(&it, end, values, 2, 4))
+				return false;
+			if(command == 's') {
+				values[2] += current_x;
+				values[3] += current_y;
+				values[4] += current_x;
+				values[5] += current_y;
+			}
+			plutovg_path_cubic_to(path, values[0], values[1], values[2], values[3], values[4], values[5]);
+			last_control_x = values[2];
+			last_control_y = values[3];
+			current_x = values[4];
+			current_y = values[5];
+		} else if(command == 'A' || command == 'a') {
+			if(!parse_path_coordinates(&it, end, values, 0, 3)
+				|| !parse_arc_flag(&it, end, &flags[0])
+				|| !parse_arc_flag(&it, end, &flags[1])
+				|| !parse_path_coordinates(&it, end, values, 3, 2)) {
+				return false;
+			}
+			if(command == 'a') {
+				values[3] += current_x;
+				values[4] += current_y;
+			}
+			plutovg_path_arc_to(path, values[0], values[1], PLUTOVG_DEG2RAD(values[2]), flags[0], flags[1], values[3], values[4]);
+			current_x = values[3];
+			current_y = values[4];
+		} else if(command == 'Z' || command == 'z') {
+			if(last_command == 'Z' || last_command == 'z')
+				return false;
+			plutovg_path_close(path);
+			current_x = start_x;
+			current_y = start_y;
+		} else {
+			return false;
+		}
+		last_command = command;
+	}
+	return true;
+}
+
+}
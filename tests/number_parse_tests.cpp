@@ -0,0 +1,173 @@
+#include "svgparserutils.h"
+#include "plutovg-utils.h"
+#include "test_support.hpp"
+#include <random>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/*
+the svg number parsers against strtof, which rounds correctly: numbers of the length exported themes hold have to come
+out exactly, and numbers with more significant digits than the mantissa keeps, or with exponents reaching to the ends
+of the float range, within one unit in the last place
+both parsers also have to stop where the number ends, leaving the e of an em or ex unit, and refuse what does not fit
+in a float; since they read eight digits at a time where there are eight bytes left, the short numbers are also read
+with the rest of an attribute after them
+*/
+
+static float reference(std::string const& s) {
+	return std::strtof(s.c_str(), nullptr);
+}
+
+// how many floats apart two floats are, counting across zero
+static int64_t ulps(float a, float b) {
+	auto ordered = [](float f) {
+		int32_t bits = 0;
+		std::memcpy(&bits, &f, sizeof(bits));
+		return bits < 0 ? int64_t(INT32_MIN) - int64_t(bits) : int64_t(bits);
+	};
+	return std::abs(ordered(a) - ordered(b));
+}
+
+struct parsed {
+	bool ok = false;
+	float value = 0.0f;
+	size_t rest = 0;
+};
+
+static parsed parse_lunasvg(std::string const& s) {
+	parsed p;
+	std::string_view input = s;
+	p.ok = lunasvg::parseNumber(input, p.value);
+	p.rest = input.size();
+	return p;
+}
+static parsed parse_plutovg(std::string const& s) {
+	parsed p;
+	char const* it = s.data();
+	p.ok = plutovg_parse_number(&it, s.data() + s.size(), &p.value);
+	p.rest = size_t(s.data() + s.size() - it);
+	return p;
+}
+
+// one failure per parser and kind of number is enough to see what went wrong; numbers past the largest float have to be
+// refused
+// the tail is put after each number and has to be left unread
+struct checker {
+	char const* kind;
+	int64_t max_ulps;
+	std::string tail;
+	bool lunasvg_failed = false;
+	bool plutovg_failed = false;
+
+	void operator()(std::string const& s) {
+		auto expected = reference(s);
+		auto l = parse_lunasvg(s + tail);
+		auto p = parse_plutovg(s + tail);
+		if(std::isinf(expected)) {
+			if(!lunasvg_failed && l.ok) {
+				testing::check(false, std::string("lunasvg, ") + kind + ": " + s + ", past the largest float, is not refused");
+				lunasvg_failed = true;
+			}
+			if(!plutovg_failed && p.ok) {
+				testing::check(false, std::string("plutovg, ") + kind + ": " + s + ", past the largest float, is not refused");
+				plutovg_failed = true;
+			}
+			return;
+		}
+		if(!lunasvg_failed && (!l.ok || l.rest != tail.size() || ulps(l.value, expected) > max_ulps)) {
+			testing::check(false, std::string("lunasvg, ") + kind + ": " + s + " read as " + std::to_string(l.value) + ", off by " + std::to_string(ulps(l.value, expected)) + " ulps");
+			lunasvg_failed = true;
+		}
+		if(!plutovg_failed && (!p.ok || p.rest != tail.size() || ulps(p.value, expected) > max_ulps)) {
+			testing::check(false, std::string("plutovg, ") + kind + ": " + s + " read as " + std::to_string(p.value) + ", off by " + std::to_string(ulps(p.value, expected)) + " ulps");
+			plutovg_failed = true;
+		}
+	}
+};
+
+static std::string digits(std::mt19937& rng, int32_t count) {
+	std::string s;
+	s += char('1' + rng() % 9);
+	for(int32_t i = 1; i < count; ++i)
+		s += char('0' + rng() % 10);
+	return s;
+}
+
+// count significant digits, with the decimal point somewhere in them (or before or after them), and an exponent
+static std::string number(std::mt19937& rng, int32_t count, int32_t min_exponent, int32_t max_exponent, bool always_exponent) {
+	auto d = digits(rng, count);
+	std::string s = rng() % 4 == 0 ? "-" : "";
+	auto point = int32_t(rng() % uint32_t(count + 1));
+	if(point == 0)
+		s += "0." + d;
+	else if(point == count)
+		s += d;
+	else
+		s += d.substr(0, point) + "." + d.substr(point);
+	if(always_exponent || rng() % 3 == 0) {
+		auto e = min_exponent + int32_t(rng() % uint32_t(max_exponent - min_exponent + 1));
+		s += (rng() % 2 == 0 ? "e" : "E") + std::to_string(e);
+	}
+	return s;
+}
+
+int main() {
+	std::mt19937 rng(47);
+
+	checker exact{ "short numbers", 0 };
+	for(char const* s : { "0", "1", "-1", "+2.5", ".5", "-.75", "0.1", "0.2", "0.3", "100", "12.345", "1e3", "1E-3", "2.5e+2", "0.000001", "16777216", "16777217", "3.14159", "-0.0" })
+		exact(s);
+	for(int32_t i = 0; i < 200000; ++i)
+		exact(number(rng, 1 + int32_t(rng() % 9), -10, 10, false));
+
+	checker exact_in_path{ "short numbers in path data", 0, "-12.5.25 3,4l5" };
+	checker exact_in_list{ "short numbers in a number list", 0, " 12345678 9" };
+	for(int32_t i = 0; i < 200000; ++i) {
+		auto s = number(rng, 1 + int32_t(rng() % 9), -10, 10, false);
+		exact_in_path(s);
+		exact_in_list(s);
+	}
+
+	checker long_mantissas{ "long mantissas", 1 };
+	for(char const* s : {
+		"3.14159265358979323846264338327950288",
+		"0.1000000000000000055511151231257827021181583404541015625",
+		"1.000000059604644775390625",
+		"1.00000005960464477539062500000001",
+		"0.99999997019767761230468750000001",
+		"123456789012345678901234567890",
+		"0.000000000000000000000000000001234567890123456789012345",
+		"16777217.00000000000000000000001" })
+		long_mantissas(s);
+	for(int32_t i = 0; i < 200000; ++i)
+		long_mantissas(number(rng, 19 + int32_t(rng() % 22), -20, 20, false));
+
+	checker large_exponents{ "large exponents", 1 };
+	for(char const* s : { "1e38", "3.4028234e38", "340282346638528859811704183484516925440", "-3.4e38", "1e-30", "1.17549435e-38", "1.1754942e-38", "1e-40", "1.4e-45", "7e-46", "1e-50", "1e-400", "0e999", "0.0000000001e48", "12345678901234567890123e-60" })
+		large_exponents(s);
+	for(int32_t i = 0; i < 200000; ++i)
+		large_exponents(number(rng, 1 + int32_t(rng() % 30), -60, 36, true));
+
+	for(char const* s : { "3.5e38", "-1e39", "1e400", "99999999999999999999999999999999999999999" }) {
+		testing::check(!parse_lunasvg(s).ok, std::string("lunasvg refuses ") + s + ", which is past the largest float");
+		testing::check(!parse_plutovg(s).ok, std::string("plutovg refuses ") + s + ", which is past the largest float");
+	}
+	for(char const* s : { "", "-", ".", "e5", "1.e5", "1e+" }) {
+		testing::check(!parse_lunasvg(s).ok, std::string("lunasvg refuses \"") + s + "\"");
+		testing::check(!parse_plutovg(s).ok, std::string("plutovg refuses \"") + s + "\"");
+	}
+	testing::check(!parse_plutovg("1e").ok, "plutovg refuses \"1e\"");
+
+	// lunasvg reads lengths, where an e can start a unit; plutovg reads path data and transforms, where it cannot
+	auto em = parse_lunasvg("1.5em");
+	testing::check(em.ok && em.value == 1.5f && em.rest == 2, "lunasvg leaves the em of 1.5em");
+	auto ex = parse_lunasvg("2ex");
+	testing::check(ex.ok && ex.value == 2.0f && ex.rest == 2, "lunasvg leaves the ex of 2ex");
+	auto px = parse_lunasvg("3e2px");
+	testing::check(px.ok && px.value == 300.0f && px.rest == 2, "lunasvg reads the exponent of 3e2px and leaves the px");
+	auto run = parse_plutovg("-1.5.5-2e1");
+	testing::check(run.ok && run.value == -1.5f && run.rest == 6, "plutovg stops -1.5.5-2e1 at the second point");
+
+	return testing::finish("number_parse_tests");
+}
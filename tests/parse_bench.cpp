@@ -0,0 +1,266 @@
+#include "lunasvg.h"
+#include "plutovg.h"
+#include "svgparserutils.h"
+#include "plutovg-utils.h"
+#include "legacy_number_parsing.hpp"
+#include "test_support.hpp"
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <vector>
+#include <cstdlib>
+#include <cctype>
+#include <cmath>
+
+/*
+parses a corpus of large svgs: every number in them through both number parsers, as they are now and as they were
+before they gathered digits into an integer mantissa, then every path's data through plutovg_path_parse as it is now
+and as it was before it had its own tokenizer, and then every whole document
+the numbers are also compared with strtof, which rounds correctly, to count how many each version reads exactly
+the corpus is the svgs named on the command line or, with none, sixteen made up ones in the shape exported themes
+have: long relative paths with two or three decimals and no separators where the svg grammar allows it, polylines,
+matrices and dash arrays
+*/
+
+static void append_number(std::string& s, std::mt19937& rng, float range, int32_t decimals, bool separate) {
+	auto value = (float(rng() % 200001) / 100000.0f - 1.0f) * range;
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), "%.*f", int(decimals), double(value));
+	std::string_view text = buffer;
+	// exporters drop the zero before the point, and the separator before a minus sign or before a second point
+	if(text.substr(0, 2) == "0.") {
+		text.remove_prefix(1);
+	} else if(text.substr(0, 3) == "-0.") {
+		s += '-';
+		text.remove_prefix(2);
+	}
+	if(separate && text.front() != '-' && s.back() != '-') {
+		auto previous = s.find_last_not_of("0123456789.");
+		bool previous_has_point = s.find('.', previous == std::string::npos ? 0 : previous + 1) != std::string::npos;
+		if(text.front() != '.' || !previous_has_point)
+			s += ' ';
+	}
+	s += text;
+}
+
+static std::string made_up_svg(uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::string s = "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"512\" height=\"512\" viewBox=\"0 0 512 512\">\n";
+	for(int32_t group = 0; group < 40; ++group) {
+		s += "<g transform=\"matrix(";
+		for(int32_t i = 0; i < 6; ++i) {
+			if(i > 0)
+				s += ',';
+			append_number(s, rng, i < 4 ? 1.5f : 256.0f, 4, false);
+		}
+		s += ")\">\n";
+		for(int32_t shape = 0; shape < 6; ++shape) {
+			s += "<path fill=\"#3a5f8c\" stroke=\"#102030\" stroke-width=\"1.25\" d=\"M";
+			append_number(s, rng, 256.0f, 3, false);
+			append_number(s, rng, 256.0f, 3, true);
+			auto segments = 40 + int32_t(rng() % 80);
+			for(int32_t i = 0; i < segments; ++i) {
+				auto command = "clsqc"[rng() % 5];
+				s += command;
+				auto count = command == 'c' ? 6 : (command == 's' || command == 'q') ? 4 : 2;
+				for(int32_t j = 0; j < count; ++j)
+					append_number(s, rng, 24.0f, 2 + int32_t(rng() % 2), j > 0);
+			}
+			s += "z\"/>\n";
+		}
+		s += "<polyline fill=\"none\" stroke=\"#c0c0c0\" stroke-dasharray=\"";
+		for(int32_t i = 0; i < 4; ++i) {
+			if(i > 0)
+				s += ' ';
+			append_number(s, rng, 8.0f, 2, false);
+		}
+		s += "\" points=\"";
+		for(int32_t i = 0; i < 60; ++i) {
+			if(i > 0)
+				s += ' ';
+			append_number(s, rng, 256.0f, 2, false);
+			s += ',';
+			append_number(s, rng, 256.0f, 2, false);
+		}
+		s += "\"/>\n<rect x=\"";
+		append_number(s, rng, 256.0f, 3, false);
+		s += "\" y=\"";
+		append_number(s, rng, 256.0f, 3, false);
+		s += "\" width=\"12.5\" height=\"8.75\" rx=\"1.5e-1\" opacity=\".85\"/>\n</g>\n";
+	}
+	s += "</svg>\n";
+	return s;
+}
+
+// a number and the rest of its attribute from where it starts, which is what the parsers are given: they may look past
+// the end of the number, as far as the end of the attribute
+struct number_in_attribute {
+	std::string_view text;
+	std::string_view rest;
+};
+
+// every number in the attributes that hold numbers, the way the parsers meet them: where one number stops the next may
+// start at once, and the letters between them are path commands, transform names and units
+static std::vector<number_in_attribute> numbers_in(std::string const& svg) {
+	static constexpr std::string_view numeric[] = {
+		"d", "points", "transform", "viewBox", "x", "y", "x1", "y1", "x2", "y2", "cx", "cy", "r", "rx", "ry", "width",
+		"height", "stroke-width", "stroke-dasharray", "stroke-dashoffset", "opacity", "fill-opacity", "stroke-opacity",
+		"offset", "font-size"
+	};
+	std::vector<number_in_attribute> result;
+	for(size_t at = svg.find("=\""); at != std::string::npos; at = svg.find("=\"", at + 2)) {
+		auto name_start = at;
+		while(name_start > 0 && (std::isalnum((unsigned char)(svg[name_start - 1])) || svg[name_start - 1] == '-'))
+			--name_start;
+		auto name = std::string_view(svg.data() + name_start, at - name_start);
+		auto end = svg.find('"', at + 2);
+		if(end == std::string::npos)
+			break;
+		if(std::find(std::begin(numeric), std::end(numeric), name) == std::end(numeric))
+			continue;
+		char const* it = svg.data() + at + 2;
+		char const* value_end = svg.data() + end;
+		while(it < value_end) {
+			char const* start = it;
+			float value = 0.0f;
+			if(plutovg_parse_number(&it, value_end, &value))
+				result.push_back(number_in_attribute{ std::string_view(start, size_t(it - start)), std::string_view(start, size_t(value_end - start)) });
+			else
+				it = start + 1;
+		}
+		at = end;
+	}
+	return result;
+}
+
+static std::vector<std::string_view> path_data_in(std::string const& svg) {
+	std::vector<std::string_view> result;
+	for(size_t at = svg.find(" d=\""); at != std::string::npos; at = svg.find(" d=\"", at + 4)) {
+		auto end = svg.find('"', at + 4);
+		if(end == std::string::npos)
+			break;
+		result.emplace_back(svg.data() + at + 4, end - at - 4);
+	}
+	return result;
+}
+
+static double megabytes_per_second(size_t bytes, double ms) {
+	return double(bytes) / (1024.0 * 1024.0) / (ms / 1000.0);
+}
+
+int main(int argc, char** argv) {
+	std::vector<std::string> corpus;
+	for(int i = 1; i < argc; ++i) {
+		std::ifstream file(argv[i], std::ios::binary);
+		std::stringstream contents;
+		contents << file.rdbuf();
+		if(!file || contents.str().empty()) {
+			std::printf("could not read %s\n", argv[i]);
+			return 1;
+		}
+		corpus.push_back(contents.str());
+	}
+	if(corpus.empty()) {
+		for(uint32_t seed = 1; seed <= 16; ++seed)
+			corpus.push_back(made_up_svg(seed));
+	}
+
+	size_t corpus_bytes = 0;
+	std::vector<number_in_attribute> numbers;
+	std::vector<std::string_view> paths;
+	for(auto& svg : corpus) {
+		corpus_bytes += svg.size();
+		auto n = numbers_in(svg);
+		numbers.insert(numbers.end(), n.begin(), n.end());
+		auto p = path_data_in(svg);
+		paths.insert(paths.end(), p.begin(), p.end());
+	}
+	size_t number_bytes = 0;
+	for(auto& n : numbers)
+		number_bytes += n.text.size();
+	size_t path_bytes = 0;
+	for(auto p : paths)
+		path_bytes += p.size();
+	std::printf("%zu svgs, %zu bytes, %zu numbers, %zu paths\n\n", corpus.size(), corpus_bytes, numbers.size(), paths.size());
+
+	// the sum is printed so that the parsing cannot be left out
+	float sum = 0.0f;
+	auto time_numbers = [&](auto&& parse) {
+		return testing::time_ms(5, [&]() {
+			for(auto& n : numbers) {
+				float value = 0.0f;
+				parse(n.rest, value);
+				sum += value;
+			}
+		});
+	};
+	auto count_exact = [&](auto&& parse) {
+		size_t exact = 0;
+		for(auto& n : numbers) {
+			float value = 0.0f;
+			parse(n.rest, value);
+			exact += value == std::strtof(std::string(n.text).c_str(), nullptr) ? 1 : 0;
+		}
+		return exact;
+	};
+	auto old_lunasvg = [](std::string_view n, float& value) { legacy::parse_number(n, value); };
+	auto new_lunasvg = [](std::string_view n, float& value) { lunasvg::parseNumber(n, value); };
+	auto old_plutovg = [](std::string_view n, float& value) { char const* it = n.data(); legacy::plutovg_parse_number(&it, n.data() + n.size(), &value); };
+	auto new_plutovg = [](std::string_view n, float& value) { char const* it = n.data(); plutovg_parse_number(&it, n.data() + n.size(), &value); };
+
+	std::printf("%-18s %10s %10s %9s %14s %14s\n", "numbers", "old MB/s", "new MB/s", "speedup", "old exact", "new exact");
+	auto old_ms = time_numbers(old_lunasvg);
+	auto new_ms = time_numbers(new_lunasvg);
+	std::printf("%-18s %10.1f %10.1f %8.2fx %14zu %14zu\n", "lunasvg", megabytes_per_second(number_bytes, old_ms), megabytes_per_second(number_bytes, new_ms), old_ms / new_ms, count_exact(old_lunasvg), count_exact(new_lunasvg));
+	old_ms = time_numbers(old_plutovg);
+	new_ms = time_numbers(new_plutovg);
+	std::printf("%-18s %10.1f %10.1f %8.2fx %14zu %14zu\n\n", "plutovg", megabytes_per_second(number_bytes, old_ms), megabytes_per_second(number_bytes, new_ms), old_ms / new_ms, count_exact(old_plutovg), count_exact(new_plutovg));
+
+	auto path = plutovg_path_create();
+	auto time_paths = [&](auto&& parse) {
+		return testing::time_ms(5, [&]() {
+			for(auto p : paths) {
+				plutovg_path_reset(path);
+				parse(path, p.data(), int(p.size()));
+			}
+		});
+	};
+	auto old_paths_ms = time_paths(legacy::plutovg_path_parse);
+	auto paths_ms = time_paths(plutovg_path_parse);
+	// both have to build the same elements, with points no further apart than the old number parser's rounding explains
+	size_t same_paths = 0;
+	auto old_path = plutovg_path_create();
+	for(auto p : paths) {
+		plutovg_path_reset(path);
+		plutovg_path_reset(old_path);
+		plutovg_path_parse(path, p.data(), int(p.size()));
+		legacy::plutovg_path_parse(old_path, p.data(), int(p.size()));
+		plutovg_path_element_t const* elements = nullptr;
+		plutovg_path_element_t const* old_elements = nullptr;
+		auto count = plutovg_path_get_elements(path, &elements);
+		auto old_count = plutovg_path_get_elements(old_path, &old_elements);
+		bool same = count == old_count;
+		for(int32_t i = 0; same && i < count; i += elements[i].header.length) {
+			same = elements[i].header.command == old_elements[i].header.command && elements[i].header.length == old_elements[i].header.length;
+			for(int32_t j = 1; same && j < elements[i].header.length; ++j) {
+				same = std::abs(elements[i + j].point.x - old_elements[i + j].point.x) < 0.001f && std::abs(elements[i + j].point.y - old_elements[i + j].point.y) < 0.001f;
+			}
+		}
+		same_paths += same ? 1 : 0;
+	}
+	plutovg_path_destroy(old_path);
+	plutovg_path_destroy(path);
+	size_t loaded = 0;
+	auto documents_ms = testing::time_ms(5, [&]() {
+		loaded = 0;
+		for(auto& svg : corpus) {
+			auto doc = lunasvg::Document::loadFromData(svg.data(), svg.size(), [](std::string_view) { return lunasvg::Bitmap{ }; });
+			loaded += doc ? 1 : 0;
+		}
+	});
+	std::printf("%-18s %10s %10s %9s\n", "", "old MB/s", "new MB/s", "speedup");
+	std::printf("%-18s %10.1f %10.1f %8.2fx\n", "path data", megabytes_per_second(path_bytes, old_paths_ms), megabytes_per_second(path_bytes, paths_ms), old_paths_ms / paths_ms);
+	std::printf("%-18s %10s %10.1f\n", "whole documents", "", megabytes_per_second(corpus_bytes, documents_ms));
+	std::printf("\n(%zu of %zu paths built the same by both, %zu of %zu documents loaded, sum %g)\n", same_paths, paths.size(), loaded, corpus.size(), double(sum));
+	return 0;
+}
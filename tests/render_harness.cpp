@@ -0,0 +1,347 @@
+#include "asvg.hpp"
+#include "templateproject.hpp"
+#include "stools.hpp"
+#include "filesystem.hpp"
+#include "plutovg.h"
+#include "test_support.hpp"
+#include <new>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <psapi.h>
+#endif
+
+/*
+renders the templates of a .tui without a gpu: each background and icon in the .tui's svg_directory is rendered at a
+matrix of sizes, grid sizes and the .tui's colors through svg::render_pixels and simple_svg::render_pixels, which are
+make_new_render without the texture upload, and at the scale the editor uses
+each render is compared with a golden png: a pixel differs if any of its premultiplied channels is more than the
+tolerance away from the golden's, and the render fails if more than max_differing percent of its pixels differ, which
+leaves room for the edges a different compiler rounds the other way
+per file it reports, as json, the render time (the fastest of the runs), how many allocations the renders made and how
+many bytes they held at their peak; the bitmaps are allocated by plutovg with malloc and are not among them, so their
+size is reported separately
+render_harness [file.tui] [--update] [--golden directory] [--report file.json] [--tolerance n] [--max-differing percent] [--runs n]
+the .tui is tests/render_corpus/the.tui if none is given, the goldens are in the golden directory next to it, and the
+report is written next to the executable; --update writes the goldens instead of comparing with them
+*/
+
+namespace template_project {
+project bytes_to_project(serialization::in_buffer& buffer);
+}
+
+// every allocation through operator new, and the bytes held; each block carries its size in front of it so that
+// deleting it can take it off again
+namespace {
+size_t allocations = 0;
+size_t allocated_bytes = 0;
+size_t live_bytes = 0;
+size_t peak_bytes = 0;
+constexpr size_t size_header = alignof(std::max_align_t);
+}
+
+void* operator new(size_t size) {
+	auto block = static_cast<char*>(std::malloc(size + size_header));
+	if(!block)
+		throw std::bad_alloc{ };
+	std::memcpy(block, &size, sizeof(size));
+	++allocations;
+	allocated_bytes += size;
+	live_bytes += size;
+	peak_bytes = std::max(peak_bytes, live_bytes);
+	return block + size_header;
+}
+void operator delete(void* p) noexcept {
+	if(!p)
+		return;
+	auto block = static_cast<char*>(p) - size_header;
+	size_t size = 0;
+	std::memcpy(&size, block, sizeof(size));
+	live_bytes -= size;
+	std::free(block);
+}
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+void operator delete[](void* p) noexcept {
+	operator delete(p);
+}
+void operator delete(void* p, size_t) noexcept {
+	operator delete(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+	operator delete(p);
+}
+
+struct heap_use {
+	size_t allocations = 0;
+	size_t allocated_bytes = 0;
+	size_t peak_bytes = 0; // above what was held when it started
+};
+
+// what f allocates and the most it holds at once
+template<typename F>
+heap_use measure_heap(F&& f) {
+	auto allocations_before = allocations;
+	auto bytes_before = allocated_bytes;
+	auto live_before = live_bytes;
+	peak_bytes = live_bytes;
+	f();
+	return heap_use{ allocations - allocations_before, allocated_bytes - bytes_before, peak_bytes - live_before };
+}
+
+static size_t process_peak_memory() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters{ };
+	if(K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return size_t(counters.PeakWorkingSetSize);
+#endif
+	return 0;
+}
+
+struct render_size {
+	int32_t x = 0;
+	int32_t y = 0;
+};
+// in grid cells; icons are rendered at the same number of pixels as a background of that size
+static constexpr render_size sizes[] = { { 2, 1 }, { 4, 3 }, { 7, 2 } };
+static constexpr int32_t grid_sizes[] = { 10, 16 };
+static constexpr float editor_scale = 2.0f;
+
+struct options {
+	std::wstring tui = L"tests/render_corpus/the.tui";
+	std::wstring golden_directory;
+	std::wstring report;
+	int32_t tolerance = 8;
+	double max_differing = 0.5;
+	int32_t runs = 3;
+	bool update = false;
+};
+
+struct comparison {
+	bool golden_found = false;
+	bool same_size = false;
+	int32_t largest_difference = 0;
+	size_t differing_pixels = 0;
+};
+
+// both images premultiplied, as plutovg keeps them, so that the color of a pixel that is not there does not count
+static comparison compare_with_golden(lunasvg::Bitmap const& render, std::wstring const& golden_path, int32_t tolerance) {
+	comparison result;
+	auto golden = plutovg_surface_load_from_image_file(fs::native_to_utf8(golden_path).c_str());
+	if(!golden)
+		return result;
+	result.golden_found = true;
+	result.same_size = plutovg_surface_get_width(golden) == render.width() && plutovg_surface_get_height(golden) == render.height();
+	if(result.same_size) {
+		auto golden_data = plutovg_surface_get_data(golden);
+		auto golden_stride = plutovg_surface_get_stride(golden);
+		for(int32_t y = 0; y < render.height(); ++y) {
+			auto a = render.data() + size_t(y) * size_t(render.stride());
+			auto b = golden_data + size_t(y) * size_t(golden_stride);
+			for(int32_t x = 0; x < render.width() * 4; x += 4) {
+				int32_t largest = 0;
+				for(int32_t c = 0; c < 4; ++c)
+					largest = std::max(largest, std::abs(int32_t(a[x + c]) - int32_t(b[x + c])));
+				result.largest_difference = std::max(result.largest_difference, largest);
+				if(largest > tolerance)
+					++result.differing_pixels;
+			}
+		}
+	}
+	plutovg_surface_destroy(golden);
+	return result;
+}
+
+static std::wstring file_stem(std::string const& file_name) {
+	auto name = fs::utf8_to_native(file_name);
+	auto dot = name.find_last_of(L'.');
+	return dot == std::wstring::npos ? name : name.substr(0, dot);
+}
+
+static std::string hex_color(template_project::color_definition const& c) {
+	char buffer[8];
+	std::snprintf(buffer, sizeof(buffer), "%02x%02x%02x", unsigned(c.r * 255.0f) & 0xFF, unsigned(c.g * 255.0f) & 0xFF, unsigned(c.b * 255.0f) & 0xFF);
+	return buffer;
+}
+
+static std::string json_string(std::string_view s) {
+	std::string result = "\"";
+	for(auto c : s) {
+		if(c == '"' || c == '\\')
+			result += '\\';
+		result += c;
+	}
+	return result + "\"";
+}
+
+class harness {
+	options const& opts;
+	std::vector<template_project::color_definition> colors;
+	std::string report;
+	bool first_file = true;
+public:
+	harness(options const& opts, std::vector<template_project::color_definition> const& project_colors) : opts(opts), colors(project_colors) {
+		if(colors.empty())
+			colors.emplace_back();
+	}
+
+	// render(size, grid size, color, bitmap) renders one cell of the matrix
+	template<typename F>
+	void run_file(std::string const& file_name, char const* kind, F&& render) {
+		std::string entries;
+		double total_ms = 0.0;
+		double slowest_ms = 0.0;
+		heap_use total_heap;
+		size_t largest_bitmap = 0;
+		int32_t count = 0;
+
+		for(auto size : sizes) {
+			for(auto grid_size : grid_sizes) {
+				for(auto& color : colors) {
+					auto name = file_stem(file_name) + L"_" + std::to_wstring(size.x) + L"x" + std::to_wstring(size.y) + L"_g" + std::to_wstring(grid_size) + L"_" + fs::utf8_to_native(hex_color(color));
+					auto what = fs::native_to_utf8(name);
+
+					lunasvg::Bitmap bmp;
+					bool rendered = false;
+					auto heap = measure_heap([&]() { rendered = render(size, grid_size, color, bmp); });
+					testing::check(rendered && !bmp.isNull(), what + ": renders");
+					if(!rendered || bmp.isNull())
+						continue;
+					auto ms = testing::time_ms(opts.runs, [&]() {
+						lunasvg::Bitmap again;
+						render(size, grid_size, color, again);
+					});
+
+					// back to the premultiplied pixels png writing and comparing expect
+					plutovg_convert_rgba_to_argb(bmp.data(), bmp.data(), bmp.width(), bmp.height(), bmp.stride());
+					auto golden_path = opts.golden_directory + name + L".png";
+					comparison result;
+					if(opts.update) {
+						testing::check(bmp.writeToPng(fs::native_to_utf8(golden_path)), what + ": golden written");
+					} else {
+						result = compare_with_golden(bmp, golden_path, opts.tolerance);
+						auto pixels = size_t(bmp.width()) * size_t(bmp.height());
+						testing::check(result.golden_found, what + ": has a golden png");
+						testing::check(!result.golden_found || result.same_size, what + ": is the size of its golden png");
+						testing::check(!result.same_size || double(result.differing_pixels) * 100.0 <= opts.max_differing * double(pixels),
+							what + ": " + std::to_string(result.differing_pixels) + " of " + std::to_string(pixels) + " pixels differ from the golden png by more than " + std::to_string(opts.tolerance) + " (at most " + std::to_string(result.largest_difference) + ")");
+					}
+
+					auto bitmap_bytes = size_t(bmp.height()) * size_t(bmp.stride());
+					char entry[512];
+					std::snprintf(entry, sizeof(entry),
+						"%s\n\t\t\t\t{ \"width\": %d, \"height\": %d, \"grid_size\": %d, \"color\": \"%s\", \"pixels\": \"%dx%d\", \"render_ms\": %.4f, \"allocations\": %zu, \"allocated_bytes\": %zu, \"peak_heap_bytes\": %zu, \"bitmap_bytes\": %zu, \"largest_difference\": %d, \"differing_pixels\": %zu }",
+						count == 0 ? "" : ",", int(size.x), int(size.y), int(grid_size), hex_color(color).c_str(), bmp.width(), bmp.height(), ms, heap.allocations, heap.allocated_bytes, heap.peak_bytes, bitmap_bytes, int(result.largest_difference), result.differing_pixels);
+					entries += entry;
+
+					total_ms += ms;
+					slowest_ms = std::max(slowest_ms, ms);
+					total_heap.allocations += heap.allocations;
+					total_heap.allocated_bytes += heap.allocated_bytes;
+					total_heap.peak_bytes = std::max(total_heap.peak_bytes, heap.peak_bytes);
+					largest_bitmap = std::max(largest_bitmap, bitmap_bytes);
+					++count;
+				}
+			}
+		}
+
+		char summary[512];
+		std::snprintf(summary, sizeof(summary),
+			"%s\n\t\t{\n\t\t\t\"file\": %s, \"kind\": \"%s\", \"renders\": %d, \"render_ms\": %.4f, \"slowest_render_ms\": %.4f, \"allocations\": %zu, \"allocated_bytes\": %zu, \"peak_heap_bytes\": %zu, \"largest_bitmap_bytes\": %zu,\n\t\t\t\"matrix\": [",
+			first_file ? "" : ",", json_string(file_name).c_str(), kind, int(count), total_ms, slowest_ms, total_heap.allocations, total_heap.allocated_bytes, total_heap.peak_bytes, largest_bitmap);
+		report += summary;
+		report += entries;
+		report += "\n\t\t\t]\n\t\t}";
+		first_file = false;
+		std::printf("%-24s %-10s %3d renders %9.3f ms %8zu allocations %10zu peak heap bytes\n", file_name.c_str(), kind, int(count), total_ms, total_heap.allocations, total_heap.peak_bytes);
+	}
+
+	std::string finish_report() {
+		char header[256];
+		std::snprintf(header, sizeof(header), "{\n\t\"scale\": %g, \"tolerance\": %d, \"max_differing_percent\": %g, \"runs\": %d,\n\t\"files\": [",
+			double(editor_scale), int(opts.tolerance), opts.max_differing, int(opts.runs));
+		char footer[128];
+		std::snprintf(footer, sizeof(footer), "\n\t],\n\t\"process_peak_memory_bytes\": %zu\n}\n", process_peak_memory());
+		return header + report + footer;
+	}
+};
+
+static std::wstring directory_of(std::wstring const& path) {
+	auto slash = path.find_last_of(L"/\\");
+	return slash == std::wstring::npos ? std::wstring{ } : path.substr(0, slash + 1);
+}
+
+int main(int argc, char** argv) {
+	options opts;
+	for(int i = 1; i < argc; ++i) {
+		std::string_view arg = argv[i];
+		bool has_value = i + 1 < argc;
+		if(arg == "--update") {
+			opts.update = true;
+		} else if(arg == "--golden" && has_value) {
+			opts.golden_directory = fs::utf8_to_native(argv[++i]);
+			if(opts.golden_directory.back() != L'/' && opts.golden_directory.back() != L'\\')
+				opts.golden_directory += L'/';
+		} else if(arg == "--report" && has_value) {
+			opts.report = fs::utf8_to_native(argv[++i]);
+		} else if(arg == "--tolerance" && has_value) {
+			opts.tolerance = std::atoi(argv[++i]);
+		} else if(arg == "--max-differing" && has_value) {
+			opts.max_differing = std::atof(argv[++i]);
+		} else if(arg == "--runs" && has_value) {
+			opts.runs = std::max(1, std::atoi(argv[++i]));
+		} else {
+			opts.tui = fs::utf8_to_native(argv[i]);
+		}
+	}
+	auto project_directory = directory_of(opts.tui);
+	if(opts.golden_directory.empty())
+		opts.golden_directory = project_directory + L"golden/";
+	if(opts.report.empty())
+		opts.report = directory_of(fs::utf8_to_native(argv[0])) + L"render_report.json";
+
+	template_project::project templates;
+	{
+		fs::file loaded_file{ opts.tui };
+		if(!loaded_file.content().data) {
+			testing::check(false, fs::native_to_utf8(opts.tui) + " can be read");
+			return testing::finish("render_harness");
+		}
+		serialization::in_buffer file_content{ loaded_file.content().data, loaded_file.content().file_size };
+		templates = template_project::bytes_to_project(file_content);
+	}
+	// as the editor opens a project
+	auto svg_directory = project_directory + templates.svg_directory;
+	asvg::common_file_bank::bank.set_root_directory(svg_directory);
+	testing::check(!templates.backgrounds.empty() || !templates.icons.empty(), fs::native_to_utf8(opts.tui) + " has templates to render");
+
+	harness h(opts, templates.colors);
+	for(auto& b : templates.backgrounds) {
+		fs::file loaded_file{ svg_directory + fs::utf8_to_native(b.file_name) };
+		testing::check(loaded_file.content().data != nullptr, b.file_name + " can be read");
+		if(!loaded_file.content().data)
+			continue;
+		asvg::svg s(loaded_file.content().data, size_t(loaded_file.content().file_size), b.base_x, b.base_y);
+		h.run_file(b.file_name, "background", [&](render_size size, int32_t grid_size, template_project::color_definition const& c, lunasvg::Bitmap& bmp) {
+			return s.render_pixels(float(size.x), float(size.y), grid_size, editor_scale, c.r, c.g, c.b, bmp);
+		});
+	}
+	for(auto& i : templates.icons) {
+		fs::file loaded_file{ svg_directory + fs::utf8_to_native(i.file_name) };
+		testing::check(loaded_file.content().data != nullptr, i.file_name + " can be read");
+		if(!loaded_file.content().data)
+			continue;
+		asvg::simple_svg s(loaded_file.content().data, size_t(loaded_file.content().file_size));
+		h.run_file(i.file_name, "icon", [&](render_size size, int32_t grid_size, template_project::color_definition const& c, lunasvg::Bitmap& bmp) {
+			return s.render_pixels(size.x * grid_size, size.y * grid_size, editor_scale, c.r, c.g, c.b, bmp);
+		});
+	}
+
+	auto report = h.finish_report();
+	testing::check(fs::write_file(opts.report, report.data(), uint32_t(report.size())), "the report is written to " + fs::native_to_utf8(opts.report));
+	return testing::finish("render_harness");
+}
@@ -0,0 +1,100 @@
+#include "project_description.hpp"
+#include "templateproject.hpp"
+#include "stools.hpp"
+#include "filesystem.hpp"
+#include "sample_project.hpp"
+#include "sample_templates.hpp"
+#include "test_support.hpp"
+#include <cstring>
+
+/*
+that the .aui and .tui files keep their layout on disk: each project is saved, loaded and saved again, and the bytes
+have to come out the same every time
+sample_project.aui and sample_templates.tui were saved by the schema writers from sample_project.hpp and
+sample_templates.hpp, after the bake_layouts header flag and the nine-slice field were added, so matching them shows
+that the layout has not changed since then, not that the schemas kept the layout of the hand-written writers before
+them; their wide strings (the source path and the svg directory) were then narrowed to two bytes a character, as the
+editor saves them on windows
+any other .aui or .tui files named on the command line (last saved by this version of the editor) are loaded, saved
+and compared as well
+*/
+
+open_project_t bytes_to_project(serialization::in_buffer& buffer);
+void project_to_bytes(open_project_t const& p, serialization::out_buffer& buffer);
+namespace template_project {
+project bytes_to_project(serialization::in_buffer& buffer);
+void project_to_bytes(project const& p, serialization::out_buffer& buffer);
+}
+
+static std::string_view bytes_of(serialization::out_buffer const& b) {
+	return std::string_view(b.data(), b.size());
+}
+
+static std::string resave_project(std::string_view bytes) {
+	serialization::in_buffer in(bytes.data(), bytes.size());
+	auto p = bytes_to_project(in);
+	serialization::out_buffer out;
+	project_to_bytes(p, out);
+	return std::string(bytes_of(out));
+}
+static std::string resave_templates(std::string_view bytes) {
+	serialization::in_buffer in(bytes.data(), bytes.size());
+	auto p = template_project::bytes_to_project(in);
+	serialization::out_buffer out;
+	template_project::project_to_bytes(p, out);
+	return std::string(bytes_of(out));
+}
+
+static std::string file_contents(std::wstring const& path) {
+	fs::file f{ path };
+	auto c = f.content();
+	return c.data ? std::string(c.data, c.file_size) : std::string();
+}
+
+static bool ends_with(std::wstring const& s, std::wstring const& suffix) {
+	return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int main(int argc, char** argv) {
+	{
+		auto golden = file_contents(L"tests/sample_project.aui");
+		testing::check(!golden.empty(), "tests/sample_project.aui can be read");
+
+		serialization::out_buffer out;
+		project_to_bytes(testing::make_sample_project(12, 12), out);
+		testing::check(bytes_of(out) == golden, ".aui: the sample project is saved exactly as tests/sample_project.aui");
+		testing::check(resave_project(golden) == golden, ".aui: tests/sample_project.aui is saved again unchanged");
+
+		serialization::out_buffer large;
+		project_to_bytes(testing::make_sample_project(120, 60), large);
+		testing::check(resave_project(bytes_of(large)) == bytes_of(large), ".aui: a large project is saved again unchanged");
+	}
+	{
+		auto golden = file_contents(L"tests/sample_templates.tui");
+		testing::check(!golden.empty(), "tests/sample_templates.tui can be read");
+
+		serialization::out_buffer out;
+		template_project::project_to_bytes(testing::make_sample_templates(3), out);
+		testing::check(bytes_of(out) == golden, ".tui: the sample templates are saved exactly as tests/sample_templates.tui");
+		testing::check(resave_templates(golden) == golden, ".tui: tests/sample_templates.tui is saved again unchanged");
+
+		// a templates file cut short anywhere loads without reading past its end (a cut .aui file is not, since it
+		// aborts on the first property it does not know)
+		for(size_t length = 0; length < golden.size(); ++length)
+			resave_templates(std::string_view(golden.data(), length));
+	}
+	for(int i = 1; i < argc; ++i) {
+		auto path = fs::utf8_to_native(argv[i]);
+		auto contents = file_contents(path);
+		if(contents.empty()) {
+			testing::check(false, std::string(argv[i]) + " can be read");
+		} else if(ends_with(path, L".aui")) {
+			testing::check(resave_project(contents) == contents, std::string(argv[i]) + " is saved again unchanged");
+		} else if(ends_with(path, L".tui")) {
+			testing::check(resave_templates(contents) == contents, std::string(argv[i]) + " is saved again unchanged");
+		} else {
+			testing::check(false, std::string(argv[i]) + " is an .aui or .tui file");
+		}
+	}
+	return testing::finish("round_trip_tests");
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <string>
+#include <algorithm>
+#include "project_description.hpp"
+
+/*
+a made up project of any size that sets every kind of record and most of the optional properties .aui files can hold,
+for the tests and benchmarks that need a project without shipping one; the same arguments always make the same project
+*/
+namespace testing {
+
+inline open_project_t make_sample_project(int32_t window_count, int32_t controls_per_window) {
+	open_project_t p;
+	p.project_name = L"sample";
+	p.source_path = L"sample_generated.cpp";
+	p.grid_size = 9;
+
+	int32_t table_count = std::max(window_count / 10, 1);
+	// the last windows are the rows the generators of the others insert; they have no generators of their own, since
+	// the editor expects generators not to insert, however indirectly, the window they are in
+	int32_t first_row_window = window_count - std::max(window_count / 10, 1);
+	for(int32_t t = 0; t < table_count; ++t) {
+		table_definition tab;
+		tab.name = "table_" + std::to_string(t);
+		tab.ascending_sort_icon = "sort_up.svg";
+		tab.descending_sort_icon = "sort_down.svg";
+		tab.highlight_color = color4f{ 0.5f, 0.5f, 0.0f, 0.25f };
+		tab.divider_color = color3f{ 0.1f, 0.1f, 0.1f };
+		tab.has_highlight_color = (t % 2) == 0;
+		for(int32_t c = 0; c < 4; ++c) {
+			full_col_data col;
+			col.internal_data.column_name = "column_" + std::to_string(c);
+			col.internal_data.container = c == 3 ? "window_0" : "";
+			col.internal_data.cell_type = c == 3 ? table_cell_type::container : table_cell_type::text;
+			col.internal_data.sortable = c != 0;
+			col.internal_data.has_dy_cell_tooltip = c == 1;
+			col.display_data.header_key = "header_" + std::to_string(c);
+			col.display_data.header_tooltip_key = c == 2 ? "header_tooltip" : "";
+			col.display_data.cell_tooltip_key = c == 1 ? "cell_tooltip" : "";
+			col.display_data.width = int16_t(40 + c * 10);
+			col.display_data.text_alignment = aui_text_alignment(c % 3);
+			tab.table_columns.push_back(std::move(col));
+		}
+		p.tables.push_back(std::move(tab));
+	}
+
+	for(int32_t w = 0; w < window_count; ++w) {
+		window_element_wrapper_t win;
+		auto& wd = win.wrapped;
+		wd.name = "window_" + std::to_string(w);
+		wd.parent = w == 0 ? "" : "window_0";
+		wd.x_pos = int16_t(w % 50);
+		wd.y_pos = int16_t(w % 30);
+		wd.x_size = 400;
+		wd.y_size = 300;
+		wd.border_size = int16_t(w % 3 == 0 ? 8 : 0);
+		wd.background = w % 4 == 0 ? background_type::bordered_texture : background_type::texture;
+		wd.texture = "window_bg_" + std::to_string(w % 7) + ".dds";
+		wd.draggable = (w % 2) == 0;
+		wd.orientation = orientation::center;
+		wd.members.push_back(data_member{ "int32_t", "selected" });
+		if(w % 5 == 0) {
+			wd.page_left_texture = "page_left.dds";
+			wd.page_right_texture = "page_right.dds";
+		}
+		if(w % 10 == 1)
+			wd.table_connection = "table_" + std::to_string((w / 10) % table_count);
+
+		for(int32_t c = 0; c < controls_per_window; ++c) {
+			ui_element_t e;
+			e.name = "control_" + std::to_string(c);
+			e.x_pos = int16_t((c % 10) * 36);
+			e.y_pos = int16_t((c / 10) * 27);
+			e.x_size = 36;
+			e.y_size = 27;
+			switch(c % 6) {
+				case 0:
+					e.background = background_type::texture;
+					e.texture = "button_" + std::to_string(c % 5) + ".dds";
+					e.text_key = "button_text_" + std::to_string(c);
+					e.left_click_action = true;
+					e.tooltip_text_key = "button_tooltip";
+					break;
+				case 1:
+					e.text_key = "label_" + std::to_string(c);
+					e.text_color = text_color::white;
+					e.text_align = aui_text_alignment::center;
+					e.dynamic_text = true;
+					break;
+				case 2:
+					e.background = background_type::icon_strip;
+					e.texture = "icons.dds";
+					e.dynamic_element = true;
+					e.dynamic_tooltip = true;
+					break;
+				case 3:
+					e.container_type = container_type::list;
+					e.list_content = "window_" + std::to_string((w + 1) % window_count);
+					e.members.push_back(data_member{ "dcon::nation_id", "content" });
+					break;
+				case 4:
+					e.background = background_type::linechart;
+					e.datapoints = 40;
+					e.other_color = color4f{ 0.0f, 1.0f, 0.0f, 1.0f };
+					break;
+				case 5:
+					e.container_type = container_type::table;
+					e.table_connection = "table_" + std::to_string(w % table_count);
+					e.ascending_sort_icon = "sort_up.svg";
+					e.descending_sort_icon = "sort_down.svg";
+					e.row_background_a = "row_a.dds";
+					e.row_background_b = "row_b.dds";
+					e.row_height = 1.5f;
+					e.has_table_highlight_color = true;
+					e.table_highlight_color = color4f{ 1.0f, 1.0f, 0.0f, 0.5f };
+					break;
+			}
+			win.children.push_back(std::move(e));
+		}
+
+		// every kind of layout item: the controls, in pages, with a nested level and a generator
+		win.layout.type = layout_type::multiline_vertical;
+		win.layout.paged = true;
+		win.layout.size_x = 400;
+		win.layout.size_y = 300;
+		win.layout.contents.push_back(texture_layer_t{ background_type::texture, "layer.dds" });
+		auto nested = make_sub_layout(win);
+		get_sub_layout(win, nested).type = layout_type::single_horizontal;
+		for(int32_t c = 0; c < controls_per_window; ++c) {
+			layout_control_t lc;
+			lc.name = "control_" + std::to_string(c);
+			lc.fill_x = (c % 3) == 0;
+			if(c % 4 == 0)
+				get_sub_layout(win, nested).contents.push_back(std::move(lc));
+			else
+				win.layout.contents.push_back(std::move(lc));
+			if(c % 8 == 7)
+				win.layout.contents.push_back(layout_glue_t{ glue_type::at_least, int16_t(c % 5) });
+		}
+		win.layout.contents.push_back(nested);
+		win.layout.contents.push_back(layout_window_t{ "window_" + std::to_string((w + 2) % window_count) });
+		if(w < first_row_window) {
+			generator_t gen;
+			gen.name = "rows";
+			gen.inserts.push_back(generator_item{ "window_" + std::to_string(first_row_window + w % (window_count - first_row_window)), "header", "", -1, 2, glue_type::standard, true });
+			win.layout.contents.push_back(std::move(gen));
+		}
+
+		p.windows.push_back(std::move(win));
+	}
+	return p;
+}
+
+}
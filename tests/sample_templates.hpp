@@ -0,0 +1,208 @@
+#pragma once
+#include <string>
+#include <cstring>
+#include "templateproject.hpp"
+
+/*
+a made up templates project with count of every kind of template, each field set to a value that no other field has,
+so that a field read into the wrong place or in the wrong order shows up; the same count always makes the same project
+*/
+namespace testing {
+
+class distinct_values {
+	int32_t next = 1;
+public:
+	int32_t i() {
+		return next++;
+	}
+	float f() {
+		return float(next++) * 0.25f;
+	}
+	bool b() {
+		return (next++ % 2) == 0;
+	}
+	std::string s(char const* prefix) {
+		return prefix + std::to_string(next++);
+	}
+	template_project::aui_text_alignment align() {
+		return template_project::aui_text_alignment(next++ % 3);
+	}
+	// an affine_transform is written whole, with the padding after its dimension, so it is cleared first for the same
+	// values to always give the same bytes
+	void transform(template_project::affine_transform& t) {
+		std::memset(&t, 0, sizeof(t));
+		t.scale = f();
+		t.offset = f();
+		t.dimension = template_project::dimension_relative(next++ % 5);
+	}
+	void text_region(template_project::text_region_template& r) {
+		r = template_project::text_region_template{ i(), i(), i(), f(), f(), f(), align(), align() };
+	}
+	void icon_region(template_project::icon_region_template& r) {
+		r.bg = i();
+		r.icon_color = i();
+		transform(r.icon_top);
+		transform(r.icon_left);
+		transform(r.icon_bottom);
+		transform(r.icon_right);
+	}
+	void mixed_region(template_project::mixed_region_template& r) {
+		r.bg = i();
+		r.shared_color = i();
+		r.font_choice = i();
+		r.font_scale = f();
+		r.h_text_margins = f();
+		r.v_text_margins = f();
+		r.h_text_alignment = align();
+		r.v_text_alignment = align();
+		transform(r.icon_top);
+		transform(r.icon_left);
+		transform(r.icon_bottom);
+		transform(r.icon_right);
+	}
+	void toggle(template_project::toggle_region& r) {
+		r.primary = template_project::color_region{ i(), i() };
+		r.active = template_project::color_region{ i(), i() };
+		r.disabled = template_project::color_region{ i(), i() };
+		r.font_choice = i();
+		r.font_scale = f();
+		r.h_text_alignment = align();
+		r.v_text_alignment = align();
+		transform(r.text_margin_left);
+		transform(r.text_margin_right);
+		transform(r.text_margin_top);
+		transform(r.text_margin_bottom);
+	}
+};
+
+inline template_project::project make_sample_templates(int32_t count) {
+	using namespace template_project;
+	distinct_values v;
+	project p;
+	p.svg_directory = L"assets/svg/";
+	// the templates holding transforms are made where they stay, so that moving them cannot lose the cleared padding
+	p.iconic_button_t.reserve(size_t(count));
+	p.mixed_button_t.reserve(size_t(count));
+	p.toggle_button_t.reserve(size_t(count));
+	for(int32_t n = 0; n < count; ++n) {
+		color_definition c;
+		c.display_name = v.s("color_");
+		c.r = v.f();
+		c.g = v.f();
+		c.b = v.f();
+		c.a = v.f();
+		p.colors.push_back(std::move(c));
+
+		icon_definition icon;
+		icon.file_name = v.s("icon_");
+		p.icons.push_back(std::move(icon));
+
+		background_definition bg;
+		bg.file_name = v.s("background_");
+		bg.base_x = v.i();
+		bg.base_y = v.i();
+		bg.nine_slice_border = n % 2 == 0 ? 0 : v.i();
+		p.backgrounds.push_back(std::move(bg));
+
+		label_template label;
+		label.display_name = v.s("label_");
+		v.text_region(label.primary);
+		p.label_t.push_back(std::move(label));
+
+		button_template button;
+		button.display_name = v.s("button_");
+		v.text_region(button.primary);
+		v.text_region(button.active);
+		v.text_region(button.disabled);
+		button.animate_active_transition = v.b();
+		p.button_t.push_back(std::move(button));
+
+		progress_bar_template bar;
+		bar.display_name = v.s("progress_bar_");
+		bar.bg_a = v.i();
+		bar.bg_b = v.i();
+		bar.text_color = v.i();
+		bar.font_choice = v.i();
+		bar.h_text_margins = v.f();
+		bar.v_text_margins = v.f();
+		bar.h_text_alignment = v.align();
+		bar.v_text_alignment = v.align();
+		bar.display_percentage_text = v.b();
+		p.progress_bar_t.push_back(std::move(bar));
+
+		window_template window;
+		window.display_name = v.s("window_");
+		window.bg = v.i();
+		window.layout_region_definition = v.i();
+		window.close_button_definition = v.i();
+		window.close_button_icon = v.i();
+		window.h_close_button_margin = v.f();
+		window.v_close_button_margin = v.f();
+		p.window_t.push_back(std::move(window));
+
+		auto& iconic = p.iconic_button_t.emplace_back();
+		iconic.display_name = v.s("iconic_button_");
+		v.icon_region(iconic.primary);
+		v.icon_region(iconic.active);
+		v.icon_region(iconic.disabled);
+		iconic.animate_active_transition = v.b();
+
+		layout_region_template region;
+		region.display_name = v.s("layout_region_");
+		v.text_region(region.page_number_text);
+		region.bg = v.i();
+		region.left_button = v.i();
+		region.left_button_icon = v.i();
+		region.right_button = v.i();
+		region.right_button_icon = v.i();
+		p.layout_region_t.push_back(std::move(region));
+
+		auto& mixed = p.mixed_button_t.emplace_back();
+		mixed.display_name = v.s("mixed_button_");
+		v.mixed_region(mixed.primary);
+		v.mixed_region(mixed.active);
+		v.mixed_region(mixed.disabled);
+		mixed.animate_active_transition = v.b();
+
+		auto& toggle = p.toggle_button_t.emplace_back();
+		toggle.display_name = v.s("toggle_button_");
+		v.toggle(toggle.on_region);
+		v.toggle(toggle.off_region);
+		toggle.animate_active_transition = v.b();
+
+		table_template table;
+		table.display_name = v.s("table_");
+		table.arrow_increasing = v.i();
+		table.arrow_decreasing = v.i();
+		table.table_color = v.i();
+		table.interactable_header_bg = v.i();
+		table.active_header_bg = v.i();
+		p.table_t.push_back(std::move(table));
+
+		stacked_bar_template stacked;
+		stacked.display_name = v.s("stacked_bar_");
+		stacked.overlay_bg = v.i();
+		stacked.l_margin = v.f();
+		stacked.t_margin = v.f();
+		stacked.r_margin = v.f();
+		stacked.b_margin = v.f();
+		p.stacked_bar_t.push_back(std::move(stacked));
+
+		drop_down_template drop_down;
+		drop_down.display_name = v.s("drop_down_");
+		drop_down.primary_bg = v.i();
+		drop_down.active_bg = v.i();
+		drop_down.disabled_bg = v.i();
+		drop_down.list_button = v.i();
+		drop_down.list_button_alt = v.i();
+		drop_down.selection_icon = v.i();
+		drop_down.layout_region_base = v.i();
+		drop_down.dropdown_window_bg = v.i();
+		drop_down.dropdown_window_margin = v.f();
+		drop_down.animate_active_transition = v.b();
+		p.drop_down_t.push_back(std::move(drop_down));
+	}
+	return p;
+}
+
+}
@@ -0,0 +1,192 @@
+#include "stools.hpp"
+#include "project_description.hpp"
+#include "sample_project.hpp"
+#include "test_support.hpp"
+#include <functional>
+
+/*
+how fast serialization::out_buffer writes, against the version it replaced, which grew a std::vector one write at a
+time and kept its relocations as std::function
+the same records are written through both, once as plain fields and sections and once with every record's name put
+behind a relocation, and then a whole made up project is saved the way the editor saves .aui files
+*/
+
+void project_to_bytes(open_project_t const& p, serialization::out_buffer& buffer);
+
+namespace legacy {
+
+class out_buffer {
+private:
+	std::vector<char> data_;
+	std::vector<std::pair<size_t, std::function<void(out_buffer&)>>> pending_writes;
+	std::vector<size_t> open_sections;
+public:
+	char const* data() const {
+		return data_.data();
+	}
+	size_t size() const {
+		return data_.size();
+	}
+	void finish_pending() {
+		while(!pending_writes.empty()) {
+			auto relocation_address = data_.data() + pending_writes.back().first;
+			uint32_t new_address = uint32_t(data_.size());
+			std::memcpy(relocation_address, &new_address, sizeof(uint32_t));
+
+			pending_writes.back().second(*this);
+
+			pending_writes.pop_back();
+		}
+	}
+	void start_section() {
+		auto sz_address = data_.size();
+		uint32_t placeholder = 0;
+		write(placeholder);
+		open_sections.emplace_back(sz_address);
+	}
+	void finish_section() {
+		auto size_address = data_.data() + open_sections.back();
+		uint32_t bytes_in_section = uint32_t(data_.size() - open_sections.back());
+		std::memcpy(size_address, &bytes_in_section, sizeof(uint32_t));
+
+		open_sections.pop_back();
+	}
+	void finalize() {
+		finish_pending();
+		while(open_sections.empty() == false) {
+			finish_section();
+		}
+	}
+
+	template<typename T>
+	void write(T const& d) {
+		auto start_size = data_.size();
+		data_.resize(start_size + sizeof(T), 0);
+		std::memcpy(data_.data() + start_size, &d, sizeof(T));
+	}
+	template<typename T>
+	void write_fixed(T const* d, size_t count) {
+		auto start_size = data_.size();
+		data_.resize(start_size + sizeof(T) * count, 0);
+		std::memcpy(data_.data() + start_size, d, sizeof(T) * count);
+	}
+	template<typename T>
+	void write_variable(T const* d, size_t count) {
+		uint32_t c = uint32_t(count);
+		write(c);
+		write_fixed(d, count);
+	}
+	void write_relocation(std::function<void(out_buffer&)>&& f) {
+		auto reloc_address = data_.size();
+		uint32_t placeholder = 0;
+		write(placeholder);
+		pending_writes.emplace_back(reloc_address, std::move(f));
+	}
+	void write(std::string const& s) {
+		write_variable(s.data(), s.length());
+	}
+};
+
+}
+
+struct record {
+	std::string name;
+	std::string texture;
+	int16_t x = 0;
+	int16_t y = 0;
+	int16_t width = 0;
+	int16_t height = 0;
+	color3f color;
+	uint8_t flags = 0;
+};
+
+template<typename B>
+void write_records(B& buffer, std::vector<record> const& records, bool relocated) {
+	buffer.start_section();
+	for(auto& r : records) {
+		buffer.start_section();
+		if(relocated) {
+			// the name and the texture captured the way callers capture them: by pointer, and by value
+			auto p = &r;
+			buffer.write_relocation([p](auto& b) { b.write(p->name); });
+			buffer.write_relocation([texture = r.texture, scale = 1.0f](auto& b) { b.write(texture); b.write(scale); });
+		} else {
+			buffer.write(r.name);
+			buffer.write(r.texture);
+		}
+		buffer.write(r.x);
+		buffer.write(r.y);
+		buffer.write(r.width);
+		buffer.write(r.height);
+		buffer.write(r.color);
+		buffer.write(r.flags);
+		buffer.finish_section();
+	}
+	buffer.finish_section();
+	buffer.finalize();
+}
+
+static double megabytes_per_second(size_t bytes, double ms) {
+	return double(bytes) / (1024.0 * 1024.0) / (ms / 1000.0);
+}
+
+int main() {
+	std::vector<record> records;
+	for(int32_t i = 0; i < 200000; ++i) {
+		record r;
+		r.name = "control_" + std::to_string(i);
+		r.texture = "texture_" + std::to_string(i % 97) + ".dds";
+		r.x = int16_t(i % 400);
+		r.y = int16_t(i % 300);
+		r.width = 36;
+		r.height = 27;
+		r.color = color3f{ 0.5f, 0.25f, 1.0f };
+		r.flags = uint8_t(i);
+		records.push_back(std::move(r));
+	}
+
+	std::printf("%-22s %12s %12s %12s %12s\n", "case", "bytes", "old MB/s", "new MB/s", "speedup");
+	for(bool relocated : { false, true }) {
+		size_t old_bytes = 0;
+		size_t new_bytes = 0;
+		auto old_ms = testing::time_ms(5, [&]() {
+			legacy::out_buffer b;
+			write_records(b, records, relocated);
+			old_bytes = b.size();
+		});
+		auto new_ms = testing::time_ms(5, [&]() {
+			serialization::out_buffer b;
+			write_records(b, records, relocated);
+			new_bytes = b.size();
+		});
+		{
+			legacy::out_buffer old_b;
+			write_records(old_b, records, relocated);
+			serialization::out_buffer new_b;
+			write_records(new_b, records, relocated);
+			if(old_b.size() != new_b.size() || std::memcmp(old_b.data(), new_b.data(), new_b.size()) != 0) {
+				std::printf("the two buffers wrote different bytes\n");
+				return 1;
+			}
+		}
+		std::printf("%-22s %12zu %12.1f %12.1f %11.2fx\n", relocated ? "records, relocated" : "records, plain", new_bytes, megabytes_per_second(old_bytes, old_ms), megabytes_per_second(new_bytes, new_ms), old_ms / new_ms);
+	}
+
+	// saving a project into a buffer that grows as it goes, and into one reserved from the size of the last save,
+	// as the autosave does
+	auto project = testing::make_sample_project(400, 60);
+	size_t project_bytes = 0;
+	auto grown_ms = testing::time_ms(5, [&]() {
+		serialization::out_buffer b;
+		project_to_bytes(project, b);
+		project_bytes = b.size();
+	});
+	auto reserved_ms = testing::time_ms(5, [&]() {
+		serialization::out_buffer b;
+		b.reserve(project_bytes + project_bytes / 8);
+		project_to_bytes(project, b);
+	});
+	std::printf("%-22s %12zu %12s %12.1f\n", "project, grown", project_bytes, "", megabytes_per_second(project_bytes, grown_ms));
+	std::printf("%-22s %12zu %12s %12.1f\n", "project, reserved", project_bytes, "", megabytes_per_second(project_bytes, reserved_ms));
+	return 0;
+}
@@ -0,0 +1,89 @@
+#include "plutovg.h"
+#include "test_support.hpp"
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+
+/*
+a retained path stroked again through a matrix that only moves it reuses its outline, and must come out exactly as
+a fresh stroke would; through any other matrix it is stroked again
+*/
+
+struct stroke_result {
+	std::vector<unsigned char> pixels;
+	int hits = 0;
+	int misses = 0;
+};
+
+static stroke_result stroke(plutovg_path_t* path, float tx, float ty, float scale, float width) {
+	auto surface = plutovg_surface_create(96, 96);
+	auto canvas = plutovg_canvas_create(surface);
+	plutovg_canvas_translate(canvas, tx, ty);
+	plutovg_canvas_scale(canvas, scale, scale);
+	plutovg_canvas_set_line_width(canvas, width);
+	plutovg_canvas_set_rgb(canvas, 0, 0, 0);
+	plutovg_canvas_stroke_path(canvas, path);
+
+	stroke_result result;
+	plutovg_canvas_get_stroke_cache_counts(canvas, &result.hits, &result.misses);
+	auto data = plutovg_surface_get_data(surface);
+	result.pixels.assign(data, data + 96 * 96 * 4);
+	plutovg_canvas_destroy(canvas);
+	plutovg_surface_destroy(surface);
+	return result;
+}
+
+static plutovg_path_t* make_path() {
+	auto path = plutovg_path_create();
+	plutovg_path_add_circle(path, 10, 10, 3);
+	plutovg_path_move_to(path, 2, 2);
+	plutovg_path_cubic_to(path, 8, 1, 3, 15, 18, 17);
+	return path;
+}
+
+static void translations_reuse_the_outline() {
+	auto retained = make_path();
+	std::srand(1);
+	int32_t different = 0;
+	int32_t reused = 0;
+	for(int32_t i = 0; i < 100; ++i) {
+		float tx = float(std::rand() % 1000) / 37.0f;
+		float ty = float(std::rand() % 1000) / 53.0f;
+		stroke(retained, 0.25f, 0.5f, 3.0f, 0.7f);
+		auto cached = stroke(retained, tx, ty, 3.0f, 0.7f);
+		auto fresh_path = make_path();
+		auto fresh = stroke(fresh_path, tx, ty, 3.0f, 0.7f);
+		plutovg_path_destroy(fresh_path);
+		reused += cached.hits;
+		if(cached.pixels != fresh.pixels)
+			++different;
+	}
+	testing::check(reused == 100, "translated strokes reuse the outline, " + std::to_string(reused) + " of 100 did");
+	testing::check(different == 0, std::to_string(different) + " translated strokes differ from fresh ones");
+	plutovg_path_destroy(retained);
+}
+
+static void other_changes_stroke_again() {
+	auto path = make_path();
+	stroke(path, 0.0f, 0.0f, 3.0f, 0.7f);
+	auto same = stroke(path, 0.0f, 0.0f, 3.0f, 0.7f);
+	testing::check(same.hits == 1 && same.misses == 0, "same matrix and width: reused");
+	auto smaller = stroke(path, 0.0f, 0.0f, 2.5f, 0.7f);
+	testing::check(smaller.hits == 0 && smaller.misses == 1, "smaller scale: stroked again");
+	auto larger = stroke(path, 0.0f, 0.0f, 4.0f, 0.7f);
+	testing::check(larger.hits == 0 && larger.misses == 1, "larger scale: stroked again");
+	auto wider = stroke(path, 0.0f, 0.0f, 4.0f, 0.9f);
+	testing::check(wider.hits == 0 && wider.misses == 1, "different width: stroked again");
+
+	// a changed path drops its outline
+	plutovg_path_line_to(path, 30, 5);
+	auto changed = stroke(path, 0.0f, 0.0f, 4.0f, 0.9f);
+	testing::check(changed.hits == 0 && changed.misses == 1, "changed path: stroked again");
+	plutovg_path_destroy(path);
+}
+
+int main() {
+	translations_reuse_the_outline();
+	other_changes_stroke_again();
+	return testing::finish("stroke_cache_tests");
+}
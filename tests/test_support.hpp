@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdio>
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <algorithm>
+
+/*
+the tests and benchmarks are small console programs built by build.ninja (ninja tests, ninja benchmarks)
+a test prints each check that fails and exits with 1 if any did; a benchmark prints its timings
+*/
+namespace testing {
+
+inline int32_t failures = 0;
+
+inline void check(bool condition, std::string const& what) {
+	if(!condition) {
+		std::printf("failed: %s\n", what.c_str());
+		++failures;
+	}
+}
+
+inline int finish(char const* name) {
+	if(failures == 0)
+		std::printf("%s: passed\n", name);
+	else
+		std::printf("%s: %d checks failed\n", name, int(failures));
+	return failures == 0 ? 0 : 1;
+}
+
+// the fastest of the runs, in milliseconds; it is the one least disturbed by whatever else the machine was doing
+template<typename F>
+double time_ms(int32_t runs, F&& f) {
+	double best = 1e30;
+	for(int32_t i = 0; i < runs; ++i) {
+		auto start = std::chrono::steady_clock::now();
+		f();
+		auto end = std::chrono::steady_clock::now();
+		best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+	}
+	return best;
+}
+
+}
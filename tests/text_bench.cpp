@@ -0,0 +1,71 @@
+#include "lunasvg.h"
+#include "test_support.hpp"
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+/*
+renders text_bench.svg, a sheet of text lines, through the glyph masks cached on the font face, and the same sheet
+through the path rasterizer every glyph went through before: the text group is given a skew too small to see, and
+plutovg only blits masks for text that is not skewed
+each scale is timed rendering fifty times in a row, and the two renders are compared pixel by pixel, since masks are
+placed at the nearest quarter pixel instead of exactly
+run from the repository's root, or pass the path of the svg; the text is drawn in the system's sans-serif font
+*/
+
+static std::unique_ptr<lunasvg::Document> load(std::string const& data) {
+	return lunasvg::Document::loadFromData(data.data(), data.size(), [](std::string_view) { return lunasvg::Bitmap{ }; });
+}
+
+int main(int argc, char** argv) {
+	char const* path = argc > 1 ? argv[1] : "tests/text_bench.svg";
+	std::ifstream file(path, std::ios::binary);
+	std::stringstream contents;
+	contents << file.rdbuf();
+	auto data = contents.str();
+	auto skewed_data = data;
+	auto group = skewed_data.find("<g id=\"text\"");
+	if(group != std::string::npos)
+		skewed_data.insert(group + 2, " transform=\"skewX(0.0001)\"");
+
+	auto doc = load(data);
+	auto skewed_doc = load(skewed_data);
+	if(!doc || !skewed_doc || group == std::string::npos) {
+		std::printf("could not read %s\n", path);
+		return 1;
+	}
+
+	std::printf("%6s %12s %12s %9s %14s %14s\n", "scale", "masks ms", "paths ms", "speedup", "mean diff", "max diff");
+	for(float scale : { 1.0f, 1.5f, 2.0f }) {
+		auto width = int32_t(std::ceil(doc->width() * scale));
+		auto height = int32_t(std::ceil(doc->height() * scale));
+		lunasvg::Bitmap masks(width, height);
+		lunasvg::Bitmap paths(width, height);
+		auto matrix = lunasvg::Matrix{ }.scale(scale, scale);
+
+		auto masks_ms = testing::time_ms(3, [&]() {
+			for(int32_t i = 0; i < 50; ++i) {
+				masks.clear(0);
+				doc->render(masks, matrix);
+			}
+		});
+		auto paths_ms = testing::time_ms(3, [&]() {
+			for(int32_t i = 0; i < 50; ++i) {
+				paths.clear(0);
+				skewed_doc->render(paths, matrix);
+			}
+		});
+
+		// the background is the same in both, so the differences are all in the text
+		double total = 0.0;
+		int32_t largest = 0;
+		auto count = size_t(paths.stride()) * size_t(height);
+		for(size_t i = 0; i < count; ++i) {
+			int32_t d = std::abs(int32_t(masks.data()[i]) - int32_t(paths.data()[i]));
+			total += d;
+			largest = std::max(largest, d);
+		}
+		std::printf("%6.1f %12.2f %12.2f %8.2fx %10.2f/255 %10d/255\n", scale, masks_ms, paths_ms, paths_ms / masks_ms, total / double(count), int(largest));
+	}
+	return 0;
+}
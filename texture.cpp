@@ -1,4 +1,11 @@
 #include "texture.hpp"
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #define GL_SILENCE_DEPRECATION
@@ -26,46 +33,181 @@
 
 namespace ogl {
 
-texture::~texture() {
-	if(texture_handle != 0 && loaded) {
-		glDeleteTextures(1, &texture_handle);
+struct texture_cache {
+	std::mutex lock;
+	std::condition_variable wake;
+	std::unordered_map<std::wstring, std::weak_ptr<texture_data>> entries;
+	std::deque<std::weak_ptr<texture_data>> to_decode;
+	std::deque<std::weak_ptr<texture_data>> to_upload;
+	std::vector<uint32_t> to_delete;
+	std::vector<std::thread> workers;
+	size_t decoding = 0; // taken off to_decode but not finished yet
+	bool stopping = false;
+	bool shut_down = false;
+};
+
+// never destroyed: textures held by global objects may be released after every other static is gone
+static texture_cache& cache() {
+	static texture_cache* c = new texture_cache();
+	return *c;
+}
+
+static std::wstring normalize_path(std::wstring const& file) {
+	std::wstring result;
+	auto length = GetFullPathNameW(file.c_str(), 0, nullptr, nullptr);
+	if(length == 0) {
+		result = file;
+	} else {
+		result.resize(length);
+		length = GetFullPathNameW(file.c_str(), length, result.data(), nullptr);
+		result.resize(length);
 	}
+	std::replace(result.begin(), result.end(), L'/', L'\\');
+	if(!result.empty())
+		CharLowerBuffW(result.data(), DWORD(result.size()));
+	return result;
 }
 
-texture::texture(texture&& other) noexcept {
-	loaded = other.loaded;
-	texture_handle = other.texture_handle;
+texture_data::~texture_data() {
+	if(pixels)
+		STBI_FREE(pixels);
 
-	other.loaded = false;
-	other.texture_handle = 0;
+	auto& c = cache();
+	std::lock_guard<std::mutex> guard(c.lock);
+	if(texture_handle != 0 && !c.shut_down)
+		c.to_delete.push_back(texture_handle);
+	// the entry may already have been replaced by a newer load of the same file
+	if(auto it = c.entries.find(file); it != c.entries.end() && it->second.expired())
+		c.entries.erase(it);
 }
-texture::texture(texture const& other) noexcept {
-}
-texture& texture::operator=(texture&& other) noexcept {
-	loaded = other.loaded;
-	texture_handle = other.texture_handle;
-	other.loaded = false;
-	other.texture_handle = 0;
-	return *this;
+
+static void decode_textures() {
+	auto& c = cache();
+	while(true) {
+		std::shared_ptr<texture_data> entry;
+		{
+			std::unique_lock<std::mutex> guard(c.lock);
+			c.wake.wait(guard, [&]() { return c.stopping || !c.to_decode.empty(); });
+			if(c.stopping)
+				return;
+			entry = c.to_decode.front().lock();
+			c.to_decode.pop_front();
+			if(entry)
+				++c.decoding;
+		}
+		if(!entry) // every control using it went away before it got its turn
+			continue;
+
+		uint8_t* pixels = nullptr;
+		int32_t size_x = 0;
+		int32_t size_y = 0;
+		{
+			fs::file tex{ entry->file };
+			auto content = tex.content();
+			int32_t file_channels = 4;
+			if(content.data)
+				pixels = stbi_load_from_memory(reinterpret_cast<uint8_t const*>(content.data), int32_t(content.file_size), &size_x, &size_y, &file_channels, 4);
+		}
+		{
+			std::lock_guard<std::mutex> guard(c.lock);
+			if(pixels) {
+				if(entry->pixels) // the file was reloaded again before the previous version got uploaded
+					STBI_FREE(entry->pixels);
+				else
+					c.to_upload.push_back(entry);
+				entry->pixels = pixels;
+				entry->size_x = size_x;
+				entry->size_y = size_y;
+			}
+			--c.decoding;
+		}
+		// when a reloaded file fails to decode (it may still be half written), the image that was already there stays
+		auto expected = texture_state::decoding;
+		entry->state.compare_exchange_strong(expected, pixels ? texture_state::decoded : texture_state::failed, std::memory_order_release);
+		entry.reset(); // outside of the lock, since releasing the last reference takes it
+	}
 }
-texture& texture::operator=(texture const& other) noexcept {
-	return *this;
+
+// with the cache locked
+static void start_decoding(texture_cache& c) {
+	if(c.workers.empty()) {
+		auto count = std::clamp(int32_t(std::thread::hardware_concurrency()) - 1, 1, 4);
+		for(int32_t i = 0; i < count; ++i) {
+			c.workers.emplace_back(decode_textures);
+		}
+	}
 }
+
 void texture::load(std::wstring const& file_name) {
-	fs::file tex{ file_name };
-	auto content = tex.content();
-	int32_t file_channels = 4;
-	int32_t size_x = 0;
-	int32_t size_y = 0;
-	auto data = stbi_load_from_memory(reinterpret_cast<uint8_t const*>(content.data), int32_t(content.file_size), &(size_x), &(size_y), &file_channels, 4);
 	loaded = true;
-	texture_handle = 0;
-	if(data) {
-		glGenTextures(1, &texture_handle);
-		if(texture_handle) {
-			glBindTexture(GL_TEXTURE_2D, texture_handle);
+	auto file = normalize_path(file_name);
+
+	auto& c = cache();
+	std::shared_ptr<texture_data> found;
+	{
+		std::lock_guard<std::mutex> guard(c.lock);
+		if(auto it = c.entries.find(file); it != c.entries.end())
+			found = it->second.lock();
+		if(!found) {
+			found = std::make_shared<texture_data>();
+			found->file = file;
+			c.entries.insert_or_assign(file, found);
+			if(c.shut_down) {
+				found->state = texture_state::failed;
+			} else {
+				c.to_decode.push_back(found);
+				start_decoding(c);
+			}
+		}
+	}
+	c.wake.notify_one();
+	data = std::move(found);
+}
+
+bool textures_pending() {
+	auto& c = cache();
+	std::lock_guard<std::mutex> guard(c.lock);
+	return !c.to_decode.empty() || !c.to_upload.empty() || c.decoding != 0;
+}
+
+size_t upload_pending_textures(size_t byte_budget) {
+	auto& c = cache();
+	std::vector<uint32_t> deletions;
+	std::deque<std::weak_ptr<texture_data>> uploads;
+	{
+		std::lock_guard<std::mutex> guard(c.lock);
+		deletions.swap(c.to_delete);
+		uploads.swap(c.to_upload);
+	}
+	if(!deletions.empty())
+		glDeleteTextures(GLsizei(deletions.size()), deletions.data());
+
+	size_t uploaded = 0;
+	size_t count = 0;
+	while(!uploads.empty() && uploaded < byte_budget) {
+		auto entry = uploads.front().lock();
+		uploads.pop_front();
+		if(!entry)
+			continue;
+
+		uint8_t* pixels = nullptr;
+		int32_t size_x = 0;
+		int32_t size_y = 0;
+		{
+			std::lock_guard<std::mutex> guard(c.lock);
+			std::swap(pixels, entry->pixels);
+			size_x = entry->size_x;
+			size_y = entry->size_y;
+		}
+		if(!pixels)
+			continue;
+
+		GLuint handle = 0;
+		glGenTextures(1, &handle);
+		if(handle) {
+			glBindTexture(GL_TEXTURE_2D, handle);
 			glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, size_x, size_y);
-			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size_x, size_y, GL_RGBA, GL_UNSIGNED_BYTE, data);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size_x, size_y, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
 
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -74,17 +216,82 @@ void texture::load(std::wstring const& file_name) {
 
 			glBindTexture(GL_TEXTURE_2D, 0);
 		}
-		STBI_FREE(data);
+		if(entry->texture_handle != 0) // a reloaded file replaces the texture only now, so the old one stayed on screen until here
+			glDeleteTextures(1, &entry->texture_handle);
+		entry->texture_handle = handle;
+		uploaded += size_t(size_x) * size_t(size_y) * 4;
+		++count;
+		STBI_FREE(pixels);
+		entry->state.store(handle ? texture_state::ready : texture_state::failed, std::memory_order_release);
+	}
+
+	if(!uploads.empty()) { // whatever did not fit into this frame goes first next frame
+		std::lock_guard<std::mutex> guard(c.lock);
+		c.to_upload.insert(c.to_upload.begin(), std::make_move_iterator(uploads.begin()), std::make_move_iterator(uploads.end()));
 	}
-	
+	return count;
 }
-void texture::unload() {
-	if(texture_handle != 0 && loaded) {
-		glDeleteTextures(1, &texture_handle);
+
+void reload_texture(std::wstring const& file_name) {
+	auto file = file_name.empty() ? std::wstring{ } : normalize_path(file_name);
+	auto& c = cache();
+	std::vector<std::shared_ptr<texture_data>> queued;
+	{
+		std::lock_guard<std::mutex> guard(c.lock);
+		if(c.shut_down)
+			return;
+		for(auto& e : c.entries) {
+			if(!file.empty() && e.first != file)
+				continue;
+			if(auto entry = e.second.lock()) {
+				auto expected = texture_state::failed;
+				entry->state.compare_exchange_strong(expected, texture_state::decoding);
+				c.to_decode.push_back(entry);
+				queued.push_back(std::move(entry));
+			}
+		}
+		if(!queued.empty())
+			start_decoding(c);
 	}
-	loaded = false;
-	texture_handle = 0;
+	c.wake.notify_all();
+	queued.clear(); // outside of the lock, since releasing the last reference takes it
 }
 
+void shutdown_texture_cache() {
+	auto& c = cache();
+	std::vector<std::thread> workers;
+	{
+		std::lock_guard<std::mutex> guard(c.lock);
+		c.stopping = true;
+		workers.swap(c.workers);
+	}
+	c.wake.notify_all();
+	for(auto& w : workers) {
+		w.join();
+	}
+
+	std::vector<std::shared_ptr<texture_data>> live;
+	std::vector<uint32_t> deletions;
+	{
+		std::lock_guard<std::mutex> guard(c.lock);
+		for(auto& e : c.entries) {
+			if(auto entry = e.second.lock())
+				live.push_back(std::move(entry));
+		}
+		deletions.swap(c.to_delete);
+		c.to_decode.clear();
+		c.to_upload.clear();
+		c.shut_down = true;
+	}
+	for(auto& entry : live) {
+		if(entry->texture_handle != 0)
+			deletions.push_back(entry->texture_handle);
+		entry->texture_handle = 0;
+		entry->state = texture_state::failed;
+	}
+	if(!deletions.empty())
+		glDeleteTextures(GLsizei(deletions.size()), deletions.data());
+	live.clear();
 }
 
+}
@@ -1,22 +1,57 @@
 #pragma once
 #include <stdint.h>
 #include <string>
+#include <memory>
+#include <atomic>
 
 namespace ogl {
 
+/*
+images are shared through a central cache keyed by their normalized path, so any number of controls using the same
+file share one decode and one gl texture, and copying a control (or a whole window) just copies the reference
+files are decoded by a small pool of worker threads; the gl upload happens on the main thread in upload_pending_textures
+until then (or if the file could not be decoded) the handle is 0 and the control is drawn without its image
+*/
+
+enum class texture_state : uint8_t {
+	decoding, decoded, ready, failed
+};
+
+struct texture_data {
+	std::wstring file; // normalized
+	std::atomic<texture_state> state = texture_state::decoding;
+	uint32_t texture_handle = 0;
+	int32_t size_x = 0;
+	int32_t size_y = 0;
+	uint8_t* pixels = nullptr; // rgba, owned between the decode and the upload
+
+	~texture_data();
+};
+
 class texture {
 public:
-	uint32_t texture_handle = 0;
-	bool loaded = false;
-
-	texture() { }
-	texture(texture const&) noexcept;
-	texture(texture&& other) noexcept;
-	~texture();
-	texture& operator=(texture const&) noexcept;
-	texture& operator=(texture&& other) noexcept;
+	std::shared_ptr<texture_data> data;
+	bool loaded = false; // a load has been requested; the image may still be on its way
+
 	void load(std::wstring const& file);
-	void unload();
+	void unload() {
+		data.reset();
+		loaded = false;
+	}
+	uint32_t handle() const {
+		return data && data->state.load(std::memory_order_acquire) == texture_state::ready ? data->texture_handle : 0;
+	}
 };
 
+// main thread only: uploads up to roughly the given number of bytes of decoded images and deletes textures that are no longer used
+// returns the number of images uploaded
+size_t upload_pending_textures(size_t byte_budget = size_t(16) * 1024 * 1024);
+// whether any image is still being decoded or waiting for its upload
+bool textures_pending();
+// decodes the file again for everything using it, which keeps showing the old image until the new one is uploaded
+// an empty name reloads every image in the cache
+void reload_texture(std::wstring const& file);
+// stops the decoding threads and deletes every texture still held by the cache; call while the gl context is current
+void shutdown_texture_cache();
+
 }
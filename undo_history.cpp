@@ -0,0 +1,197 @@
+#include <unordered_map>
+#include "undo_history.hpp"
+#include "stools.hpp"
+
+void window_to_bytes(open_project_t const& p, window_element_wrapper_t const& win, serialization::out_buffer& buffer);
+void table_to_bytes(table_definition const& tab, serialization::out_buffer& buffer);
+
+namespace undo {
+
+uint64_t fingerprint_bytes(char const* data, size_t size) {
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for(size_t i = 0; i < size; ++i) {
+		hash ^= uint64_t(uint8_t(data[i]));
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+// the fingerprint is taken over the same bytes the project file would contain, so editor-only state
+// (temporary names, loaded textures) never counts as a change
+static uint64_t fingerprint_window(open_project_t const& p, window_element_wrapper_t const& win, size_t& bytes) {
+	serialization::out_buffer buffer;
+	window_to_bytes(p, win, buffer);
+	bytes = buffer.size();
+	return fingerprint_bytes(buffer.data(), buffer.size());
+}
+static uint64_t fingerprint_tables(open_project_t const& p, size_t& bytes) {
+	serialization::out_buffer buffer;
+	for(auto& t : p.tables) {
+		table_to_bytes(t, buffer);
+	}
+	bytes = buffer.size();
+	return fingerprint_bytes(buffer.data(), buffer.size());
+}
+
+std::shared_ptr<window_snapshot const> history::make_window_snapshot(open_project_t const& p, window_element_wrapper_t const& win) {
+	auto result = std::make_shared<window_snapshot>();
+	result->contents = win;
+	compact_sub_layouts(result->contents); // levels the window no longer reaches are not carried into the history
+	// a rename that was typed but never committed is not part of the state
+	result->contents.wrapped.temp_name = win.wrapped.name;
+	result->contents.wrapped.ogl_texture.unload(); // textures are picked up again from the cache when drawn
+	for(auto& c : result->contents.children) {
+		c.temp_name = c.name;
+		c.ogl_texture.unload();
+	}
+	result->fingerprint = fingerprint_window(p, win, result->bytes);
+	result->accounted_in = memory_used;
+	*memory_used += result->bytes;
+	return result;
+}
+std::shared_ptr<tables_snapshot const> history::make_tables_snapshot(open_project_t const& p) {
+	auto result = std::make_shared<tables_snapshot>();
+	result->contents = p.tables;
+	for(auto& t : result->contents) {
+		t.temp_name = t.name;
+	}
+	result->fingerprint = fingerprint_tables(p, result->bytes);
+	result->accounted_in = memory_used;
+	*memory_used += result->bytes;
+	return result;
+}
+
+void history::reset(open_project_t const& p) {
+	states.clear();
+	position = 0;
+	memory_used = std::make_shared<std::atomic<size_t>>(0);
+	check_everything = false;
+
+	project_state initial;
+	for(auto& w : p.windows) {
+		initial.windows.push_back(make_window_snapshot(p, w));
+	}
+	initial.tables = make_tables_snapshot(p);
+	initial.source_path = p.source_path;
+	initial.grid_size = p.grid_size;
+	initial.omit_lua = p.omit_lua;
+	initial.bake_layouts = p.bake_layouts;
+	states.push_back(std::move(initial));
+}
+
+bool history::record(open_project_t const& p, int32_t edited_window, bool tables_edited) {
+	if(states.empty()) {
+		reset(p);
+		return false;
+	}
+
+	auto const& top = states[position];
+	bool changed = false;
+
+	project_state next;
+	next.source_path = p.source_path;
+	next.grid_size = p.grid_size;
+	next.omit_lua = p.omit_lua;
+	next.bake_layouts = p.bake_layouts;
+	next.focus_window = edited_window;
+	if(next.source_path != top.source_path || next.omit_lua != top.omit_lua || next.bake_layouts != top.bake_layouts) {
+		changed = true;
+	}
+	bool full_check = check_everything || p.windows.size() != top.windows.size() || next.grid_size != top.grid_size; // templated windows embed the grid size
+	check_everything = false;
+
+	if(full_check) {
+		// windows that were only moved around in the list are matched up again by their fingerprint
+		std::unordered_map<uint64_t, std::shared_ptr<window_snapshot const>> previous;
+		for(auto& w : top.windows) {
+			previous.insert_or_assign(w->fingerprint, w);
+		}
+		changed = changed || p.windows.size() != top.windows.size() || next.grid_size != top.grid_size;
+		for(size_t i = 0; i < p.windows.size(); ++i) {
+			size_t bytes = 0;
+			auto fp = fingerprint_window(p, p.windows[i], bytes);
+			if(auto it = previous.find(fp); it != previous.end()) {
+				next.windows.push_back(it->second);
+			} else {
+				next.windows.push_back(make_window_snapshot(p, p.windows[i]));
+			}
+			if(i >= top.windows.size() || next.windows[i] != top.windows[i]) {
+				changed = true;
+				if(next.focus_window == -1)
+					next.focus_window = int32_t(i);
+			}
+		}
+	} else {
+		next.windows = top.windows;
+		if(0 <= edited_window && edited_window < int32_t(p.windows.size())) {
+			size_t bytes = 0;
+			if(fingerprint_window(p, p.windows[edited_window], bytes) != top.windows[edited_window]->fingerprint) {
+				next.windows[edited_window] = make_window_snapshot(p, p.windows[edited_window]);
+				changed = true;
+			}
+		}
+	}
+
+	next.tables = top.tables;
+	if(full_check || tables_edited || p.tables.size() != top.tables->contents.size()) {
+		size_t bytes = 0;
+		if(fingerprint_tables(p, bytes) != top.tables->fingerprint) {
+			next.tables = make_tables_snapshot(p);
+			changed = true;
+		}
+	}
+
+	if(!changed)
+		return false;
+
+	while(states.size() > position + 1) {
+		states.pop_back();
+	}
+	states.push_back(std::move(next));
+	position = states.size() - 1;
+
+	while(states.size() > 1 && (*memory_used > memory_budget || states.size() > max_steps)) {
+		states.pop_front();
+		--position;
+	}
+	return true;
+}
+
+// windows whose snapshot is the same on both sides are kept as they are, which also keeps their loaded textures
+void history::apply(open_project_t& p, project_state const& from, project_state const& to) {
+	std::vector<window_element_wrapper_t> windows;
+	windows.reserve(to.windows.size());
+	for(size_t i = 0; i < to.windows.size(); ++i) {
+		if(i < from.windows.size() && i < p.windows.size() && from.windows[i] == to.windows[i]) {
+			windows.push_back(std::move(p.windows[i]));
+		} else {
+			windows.push_back(to.windows[i]->contents);
+		}
+	}
+	p.windows = std::move(windows);
+	if(from.tables != to.tables) {
+		p.tables = to.tables->contents;
+	}
+	p.source_path = to.source_path;
+	p.grid_size = to.grid_size;
+	p.omit_lua = to.omit_lua;
+	p.bake_layouts = to.bake_layouts;
+}
+
+int32_t history::undo(open_project_t& p) {
+	if(!can_undo())
+		return -1;
+	auto focus = states[position].focus_window;
+	apply(p, states[position], states[position - 1]);
+	--position;
+	return focus;
+}
+int32_t history::redo(open_project_t& p) {
+	if(!can_redo())
+		return -1;
+	apply(p, states[position], states[position + 1]);
+	++position;
+	return states[position].focus_window;
+}
+
+}
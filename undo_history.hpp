@@ -0,0 +1,100 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <deque>
+#include <string>
+#include <atomic>
+#include <stdint.h>
+#include "project_description.hpp"
+
+namespace undo {
+
+/*
+every state in the history is a list of pointers to immutable copies of the windows (and of the table list)
+a step that only touched one window shares all of the other copies with the state before it, so recording
+an edit costs a copy of the edited window and nothing more
+
+snapshots may outlive the history that made them (the autosave thread holds on to them while it writes),
+so each one gives its bytes back to the history's running total when it is finally destroyed
+*/
+
+struct window_snapshot {
+	window_element_wrapper_t contents;
+	uint64_t fingerprint = 0;
+	size_t bytes = 0;
+	std::shared_ptr<std::atomic<size_t>> accounted_in;
+
+	~window_snapshot() {
+		if(accounted_in)
+			*accounted_in -= bytes;
+	}
+};
+struct tables_snapshot {
+	std::vector<table_definition> contents;
+	uint64_t fingerprint = 0;
+	size_t bytes = 0;
+	std::shared_ptr<std::atomic<size_t>> accounted_in;
+
+	~tables_snapshot() {
+		if(accounted_in)
+			*accounted_in -= bytes;
+	}
+};
+
+uint64_t fingerprint_bytes(char const* data, size_t size);
+
+struct project_state {
+	std::vector<std::shared_ptr<window_snapshot const>> windows;
+	std::shared_ptr<tables_snapshot const> tables;
+	std::wstring source_path;
+	int32_t grid_size = 9;
+	bool omit_lua = false;
+	bool bake_layouts = false;
+	int32_t focus_window = -1; // the window that was edited to produce this state
+};
+
+class history {
+private:
+	std::deque<project_state> states;
+	size_t position = 0; // the state that matches the live project
+	std::shared_ptr<std::atomic<size_t>> memory_used = std::make_shared<std::atomic<size_t>>(0);
+	bool check_everything = false;
+
+	std::shared_ptr<window_snapshot const> make_window_snapshot(open_project_t const& p, window_element_wrapper_t const& win);
+	std::shared_ptr<tables_snapshot const> make_tables_snapshot(open_project_t const& p);
+	void apply(open_project_t& p, project_state const& from, project_state const& to);
+public:
+	size_t memory_budget = size_t(256) * 1024 * 1024; // approximate, measured in serialized bytes
+	size_t max_steps = 10000;
+
+	// forget everything and start over from the given project
+	void reset(open_project_t const& p);
+	// the next call to record will compare every window, not just the one being edited
+	// needed after edits that reach across windows, such as renaming a window or a table
+	void request_full_check() {
+		check_everything = true;
+	}
+	// compares the live project against the current state and pushes a new state if anything changed
+	// only the edited window (and the tables, if asked) is compared unless windows were added or removed
+	bool record(open_project_t const& p, int32_t edited_window, bool tables_edited);
+	bool can_undo() const {
+		return position > 0;
+	}
+	bool can_redo() const {
+		return position + 1 < states.size();
+	}
+	// both return the window that the step touched, or -1 if it did not touch a particular window
+	int32_t undo(open_project_t& p);
+	int32_t redo(open_project_t& p);
+	size_t steps() const {
+		return states.size();
+	}
+	size_t memory() const {
+		return memory_used->load();
+	}
+	project_state const& current() const {
+		return states[position];
+	}
+};
+
+}